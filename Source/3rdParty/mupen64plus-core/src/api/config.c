@@ -23,7 +23,17 @@
  * outside of the core library.
  */
 
+#ifdef USE_SDL3
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_thread.h>
+#else
+#include <SDL.h>
+#include <SDL_thread.h>
+#endif
+#include <ctype.h>
+#include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +53,14 @@
 
 #define SECTION_MAGIC 0xDBDC0580
 
+/* minimum number of buckets of the section and variable hash tables,
+ * they're doubled when they hold more entries than buckets */
+#define CONFIG_HASH_MIN_BUCKETS 16
+
+/* time in milliseconds the config writer waits for more
+ * saves before writing the config file to the disk */
+#define CONFIG_WRITE_DELAY 500
+
 struct external_config {
   char *file;
   size_t length;
@@ -58,13 +76,22 @@ typedef struct _config_var {
   } val;
   char                 *comment;
   struct _config_var   *next;
+  unsigned int          hash;
+  struct _config_var   *hash_next;
   } config_var;
 
 typedef struct _config_section {
   unsigned int            magic;
   char                   *name;
   struct _config_var     *first_var;
+  struct _config_var     *last_var;
   struct _config_section *next;
+  /* hash table of the variables, when it's NULL the variable list is searched */
+  struct _config_var    **var_buckets;
+  unsigned int            var_bucket_count;
+  unsigned int            var_count;
+  unsigned int            hash;
+  struct _config_section *hash_next;
   } config_section;
 
 typedef config_section *config_list;
@@ -78,6 +105,28 @@ static char       *l_UserDataDirOverride = NULL;
 static config_list l_ConfigListActive = NULL;
 static config_list l_ConfigListSaved = NULL;
 
+/* hash table of the sections in the Active list, when it's NULL the list is searched */
+static config_section **l_SectionBuckets = NULL;
+static unsigned int     l_SectionBucketCount = 0;
+static unsigned int     l_SectionCount = 0;
+
+/* the config writer thread writes the config file which has been
+ * serialized by ConfigSaveFile() and ConfigSaveSection(), so saving
+ * never waits on the disk, l_WriterLock protects the pending file */
+static SDL_Thread *l_WriterThread = NULL;
+#ifdef USE_SDL3
+static SDL_Mutex *l_WriterLock = NULL;
+static SDL_Condition *l_WriterCond = NULL;
+#else
+static SDL_mutex *l_WriterLock = NULL;
+static SDL_cond *l_WriterCond = NULL;
+#endif
+static int       l_WriterRunning = 0;
+static char     *l_WriterPath = NULL;
+static char     *l_WriterData = NULL;
+static size_t    l_WriterLength = 0;
+static uint64_t  l_WriterDeadline = 0;
+
 /* --------------- */
 /* local functions */
 /* --------------- */
@@ -136,6 +185,117 @@ static config_section *find_section(config_list list, const char *ParamName)
     return *find_section_link(&list, ParamName);
 }
 
+/* case-insensitive FNV-1a hash, which matches osal_insensitive_strcmp() */
+static unsigned int config_name_hash(const char *name)
+{
+    unsigned int hash = 2166136261u;
+
+    while (*name != '\0')
+    {
+        hash ^= (unsigned int) tolower((unsigned char) *name++);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* rebuilds the section hash table from the Active list, when the
+ * table can't be allocated, sections are looked up in the list */
+static void rehash_active_sections(unsigned int bucket_count)
+{
+    config_section *curr_section;
+
+    free(l_SectionBuckets);
+    l_SectionCount = 0;
+    l_SectionBucketCount = 0;
+
+    l_SectionBuckets = (config_section **) calloc(bucket_count, sizeof(config_section *));
+    if (l_SectionBuckets == NULL)
+        return;
+    l_SectionBucketCount = bucket_count;
+
+    for (curr_section = l_ConfigListActive; curr_section != NULL; curr_section = curr_section->next)
+    {
+        unsigned int index = curr_section->hash & (l_SectionBucketCount - 1);
+        curr_section->hash_next = l_SectionBuckets[index];
+        l_SectionBuckets[index] = curr_section;
+        l_SectionCount++;
+    }
+}
+
+/* adds a section, which has already been linked into the Active list, to the hash table */
+static void index_active_section(config_section *section)
+{
+    unsigned int index;
+
+    if (l_SectionBuckets == NULL || l_SectionCount >= l_SectionBucketCount)
+    {
+        unsigned int bucket_count = l_SectionBucketCount * 2;
+        if (bucket_count < CONFIG_HASH_MIN_BUCKETS)
+            bucket_count = CONFIG_HASH_MIN_BUCKETS;
+        rehash_active_sections(bucket_count);
+        return;
+    }
+
+    index = section->hash & (l_SectionBucketCount - 1);
+    section->hash_next = l_SectionBuckets[index];
+    l_SectionBuckets[index] = section;
+    l_SectionCount++;
+}
+
+static void unindex_active_section(config_section *section)
+{
+    config_section **curr_section_link;
+
+    if (l_SectionBuckets == NULL)
+        return;
+
+    curr_section_link = &l_SectionBuckets[section->hash & (l_SectionBucketCount - 1)];
+    for (; *curr_section_link != NULL; curr_section_link = &(*curr_section_link)->hash_next)
+    {
+        if (*curr_section_link == section)
+        {
+            *curr_section_link = section->hash_next;
+            l_SectionCount--;
+            break;
+        }
+    }
+}
+
+static config_section *find_active_section(const char *ParamName)
+{
+    config_section *curr_section;
+    unsigned int hash;
+
+    if (l_SectionBuckets == NULL)
+        return find_section(l_ConfigListActive, ParamName);
+
+    hash = config_name_hash(ParamName);
+    for (curr_section = l_SectionBuckets[hash & (l_SectionBucketCount - 1)]; curr_section != NULL; curr_section = curr_section->hash_next)
+    {
+        if (curr_section->hash == hash && osal_insensitive_strcmp(ParamName, curr_section->name) == 0)
+            return curr_section;
+    }
+
+    return NULL;
+}
+
+/* returns the link to a section in the Active list, without
+ * comparing the names of all of the sections before it */
+static config_section **find_active_section_link(const char *ParamName)
+{
+    config_section *section = find_active_section(ParamName);
+    config_section **curr_sec_link;
+
+    for (curr_sec_link = &l_ConfigListActive; *curr_sec_link != NULL; curr_sec_link = &(*curr_sec_link)->next)
+    {
+        if (*curr_sec_link == section)
+            break;
+    }
+
+    return curr_sec_link;
+}
+
 static config_var *config_var_create(const char *ParamName, const char *ParamHelp)
 {
     config_var *var;
@@ -173,16 +333,57 @@ static config_var *config_var_create(const char *ParamName, const char *ParamHel
         var->comment = NULL;
 
     var->next = NULL;
+    var->hash = config_name_hash(var->name);
+    var->hash_next = NULL;
     return var;
 }
 
-static config_var *find_section_var(config_section *section, const char *ParamName)
+/* rebuilds the variable hash table of a section, when the
+ * table can't be allocated, variables are looked up in the list */
+static void rehash_section_vars(config_section *section, unsigned int bucket_count)
 {
-    /* walk through the linked list of variables in the section */
     config_var *curr_var;
+
+    free(section->var_buckets);
+    section->var_count = 0;
+    section->var_bucket_count = 0;
+
+    section->var_buckets = (config_var **) calloc(bucket_count, sizeof(config_var *));
+    if (section->var_buckets == NULL)
+        return;
+    section->var_bucket_count = bucket_count;
+
     for (curr_var = section->first_var; curr_var != NULL; curr_var = curr_var->next)
     {
-        if (osal_insensitive_strcmp(ParamName, curr_var->name) == 0)
+        unsigned int index = curr_var->hash & (section->var_bucket_count - 1);
+        curr_var->hash_next = section->var_buckets[index];
+        section->var_buckets[index] = curr_var;
+        section->var_count++;
+    }
+}
+
+static config_var *find_section_var(config_section *section, const char *ParamName)
+{
+    config_var *curr_var;
+    unsigned int hash;
+
+    if (section->var_buckets == NULL)
+    {
+        /* walk through the linked list of variables in the section */
+        for (curr_var = section->first_var; curr_var != NULL; curr_var = curr_var->next)
+        {
+            if (osal_insensitive_strcmp(ParamName, curr_var->name) == 0)
+                return curr_var;
+        }
+
+        /* couldn't find this configuration parameter */
+        return NULL;
+    }
+
+    hash = config_name_hash(ParamName);
+    for (curr_var = section->var_buckets[hash & (section->var_bucket_count - 1)]; curr_var != NULL; curr_var = curr_var->hash_next)
+    {
+        if (curr_var->hash == hash && osal_insensitive_strcmp(ParamName, curr_var->name) == 0)
             return curr_var;
     }
 
@@ -192,22 +393,30 @@ static config_var *find_section_var(config_section *section, const char *ParamNa
 
 static void append_var_to_section(config_section *section, config_var *var)
 {
-    config_var *last_var;
+    unsigned int index;
 
     if (section == NULL || var == NULL || section->magic != SECTION_MAGIC)
         return;
 
-    if (section->first_var == NULL)
-    {
+    if (section->last_var == NULL)
         section->first_var = var;
+    else
+        section->last_var->next = var;
+    section->last_var = var;
+
+    if (section->var_buckets == NULL || section->var_count >= section->var_bucket_count)
+    {
+        unsigned int bucket_count = section->var_bucket_count * 2;
+        if (bucket_count < CONFIG_HASH_MIN_BUCKETS)
+            bucket_count = CONFIG_HASH_MIN_BUCKETS;
+        rehash_section_vars(section, bucket_count);
         return;
     }
 
-    last_var = section->first_var;
-    while (last_var->next != NULL)
-        last_var = last_var->next;
-
-    last_var->next = var;
+    index = var->hash & (section->var_bucket_count - 1);
+    var->hash_next = section->var_buckets[index];
+    section->var_buckets[index] = var;
+    section->var_count++;
 }
 
 static void delete_var(config_var *var)
@@ -234,6 +443,7 @@ static void delete_section(config_section *pSection)
         curr_var = next_var;
     }
 
+    free(pSection->var_buckets);
     free(pSection->name);
     free(pSection);
 }
@@ -272,14 +482,20 @@ static config_section *config_section_create(const char *ParamName)
         return NULL;
     }
     sec->first_var = NULL;
+    sec->last_var = NULL;
     sec->next = NULL;
+    sec->var_buckets = NULL;
+    sec->var_bucket_count = 0;
+    sec->var_count = 0;
+    sec->hash = config_name_hash(sec->name);
+    sec->hash_next = NULL;
     return sec;
 }
 
 static config_section * section_deepcopy(config_section *orig_section)
 {
     config_section *new_section;
-    config_var *orig_var, *last_new_var;
+    config_var *orig_var;
 
     /* Input validation */
     if (orig_section == NULL)
@@ -292,7 +508,6 @@ static config_section * section_deepcopy(config_section *orig_section)
 
     /* create and copy all section variables */
     orig_var = orig_section->first_var;
-    last_new_var = NULL;
     while (orig_var != NULL)
     {
         config_var *new_var = config_var_create(orig_var->name, orig_var->comment);
@@ -332,11 +547,7 @@ static config_section * section_deepcopy(config_section *orig_section)
         }
 
         /* add the new variable to the new section */
-        if (last_new_var == NULL)
-            new_section->first_var = new_var;
-        else
-            last_new_var->next = new_var;
-        last_new_var = new_var;
+        append_var_to_section(new_section, new_var);
         /* advance variable pointer in original section variable list */
         orig_var = orig_var->next;
     }
@@ -366,62 +577,312 @@ static void copy_configlist_active_to_saved(void)
     }
 }
 
-static m64p_error write_configlist_file(void)
+typedef struct {
+    char  *data;
+    size_t length;
+    size_t capacity;
+    int    failed;
+} config_buffer;
+
+static void config_buffer_printf(config_buffer *buffer, const char *format, ...)
 {
-    config_section *curr_section;
-    const char *configpath;
-    char *filepath;
-    FILE *fPtr;
+    va_list args;
+    int length;
 
-    /* get the full pathname to the config file and try to open it */
-    configpath = ConfigGetUserConfigPath();
-    if (configpath == NULL)
-        return M64ERR_FILES;
+    if (buffer->failed)
+        return;
 
-    filepath = combinepath(configpath, MUPEN64PLUS_CFG_NAME);
-    if (filepath == NULL)
-        return M64ERR_NO_MEMORY;
+    va_start(args, format);
+    length = vsnprintf(buffer->data + buffer->length, buffer->capacity - buffer->length, format, args);
+    va_end(args);
 
-    fPtr = osal_file_open(filepath, "wb");
-    if (fPtr == NULL)
+    if (length < 0)
     {
-        DebugMessage(M64MSG_ERROR, "Couldn't open configuration file '%s' for writing.", filepath);
-        free(filepath);
-        return M64ERR_FILES;
+        buffer->failed = 1;
+        return;
     }
-    free(filepath);
+
+    /* grow the buffer and format the string again when it didn't fit */
+    if ((size_t) length >= buffer->capacity - buffer->length)
+    {
+        size_t capacity = buffer->capacity * 2;
+        char *data;
+
+        while ((size_t) length >= capacity - buffer->length)
+            capacity *= 2;
+
+        data = (char *) realloc(buffer->data, capacity);
+        if (data == NULL)
+        {
+            buffer->failed = 1;
+            return;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+
+        va_start(args, format);
+        vsnprintf(buffer->data + buffer->length, buffer->capacity - buffer->length, format, args);
+        va_end(args);
+    }
+
+    buffer->length += (size_t) length;
+}
+
+/* serializes the Saved list to the config file format */
+static m64p_error serialize_configlist(config_buffer *buffer)
+{
+    config_section *curr_section;
+
+    buffer->capacity = 16384;
+    buffer->length = 0;
+    buffer->failed = 0;
+    buffer->data = (char *) malloc(buffer->capacity);
+    if (buffer->data == NULL)
+        return M64ERR_NO_MEMORY;
 
     /* write out header */
-    fprintf(fPtr, "# Mupen64Plus Configuration File\n");
-    fprintf(fPtr, "# This file is automatically read and written by the Mupen64Plus Core library\n");
+    config_buffer_printf(buffer, "# Mupen64Plus Configuration File\n");
+    config_buffer_printf(buffer, "# This file is automatically read and written by the Mupen64Plus Core library\n");
 
     /* write out all of the config parameters from the Saved list */
     curr_section = l_ConfigListSaved;
     while (curr_section != NULL)
     {
         config_var *curr_var = curr_section->first_var;
-        fprintf(fPtr, "\n[%s]\n\n", curr_section->name);
+        config_buffer_printf(buffer, "\n[%s]\n\n", curr_section->name);
         while (curr_var != NULL)
         {
             if (curr_var->comment != NULL && strlen(curr_var->comment) > 0)
-                fprintf(fPtr, "# %s\n", curr_var->comment);
+                config_buffer_printf(buffer, "# %s\n", curr_var->comment);
             if (curr_var->type == M64TYPE_INT)
-                fprintf(fPtr, "%s = %i\n", curr_var->name, curr_var->val.integer);
+                config_buffer_printf(buffer, "%s = %i\n", curr_var->name, curr_var->val.integer);
             else if (curr_var->type == M64TYPE_FLOAT)
-                fprintf(fPtr, "%s = %f\n", curr_var->name, curr_var->val.number);
+                config_buffer_printf(buffer, "%s = %f\n", curr_var->name, curr_var->val.number);
             else if (curr_var->type == M64TYPE_BOOL && curr_var->val.integer)
-                fprintf(fPtr, "%s = True\n", curr_var->name);
+                config_buffer_printf(buffer, "%s = True\n", curr_var->name);
             else if (curr_var->type == M64TYPE_BOOL && !curr_var->val.integer)
-                fprintf(fPtr, "%s = False\n", curr_var->name);
+                config_buffer_printf(buffer, "%s = False\n", curr_var->name);
             else if (curr_var->type == M64TYPE_STRING && curr_var->val.string != NULL)
-                fprintf(fPtr, "%s = \"%s\"\n", curr_var->name, curr_var->val.string);
+                config_buffer_printf(buffer, "%s = \"%s\"\n", curr_var->name, curr_var->val.string);
             curr_var = curr_var->next;
         }
-        fprintf(fPtr, "\n");
+        config_buffer_printf(buffer, "\n");
         curr_section = curr_section->next;
     }
 
-    fclose(fPtr);
+    if (buffer->failed)
+    {
+        free(buffer->data);
+        buffer->data = NULL;
+        return M64ERR_NO_MEMORY;
+    }
+
+    return M64ERR_SUCCESS;
+}
+
+/* writes the data to a temporary file first and then replaces the
+ * config file with it, so the config file is never left half-written */
+static m64p_error write_config_data(const char *filepath, const char *data, size_t length)
+{
+    char *temppath;
+    FILE *fPtr;
+    int failed;
+
+    temppath = formatstr("%s.tmp", filepath);
+    if (temppath == NULL)
+        return M64ERR_NO_MEMORY;
+
+    fPtr = osal_file_open(temppath, "wb");
+    if (fPtr == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "Couldn't open configuration file '%s' for writing.", temppath);
+        free(temppath);
+        return M64ERR_FILES;
+    }
+
+    failed = fwrite(data, 1, length, fPtr) != length;
+    failed |= fclose(fPtr) != 0;
+
+    if (failed || osal_file_replace(temppath, filepath) != 0)
+    {
+        DebugMessage(M64MSG_ERROR, "Couldn't write configuration file '%s'.", filepath);
+        remove(temppath);
+        free(temppath);
+        return M64ERR_FILES;
+    }
+
+    free(temppath);
+    return M64ERR_SUCCESS;
+}
+
+/* writes the pending config file, expects l_WriterLock to be locked */
+static void config_writer_flush(void)
+{
+    char  *filepath = l_WriterPath;
+    char  *data = l_WriterData;
+    size_t length = l_WriterLength;
+
+    if (data == NULL)
+        return;
+
+    l_WriterPath = NULL;
+    l_WriterData = NULL;
+    l_WriterLength = 0;
+
+    /* don't hold the lock while writing, so
+     * saving doesn't wait on the disk */
+    SDL_UnlockMutex(l_WriterLock);
+    write_config_data(filepath, data, length);
+    free(filepath);
+    free(data);
+    SDL_LockMutex(l_WriterLock);
+}
+
+static int config_writer_thread(void *data)
+{
+    SDL_LockMutex(l_WriterLock);
+    while (l_WriterRunning)
+    {
+        uint64_t now = SDL_GetTicks();
+
+        if (l_WriterData == NULL)
+        {
+#ifdef USE_SDL3
+            SDL_WaitCondition(l_WriterCond, l_WriterLock);
+#else
+            SDL_CondWait(l_WriterCond, l_WriterLock);
+#endif
+        }
+        else if (now < l_WriterDeadline)
+        {
+            /* wait until there haven't been any saves for CONFIG_WRITE_DELAY */
+#ifdef USE_SDL3
+            SDL_WaitConditionTimeout(l_WriterCond, l_WriterLock, (Sint32)(l_WriterDeadline - now));
+#else
+            SDL_CondWaitTimeout(l_WriterCond, l_WriterLock, (Uint32)(l_WriterDeadline - now));
+#endif
+        }
+        else
+        {
+            config_writer_flush();
+        }
+    }
+
+    /* write the last save before exiting */
+    config_writer_flush();
+    SDL_UnlockMutex(l_WriterLock);
+    return 0;
+}
+
+static int config_writer_start(void)
+{
+    if (l_WriterThread != NULL)
+        return 1;
+
+    if (l_WriterLock == NULL)
+        l_WriterLock = SDL_CreateMutex();
+    if (l_WriterCond == NULL)
+#ifdef USE_SDL3
+        l_WriterCond = SDL_CreateCondition();
+#else
+        l_WriterCond = SDL_CreateCond();
+#endif
+    if (l_WriterLock == NULL || l_WriterCond == NULL)
+        return 0;
+
+    l_WriterRunning = 1;
+    l_WriterThread = SDL_CreateThread(config_writer_thread, "m64pconfig", NULL);
+    if (l_WriterThread == NULL)
+    {
+        DebugMessage(M64MSG_WARNING, "Couldn't create configuration writer thread: %s", SDL_GetError());
+        l_WriterRunning = 0;
+        return 0;
+    }
+
+    return 1;
+}
+
+/* stops the config writer thread, which writes the pending config file first */
+static void config_writer_stop(void)
+{
+    if (l_WriterThread != NULL)
+    {
+        SDL_LockMutex(l_WriterLock);
+        l_WriterRunning = 0;
+#ifdef USE_SDL3
+        SDL_SignalCondition(l_WriterCond);
+#else
+        SDL_CondSignal(l_WriterCond);
+#endif
+        SDL_UnlockMutex(l_WriterLock);
+        SDL_WaitThread(l_WriterThread, NULL);
+        l_WriterThread = NULL;
+    }
+
+    if (l_WriterCond != NULL)
+    {
+#ifdef USE_SDL3
+        SDL_DestroyCondition(l_WriterCond);
+#else
+        SDL_DestroyCond(l_WriterCond);
+#endif
+        l_WriterCond = NULL;
+    }
+
+    if (l_WriterLock != NULL)
+    {
+        SDL_DestroyMutex(l_WriterLock);
+        l_WriterLock = NULL;
+    }
+}
+
+static m64p_error write_configlist_file(void)
+{
+    config_buffer buffer;
+    const char *configpath;
+    char *filepath;
+    m64p_error rval;
+
+    /* get the full pathname to the config file */
+    configpath = ConfigGetUserConfigPath();
+    if (configpath == NULL)
+        return M64ERR_FILES;
+
+    filepath = combinepath(configpath, MUPEN64PLUS_CFG_NAME);
+    if (filepath == NULL)
+        return M64ERR_NO_MEMORY;
+
+    rval = serialize_configlist(&buffer);
+    if (rval != M64ERR_SUCCESS)
+    {
+        free(filepath);
+        return rval;
+    }
+
+    /* fall back to writing the file on the calling thread */
+    if (!config_writer_start())
+    {
+        rval = write_config_data(filepath, buffer.data, buffer.length);
+        free(filepath);
+        free(buffer.data);
+        return rval;
+    }
+
+    /* replace the pending file, only the latest save has to be written */
+    SDL_LockMutex(l_WriterLock);
+    free(l_WriterPath);
+    free(l_WriterData);
+    l_WriterPath = filepath;
+    l_WriterData = buffer.data;
+    l_WriterLength = buffer.length;
+    l_WriterDeadline = SDL_GetTicks() + CONFIG_WRITE_DELAY;
+#ifdef USE_SDL3
+    SDL_SignalCondition(l_WriterCond);
+#else
+    SDL_CondSignal(l_WriterCond);
+#endif
+    SDL_UnlockMutex(l_WriterLock);
+
     return M64ERR_SUCCESS;
 }
 
@@ -618,9 +1079,16 @@ m64p_error ConfigShutdown(void)
         l_UserCacheDirOverride = NULL;
     }
 
+    /* write the pending config file */
+    config_writer_stop();
+
     /* free all of the memory in the 2 lists */
     delete_list(&l_ConfigListActive);
     delete_list(&l_ConfigListSaved);
+    free(l_SectionBuckets);
+    l_SectionBuckets = NULL;
+    l_SectionBucketCount = 0;
+    l_SectionCount = 0;
 
     return M64ERR_SUCCESS;
 }
@@ -767,11 +1235,11 @@ EXPORT m64p_error CALL ConfigOpenSection(const char *SectionName, m64p_handle *C
     if (SectionName == NULL || ConfigSectionHandle == NULL)
         return M64ERR_INPUT_ASSERT;
 
-    /* walk through the section list, looking for a case-insensitive name match */
-    curr_section = find_alpha_section_link(&l_ConfigListActive, SectionName);
-    if (*curr_section != NULL && osal_insensitive_strcmp(SectionName, (*curr_section)->name) == 0)
+    /* look up the section by its case-insensitive name */
+    new_section = find_active_section(SectionName);
+    if (new_section != NULL)
     {
-        *ConfigSectionHandle = *curr_section;
+        *ConfigSectionHandle = new_section;
         return M64ERR_SUCCESS;
     }
 
@@ -781,8 +1249,10 @@ EXPORT m64p_error CALL ConfigOpenSection(const char *SectionName, m64p_handle *C
         return M64ERR_NO_MEMORY;
 
     /* add section to list in alphabetical order */
+    curr_section = find_alpha_section_link(&l_ConfigListActive, SectionName);
     new_section->next = *curr_section;
     *curr_section = new_section;
+    index_active_section(new_section);
 
     *ConfigSectionHandle = new_section;
     return M64ERR_SUCCESS;
@@ -851,8 +1321,8 @@ EXPORT int CALL ConfigHasUnsavedChanges(const char *SectionName)
             return 1;
     }
 
-    /* walk through the Active section list, looking for a case-insensitive name match with input string */
-    input_section = find_section(l_ConfigListActive, SectionName);
+    /* look up the section in the Active list by its case-insensitive name */
+    input_section = find_active_section(SectionName);
     if (input_section == NULL)
     {
         DebugMessage(M64MSG_ERROR, "ConfigHasUnsavedChanges(): section name '%s' not found!", SectionName);
@@ -937,11 +1407,12 @@ EXPORT m64p_error CALL ConfigDeleteSection(const char *SectionName)
         return M64ERR_INPUT_NOT_FOUND;
 
     /* find the named section and pull it out of the list */
-    curr_section_link = find_section_link(&l_ConfigListActive, SectionName);
+    curr_section_link = find_active_section_link(SectionName);
     if (*curr_section_link == NULL)
         return M64ERR_INPUT_NOT_FOUND;
 
     next_section = (*curr_section_link)->next;
+    unindex_active_section(*curr_section_link);
 
     /* delete the named section */
     delete_section(*curr_section_link);
@@ -974,8 +1445,8 @@ EXPORT m64p_error CALL ConfigSaveSection(const char *SectionName)
     if (SectionName == NULL || strlen(SectionName) < 1)
         return M64ERR_INPUT_ASSERT;
 
-    /* walk through the Active section list, looking for a case-insensitive name match */
-    curr_section = find_section(l_ConfigListActive, SectionName);
+    /* look up the section in the Active list by its case-insensitive name */
+    curr_section = find_active_section(SectionName);
     if (curr_section == NULL)
         return M64ERR_INPUT_NOT_FOUND;
 
@@ -1014,8 +1485,8 @@ EXPORT m64p_error CALL ConfigRevertChanges(const char *SectionName)
     if (SectionName == NULL)
         return M64ERR_INPUT_ASSERT;
 
-    /* walk through the Active section list, looking for a case-insensitive name match with input string */
-    active_section_link = find_section_link(&l_ConfigListActive, SectionName);
+    /* look up the section in the Active list by its case-insensitive name */
+    active_section_link = find_active_section_link(SectionName);
     active_section = *active_section_link;
     if (active_section == NULL)
         return M64ERR_INPUT_NOT_FOUND;
@@ -1034,8 +1505,10 @@ EXPORT m64p_error CALL ConfigRevertChanges(const char *SectionName)
         return M64ERR_NO_MEMORY;
 
     /* replace active_section with saved_section in the linked list */
+    unindex_active_section(active_section);
     *active_section_link = new_section;
     new_section->next = active_section->next;
+    index_active_section(new_section);
 
     /* release memory associated with active_section */
     delete_section(active_section);
@@ -304,6 +304,16 @@ EXPORT m64p_error CALL CoreDoCommand(m64p_command Command, int ParamInt, void *P
                 return M64ERR_INPUT_INVALID;
             main_state_save(ParamInt, (char *) ParamPtr);
             return M64ERR_SUCCESS;
+        case M64CMD_STATE_LOAD_MEMORY:
+        case M64CMD_STATE_SAVE_MEMORY:
+            if (!g_EmulatorRunning)
+                return M64ERR_INVALID_STATE;
+            if (ParamPtr == NULL || ParamInt < SAVESTATE_M64P_SIZE)
+                return M64ERR_INPUT_INVALID;
+            if (Command == M64CMD_STATE_LOAD_MEMORY)
+                return main_state_load_memory(ParamPtr, (size_t) ParamInt);
+            else
+                return main_state_save_memory(ParamPtr, (size_t) ParamInt);
         case M64CMD_STATE_SET_SLOT:
             if (ParamInt < 0 || ParamInt > 9)
                 return M64ERR_INPUT_INVALID;
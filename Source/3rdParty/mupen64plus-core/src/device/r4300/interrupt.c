@@ -44,6 +44,7 @@
 #include "device/rcp/ai/ai_controller.h"
 #include "device/rcp/vi/vi_controller.h"
 #include "main/main.h"
+#include "main/rollback.h"
 #include "main/savestates.h"
 
 
@@ -553,6 +554,17 @@ void gen_interrupt(struct r4300_core* r4300)
 
     if (!r4300->cp0.interrupt_unsafe_state)
     {
+        if (rollback_process_load())
+        {
+            return;
+        }
+
+        if (savestates_get_memory_job() == savestates_job_load)
+        {
+            savestates_load_memory();
+            return;
+        }
+
         if (savestates_get_job() == savestates_job_load)
         {
             savestates_load();
@@ -673,6 +685,13 @@ void gen_interrupt(struct r4300_core* r4300)
 
     if (!r4300->cp0.interrupt_unsafe_state)
     {
+        rollback_process_save();
+
+        if (savestates_get_memory_job() == savestates_job_save)
+        {
+            savestates_save_memory();
+        }
+
         if (savestates_get_job() == savestates_job_save)
         {
             savestates_save();
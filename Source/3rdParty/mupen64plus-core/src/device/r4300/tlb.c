@@ -28,12 +28,24 @@
 #include <assert.h>
 #include <string.h>
 
+static void mark_lut_dirty(struct tlb* tlb, unsigned int start, unsigned int end)
+{
+    unsigned int i;
+
+    if (start >= end)
+        return;
+
+    for (i = start >> 22; i <= ((end - 1) >> 22); ++i)
+        tlb->LUT_dirty[i] = 1;
+}
+
 void poweron_tlb(struct tlb* tlb)
 {
     /* clear TLB entries */
     memset(tlb->entries, 0, 32 * sizeof(tlb->entries[0]));
     memset(tlb->LUT_r, 0, 0x100000 * sizeof(tlb->LUT_r[0]));
     memset(tlb->LUT_w, 0, 0x100000 * sizeof(tlb->LUT_w[0]));
+    memset(tlb->LUT_dirty, 1, TLB_LUT_DIRTY_PAGES_COUNT * sizeof(tlb->LUT_dirty[0]));
 }
 
 void tlb_unmap(struct tlb* tlb, size_t entry)
@@ -46,6 +58,7 @@ void tlb_unmap(struct tlb* tlb, size_t entry)
 
     if (e->v_even)
     {
+        mark_lut_dirty(tlb, e->start_even, e->end_even);
         for (i=e->start_even; i<e->end_even; i += 0x1000)
             tlb->LUT_r[i>>12] = 0;
         if (e->d_even)
@@ -55,6 +68,7 @@ void tlb_unmap(struct tlb* tlb, size_t entry)
 
     if (e->v_odd)
     {
+        mark_lut_dirty(tlb, e->start_odd, e->end_odd);
         for (i=e->start_odd; i<e->end_odd; i += 0x1000)
             tlb->LUT_r[i>>12] = 0;
         if (e->d_odd)
@@ -77,6 +91,7 @@ void tlb_map(struct tlb* tlb, size_t entry)
             !(e->start_even >= 0x80000000 && e->end_even < 0xC0000000) &&
             e->phys_even < 0x20000000)
         {
+            mark_lut_dirty(tlb, e->start_even, e->end_even);
             for (i=e->start_even;i<e->end_even;i+=0x1000)
                 tlb->LUT_r[i>>12] = UINT32_C(0x80000000) | (e->phys_even + (i - e->start_even) + 0xFFF);
             if (e->d_even)
@@ -91,6 +106,7 @@ void tlb_map(struct tlb* tlb, size_t entry)
             !(e->start_odd >= 0x80000000 && e->end_odd < 0xC0000000) &&
             e->phys_odd < 0x20000000)
         {
+            mark_lut_dirty(tlb, e->start_odd, e->end_odd);
             for (i=e->start_odd;i<e->end_odd;i+=0x1000)
                 tlb->LUT_r[i>>12] = UINT32_C(0x80000000) | (e->phys_odd + (i - e->start_odd) + 0xFFF);
             if (e->d_odd)
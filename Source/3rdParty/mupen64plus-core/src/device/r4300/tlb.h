@@ -52,11 +52,16 @@ struct tlb_entry
    unsigned int phys_odd;
 };
 
+/* changes to LUT_r and LUT_w are tracked per 4KB of
+ * entries (1024 of them) for the delta snapshots */
+enum { TLB_LUT_DIRTY_PAGES_COUNT = 0x400 };
+
 struct tlb
 {
     struct tlb_entry entries[32];
     uint32_t LUT_r[0x100000];
     uint32_t LUT_w[0x100000];
+    unsigned char LUT_dirty[TLB_LUT_DIRTY_PAGES_COUNT];
 };
 
 void poweron_tlb(struct tlb* tlb);
@@ -114,6 +114,7 @@ static void dma_pi_write(struct pi_controller* pi)
     unsigned int cycles = handler->dma_write(opaque, dram, dram_addr, cart_addr, length);
 
     post_framebuffer_write(&pi->dp->fb, dram_addr, length);
+    rdram_mark_dirty(pi->ri->rdram, dram_addr, length);
 
     /* Mark DMA as busy */
     pi->regs[PI_STATUS_REG] |= PI_STATUS_DMA_BUSY;
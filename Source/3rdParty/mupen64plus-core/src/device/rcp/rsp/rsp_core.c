@@ -62,6 +62,7 @@ static void do_sp_dma(struct rsp_core* sp, const struct sp_dma* dma)
             }
             if (dramaddr <= 0x800000)
                 post_framebuffer_write(&sp->dp->fb, dramaddr - length, length);
+            rdram_mark_dirty(sp->ri->rdram, (dramaddr - length) & 0x7fffff, length);
             dramaddr+=skip;
         }
 
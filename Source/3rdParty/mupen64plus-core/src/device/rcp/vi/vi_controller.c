@@ -163,10 +163,15 @@ void write_vi_regs(void* opaque, uint32_t address, uint32_t value, uint32_t mask
 void vi_vertical_interrupt_event(void* opaque)
 {
     struct vi_controller* vi = (struct vi_controller*)opaque;
-    if (vi->dp->do_on_unfreeze & DELAY_DP_INT)
-        vi->dp->do_on_unfreeze |= DELAY_UPDATESCREEN;
-    else
-        gfx.updateScreen();
+    /* during fast-forward, the video plugin
+     * doesn't present skipped frames */
+    if (!main_skip_screen_update())
+    {
+        if (vi->dp->do_on_unfreeze & DELAY_DP_INT)
+            vi->dp->do_on_unfreeze |= DELAY_UPDATESCREEN;
+        else
+            gfx.updateScreen();
+    }
 
     /* allow main module to do things on VI event */
     new_vi();
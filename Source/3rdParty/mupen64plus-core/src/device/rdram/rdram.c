@@ -151,6 +151,7 @@ void poweron_rdram(struct rdram* rdram)
     size_t modules = get_modules_count(rdram);
     memset(rdram->regs, 0, RDRAM_MAX_MODULES_COUNT*RDRAM_REGS_COUNT*sizeof(uint32_t));
     memset(rdram->dram, 0, rdram->dram_size);
+    memset(rdram->dirty_page, 1, RDRAM_DIRTY_PAGES_COUNT*sizeof(rdram->dirty_page[0]));
 
     DebugMessage(M64MSG_INFO, "Initializing %u RDRAM modules for a total of %u MB",
         (uint32_t) modules, (uint32_t) rdram->dram_size / (1024*1024));
@@ -260,5 +261,6 @@ void write_rdram_dram(void* opaque, uint32_t address, uint32_t value, uint32_t m
     if (address < rdram->dram_size)
     {
         masked_write(&rdram->dram[addr], value, mask);
+        rdram->dirty_page[address >> 12] = 1;
     }
 }
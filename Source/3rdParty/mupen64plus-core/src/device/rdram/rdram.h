@@ -47,6 +47,9 @@ enum rdram_registers
 /* IPL3 rdram initialization accepts up to 8 RDRAM modules */
 enum { RDRAM_MAX_MODULES_COUNT = 8 };
 
+/* writes to RDRAM are tracked per 4KB page for the delta snapshots */
+enum { RDRAM_DIRTY_PAGES_COUNT = 0x800 };
+
 struct rdram
 {
     uint32_t regs[RDRAM_MAX_MODULES_COUNT][RDRAM_REGS_COUNT];
@@ -56,6 +59,8 @@ struct rdram
 
     uint8_t corrupted_handler;
 
+    unsigned char dirty_page[RDRAM_DIRTY_PAGES_COUNT];
+
     struct r4300_core* r4300;
 };
 
@@ -69,6 +74,22 @@ static osal_inline uint32_t rdram_dram_address(uint32_t address)
     return (address & 0xffffff) >> 2;
 }
 
+/* marks the pages of [address, address + length) as written,
+ * used by the DMAs which write to RDRAM without the write handler */
+static osal_inline void rdram_mark_dirty(struct rdram* rdram, uint32_t address, uint32_t length)
+{
+    uint32_t page;
+    uint32_t last;
+
+    if (length == 0)
+        return;
+
+    last = (address + length - 1) >> 12;
+    for (page = address >> 12; page <= last; ++page) {
+        rdram->dirty_page[page & (RDRAM_DIRTY_PAGES_COUNT - 1)] = 1;
+    }
+}
+
 void init_rdram(struct rdram* rdram,
                 uint32_t* dram,
                 size_t dram_size,
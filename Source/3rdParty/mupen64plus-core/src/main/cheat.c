@@ -66,6 +66,34 @@ typedef struct cheat {
     struct list_head list;
 } cheat_t;
 
+enum cheat_op_type
+{
+    CHEAT_OP_WRITE_8,
+    CHEAT_OP_WRITE_16,
+    CHEAT_OP_EQUAL_8,
+    CHEAT_OP_EQUAL_16,
+    CHEAT_OP_NOT_EQUAL_8,
+    CHEAT_OP_NOT_EQUAL_16
+};
+
+struct cheat_op
+{
+    uint8_t type;
+    /* only applied when the GS button is pressed */
+    uint8_t gameshark;
+    uint16_t value;
+    /* op to continue at when the condition fails */
+    uint32_t fail_index;
+    /* offset in RDRAM, without the byte swap */
+    uint32_t offset;
+    /* address passed to invalidate_r4300_cached_code() */
+    uint32_t address;
+    /* resolved RDRAM pointer, with the byte swap */
+    unsigned char* ptr;
+    /* where the memory before the first write is saved, can be NULL */
+    uint32_t* old_value;
+};
+
 /* private functions */
 static uint16_t read_address_16bit(struct r4300_core* r4300, uint32_t address)
 {
@@ -156,6 +184,276 @@ static int execute_cheat(struct r4300_core* r4300, uint32_t address, uint32_t va
     }
 }
 
+/* cheat ops, the codes of the enabled cheats decoded once so
+ * ENTRY_VI doesn't have to walk the lists and decode every code
+ */
+static struct cheat_op *append_cheat_op(struct cheat_ctx* ctx, struct r4300_core* r4300,
+                                        uint8_t type, uint8_t gameshark, uint32_t address, uint32_t value, uint32_t* old_value)
+{
+    struct cheat_op *op;
+    int is_16bit = (type == CHEAT_OP_WRITE_16 || type == CHEAT_OP_EQUAL_16 || type == CHEAT_OP_NOT_EQUAL_16);
+
+    if (ctx->op_count == ctx->op_capacity)
+    {
+        size_t capacity = (ctx->op_capacity == 0) ? 64 : ctx->op_capacity * 2;
+        struct cheat_op *ops = realloc(ctx->ops, capacity * sizeof(*ops));
+        if (ops == NULL)
+            return NULL;
+
+        ctx->ops = ops;
+        ctx->op_capacity = capacity;
+    }
+
+    op = &ctx->ops[ctx->op_count++];
+    op->type = type;
+    op->gameshark = gameshark;
+    op->value = is_16bit ? (uint16_t)value : (uint8_t)value;
+    op->fail_index = 0;
+    op->offset = address & 0xFFFFFF;
+    op->ptr = (unsigned char*)r4300->rdram->dram + (op->offset ^ (is_16bit ? S16 : S8));
+    /* mask out bit 24 which is used by GS codes to specify 8/16 bits */
+    op->address = is_16bit ? (address & 0xfeffffff) : address;
+    op->old_value = old_value;
+
+    if (gameshark)
+        ctx->ops_gameshark = 1;
+
+    return op;
+}
+
+/* appends the ops of a code, returns the amount of ops which
+ * have been appended or -1 when we've failed to allocate them
+ */
+static int append_cheat_code_ops(struct cheat_ctx* ctx, struct r4300_core* r4300, cheat_code_t* code)
+{
+    uint32_t address = code->address;
+    uint32_t value = code->value;
+    uint8_t type;
+    uint8_t gameshark = 0;
+    uint32_t* old_value = NULL;
+
+    switch (address & 0xFF000000)
+    {
+    case 0xD8000000:
+        gameshark = 1;
+        /* fallthrough */
+    case 0xD0000000:
+        type = CHEAT_OP_EQUAL_8;
+        break;
+    case 0xD9000000:
+        gameshark = 1;
+        /* fallthrough */
+    case 0xD1000000:
+        type = CHEAT_OP_EQUAL_16;
+        break;
+    case 0xDB000000:
+        gameshark = 1;
+        /* fallthrough */
+    case 0xD2000000:
+        type = CHEAT_OP_NOT_EQUAL_8;
+        break;
+    case 0xDA000000:
+        gameshark = 1;
+        /* fallthrough */
+    case 0xD3000000:
+        type = CHEAT_OP_NOT_EQUAL_16;
+        break;
+    case 0x88000000:
+    case 0xA8000000:
+        gameshark = 1;
+        type = CHEAT_OP_WRITE_8;
+        break;
+    case 0x89000000:
+    case 0xA9000000:
+        gameshark = 1;
+        type = CHEAT_OP_WRITE_16;
+        break;
+    case 0x80000000:
+    case 0xA0000000:
+        type = CHEAT_OP_WRITE_8;
+        old_value = &code->old_value;
+        break;
+    case 0x81000000:
+    case 0xA1000000:
+        type = CHEAT_OP_WRITE_16;
+        old_value = &code->old_value;
+        break;
+    case 0xEE000000:
+        /* most likely, this doesnt do anything. */
+        if (append_cheat_op(ctx, r4300, CHEAT_OP_WRITE_16, 0, 0xF1000318, 0x0040, NULL) == NULL ||
+            append_cheat_op(ctx, r4300, CHEAT_OP_WRITE_16, 0, 0xF100031A, 0x0000, NULL) == NULL)
+            return -1;
+        return 2;
+    default:
+        /* boot-time codes, unknown codes and conditions which
+         * are always true don't do anything on ENTRY_VI */
+        return 0;
+    }
+
+    if (append_cheat_op(ctx, r4300, type, gameshark, address, value, old_value) == NULL)
+        return -1;
+
+    return 1;
+}
+
+/* appends the ops of an enabled cheat, consecutive conditions
+ * and the code following them become a chain, when any condition
+ * of a chain fails, the rest of the chain is skipped
+ */
+static int append_cheat_ops(struct cheat_ctx* ctx, struct r4300_core* r4300, cheat_t* cheat)
+{
+    cheat_code_t *code;
+    size_t chain_start = ctx->op_count;
+    size_t chain_code;
+    size_t i;
+    int count;
+
+    list_for_each_entry_t(code, &cheat->cheat_codes, cheat_code_t, list) {
+        chain_code = ctx->op_count;
+
+        count = append_cheat_code_ops(ctx, r4300, code);
+        if (count < 0)
+            return 0;
+
+        /* conditions are added to the chain */
+        if ((code->address & 0xF0000000) == 0xD0000000)
+            continue;
+
+        if (count == 0)
+        {
+            /* the conditions don't guard anything */
+            ctx->op_count = chain_start;
+        }
+        else
+        {
+            for (i = chain_start; i < chain_code; ++i) {
+                ctx->ops[i].fail_index = (uint32_t)ctx->op_count;
+            }
+        }
+
+        chain_start = ctx->op_count;
+    }
+
+    /* trailing conditions don't guard anything either */
+    ctx->op_count = chain_start;
+    return 1;
+}
+
+/* decodes the enabled cheats and restores the memory
+ * of the cheats which have been disabled
+ */
+static void compile_cheats(struct cheat_ctx* ctx, struct r4300_core* r4300)
+{
+    cheat_t *cheat;
+    cheat_code_t *code;
+
+    ctx->op_count = 0;
+    ctx->ops_gameshark = 0;
+
+    list_for_each_entry_t(cheat, &ctx->active_cheats, cheat_t, list) {
+        if (cheat->enabled)
+        {
+            cheat->was_enabled = 1;
+            if (!append_cheat_ops(ctx, r4300, cheat))
+            {
+                DebugMessage(M64MSG_ERROR, "Failed to allocate memory for cheat '%s'", cheat->name);
+                ctx->op_count = 0;
+                break;
+            }
+        }
+        /* if cheat was enabled, but is now disabled, restore old memory values */
+        else if (cheat->was_enabled)
+        {
+            cheat->was_enabled = 0;
+            list_for_each_entry_t(code, &cheat->cheat_codes, cheat_code_t, list) {
+                /* set memory back to old value and clear saved copy of old value */
+                if(code->old_value != CHEAT_CODE_MAGIC_VALUE)
+                {
+                    execute_cheat(r4300, code->address, code->old_value, NULL);
+                    code->old_value = CHEAT_CODE_MAGIC_VALUE;
+                }
+            }
+        }
+    }
+
+    ctx->ops_dram = r4300->rdram->dram;
+    ctx->ops_dirty = 0;
+}
+
+static void run_cheat_ops(struct cheat_ctx* ctx, struct r4300_core* r4300)
+{
+    const struct cheat_op *op;
+    int gameshark_active = ctx->ops_gameshark ? event_gameshark_active() : 0;
+    size_t i = 0;
+
+    while (i < ctx->op_count)
+    {
+        op = &ctx->ops[i];
+
+        /* GS button codes are skipped when it isn't pressed,
+         * for conditions that means the condition fails */
+        if (op->gameshark && !gameshark_active)
+        {
+            i = (op->type == CHEAT_OP_WRITE_8 || op->type == CHEAT_OP_WRITE_16) ? i + 1 : op->fail_index;
+            continue;
+        }
+
+        switch (op->type)
+        {
+        case CHEAT_OP_WRITE_8:
+            /* if pointer to old value is valid and uninitialized, write current value to it */
+            if (op->old_value && (*op->old_value == CHEAT_CODE_MAGIC_VALUE)) {
+                *op->old_value = *op->ptr;
+            }
+            /* unchanged memory doesn't have to be written or invalidated */
+            if (*op->ptr != (uint8_t)op->value) {
+                *op->ptr = (uint8_t)op->value;
+                rdram_mark_dirty(r4300->rdram, op->offset, 1);
+                invalidate_r4300_cached_code(r4300, op->address, 1);
+            }
+            break;
+        case CHEAT_OP_WRITE_16:
+            if (op->old_value && (*op->old_value == CHEAT_CODE_MAGIC_VALUE)) {
+                *op->old_value = *(uint16_t*)op->ptr;
+            }
+            if (*(uint16_t*)op->ptr != op->value) {
+                *(uint16_t*)op->ptr = op->value;
+                rdram_mark_dirty(r4300->rdram, op->offset, 2);
+                invalidate_r4300_cached_code(r4300, op->address, 2);
+            }
+            break;
+        case CHEAT_OP_EQUAL_8:
+            if (*op->ptr != (uint8_t)op->value) {
+                i = op->fail_index;
+                continue;
+            }
+            break;
+        case CHEAT_OP_EQUAL_16:
+            if (*(uint16_t*)op->ptr != op->value) {
+                i = op->fail_index;
+                continue;
+            }
+            break;
+        case CHEAT_OP_NOT_EQUAL_8:
+            if (*op->ptr == (uint8_t)op->value) {
+                i = op->fail_index;
+                continue;
+            }
+            break;
+        case CHEAT_OP_NOT_EQUAL_16:
+            if (*(uint16_t*)op->ptr == op->value) {
+                i = op->fail_index;
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        ++i;
+    }
+}
+
 static cheat_t *find_or_create_cheat(struct cheat_ctx* ctx, const char *name)
 {
     cheat_t *cheat;
@@ -200,6 +498,12 @@ void cheat_init(struct cheat_ctx* ctx)
 {
     ctx->mutex = SDL_CreateMutex();
     INIT_LIST_HEAD(&ctx->active_cheats);
+    ctx->ops = NULL;
+    ctx->op_count = 0;
+    ctx->op_capacity = 0;
+    ctx->ops_dram = NULL;
+    ctx->ops_gameshark = 0;
+    ctx->ops_dirty = 1;
 }
 
 void cheat_uninit(struct cheat_ctx* ctx)
@@ -208,13 +512,17 @@ void cheat_uninit(struct cheat_ctx* ctx)
         SDL_DestroyMutex(ctx->mutex);
     }
     ctx->mutex = NULL;
+
+    free(ctx->ops);
+    ctx->ops = NULL;
+    ctx->op_count = 0;
+    ctx->op_capacity = 0;
 }
 
 void cheat_apply_cheats(struct cheat_ctx* ctx, struct r4300_core* r4300, int entry)
 {
     cheat_t *cheat;
     cheat_code_t *code;
-    int cond_failed;
 
     if (list_empty(&ctx->active_cheats))
         return;
@@ -227,97 +535,32 @@ void cheat_apply_cheats(struct cheat_ctx* ctx, struct r4300_core* r4300, int ent
 
     SDL_LockMutex(ctx->mutex);
 
-    list_for_each_entry_t(cheat, &ctx->active_cheats, cheat_t, list) {
-        if (cheat->enabled)
-        {
-            cheat->was_enabled = 1;
-            switch(entry)
+    switch(entry)
+    {
+    case ENTRY_BOOT:
+        list_for_each_entry_t(cheat, &ctx->active_cheats, cheat_t, list) {
+            if (cheat->enabled)
             {
-            case ENTRY_BOOT:
+                cheat->was_enabled = 1;
                 list_for_each_entry_t(code, &cheat->cheat_codes, cheat_code_t, list) {
                     /* code should only be written once at boot time */
                     if ((code->address & 0xF0000000) == 0xF0000000) {
                         execute_cheat(r4300, code->address, code->value, &code->old_value);
                     }
                 }
-                break;
-            case ENTRY_VI:
-                /* a cheat starts without failed preconditions */
-                cond_failed = 0;
-
-                list_for_each_entry_t(code, &cheat->cheat_codes, cheat_code_t, list) {
-                    /* conditional cheat codes */
-                    if ((code->address & 0xF0000000) == 0xD0000000)
-                    {
-                        /* if code needs GS button pressed and it's not, skip it */
-                        if (((code->address & 0xFF000000) == 0xD8000000 ||
-                                    (code->address & 0xFF000000) == 0xD9000000 ||
-                                    (code->address & 0xFF000000) == 0xDA000000 ||
-                                    (code->address & 0xFF000000) == 0xDB000000) &&
-                                !event_gameshark_active()) {
-                            /* if condition false, skip next code non-test code */
-                            cond_failed = 1;
-                        }
-
-                        /* if condition false, skip next code non-test code */
-                        if (!execute_cheat(r4300, code->address, code->value, NULL)) {
-                            cond_failed = 1;
-                        }
-                    }
-                    else {
-                        /* preconditions were false for this non-test code
-                         * reset the condition state and skip the cheat
-                         */
-                        if (cond_failed) {
-                            cond_failed = 0;
-                            continue;
-                        }
-
-                        switch (code->address & 0xFF000000) {
-                        /* GS button triggers cheat code */
-                        case 0x88000000:
-                        case 0x89000000:
-                        case 0xA8000000:
-                        case 0xA9000000:
-                            if (event_gameshark_active()) {
-                                execute_cheat(r4300, code->address, code->value, NULL);
-                            }
-                            break;
-                            /* normal cheat code */
-                        default:
-                            /* exclude boot-time cheat codes */
-                            if ((code->address & 0xF0000000) != 0xF0000000) {
-                                execute_cheat(r4300, code->address, code->value, &code->old_value);
-                            }
-                            break;
-                        }
-                    }
-                }
-                break;
-            default:
-                break;
             }
         }
-        /* if cheat was enabled, but is now disabled, restore old memory values */
-        else if (cheat->was_enabled)
-        {
-            cheat->was_enabled = 0;
-            switch(entry)
-            {
-            case ENTRY_VI:
-                list_for_each_entry_t(code, &cheat->cheat_codes, cheat_code_t, list) {
-                    /* set memory back to old value and clear saved copy of old value */
-                    if(code->old_value != CHEAT_CODE_MAGIC_VALUE)
-                    {
-                        execute_cheat(r4300, code->address, code->old_value, NULL);
-                        code->old_value = CHEAT_CODE_MAGIC_VALUE;
-                    }
-                }
-                break;
-            default:
-                break;
-            }
+        break;
+    case ENTRY_VI:
+        /* only decode the cheats again when they've changed */
+        if (ctx->ops_dirty || ctx->ops_dram != r4300->rdram->dram) {
+            compile_cheats(ctx, r4300);
         }
+
+        run_cheat_ops(ctx, r4300);
+        break;
+    default:
+        break;
     }
 
     SDL_UnlockMutex(ctx->mutex);
@@ -351,6 +594,10 @@ void cheat_delete_all(struct cheat_ctx* ctx)
         free(cheat);
     }
 
+    /* the ops point to the codes which have been freed */
+    ctx->op_count = 0;
+    ctx->ops_dirty = 1;
+
     SDL_UnlockMutex(ctx->mutex);
 }
 
@@ -373,6 +620,7 @@ int cheat_set_enabled(struct cheat_ctx* ctx, const char* name, int enabled)
         if (strcmp(name, cheat->name) == 0)
         {
             cheat->enabled = enabled;
+            ctx->ops_dirty = 1;
             SDL_UnlockMutex(ctx->mutex);
             return 1;
         }
@@ -405,6 +653,7 @@ int cheat_add_new(struct cheat_ctx* ctx, const char* name, m64p_cheat_code* code
 
     /* default for new cheats is enabled */
     cheat->enabled = 1;
+    ctx->ops_dirty = 1;
 
     for (i = 0; i < num_codes; i++)
     {
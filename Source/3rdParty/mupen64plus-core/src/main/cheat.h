@@ -26,6 +26,7 @@
 
 #include "list.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define ENTRY_BOOT 0
@@ -33,6 +34,7 @@
 
 struct SDL_mutex;
 struct r4300_core;
+struct cheat_op;
 
 struct cheat_ctx
 {
@@ -42,6 +44,15 @@ struct cheat_ctx
     struct SDL_mutex* mutex;
 #endif
     struct list_head active_cheats;
+
+    /* codes of the enabled cheats, decoded for ENTRY_VI,
+     * rebuilt on the next VI when the cheats have changed */
+    struct cheat_op* ops;
+    size_t op_count;
+    size_t op_capacity;
+    const uint32_t* ops_dram;
+    int ops_gameshark;
+    int ops_dirty;
 };
 
 void cheat_apply_cheats(struct cheat_ctx* ctx, struct r4300_core* r4300, int entry);
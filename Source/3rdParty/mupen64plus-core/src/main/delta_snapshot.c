@@ -0,0 +1,403 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - delta_snapshot.c                                        *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+
+#include "delta_snapshot.h"
+#include "savestates.h"
+#include "main.h"
+#include "util.h"
+
+#include "api/callbacks.h"
+#include "device/device.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+/* parts of the savestate which aren't paged, they're small enough
+ * to be copied into every delta */
+static const struct
+{
+    size_t offset;
+    size_t size;
+} misc_ranges[] =
+{
+    { 0, SAVESTATE_M64P_RDRAM_OFFSET },
+    { SAVESTATE_M64P_RDRAM_OFFSET + RDRAM_MAX_SIZE,
+      SAVESTATE_M64P_LUT_OFFSET - (SAVESTATE_M64P_RDRAM_OFFSET + RDRAM_MAX_SIZE) },
+    { SAVESTATE_M64P_LUT_OFFSET + SAVESTATE_M64P_LUT_SIZE,
+      SAVESTATE_M64P_SIZE - (SAVESTATE_M64P_LUT_OFFSET + SAVESTATE_M64P_LUT_SIZE) },
+};
+
+enum { MISC_SIZE = SAVESTATE_M64P_RDRAM_OFFSET +
+                   SAVESTATE_M64P_LUT_OFFSET - (SAVESTATE_M64P_RDRAM_OFFSET + RDRAM_MAX_SIZE) +
+                   SAVESTATE_M64P_SIZE - (SAVESTATE_M64P_LUT_OFFSET + SAVESTATE_M64P_LUT_SIZE) };
+
+enum { INITIAL_PAGE_CAPACITY = 64 };
+
+static size_t unit_offset(unsigned int unit)
+{
+    if (unit < RDRAM_DIRTY_PAGES_COUNT)
+        return SAVESTATE_M64P_RDRAM_OFFSET + (size_t)unit * DELTA_SNAPSHOT_PAGE_SIZE;
+
+    /* LUT_w directly follows LUT_r */
+    return SAVESTATE_M64P_LUT_OFFSET + (size_t)(unit - RDRAM_DIRTY_PAGES_COUNT) * DELTA_SNAPSHOT_PAGE_SIZE;
+}
+
+static const void* unit_source(unsigned int unit)
+{
+    if (unit < RDRAM_DIRTY_PAGES_COUNT)
+        return (const unsigned char*)g_dev.rdram.dram + (size_t)unit * DELTA_SNAPSHOT_PAGE_SIZE;
+
+    unit -= RDRAM_DIRTY_PAGES_COUNT;
+    if (unit < TLB_LUT_DIRTY_PAGES_COUNT)
+        return (const unsigned char*)g_dev.r4300.cp0.tlb.LUT_r + (size_t)unit * DELTA_SNAPSHOT_PAGE_SIZE;
+
+    unit -= TLB_LUT_DIRTY_PAGES_COUNT;
+    return (const unsigned char*)g_dev.r4300.cp0.tlb.LUT_w + (size_t)unit * DELTA_SNAPSHOT_PAGE_SIZE;
+}
+
+static uint64_t rdram_page_hash(unsigned int page)
+{
+    return XXH3_64bits(unit_source(page), DELTA_SNAPSHOT_PAGE_SIZE);
+}
+
+static void save_misc(unsigned char* misc, const unsigned char* state)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(misc_ranges) / sizeof(misc_ranges[0]); ++i)
+    {
+        memcpy(misc, state + misc_ranges[i].offset, misc_ranges[i].size);
+        misc += misc_ranges[i].size;
+    }
+}
+
+static void restore_misc(unsigned char* state, const unsigned char* misc)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(misc_ranges) / sizeof(misc_ranges[0]); ++i)
+    {
+        memcpy(state + misc_ranges[i].offset, misc, misc_ranges[i].size);
+        misc += misc_ranges[i].size;
+    }
+}
+
+static void clear_dirty_pages(void)
+{
+    memset(g_dev.rdram.dirty_page, 0, sizeof(g_dev.rdram.dirty_page));
+    memset(g_dev.r4300.cp0.tlb.LUT_dirty, 0, sizeof(g_dev.r4300.cp0.tlb.LUT_dirty));
+}
+
+static void drop_snapshots(struct delta_snapshot_ring* ring)
+{
+    unsigned int i;
+
+    for (i = 0; i < ring->count; ++i)
+        ring->deltas[i].valid = 0;
+
+    ring->has_reference = 0;
+}
+
+static int grow_delta(struct delta_snapshot* delta)
+{
+    size_t capacity = delta->page_capacity * 2;
+    uint16_t* units;
+    unsigned char* pages;
+
+    units = realloc(delta->units, capacity * sizeof(delta->units[0]));
+    if (units == NULL)
+        return 0;
+    delta->units = units;
+
+    pages = realloc(delta->pages, capacity * DELTA_SNAPSHOT_PAGE_SIZE);
+    if (pages == NULL)
+        return 0;
+    delta->pages = pages;
+
+    delta->page_capacity = capacity;
+    return 1;
+}
+
+/* moves the reference contents of unit into delta (unless
+ * an older copy is already there) and updates the reference */
+static int store_unit(struct delta_snapshot_ring* ring, struct delta_snapshot* delta, unsigned int unit)
+{
+    unsigned char* data = ring->reference + unit_offset(unit);
+
+    if (!ring->in_delta[unit])
+    {
+        if (delta->page_count == delta->page_capacity && !grow_delta(delta))
+            return 0;
+
+        delta->units[delta->page_count] = (uint16_t)unit;
+        memcpy(delta->pages + delta->page_count * DELTA_SNAPSHOT_PAGE_SIZE, data, DELTA_SNAPSHOT_PAGE_SIZE);
+        delta->page_count++;
+        ring->in_delta[unit] = 1;
+    }
+
+    memcpy(data, unit_source(unit), DELTA_SNAPSHOT_PAGE_SIZE);
+    to_little_endian_buffer(data, 4, DELTA_SNAPSHOT_PAGE_SIZE / 4);
+    return 1;
+}
+
+static int save_keyframe(struct delta_snapshot_ring* ring, unsigned int frame)
+{
+    struct delta_snapshot* delta = &ring->deltas[frame % ring->count];
+    unsigned int i;
+
+    drop_snapshots(ring);
+
+    if (!savestates_save_m64p_memory(ring->reference, SAVESTATE_M64P_SIZE, 0))
+        return 0;
+
+    for (i = 0; i < RDRAM_DIRTY_PAGES_COUNT; ++i)
+        ring->page_hash[i] = rdram_page_hash(i);
+
+    clear_dirty_pages();
+    memset(ring->in_delta, 0, sizeof(ring->in_delta));
+
+    delta->frame = frame;
+    delta->has_prev = 0;
+    delta->page_count = 0;
+    delta->valid = 1;
+
+    ring->newest_frame = frame;
+    ring->has_reference = 1;
+    return 1;
+}
+
+int delta_snapshot_ring_init(struct delta_snapshot_ring* ring, unsigned int count)
+{
+    unsigned int i;
+
+    memset(ring, 0, sizeof(*ring));
+
+    if (count == 0)
+        return 0;
+
+    /* zero the reference once so it has the same padding as a full savestate */
+    ring->reference = calloc(1, SAVESTATE_M64P_SIZE);
+    ring->deltas = calloc(count, sizeof(ring->deltas[0]));
+    ring->count = count;
+    if (ring->reference == NULL || ring->deltas == NULL)
+    {
+        delta_snapshot_ring_deinit(ring);
+        return 0;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        struct delta_snapshot* delta = &ring->deltas[i];
+
+        delta->page_capacity = INITIAL_PAGE_CAPACITY;
+        delta->units = malloc(delta->page_capacity * sizeof(delta->units[0]));
+        delta->pages = malloc(delta->page_capacity * DELTA_SNAPSHOT_PAGE_SIZE);
+        delta->misc = malloc(MISC_SIZE);
+        if (delta->units == NULL || delta->pages == NULL || delta->misc == NULL)
+        {
+            delta_snapshot_ring_deinit(ring);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void delta_snapshot_ring_deinit(struct delta_snapshot_ring* ring)
+{
+    unsigned int i;
+
+    if (ring->deltas != NULL)
+    {
+        for (i = 0; i < ring->count; ++i)
+        {
+            free(ring->deltas[i].units);
+            free(ring->deltas[i].pages);
+            free(ring->deltas[i].misc);
+        }
+        free(ring->deltas);
+    }
+
+    free(ring->reference);
+    memset(ring, 0, sizeof(*ring));
+}
+
+int delta_snapshot_ring_save(struct delta_snapshot_ring* ring, unsigned int frame)
+{
+    struct delta_snapshot* delta;
+    unsigned int i;
+    uint64_t hash;
+
+    if (ring->deltas == NULL)
+        return 0;
+
+    if (!ring->has_reference || frame < ring->newest_frame)
+        return save_keyframe(ring, frame);
+
+    delta = &ring->deltas[frame % ring->count];
+
+    if (frame == ring->newest_frame)
+    {
+        /* the delta of the newest frame already holds the
+         * oldest contents, the keyframe has no delta at all */
+        if (!delta->valid || delta->frame != frame || !delta->has_prev)
+            return save_keyframe(ring, frame);
+    }
+    else
+    {
+        delta->frame = frame;
+        delta->prev_frame = ring->newest_frame;
+        delta->has_prev = 1;
+        delta->page_count = 0;
+        save_misc(delta->misc, ring->reference);
+        memset(ring->in_delta, 0, sizeof(ring->in_delta));
+    }
+
+    delta->valid = 0;
+
+    /* pages past the installed RDRAM never change */
+    for (i = 0; i < RDRAM_DIRTY_PAGES_COUNT && i < (g_dev.rdram.dram_size / DELTA_SNAPSHOT_PAGE_SIZE); ++i)
+    {
+        hash = rdram_page_hash(i);
+        if (!g_dev.rdram.dirty_page[i] && hash == ring->page_hash[i])
+            continue;
+
+        ring->page_hash[i] = hash;
+        if (!store_unit(ring, delta, i))
+            goto error;
+    }
+
+    for (i = 0; i < TLB_LUT_DIRTY_PAGES_COUNT; ++i)
+    {
+        if (!g_dev.r4300.cp0.tlb.LUT_dirty[i])
+            continue;
+
+        if (!store_unit(ring, delta, RDRAM_DIRTY_PAGES_COUNT + i) ||
+            !store_unit(ring, delta, RDRAM_DIRTY_PAGES_COUNT + TLB_LUT_DIRTY_PAGES_COUNT + i))
+            goto error;
+    }
+
+    if (!savestates_save_m64p_memory(ring->reference, SAVESTATE_M64P_SIZE, 1))
+        goto error;
+
+    clear_dirty_pages();
+    delta->valid = 1;
+    ring->newest_frame = frame;
+    return 1;
+
+error:
+    DebugMessage(M64MSG_ERROR, "Could not allocate delta snapshot of frame %u", frame);
+    drop_snapshots(ring);
+    return 0;
+}
+
+int delta_snapshot_ring_contains(const struct delta_snapshot_ring* ring, unsigned int frame)
+{
+    const struct delta_snapshot* delta;
+    unsigned int current;
+    unsigned int i;
+
+    if (ring->deltas == NULL || !ring->has_reference || frame > ring->newest_frame)
+        return 0;
+
+    /* walk back from the newest snapshot, a delta which has
+     * been overwritten by a newer frame ends the chain */
+    current = ring->newest_frame;
+    for (i = 0; i < ring->count; ++i)
+    {
+        if (current == frame)
+            return 1;
+
+        delta = &ring->deltas[current % ring->count];
+        if (!delta->valid || delta->frame != current ||
+            !delta->has_prev || delta->prev_frame < frame)
+            return 0;
+
+        current = delta->prev_frame;
+    }
+
+    return 0;
+}
+
+int delta_snapshot_ring_load(struct delta_snapshot_ring* ring, unsigned int frame)
+{
+    struct delta_snapshot* delta;
+    unsigned int current;
+    unsigned int unit;
+    size_t i;
+
+    if (!delta_snapshot_ring_contains(ring, frame))
+        return 0;
+
+    /* in_delta is reused to remember which pages changed */
+    memset(ring->in_delta, 0, sizeof(ring->in_delta));
+
+    current = ring->newest_frame;
+    while (current != frame)
+    {
+        delta = &ring->deltas[current % ring->count];
+
+        for (i = 0; i < delta->page_count; ++i)
+        {
+            unit = delta->units[i];
+            memcpy(ring->reference + unit_offset(unit),
+                   delta->pages + i * DELTA_SNAPSHOT_PAGE_SIZE,
+                   DELTA_SNAPSHOT_PAGE_SIZE);
+            ring->in_delta[unit] = 1;
+        }
+        restore_misc(ring->reference, delta->misc);
+
+        delta->valid = 0;
+        current = delta->prev_frame;
+    }
+
+    if (!savestates_load_m64p_memory(ring->reference, SAVESTATE_M64P_SIZE))
+    {
+        drop_snapshots(ring);
+        return 0;
+    }
+
+    /* the hashes of pages which didn't change are still valid */
+    for (unit = 0; unit < RDRAM_DIRTY_PAGES_COUNT; ++unit)
+    {
+        if (ring->in_delta[unit])
+            ring->page_hash[unit] = rdram_page_hash(unit);
+    }
+
+    clear_dirty_pages();
+    ring->newest_frame = frame;
+
+    /* the delta of frame can be extended by another snapshot of it */
+    memset(ring->in_delta, 0, sizeof(ring->in_delta));
+    delta = &ring->deltas[frame % ring->count];
+    if (delta->valid && delta->frame == frame && delta->has_prev)
+    {
+        for (i = 0; i < delta->page_count; ++i)
+            ring->in_delta[delta->units[i]] = 1;
+    }
+
+    return 1;
+}
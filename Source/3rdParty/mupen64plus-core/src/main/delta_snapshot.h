@@ -0,0 +1,96 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - delta_snapshot.h                                        *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef M64P_MAIN_DELTA_SNAPSHOT_H
+#define M64P_MAIN_DELTA_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "device/r4300/tlb.h"
+#include "device/rdram/rdram.h"
+
+/* A ring of in-memory snapshots where only the newest snapshot is kept as
+ * a full m64p savestate (the reference), every older snapshot is a delta
+ * which holds the old contents of the 4KB pages which changed between it
+ * and the snapshot after it, plus the small part of the savestate which
+ * isn't paged (registers, SP memory, PIF RAM, the event queue, ...).
+ *
+ * Changed RDRAM pages are found through the dirty pages of struct rdram,
+ * writes which bypass the write handler and the DMAs (the new dynarec
+ * stores to RDRAM inline and the RSP and video plugins write through the
+ * RDRAM pointer) are caught by comparing the XXH3 hash of every clean page
+ * with its hash at the previous snapshot. The TLB lookup tables only
+ * change in tlb.c and are tracked exactly.
+ */
+
+enum { DELTA_SNAPSHOT_PAGE_SIZE = 0x1000 };
+
+/* RDRAM pages followed by the pages of LUT_r and LUT_w */
+enum { DELTA_SNAPSHOT_UNITS_COUNT = RDRAM_DIRTY_PAGES_COUNT + 2 * TLB_LUT_DIRTY_PAGES_COUNT };
+
+struct delta_snapshot
+{
+    unsigned int frame;
+    unsigned int prev_frame;
+    int valid;
+    int has_prev;
+
+    /* contents of the snapshot of prev_frame which differ */
+    size_t page_count;
+    size_t page_capacity;
+    uint16_t* units;
+    unsigned char* pages;
+    unsigned char* misc;
+};
+
+struct delta_snapshot_ring
+{
+    struct delta_snapshot* deltas;
+    unsigned int count;
+
+    unsigned char* reference;
+    int has_reference;
+    unsigned int newest_frame;
+
+    uint64_t page_hash[RDRAM_DIRTY_PAGES_COUNT];
+    unsigned char in_delta[DELTA_SNAPSHOT_UNITS_COUNT];
+};
+
+/* Allocates a ring of count snapshots indexed by frame modulo count,
+ * returns 0 when the allocation failed */
+int delta_snapshot_ring_init(struct delta_snapshot_ring* ring, unsigned int count);
+void delta_snapshot_ring_deinit(struct delta_snapshot_ring* ring);
+
+/* Takes a snapshot of the current state for frame, frame has to be at least
+ * the frame of the newest snapshot, a snapshot of the same frame replaces it.
+ * Only safe to call from the emulation thread when not in an unsafe state */
+int delta_snapshot_ring_save(struct delta_snapshot_ring* ring, unsigned int frame);
+
+/* Returns whether the snapshot of frame can be restored */
+int delta_snapshot_ring_contains(const struct delta_snapshot_ring* ring, unsigned int frame);
+
+/* Restores the snapshot of frame, which becomes the newest snapshot,
+ * every snapshot after it is dropped */
+int delta_snapshot_ring_load(struct delta_snapshot_ring* ring, unsigned int frame);
+
+#endif
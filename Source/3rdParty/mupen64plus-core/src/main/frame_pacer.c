@@ -0,0 +1,293 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - frame_pacer.c                                           *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifdef USE_SDL3
+#include <SDL3/SDL.h>
+#else
+#include <SDL.h>
+#endif
+
+#include "frame_pacer.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* amount of frames of which the pacing error is kept, has to be a power of 2 */
+#define FRAME_PACER_ERRORS_SIZE 1024
+
+/* when a frame is later than this many frames, the pacer
+ * starts over instead of trying to catch up, i.e after
+ * pausing or when the game runs slower than full speed */
+#define FRAME_PACER_MAX_LAG_FRAMES 2
+
+/* the display clock is only followed when its
+ * refresh rate is within this fraction of the game */
+#define FRAME_PACER_DISPLAY_TOLERANCE 0.02
+
+/* maximum fraction by which the audio clock adjusts the rate */
+#define FRAME_PACER_AUDIO_MAX_ADJUST 0.005
+
+/* bounds of the time spent spinning instead of
+ * sleeping, to make up for the sleep overshooting */
+#define FRAME_PACER_MIN_SPIN_NS  200000
+#define FRAME_PACER_MAX_SPIN_NS 4000000
+
+#ifdef USE_SDL3
+#define frame_pacer_lock(lock)   SDL_LockSpinlock(lock)
+#define frame_pacer_unlock(lock) SDL_UnlockSpinlock(lock)
+#else
+#define frame_pacer_lock(lock)   SDL_AtomicLock(lock)
+#define frame_pacer_unlock(lock) SDL_AtomicUnlock(lock)
+#endif
+
+/* shared state, protected by l_lock */
+static SDL_SpinLock l_lock = 0;
+static int l_clock = FRAME_PACER_CLOCK_SYSTEM;
+static double l_display_rate = 0.0;
+static double l_audio_queued = 0.0;
+static double l_audio_target = 0.0;
+static int64_t l_errors[FRAME_PACER_ERRORS_SIZE];
+static uint64_t l_error_count = 0;
+
+/* state of the emulation thread */
+static int l_reset = 1;
+static uint64_t l_base_ns = 0;
+static double l_deadline_ns = 0.0;
+static int64_t l_spin_ns = FRAME_PACER_MAX_SPIN_NS / 2;
+
+static uint64_t get_time_ns(void)
+{
+    static uint64_t frequency = 0;
+    uint64_t counter = SDL_GetPerformanceCounter();
+
+    if (frequency == 0)
+        frequency = SDL_GetPerformanceFrequency();
+
+    /* split the conversion so it doesn't overflow */
+    return (counter / frequency) * UINT64_C(1000000000) +
+           (counter % frequency) * UINT64_C(1000000000) / frequency;
+}
+
+static void sleep_ns(int64_t ns)
+{
+#ifdef USE_SDL3
+    SDL_DelayNS((Uint64)ns);
+#else
+    SDL_Delay((Uint32)(ns / 1000000));
+#endif
+}
+
+static void add_error(int64_t error_ns)
+{
+    frame_pacer_lock(&l_lock);
+    l_errors[l_error_count & (FRAME_PACER_ERRORS_SIZE - 1)] = error_ns;
+    l_error_count++;
+    frame_pacer_unlock(&l_lock);
+}
+
+/* returns the rate at which frames should be delivered,
+ * adjusted to the clock which the pacer follows */
+static double get_clock_rate(double rate)
+{
+    double display_rate;
+    double audio_queued;
+    double audio_target;
+    double adjust;
+    int clock;
+
+    frame_pacer_lock(&l_lock);
+    clock = l_clock;
+    display_rate = l_display_rate;
+    audio_queued = l_audio_queued;
+    audio_target = l_audio_target;
+    frame_pacer_unlock(&l_lock);
+
+    switch (clock)
+    {
+    case FRAME_PACER_CLOCK_DISPLAY:
+        /* i.e a 59.94 Hz display for a 60 Hz game, the game
+         * runs slightly slower but every frame is shown for
+         * exactly one refresh, instead of one being repeated */
+        if (display_rate > 0.0 && fabs(display_rate - rate) <= (rate * FRAME_PACER_DISPLAY_TOLERANCE))
+            return display_rate;
+        break;
+    case FRAME_PACER_CLOCK_AUDIO:
+        /* when the audio device consumes samples slower than
+         * the system clock, the queue grows, so slow down */
+        if (audio_target > 0.0)
+        {
+            adjust = (audio_target - audio_queued) / audio_target * FRAME_PACER_AUDIO_MAX_ADJUST;
+            if (adjust > FRAME_PACER_AUDIO_MAX_ADJUST)
+                adjust = FRAME_PACER_AUDIO_MAX_ADJUST;
+            else if (adjust < -FRAME_PACER_AUDIO_MAX_ADJUST)
+                adjust = -FRAME_PACER_AUDIO_MAX_ADJUST;
+            return rate * (1.0 + adjust);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return rate;
+}
+
+/* sleeps until the spin margin before the deadline and spins
+ * for the rest, the margin follows how much the sleeps overshoot */
+static uint64_t wait_until(uint64_t deadline_ns)
+{
+    uint64_t now = get_time_ns();
+    int64_t remaining = (int64_t)(deadline_ns - now);
+    int64_t requested;
+    int64_t overshoot;
+    uint64_t start;
+
+    while (remaining > l_spin_ns)
+    {
+        requested = remaining - l_spin_ns;
+        start = now;
+        sleep_ns(requested);
+
+        now = get_time_ns();
+        overshoot = (int64_t)(now - start) - requested;
+        remaining = (int64_t)(deadline_ns - now);
+
+        /* grow the margin right away when a sleep
+         * overshoots, shrink it slowly otherwise */
+        if (overshoot + FRAME_PACER_MIN_SPIN_NS > l_spin_ns)
+            l_spin_ns = overshoot + FRAME_PACER_MIN_SPIN_NS;
+        else
+            l_spin_ns -= l_spin_ns / 64;
+
+        if (l_spin_ns < FRAME_PACER_MIN_SPIN_NS)
+            l_spin_ns = FRAME_PACER_MIN_SPIN_NS;
+        else if (l_spin_ns > FRAME_PACER_MAX_SPIN_NS)
+            l_spin_ns = FRAME_PACER_MAX_SPIN_NS;
+    }
+
+    while ((int64_t)(deadline_ns - now) > 0)
+        now = get_time_ns();
+
+    return now;
+}
+
+void frame_pacer_set_clock(int clock)
+{
+    frame_pacer_lock(&l_lock);
+    l_clock = clock;
+    frame_pacer_unlock(&l_lock);
+}
+
+void frame_pacer_set_display_rate(double refresh_rate)
+{
+    frame_pacer_lock(&l_lock);
+    l_display_rate = refresh_rate;
+    frame_pacer_unlock(&l_lock);
+}
+
+void frame_pacer_report_audio_queue(double queued_seconds, double target_seconds)
+{
+    frame_pacer_lock(&l_lock);
+    l_audio_queued = queued_seconds;
+    l_audio_target = target_seconds;
+    frame_pacer_unlock(&l_lock);
+}
+
+int frame_pacer_get_errors(int64_t* errors_ns, int count)
+{
+    uint64_t available;
+    uint64_t start;
+    int i;
+
+    if (errors_ns == NULL || count <= 0)
+        return 0;
+
+    frame_pacer_lock(&l_lock);
+
+    available = l_error_count < FRAME_PACER_ERRORS_SIZE ? l_error_count : FRAME_PACER_ERRORS_SIZE;
+    if ((uint64_t)count > available)
+        count = (int)available;
+
+    start = l_error_count - (uint64_t)count;
+    for (i = 0; i < count; ++i) {
+        errors_ns[i] = l_errors[(start + i) & (FRAME_PACER_ERRORS_SIZE - 1)];
+    }
+
+    frame_pacer_unlock(&l_lock);
+    return count;
+}
+
+void frame_pacer_reset(void)
+{
+    l_reset = 1;
+
+    frame_pacer_lock(&l_lock);
+    l_error_count = 0;
+    l_audio_queued = 0.0;
+    l_audio_target = 0.0;
+    frame_pacer_unlock(&l_lock);
+}
+
+void frame_pacer_wait(double rate, int limit)
+{
+    uint64_t now = get_time_ns();
+    double period_ns;
+    double lag_ns;
+
+    if (!limit || rate <= 0.0)
+    {
+        /* start over when the limit is enabled again */
+        l_reset = 1;
+        return;
+    }
+
+    period_ns = 1000000000.0 / get_clock_rate(rate);
+
+    /* the first frame after a reset only sets the base,
+     * every deadline after that is one period after the
+     * previous deadline, so the pacing doesn't drift
+     * and a change of rate doesn't have to reset it */
+    if (l_reset)
+    {
+        l_reset = 0;
+        l_base_ns = now;
+        l_deadline_ns = 0.0;
+        return;
+    }
+
+    l_deadline_ns += period_ns;
+
+    /* when we're too far behind, i.e after a pause or
+     * when the game can't run at full speed, start over
+     * instead of running fast until we've caught up */
+    lag_ns = (double)(now - l_base_ns) - l_deadline_ns;
+    if (lag_ns > (period_ns * FRAME_PACER_MAX_LAG_FRAMES))
+    {
+        add_error((int64_t)lag_ns);
+        l_base_ns = now;
+        l_deadline_ns = 0.0;
+        return;
+    }
+
+    now = wait_until(l_base_ns + (uint64_t)l_deadline_ns);
+    add_error((int64_t)now - (int64_t)(l_base_ns + (uint64_t)l_deadline_ns));
+}
@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - frame_pacer.h                                           *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef M64P_MAIN_FRAME_PACER_H
+#define M64P_MAIN_FRAME_PACER_H
+
+#include "api/m64p_types.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* clock which the frame pacer follows */
+enum frame_pacer_clock
+{
+    /* the monotonic system clock */
+    FRAME_PACER_CLOCK_SYSTEM = 0,
+    /* the refresh rate of the display, when it's
+     * close enough to the refresh rate of the game */
+    FRAME_PACER_CLOCK_DISPLAY = 1,
+    /* the audio device, the rate is adjusted slightly
+     * to keep the queued audio at its target */
+    FRAME_PACER_CLOCK_AUDIO = 2
+};
+
+/* Sets the refresh rate of the display which the
+ * emulation is shown on (call this from RMG-Core) */
+EXPORT void CALL frame_pacer_set_display_rate(double refresh_rate);
+
+/* Reports how much audio is queued on the audio device
+ * and how much should be queued (call this from RMG-Core) */
+EXPORT void CALL frame_pacer_report_audio_queue(double queued_seconds, double target_seconds);
+
+/* Copies the pacing error of at most count of the most recent
+ * frames into errors_ns, oldest first, returns the amount of
+ * frames copied, a positive error means the frame was late */
+EXPORT int CALL frame_pacer_get_errors(int64_t* errors_ns, int count);
+
+/* Sets the clock which the frame pacer follows
+ * (called with FramePacingClock when emulation starts) */
+void frame_pacer_set_clock(int clock);
+
+/* Starts pacing from the next frame (called when emulation starts) */
+void frame_pacer_reset(void);
+
+/* Waits until the current frame should end, rate is the amount of
+ * frames per second, when limit is 0, it only keeps track of time */
+void frame_pacer_wait(double rate, int limit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -69,6 +69,7 @@
 #include "device/gb/gb_cart.h"
 #include "device/pif/bootrom_hle.h"
 #include "eventloop.h"
+#include "frame_pacer.h"
 #include "main.h"
 #include "osal/files.h"
 #include "osal/preproc.h"
@@ -127,6 +128,13 @@ static int   l_TakeScreenshot = 0;       // Tell OSD Rendering callback to take
 static int   l_SpeedFactor = 100;        // percentage of nominal game speed at which emulator is running
 static int   l_FrameAdvance = 0;         // variable to check if we pause on next frame
 static int   l_MainSpeedLimit = 1;       // insert delay during vi_interrupt to keep speed at real-time
+static int   l_FastForward = 0;          // fast-forward (turbo) is active
+static int   l_FastForwardLimit = 1;     // keep the fast-forward speed factor, otherwise run unlimited
+static int   l_FrameSkip = 0;            // screen updates to skip out of every l_FrameSkipInterval during fast-forward
+static int   l_FrameSkipInterval = 1;
+static unsigned int l_FrameSkipCounter = 0;
+static Uint64 l_FastForwardStartCounter = 0; // performance counter when fast-forward was activated
+static int   l_FastForwardStartFrame = 0;   // frame counter when fast-forward was activated
 
 static osd_message_t *l_msgVol = NULL;
 static osd_message_t *l_msgFF = NULL;
@@ -446,6 +454,10 @@ int main_set_core_defaults(void)
     ConfigSetDefaultInt(g_CoreConfig, "SaveDiskFormat", 1, "Disk Save Format (0: Full Disk Copy (*.ndr/*.d6r), 1: RAM Area Only (*.ram))");
     ConfigSetDefaultInt(g_CoreConfig, "SaveFilenameFormat", 1, "Save (SRAM/State) Filename Format (0: ROM Header Name, 1: Automatic (including partial MD5 hash))");
     ConfigSetDefaultBool(g_CoreConfig, "DisableSaveFileLoading", 0, "Disable loading of save files (SRAM/EEPROM/FlashRAM) - useful for Kaillera netplay");
+    ConfigSetDefaultInt(g_CoreConfig, "FramePacingClock", 0, "Clock which the frame pacing follows (0: System, 1: Display refresh rate, 2: Audio device)");
+    ConfigSetDefaultInt(g_CoreConfig, "FastForwardSpeedFactor", 0, "Percentage of nominal game speed to run at during fast-forward (0: unlimited)");
+    ConfigSetDefaultInt(g_CoreConfig, "FastForwardFrameSkip", 4, "Amount of frames out of every FastForwardFrameSkipInterval frames which aren't presented during fast-forward");
+    ConfigSetDefaultInt(g_CoreConfig, "FastForwardFrameSkipInterval", 5, "Interval of frames which FastForwardFrameSkip applies to");
 
     /* handle upgrades */
     if (bUpgrade)
@@ -514,14 +526,28 @@ void main_set_fastforward(int enable)
     if (netplay_is_init())
         return;
 
-    static int ff_state = 0;
     static int SavedSpeedFactor = 100;
 
-    if (enable && !ff_state)
+    if (enable && !l_FastForward)
     {
-        ff_state = 1; /* activate fast-forward */
+        int speed_factor = ConfigGetParamInt(g_CoreConfig, "FastForwardSpeedFactor");
+
+        l_FastForward = 1; /* activate fast-forward */
         SavedSpeedFactor = l_SpeedFactor;
-        l_SpeedFactor = 250;
+        /* 0 runs as fast as possible */
+        l_FastForwardLimit = speed_factor > 0;
+        if (l_FastForwardLimit)
+            l_SpeedFactor = speed_factor > 1000 ? 1000 : speed_factor;
+        /* always present at least one out of every interval frames */
+        l_FrameSkipInterval = ConfigGetParamInt(g_CoreConfig, "FastForwardFrameSkipInterval");
+        if (l_FrameSkipInterval < 1)
+            l_FrameSkipInterval = 1;
+        l_FrameSkip = ConfigGetParamInt(g_CoreConfig, "FastForwardFrameSkip");
+        if (l_FrameSkip > l_FrameSkipInterval - 1)
+            l_FrameSkip = l_FrameSkipInterval - 1;
+        l_FrameSkipCounter = 0;
+        l_FastForwardStartCounter = SDL_GetPerformanceCounter();
+        l_FastForwardStartFrame = l_CurrentFrame;
         audio.setSpeedFactor(l_SpeedFactor);
         StateChanged(M64CORE_SPEED_FACTOR, l_SpeedFactor);
         // set fast-forward indicator
@@ -529,9 +555,18 @@ void main_set_fastforward(int enable)
         osd_message_set_static(l_msgFF);
         osd_message_set_user_managed(l_msgFF);
     }
-    else if (!enable && ff_state)
+    else if (!enable && l_FastForward)
     {
-        ff_state = 0; /* de-activate fast-forward */
+        /* report the speed which was reached, relative to full speed */
+        double seconds = (double)(SDL_GetPerformanceCounter() - l_FastForwardStartCounter) / (double)SDL_GetPerformanceFrequency();
+        int frames = l_CurrentFrame - l_FastForwardStartFrame;
+        if (seconds > 0.0 && g_dev.vi.expected_refresh_rate > 0.0)
+            DebugMessage(M64MSG_INFO, "Fast-forward ran at %.1fx full speed (%d frames in %.2f seconds)",
+                         frames / (seconds * g_dev.vi.expected_refresh_rate), frames, seconds);
+
+        l_FastForward = 0; /* de-activate fast-forward */
+        l_FastForwardLimit = 1;
+        l_FrameSkip = 0;
         l_SpeedFactor = SavedSpeedFactor;
         audio.setSpeedFactor(l_SpeedFactor);
         StateChanged(M64CORE_SPEED_FACTOR, l_SpeedFactor);
@@ -542,6 +577,24 @@ void main_set_fastforward(int enable)
 
 }
 
+int main_get_fastforward(void)
+{
+    return l_FastForward;
+}
+
+int main_skip_screen_update(void)
+{
+    unsigned int index;
+
+    if (!l_FastForward || l_FrameSkip <= 0)
+        return 0;
+
+    /* present the first frame of every interval,
+     * skip the last l_FrameSkip frames of it */
+    index = l_FrameSkipCounter++ % (unsigned int)l_FrameSkipInterval;
+    return index >= (unsigned int)(l_FrameSkipInterval - l_FrameSkip);
+}
+
 static void main_set_speedlimiter(int enable)
 {
     if (netplay_is_init() && !netplay_lag())
@@ -686,6 +739,24 @@ void main_state_save(int format, const char *filename)
         savestates_set_job(savestates_job_save, (savestates_type)format, filename);
 }
 
+m64p_error main_state_load_memory(void *buffer, size_t size)
+{
+    if (netplay_is_init())
+        return M64ERR_INVALID_STATE;
+
+    savestates_set_memory_job(savestates_job_load, buffer, size);
+    return M64ERR_SUCCESS;
+}
+
+m64p_error main_state_save_memory(void *buffer, size_t size)
+{
+    if (netplay_is_init())
+        return M64ERR_INVALID_STATE;
+
+    savestates_set_memory_job(savestates_job_save, buffer, size);
+    return M64ERR_SUCCESS;
+}
+
 m64p_error main_core_state_query(m64p_core_param param, int *rval)
 {
     switch (param)
@@ -736,10 +807,15 @@ m64p_error main_core_state_query(m64p_core_param param, int *rval)
         case M64CORE_INPUT_GAMESHARK:
             *rval = event_gameshark_active();
             break;
+        case M64CORE_STATE_MEMORY_SIZE:
+            *rval = SAVESTATE_M64P_SIZE;
+            break;
         // these are only used for callbacks; they cannot be queried or set
         case M64CORE_SCREENSHOT_CAPTURED:
         case M64CORE_STATE_LOADCOMPLETE:
         case M64CORE_STATE_SAVECOMPLETE:
+        case M64CORE_STATE_MEMORY_LOADCOMPLETE:
+        case M64CORE_STATE_MEMORY_SAVECOMPLETE:
             return M64ERR_INPUT_INVALID;
         default:
             return M64ERR_INPUT_INVALID;
@@ -832,9 +908,12 @@ m64p_error main_core_state_set(m64p_core_param param, int val)
                 return M64ERR_INVALID_STATE;
             event_set_gameshark(val);
             return M64ERR_SUCCESS;
-        // these are only used for callbacks; they cannot be queried or set
+        // these are only used for callbacks or queries; they cannot be set
         case M64CORE_STATE_LOADCOMPLETE:
         case M64CORE_STATE_SAVECOMPLETE:
+        case M64CORE_STATE_MEMORY_LOADCOMPLETE:
+        case M64CORE_STATE_MEMORY_SAVECOMPLETE:
+        case M64CORE_STATE_MEMORY_SIZE:
             return M64ERR_INPUT_INVALID;
         default:
             return M64ERR_INPUT_INVALID;
@@ -970,31 +1049,8 @@ void new_frame(void)
 
 static void apply_speed_limiter(void)
 {
-    static unsigned long totalVIs = 0;
-    static int resetOnce = 0;
-    static int lastSpeedFactor = 100;
-    static uint64_t StartFPSTime = 0;
-    static const double defaultSpeedFactor = 100.0;
-    uint64_t CurrentFPSTime = SDL_GetTicks();
-
-    // calculate frame duration based upon ROM setting (50/60hz) and mupen64plus speed adjustment
-    const double VILimitMilliseconds = 1000.0 / g_dev.vi.expected_refresh_rate;
-    const double SpeedFactorMultiple = defaultSpeedFactor/l_SpeedFactor;
-    const double AdjustedLimit = VILimitMilliseconds * SpeedFactorMultiple;
-
-    //if this is the first time or we are resuming from pause
-    if(StartFPSTime == 0 || !resetOnce || lastSpeedFactor != l_SpeedFactor)
-    {
-       StartFPSTime = CurrentFPSTime;
-       totalVIs = 0;
-       resetOnce = 1;
-    }
-    else
-    {
-        ++totalVIs;
-    }
-
-    lastSpeedFactor = l_SpeedFactor;
+    // calculate frame rate based upon ROM setting (50/60hz) and mupen64plus speed adjustment
+    const double rate = g_dev.vi.expected_refresh_rate * l_SpeedFactor / 100.0;
 
 #if defined(PROFILE)
     timed_section_start(TIMED_SECTION_IDLE);
@@ -1004,33 +1060,7 @@ static void apply_speed_limiter(void)
     if(g_DebuggerActive) DebuggerCallback(DEBUG_UI_VI, 0);
 #endif
 
-    double totalElapsedGameTime = AdjustedLimit*totalVIs;
-    double elapsedRealTime = CurrentFPSTime - StartFPSTime;
-    double sleepTime = totalElapsedGameTime - elapsedRealTime;
-
-    //Reset if the sleep needed is an unreasonable value
-    static const double minSleepNeeded = -50;
-    static const double maxSleepNeeded = 50;
-    if(sleepTime < minSleepNeeded || sleepTime > (maxSleepNeeded*SpeedFactorMultiple))
-    {
-       resetOnce = 0;
-    }
-
-    if (sleepTime < minSleepNeeded) {
-        totalVIs += (unsigned long)(minSleepNeeded/AdjustedLimit);
-    }
-
-    if(l_MainSpeedLimit && sleepTime > 0 && sleepTime < maxSleepNeeded*SpeedFactorMultiple)
-    {
-        while(sleepTime >= 0) {
-            SDL_Delay((unsigned int) sleepTime);
-
-            CurrentFPSTime = SDL_GetTicks();
-            elapsedRealTime = CurrentFPSTime - StartFPSTime;
-            sleepTime = totalElapsedGameTime - elapsedRealTime;
-        }
-    }
-
+    frame_pacer_wait(rate, l_MainSpeedLimit && l_FastForwardLimit);
 
 #if defined(PROFILE)
     timed_section_end(TIMED_SECTION_IDLE);
@@ -1634,6 +1664,8 @@ m64p_error main_run(void)
     /* set some other core parameters based on the config file values */
     savestates_set_autoinc_slot(ConfigGetParamBool(g_CoreConfig, "AutoStateSlotIncrement"));
     savestates_select_slot(ConfigGetParamInt(g_CoreConfig, "CurrentStateSlot"));
+    frame_pacer_set_clock(ConfigGetParamInt(g_CoreConfig, "FramePacingClock"));
+    frame_pacer_reset();
     no_compiled_jump = ConfigGetParamBool(g_CoreConfig, "NoCompiledJump");
     //We disable any randomness for netplay
     randomize_interrupt = !netplay_is_init() ? ConfigGetParamBool(g_CoreConfig, "RandomizeInterrupt") : 0;
@@ -1771,7 +1803,6 @@ m64p_error main_run(void)
             cin_compats[i].last_pak_type = Controls[i].Plugin;
             cin_compats[i].last_input = 0;
             cin_compats[i].netplay_count = 0;
-            cin_compats[i].event_first = NULL;
 
             Controls[i].Plugin = PLUGIN_NONE;
 
@@ -1799,7 +1830,6 @@ m64p_error main_run(void)
             cin_compats[i].last_pak_type = Controls[i].Plugin;
             cin_compats[i].last_input = 0;
             cin_compats[i].netplay_count = 0;
-            cin_compats[i].event_first = NULL;
 
             l_gb_carts_data[i].control_id = (int)i;
 
@@ -23,6 +23,7 @@
 #ifndef __MAIN_H__
 #define __MAIN_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "api/m64p_types.h"
@@ -76,7 +77,13 @@ void main_advance_one(void);
 
 void main_speedup(int percent);
 void main_speeddown(int percent);
-void main_set_fastforward(int enable);
+/* enables or disables fast-forward, which runs at the
+ * FastForwardSpeedFactor and skips presenting frames
+ * as configured (call these from RMG-Core) */
+EXPORT void CALL main_set_fastforward(int enable);
+EXPORT int CALL main_get_fastforward(void);
+/* returns whether the screen update of the current VI should be skipped */
+int  main_skip_screen_update(void);
 void main_speedlimiter_toggle(void);
 
 void main_take_next_screenshot(void);
@@ -85,6 +92,9 @@ void main_state_set_slot(int slot);
 void main_state_inc_slot(void);
 void main_state_load(const char *filename);
 void main_state_save(int format, const char *filename);
+/* these return M64ERR_INVALID_STATE while netplay is active */
+m64p_error main_state_load_memory(void *buffer, size_t size);
+m64p_error main_state_save_memory(void *buffer, size_t size);
 
 m64p_error main_core_state_query(m64p_core_param param, int *rval);
 m64p_error main_core_state_set(m64p_core_param param, int val);
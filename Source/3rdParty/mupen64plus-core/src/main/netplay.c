@@ -28,6 +28,8 @@
 #include "plugin/plugin.h"
 #include "backends/plugins_compat/plugins_compat.h"
 #include "netplay.h"
+#include "netplay_telemetry.h"
+#include "netplay_event_ring.h"
 #include "osal/preproc.h"
 
 #ifdef USE_SDL3NET
@@ -79,10 +81,32 @@ static uint32_t l_vi_counter;
 static uint8_t l_status;
 static uint32_t l_reg_id;
 static struct controller_input_compat *l_cin_compats;
+static struct netplay_event_ring l_event_rings[4];
 static uint8_t l_plugin[4];
 static uint8_t l_buffer_target;
 static uint8_t l_player_lag[4];
 
+//I/O thread, it receives the UDP packets and requests missing input from the server,
+//l_io_lock protects the UDP packets and sockets, the event rings and the player status
+static SDL_Thread *l_io_thread;
+#ifdef USE_SDL3
+static SDL_Mutex *l_io_lock;
+static SDL_Condition *l_io_input_avail;
+#else
+static SDL_mutex *l_io_lock;
+static SDL_cond *l_io_input_avail;
+#endif
+static int l_io_running;
+static int l_io_request_control_id = -1; //the player the emulation thread is waiting on
+#ifndef USE_SDL3NET
+static SDLNet_SocketSet l_io_socket_set;
+#endif
+
+#define NETPLAY_IO_REQUEST_INTERVAL 5 //how often missing input is requested from the server in ms
+#define NETPLAY_INPUT_TIMEOUT 10000 //how long to wait on input before assuming the connection is lost in ms
+
+static void netplay_stop_io_thread(void);
+
 //UDP packets
 static netplay_udp_packet *l_request_input_packet;
 static netplay_udp_packet *l_send_input_packet;
@@ -190,6 +214,16 @@ static osal_inline void netplay_send_udp_packet(void* udpSocket, netplay_udp_pac
 #endif
 }
 
+static osal_inline int netplay_wait_udp_packet(void* udpSocket, int timeout)
+{
+#ifdef USE_SDL3NET
+    void* sockets[1] = { udpSocket };
+    return NET_WaitUntilInputAvailable(sockets, 1, timeout) > 0;
+#else
+    return SDLNet_CheckSockets(l_io_socket_set, timeout) > 0;
+#endif
+}
+
 static osal_inline int netplay_send_tcp_packet(void* tcpSocket, const void* data, int len)
 {
 #ifdef USE_SDL3NET
@@ -397,20 +431,10 @@ m64p_error netplay_stop()
         return M64ERR_INVALID_STATE;
     else
     {
-        if (l_cin_compats != NULL)
-        {
-            for (int i = 0; i < 4; ++i)
-            {
-                struct netplay_event* current = l_cin_compats[i].event_first;
-                struct netplay_event* next;
-                while (current != NULL)
-                {
-                    next = current->next;
-                    free(current);
-                    current = next;
-                }
-            }
-        }
+        netplay_stop_io_thread();
+
+        for (int i = 0; i < 4; ++i)
+            netplay_event_ring_clear(&l_event_rings[i]);
 
         char output_data[5];
         output_data[0] = TCP_DISCONNECT_NOTICE;
@@ -460,14 +484,8 @@ int netplay_is_init()
 static uint8_t buffer_size(uint8_t control_id)
 {
     //This function returns the size of the local input buffer
-    uint8_t counter = 0;
-    struct netplay_event* current = l_cin_compats[control_id].event_first;
-    while (current != NULL)
-    {
-        current = current->next;
-        ++counter;
-    }
-    return counter;
+    uint32_t size = l_event_rings[control_id].size;
+    return size > UINT8_MAX ? UINT8_MAX : (uint8_t)size;
 }
 
 static void netplay_request_input(uint8_t control_id)
@@ -485,40 +503,14 @@ static void netplay_request_input(uint8_t control_id)
 static int check_valid(uint8_t control_id, uint32_t count)
 {
     //Check if we already have this event recorded locally, returns 1 if we do
-    struct netplay_event* current = l_cin_compats[control_id].event_first;
-    while (current != NULL)
-    {
-        if (current->count == count) //event already recorded
-            return 1;
-        current = current->next;
-    }
-    return 0;
+    return netplay_event_ring_find(&l_event_rings[control_id], count) != NULL;
 }
 
-static int netplay_require_response(void* opaque)
-{
-    //This function runs inside a thread.
-    //It runs if our local buffer size is 0 (we need to execute a key event, but we don't have the data we need).
-    //We basically beg the server for input data.
-    //After 10 seconds a timeout occurs, we assume we have lost connection to the server.
-    uint8_t control_id = *(uint8_t*)opaque;
-    uint64_t timeout = SDL_GetTicks() + 10000;
-    while (!check_valid(control_id, l_cin_compats[control_id].netplay_count))
-    {
-        if (SDL_GetTicks() > timeout)
-        {
-            l_udpChannel = -1;
-            return 0;
-        }
-        netplay_request_input(control_id);
-        SDL_Delay(5);
-    }
-    return 1;
-}
-
-static void netplay_process()
+static int netplay_process()
 {
     //In this function we process data we have received from the server
+    //returns 1 if we received new input
+    int received = 0;
     uint32_t curr, count, keys;
     uint8_t plugin, player, current_status;
     while (netplay_recv_udp_packet(l_udpSocket, l_process_packet) == 1)
@@ -545,31 +537,20 @@ static void netplay_process()
                     l_status = current_status;
                 }
                 curr = 5;
-                //this loop processes input data from the server, inserting new events into the linked list for each player
+                //this loop processes input data from the server, inserting new events into the event ring for each player
                 //it skips events that we have already recorded, or if we receive data for an event that has already happened
+                //events which are too far ahead to fit in the ring are skipped as well, the server will send them again
                 for (uint8_t i = 0; i < l_process_packet->data[4]; ++i)
                 {
                     count = netplay_read32(&l_process_packet->data[curr]);
                     curr += 4;
 
-                    if (((count - l_cin_compats[player].netplay_count) > (UINT32_MAX / 2)) || (check_valid(player, count))) //event doesn't need to be recorded
-                    {
-                        curr += 5;
-                        continue;
-                    }
-
                     keys = netplay_read32(&l_process_packet->data[curr]);
                     curr += 4;
                     plugin = l_process_packet->data[curr];
                     curr += 1;
 
-                    //insert new event at beginning of linked list
-                    struct netplay_event* new_event = (struct netplay_event*)malloc(sizeof(struct netplay_event));
-                    new_event->count = count;
-                    new_event->buttons = keys;
-                    new_event->plugin = plugin;
-                    new_event->next = l_cin_compats[player].event_first;
-                    l_cin_compats[player].event_first = new_event;
+                    received |= netplay_event_ring_insert(&l_event_rings[player], l_cin_compats[player].netplay_count, count, keys, plugin);
                 }
                 break;
             default:
@@ -577,55 +558,164 @@ static void netplay_process()
                 break;
         }
     }
+    return received;
 }
 
-static int netplay_ensure_valid(uint8_t control_id)
+static int netplay_io_thread(void* opaque)
 {
-    //This function makes sure we have data for a certain event
-    //If we don't have the data, it will create a new thread that will request the data
-    if (check_valid(control_id, l_cin_compats[control_id].netplay_count))
-        return 1;
+    //This function runs inside the I/O thread for the duration of the game.
+    //It waits for packets from the server and stores the input they contain,
+    //waking up the emulation thread when it is waiting on input.
+    //While the emulation thread is waiting, we beg the server for input data.
+    uint64_t next_request = 0;
+    for (;;)
+    {
+        netplay_wait_udp_packet(l_udpSocket, NETPLAY_IO_REQUEST_INTERVAL);
+
+        SDL_LockMutex(l_io_lock);
+        if (!l_io_running)
+        {
+            SDL_UnlockMutex(l_io_lock);
+            break;
+        }
+
+        if (netplay_process())
+#ifdef USE_SDL3
+            SDL_BroadcastCondition(l_io_input_avail);
+#else
+            SDL_CondBroadcast(l_io_input_avail);
+#endif
+
+        if (l_io_request_control_id != -1 && SDL_GetTicks() >= next_request &&
+            !check_valid(l_io_request_control_id, l_cin_compats[l_io_request_control_id].netplay_count))
+        {
+            netplay_request_input(l_io_request_control_id);
+            next_request = SDL_GetTicks() + NETPLAY_IO_REQUEST_INTERVAL;
+        }
+        SDL_UnlockMutex(l_io_lock);
+    }
+    return 0;
+}
 
-    if (l_udpChannel == -1)
+static int netplay_start_io_thread(void)
+{
+    l_io_lock = SDL_CreateMutex();
+#ifdef USE_SDL3
+    l_io_input_avail = SDL_CreateCondition();
+#else
+    l_io_input_avail = SDL_CreateCond();
+#endif
+#ifndef USE_SDL3NET
+    l_io_socket_set = SDLNet_AllocSocketSet(1);
+    if (l_io_socket_set != NULL)
+        SDLNet_UDP_AddSocket(l_io_socket_set, l_udpSocket);
+#endif
+    l_io_request_control_id = -1;
+    l_io_running = 1;
+
+    if (l_io_lock == NULL || l_io_input_avail == NULL
+#ifndef USE_SDL3NET
+        || l_io_socket_set == NULL
+#endif
+        )
+    {
+        DebugMessage(M64MSG_ERROR, "Netplay: could not create I/O thread synchronization");
         return 0;
+    }
 
-    SDL_Thread* thread = SDL_CreateThread(netplay_require_response, "Netplay key request", &control_id);
+    l_io_thread = SDL_CreateThread(netplay_io_thread, "Netplay I/O", NULL);
+    if (l_io_thread == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "Netplay: could not create I/O thread: %s", SDL_GetError());
+        return 0;
+    }
 
-    while (!check_valid(control_id, l_cin_compats[control_id].netplay_count) && l_udpChannel != -1)
-        netplay_process();
-    int success;
-    SDL_WaitThread(thread, &success);
-    return success;
+    return 1;
 }
 
-static void netplay_delete_event(struct netplay_event* current, uint8_t control_id)
+static void netplay_stop_io_thread(void)
 {
-    //This function deletes an event from the linked list
-    struct netplay_event* find = l_cin_compats[control_id].event_first;
-    while (find != NULL)
+    if (l_io_thread != NULL)
+    {
+        SDL_LockMutex(l_io_lock);
+        l_io_running = 0;
+        SDL_UnlockMutex(l_io_lock);
+        SDL_WaitThread(l_io_thread, NULL);
+        l_io_thread = NULL;
+    }
+
+    if (l_io_input_avail != NULL)
+    {
+#ifdef USE_SDL3
+        SDL_DestroyCondition(l_io_input_avail);
+#else
+        SDL_DestroyCond(l_io_input_avail);
+#endif
+        l_io_input_avail = NULL;
+    }
+
+    if (l_io_lock != NULL)
     {
-        if (find->next == current)
+        SDL_DestroyMutex(l_io_lock);
+        l_io_lock = NULL;
+    }
+
+#ifndef USE_SDL3NET
+    if (l_io_socket_set != NULL)
+    {
+        SDLNet_FreeSocketSet(l_io_socket_set);
+        l_io_socket_set = NULL;
+    }
+#endif
+}
+
+static int netplay_ensure_valid(uint8_t control_id)
+{
+    //This function makes sure we have data for a certain event, expects l_io_lock to be locked
+    //If we don't have the data, we wait until the I/O thread has received it, the I/O thread
+    //will request it from the server while we wait
+    //After 10 seconds a timeout occurs, we assume we have lost connection to the server.
+    if (check_valid(control_id, l_cin_compats[control_id].netplay_count))
+        return 1;
+
+    if (l_udpChannel == -1 || l_io_thread == NULL)
+        return 0;
+
+    uint64_t timeout = SDL_GetTicks() + NETPLAY_INPUT_TIMEOUT;
+    int valid = 0;
+    l_io_request_control_id = control_id;
+    while (!(valid = check_valid(control_id, l_cin_compats[control_id].netplay_count)))
+    {
+        uint64_t now = SDL_GetTicks();
+        if (now >= timeout)
         {
-            find->next = current->next;
+            l_udpChannel = -1;
             break;
         }
-        find = find->next;
+#ifdef USE_SDL3
+        SDL_WaitConditionTimeout(l_io_input_avail, l_io_lock, (Sint32)(timeout - now));
+#else
+        SDL_CondWaitTimeout(l_io_input_avail, l_io_lock, (Uint32)(timeout - now));
+#endif
     }
-    if (current == l_cin_compats[control_id].event_first)
-        l_cin_compats[control_id].event_first = l_cin_compats[control_id].event_first->next;
-    free(current);
+    l_io_request_control_id = -1;
+    return valid;
 }
 
 static uint32_t netplay_get_input(uint8_t control_id)
 {
-    uint32_t keys;
-    netplay_process();
+    uint32_t keys = 0;
+    int fast_forward;
+    SDL_LockMutex(l_io_lock);
     netplay_request_input(control_id);
 
     //l_buffer_target is set by the server upon registration
     //l_player_lag is how far behind we are from the lead player
     //buffer_size is the local buffer size
-    if (l_player_lag[control_id] > 0 && buffer_size(control_id) > l_buffer_target)
+    fast_forward = l_player_lag[control_id] > 0 && buffer_size(control_id) > l_buffer_target;
+    SDL_UnlockMutex(l_io_lock);
+
+    if (fast_forward)
     {
         l_canFF = 1;
         main_core_state_set(M64CORE_SPEED_LIMITER, 0);
@@ -636,23 +726,28 @@ static uint32_t netplay_get_input(uint8_t control_id)
         l_canFF = 0;
     }
 
-    if (netplay_ensure_valid(control_id))
+    //Report how long we waited on the input of this event
+    Uint64 wait_start = SDL_GetPerformanceCounter();
+    SDL_LockMutex(l_io_lock);
+    int valid = netplay_ensure_valid(control_id);
+    if (valid)
     {
-        //We grab the event from the linked list, the delete it once it has been used
+        //We grab the event from the event ring, then remove it once it has been used
         //Finally we increment the event counter
-        struct netplay_event* current = l_cin_compats[control_id].event_first;
-        while (current->count != l_cin_compats[control_id].netplay_count)
-            current = current->next;
+        struct netplay_event* current = netplay_event_ring_find(&l_event_rings[control_id], l_cin_compats[control_id].netplay_count);
         keys = current->buttons;
         Controls[control_id].Plugin = current->plugin;
-        netplay_delete_event(current, control_id);
+        netplay_event_ring_remove(&l_event_rings[control_id], current);
         ++l_cin_compats[control_id].netplay_count;
     }
-    else
+    SDL_UnlockMutex(l_io_lock);
+    long long wait_us = (long long)((SDL_GetPerformanceCounter() - wait_start) * 1000000 / SDL_GetPerformanceFrequency());
+    call_netplay_telemetry_callback(wait_us, valid ? 1 : -1);
+
+    if (!valid)
     {
         DebugMessage(M64MSG_ERROR, "Netplay: lost connection to server");
         main_core_state_set(M64CORE_EMU_STATE, M64EMU_STOPPED);
-        keys = 0;
     }
 
     return keys;
@@ -666,7 +761,9 @@ static void netplay_send_input(uint8_t control_id, uint32_t keys)
     netplay_write32(keys, &l_send_input_packet->data[6]); //key data
     l_send_input_packet->data[10] = l_plugin[control_id]; //current plugin
     l_send_input_packet->len = 11;
+    SDL_LockMutex(l_io_lock);
     netplay_send_udp_packet(l_udpSocket, l_send_input_packet);
+    SDL_UnlockMutex(l_io_lock);
 }
 
 uint8_t netplay_register_player(uint8_t player, uint8_t plugin, uint8_t rawdata, uint32_t reg_id)
@@ -827,7 +924,9 @@ void netplay_check_sync(struct cp0* cp0)
             netplay_write32(cp0_regs[i], &l_check_sync_packet->data[(i * 4) + 5]);
         }
         l_check_sync_packet->len = l_check_sync_packet_size;
+        SDL_LockMutex(l_io_lock);
         netplay_send_udp_packet(l_udpSocket, l_check_sync_packet);
+        SDL_UnlockMutex(l_io_lock);
     }
 
     ++l_vi_counter;
@@ -841,6 +940,8 @@ void netplay_read_registration(struct controller_input_compat* cin_compats)
         return;
 
     l_cin_compats = cin_compats;
+    for (int i = 0; i < 4; ++i)
+        netplay_event_ring_clear(&l_event_rings[i]);
 
     uint32_t reg_id;
     char output_data = TCP_GET_REGISTRATION;
@@ -879,6 +980,9 @@ void netplay_read_registration(struct controller_input_compat* cin_compats)
             ++curr;
         }
     }
+
+    //from now on the I/O thread receives the input from the server
+    netplay_start_io_thread();
 }
 
 static void netplay_send_raw_input(struct pif* pif)
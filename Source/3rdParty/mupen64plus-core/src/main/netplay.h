@@ -28,13 +28,6 @@
 
 #define NETPLAY_CORE_VERSION 1
 
-struct netplay_event {
-    uint32_t buttons;
-    uint8_t plugin;
-    uint32_t count;
-    struct netplay_event* next;
-};
-
 struct controller_input_compat;
 
 #ifdef M64P_NETPLAY
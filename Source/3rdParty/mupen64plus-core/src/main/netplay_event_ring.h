@@ -0,0 +1,89 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - netplay_event_ring.h                                    *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef M64P_MAIN_NETPLAY_EVENT_RING_H
+#define M64P_MAIN_NETPLAY_EVENT_RING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "osal/preproc.h"
+
+/* Amount of events which can be buffered per player, has to be a power of 2.
+ * Events are stored in the slot of their count, so events which are further
+ * ahead than this are dropped, the server resends them when we request them.
+ */
+#define NETPLAY_EVENT_RING_SIZE 256
+
+struct netplay_event {
+    uint32_t buttons;
+    uint8_t plugin;
+    uint8_t valid;
+    uint32_t count;
+};
+
+struct netplay_event_ring {
+    struct netplay_event events[NETPLAY_EVENT_RING_SIZE];
+    uint32_t size;
+};
+
+static osal_inline void netplay_event_ring_clear(struct netplay_event_ring* ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+/* Returns the event with the given count, or NULL when it hasn't been received */
+static osal_inline struct netplay_event* netplay_event_ring_find(struct netplay_event_ring* ring, uint32_t count)
+{
+    struct netplay_event* event = &ring->events[count & (NETPLAY_EVENT_RING_SIZE - 1)];
+    return (event->valid && event->count == count) ? event : NULL;
+}
+
+/* Stores an event, base is the count of the next event which will be taken.
+ * Returns 1 when the event was stored, 0 when it was already
+ * stored or when it doesn't fit in the ring.
+ */
+static osal_inline int netplay_event_ring_insert(struct netplay_event_ring* ring, uint32_t base, uint32_t count, uint32_t buttons, uint8_t plugin)
+{
+    if ((count - base) >= NETPLAY_EVENT_RING_SIZE)
+        return 0;
+
+    struct netplay_event* event = &ring->events[count & (NETPLAY_EVENT_RING_SIZE - 1)];
+    if (event->valid && event->count == count)
+        return 0;
+
+    event->count = count;
+    event->buttons = buttons;
+    event->plugin = plugin;
+    event->valid = 1;
+    ++ring->size;
+    return 1;
+}
+
+/* Removes an event returned by netplay_event_ring_find */
+static osal_inline void netplay_event_ring_remove(struct netplay_event_ring* ring, struct netplay_event* event)
+{
+    event->valid = 0;
+    --ring->size;
+}
+
+#endif /* M64P_MAIN_NETPLAY_EVENT_RING_H */
@@ -0,0 +1,49 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - netplay_telemetry.h                                     *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+
+#ifndef M64P_MAIN_NETPLAY_TELEMETRY_H
+#define M64P_MAIN_NETPLAY_TELEMETRY_H
+
+#include "api/m64p_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Callback function type for netplay input telemetry
+ * wait_us is how long the input request blocked, result is 1
+ * when the input arrived and -1 when the connection was lost
+ */
+typedef void (*netplay_telemetry_callback_t)(long long wait_us, int result);
+
+/* Set netplay telemetry callback (call this from RMG-Core) */
+EXPORT void CALL set_netplay_telemetry_callback(netplay_telemetry_callback_t callback);
+
+/* Call the netplay telemetry callback if set (called from netplay.c) */
+void call_netplay_telemetry_callback(long long wait_us, int result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - rollback.c                                              *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#include "rollback.h"
+#include "delta_snapshot.h"
+
+#include "api/callbacks.h"
+
+#include <stddef.h>
+
+static struct delta_snapshot_ring l_ring;
+static rollback_load_callback_t l_load_callback = NULL;
+
+static int l_save_pending = 0;
+static unsigned int l_save_frame = 0;
+static int l_load_pending = 0;
+static unsigned int l_load_frame = 0;
+
+int rollback_init(unsigned int count, rollback_load_callback_t callback)
+{
+    rollback_deinit();
+
+    if (!delta_snapshot_ring_init(&l_ring, count))
+    {
+        DebugMessage(M64MSG_ERROR, "Could not allocate %u rollback snapshots", count);
+        return 0;
+    }
+
+    l_load_callback = callback;
+    return 1;
+}
+
+void rollback_deinit(void)
+{
+    delta_snapshot_ring_deinit(&l_ring);
+
+    l_load_callback = NULL;
+    l_save_pending = 0;
+    l_load_pending = 0;
+}
+
+void rollback_request_save(unsigned int frame)
+{
+    if (l_ring.deltas == NULL)
+        return;
+
+    l_save_pending = 1;
+    l_save_frame = frame;
+}
+
+int rollback_request_load(unsigned int frame)
+{
+    if (l_ring.deltas == NULL || !delta_snapshot_ring_contains(&l_ring, frame))
+        return 0;
+
+    /* a snapshot which is still pending would be taken
+     * after the load and overwrite a newer frame */
+    l_save_pending = 0;
+    l_load_pending = 1;
+    l_load_frame = frame;
+    return 1;
+}
+
+int rollback_process_load(void)
+{
+    if (!l_load_pending)
+        return 0;
+
+    l_load_pending = 0;
+
+    if (!delta_snapshot_ring_load(&l_ring, l_load_frame))
+    {
+        DebugMessage(M64MSG_ERROR, "Could not restore rollback snapshot of frame %u", l_load_frame);
+        return 0;
+    }
+
+    if (l_load_callback != NULL)
+        l_load_callback(l_load_frame);
+
+    return 1;
+}
+
+void rollback_process_save(void)
+{
+    if (!l_save_pending)
+        return;
+
+    l_save_pending = 0;
+
+    delta_snapshot_ring_save(&l_ring, l_save_frame);
+}
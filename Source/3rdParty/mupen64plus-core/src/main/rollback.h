@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - rollback.h                                              *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef M64P_MAIN_ROLLBACK_H
+#define M64P_MAIN_ROLLBACK_H
+
+#include "api/m64p_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Called on the emulation thread once a snapshot has been restored,
+ * frame is the frame which was passed to rollback_request_save()
+ */
+typedef void (*rollback_load_callback_t)(unsigned int frame);
+
+/* Allocates count in-memory snapshots which are used as a ring
+ * indexed by frame, returns 0 when the allocation failed
+ * (call this from RMG-Core before starting a rollback session)
+ */
+EXPORT int CALL rollback_init(unsigned int count, rollback_load_callback_t callback);
+
+/* Frees all snapshots */
+EXPORT void CALL rollback_deinit(void);
+
+/* Requests a snapshot of the current state for frame, it's taken
+ * at the end of the current interrupt (call this from the frame callback)
+ */
+EXPORT void CALL rollback_request_save(unsigned int frame);
+
+/* Requests the snapshot of frame to be restored at the start of the
+ * next interrupt, returns 0 when there's no snapshot for frame
+ */
+EXPORT int CALL rollback_request_load(unsigned int frame);
+
+/* Processes pending requests (called from gen_interrupt),
+ * rollback_process_load() returns 1 when the state was replaced
+ */
+int rollback_process_load(void);
+void rollback_process_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
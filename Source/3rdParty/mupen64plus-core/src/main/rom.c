@@ -58,6 +58,7 @@ enum { DEFAULT_SI_DMA_DURATION = 0x900 };
 enum { DEFAULT_AI_DMA_MODIFIER = 100 };
 
 static romdatabase_entry* ini_search_by_md5(md5_byte_t* md5);
+static romdatabase_entry* rom_settings_lookup(const m64p_rom_header* header, md5_byte_t* digest, m64p_rom_settings* settings);
 
 static _romdatabase g_romdatabase;
 
@@ -183,52 +184,8 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
     trim(ROM_PARAMS.headername); /* Remove trailing whitespace from ROM name. */
 
     /* Look up this ROM in the .ini file and fill in goodname, etc */
-    if ((entry=ini_search_by_md5(digest)) != NULL ||
-        (entry=ini_search_by_crc(tohl(ROM_HEADER.CRC1),tohl(ROM_HEADER.CRC2))) != NULL)
-    {
-        strncpy(ROM_SETTINGS.goodname, entry->goodname, 255);
-        ROM_SETTINGS.goodname[255] = '\0';
-        ROM_SETTINGS.savetype = entry->savetype;
-        ROM_SETTINGS.status = entry->status;
-        ROM_SETTINGS.players = entry->players;
-        ROM_SETTINGS.rumble = entry->rumble;
-        ROM_SETTINGS.transferpak = entry->transferpak;
-        ROM_SETTINGS.mempak = entry->mempak;
-        ROM_SETTINGS.biopak = entry->biopak;
-        ROM_SETTINGS.countperop = entry->countperop;
-        ROM_SETTINGS.disableextramem = entry->disableextramem;
-        ROM_SETTINGS.sidmaduration = entry->sidmaduration;
-        ROM_SETTINGS.aidmamodifier = entry->aidmamodifier;
-        ROM_PARAMS.cheats = entry->cheats;
-    }
-    else
-    {
-        strcpy(ROM_SETTINGS.goodname, ROM_PARAMS.headername);
-        strcat(ROM_SETTINGS.goodname, " (unknown rom)");
-        ROM_SETTINGS.status = 0;
-        ROM_SETTINGS.players = 4;
-        ROM_SETTINGS.rumble = 1;
-        ROM_SETTINGS.transferpak = 0;
-        ROM_SETTINGS.mempak = 1;
-        ROM_SETTINGS.biopak = 0;
-        ROM_SETTINGS.countperop = DEFAULT_COUNT_PER_OP;
-        ROM_SETTINGS.disableextramem = DEFAULT_DISABLE_EXTRA_MEM;
-        ROM_SETTINGS.sidmaduration = DEFAULT_SI_DMA_DURATION;
-        ROM_SETTINGS.aidmamodifier = DEFAULT_AI_DMA_MODIFIER;
-        ROM_PARAMS.cheats = NULL;
-
-        /* check if ROM has the Advanced Homebrew ROM Header (see https://n64brew.dev/wiki/ROM_Header) */
-        if (ROM_HEADER.Cartridge_ID == 0x4445)
-        {
-            /* When current ROM has the Advanced Homebrew ROM Header, use the save type */
-            ROM_SETTINGS.savetype = rom_homebrew_savetype_to_savetype(ROM_HEADER.Version >> 4);
-        }
-        else
-        {
-            /* There's no way to guess the save type, but 4K EEPROM is better than nothing */
-            ROM_SETTINGS.savetype = SAVETYPE_EEPROM_4K;
-        }
-    }
+    entry = rom_settings_lookup(&ROM_HEADER, digest, &ROM_SETTINGS);
+    ROM_PARAMS.cheats = (entry != NULL) ? entry->cheats : NULL;
 
     /* print out a bunch of info about the ROM */
     DebugMessage(M64MSG_INFO, "Goodname: %s", ROM_SETTINGS.goodname);
@@ -447,18 +404,217 @@ static unsigned char rom_homebrew_savetype_to_savetype(uint8_t save_type)
     return m64p_save_type;
 }
 
-static size_t romdatabase_resolve_round(void)
+/* Fills in the goodname and the settings of a ROM from the ROM database,
+ * or the defaults when the ROM isn't in the database.
+ *
+ * IN: header: The ROM header in N64 native (big endian) byte order.
+ *     digest: The MD5 digest of the whole ROM in N64 native byte order.
+ * OUT: settings: The ROM settings, the MD5 string isn't touched.
+ * Returns the database entry or NULL when the ROM isn't in the database.
+ */
+static romdatabase_entry* rom_settings_lookup(const m64p_rom_header* header, md5_byte_t* digest, m64p_rom_settings* settings)
+{
+    romdatabase_entry* entry;
+    char headername[21];
+
+    if ((entry=ini_search_by_md5(digest)) != NULL ||
+        (entry=ini_search_by_crc(tohl(header->CRC1),tohl(header->CRC2))) != NULL)
+    {
+        strncpy(settings->goodname, entry->goodname, 255);
+        settings->goodname[255] = '\0';
+        settings->savetype = entry->savetype;
+        settings->status = entry->status;
+        settings->players = entry->players;
+        settings->rumble = entry->rumble;
+        settings->transferpak = entry->transferpak;
+        settings->mempak = entry->mempak;
+        settings->biopak = entry->biopak;
+        settings->countperop = entry->countperop;
+        settings->disableextramem = entry->disableextramem;
+        settings->sidmaduration = entry->sidmaduration;
+        settings->aidmamodifier = entry->aidmamodifier;
+    }
+    else
+    {
+        memcpy(headername, header->Name, 20);
+        headername[20] = '\0';
+        trim(headername); /* Remove trailing whitespace from ROM name. */
+
+        strcpy(settings->goodname, headername);
+        strcat(settings->goodname, " (unknown rom)");
+        settings->status = 0;
+        settings->players = 4;
+        settings->rumble = 1;
+        settings->transferpak = 0;
+        settings->mempak = 1;
+        settings->biopak = 0;
+        settings->countperop = DEFAULT_COUNT_PER_OP;
+        settings->disableextramem = DEFAULT_DISABLE_EXTRA_MEM;
+        settings->sidmaduration = DEFAULT_SI_DMA_DURATION;
+        settings->aidmamodifier = DEFAULT_AI_DMA_MODIFIER;
+
+        /* check if ROM has the Advanced Homebrew ROM Header (see https://n64brew.dev/wiki/ROM_Header) */
+        if (header->Cartridge_ID == 0x4445)
+        {
+            /* When current ROM has the Advanced Homebrew ROM Header, use the save type */
+            settings->savetype = rom_homebrew_savetype_to_savetype(header->Version >> 4);
+        }
+        else
+        {
+            /* There's no way to guess the save type, but 4K EEPROM is better than nothing */
+            settings->savetype = SAVETYPE_EEPROM_4K;
+        }
+    }
+
+    return entry;
+}
+
+EXPORT int CALL romdatabase_lookup_rom(const void* header, const unsigned char* md5, m64p_rom_settings* settings)
 {
-    romdatabase_search *entry;
+    md5_byte_t digest[16];
+    int i;
+
+    if (header == NULL || md5 == NULL || settings == NULL)
+        return 0;
+
+    memcpy(digest, md5, sizeof(digest));
+    for (i = 0; i < 16; ++i)
+        sprintf(settings->MD5 + i*2, "%02X", digest[i]);
+    settings->MD5[32] = '\0';
+
+    return rom_settings_lookup((const m64p_rom_header*)header, digest, settings) != NULL;
+}
+
+/********************************************************************************************/
+/* INI Rom database functions */
+
+#define ROMDATABASE_CACHE_NAME    "mupen64plus.ini.cache"
+#define ROMDATABASE_CACHE_MAGIC   0x4244524D /* 'MRDB', also detects a different byte order */
+#define ROMDATABASE_CACHE_VERSION 1
+#define ROMDATABASE_NO_STRING     0xFFFFFFFF
+
+/* The layout of the cached ROM database image is the header, the entries
+ * sorted by MD5, the CRC index and the string pool. The image is only
+ * used on the machine which created it, so it's stored in native byte order.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ini_size;
+    int64_t ini_mtime;
+    uint32_t entry_count;
+    uint32_t crc_count;
+    uint32_t strings_size;
+    uint32_t reserved;
+} romdatabase_cache_header;
+
+typedef struct
+{
+    uint8_t md5[16];
+    uint32_t crc1;
+    uint32_t crc2;
+    uint32_t goodname; /* offset in the string pool or ROMDATABASE_NO_STRING */
+    uint32_t cheats;   /* offset in the string pool or ROMDATABASE_NO_STRING */
+    uint32_t sidmaduration;
+    uint32_t aidmamodifier;
+    uint32_t set_flags;
+    uint8_t status;
+    uint8_t savetype;
+    uint8_t players;
+    uint8_t rumble;
+    uint8_t countperop;
+    uint8_t disableextramem;
+    uint8_t transferpak;
+    uint8_t mempak;
+    uint8_t biopak;
+    uint8_t padding[3];
+} romdatabase_cache_entry;
+
+/* entry which is being parsed from mupen64plus.ini */
+typedef struct
+{
+    romdatabase_entry entry;
+    size_t order; /* position in mupen64plus.ini */
+    int has_crc;  /* the CRC is set by the entry itself, not by its RefMD5 */
+} romdatabase_parse_entry;
+
+typedef struct
+{
+    uint32_t crc1;
+    uint32_t crc2;
+    uint32_t index;
+} romdatabase_crc_key;
+
+static int romdatabase_parse_entry_compare(const void* a, const void* b)
+{
+    const romdatabase_parse_entry* entry_a = (const romdatabase_parse_entry*)a;
+    const romdatabase_parse_entry* entry_b = (const romdatabase_parse_entry*)b;
+    int result = memcmp(entry_a->entry.md5, entry_b->entry.md5, 16);
+
+    if (result != 0)
+        return result;
+
+    return (entry_a->order < entry_b->order) ? -1 : (entry_a->order > entry_b->order);
+}
+
+static int romdatabase_crc_key_compare(const void* a, const void* b)
+{
+    const romdatabase_crc_key* key_a = (const romdatabase_crc_key*)a;
+    const romdatabase_crc_key* key_b = (const romdatabase_crc_key*)b;
+
+    if (key_a->crc1 != key_b->crc1)
+        return (key_a->crc1 < key_b->crc1) ? -1 : 1;
+    if (key_a->crc2 != key_b->crc2)
+        return (key_a->crc2 < key_b->crc2) ? -1 : 1;
+    return (key_a->index < key_b->index) ? -1 : (key_a->index > key_b->index);
+}
+
+static romdatabase_entry* romdatabase_parse_find(romdatabase_parse_entry* entries, size_t count, const md5_byte_t* md5)
+{
+    size_t low = 0, high = count;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        int result = memcmp(entries[mid].entry.md5, md5, 16);
+        if (result == 0)
+            return &entries[mid].entry;
+        if (result < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return NULL;
+}
+
+static void romdatabase_parse_free(romdatabase_parse_entry* entries, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        free(entries[i].entry.goodname);
+        free(entries[i].entry.refmd5);
+        free(entries[i].entry.cheats);
+    }
+
+    free(entries);
+}
+
+static size_t romdatabase_resolve_round(romdatabase_parse_entry* entries, size_t count)
+{
+    romdatabase_parse_entry *entry;
     romdatabase_entry *ref;
     size_t skipped = 0;
 
     /* Resolve RefMD5 references */
-    for (entry = g_romdatabase.list; entry; entry = entry->next_entry) {
+    for (entry = entries; entry < entries + count; entry++) {
         if (!entry->entry.refmd5)
             continue;
 
-        ref = ini_search_by_md5(entry->entry.refmd5);
+        ref = romdatabase_parse_find(entries, count, entry->entry.refmd5);
         if (!ref) {
             DebugMessage(M64MSG_WARNING, "ROM Database: Error solving RefMD5s");
             continue;
@@ -564,13 +720,13 @@ static size_t romdatabase_resolve_round(void)
     return skipped;
 }
 
-static void romdatabase_resolve(void)
+static void romdatabase_resolve(romdatabase_parse_entry* entries, size_t count)
 {
     size_t last_skipped = (size_t)~0ULL;
     size_t skipped;
 
     do {
-        skipped = romdatabase_resolve_round();
+        skipped = romdatabase_resolve_round(entries, count);
         if (skipped == last_skipped) {
             DebugMessage(M64MSG_ERROR, "Unable to resolve rom database entries (loop)");
             break;
@@ -579,41 +735,25 @@ static void romdatabase_resolve(void)
     } while (skipped > 0);
 }
 
-/********************************************************************************************/
-/* INI Rom database functions */
-
-void romdatabase_open(void)
+/* parses mupen64plus.ini into entries sorted by MD5 with their RefMD5s resolved */
+static romdatabase_parse_entry* romdatabase_parse_ini(const char* pathname, size_t* count)
 {
     FILE *fPtr;
     char buffer[256];
-    romdatabase_search* search = NULL;
-    romdatabase_search** next_search;
+    romdatabase_parse_entry* entries = NULL;
+    romdatabase_parse_entry* search = NULL;
+    size_t entry_count = 0, entry_capacity = 0;
+    size_t counter, unique_count;
 
-    int counter, value, lineno;
-    unsigned char index;
-    const char *pathname = ConfigGetSharedDataFilepath("mupen64plus.ini");
-
-    if(g_romdatabase.have_database)
-        return;
+    int value, lineno;
 
     /* Open romdatabase. */
-    if (pathname == NULL || (fPtr = osal_file_open(pathname, "rb")) == NULL)
+    if ((fPtr = osal_file_open(pathname, "rb")) == NULL)
     {
         DebugMessage(M64MSG_ERROR, "Unable to open rom database file '%s'.", pathname);
-        return;
+        return NULL;
     }
 
-    g_romdatabase.have_database = 1;
-
-    /* Clear premade indices. */
-    for(counter = 0; counter < 255; ++counter)
-        g_romdatabase.crc_lists[counter] = NULL;
-    for(counter = 0; counter < 255; ++counter)
-        g_romdatabase.md5_lists[counter] = NULL;
-    g_romdatabase.list = NULL;
-
-    next_search = &g_romdatabase.list;
-
     /* Parse ROM database file */
     for (lineno = 1; fgets(buffer, 255, fPtr) != NULL; lineno++)
     {
@@ -631,11 +771,24 @@ void romdatabase_open(void)
                 continue;
             }
 
-            *next_search = (romdatabase_search*) malloc(sizeof(romdatabase_search));
-            search = *next_search;
-            next_search = &search->next_entry;
+            if (entry_count == entry_capacity)
+            {
+                size_t new_capacity = (entry_capacity == 0) ? 4096 : entry_capacity * 2;
+                romdatabase_parse_entry* new_entries = (romdatabase_parse_entry*) realloc(entries, new_capacity * sizeof(romdatabase_parse_entry));
+                if (new_entries == NULL)
+                {
+                    DebugMessage(M64MSG_ERROR, "ROM Database: Out of memory on line %i", lineno);
+                    romdatabase_parse_free(entries, entry_count);
+                    fclose(fPtr);
+                    return NULL;
+                }
+                entries = new_entries;
+                entry_capacity = new_capacity;
+            }
 
-            memset(search, 0, sizeof(romdatabase_search));
+            search = &entries[entry_count];
+            memset(search, 0, sizeof(romdatabase_parse_entry));
+            search->order = entry_count++;
 
             search->entry.goodname = NULL;
             memcpy(search->entry.md5, md5, 16);
@@ -655,13 +808,7 @@ void romdatabase_open(void)
             search->entry.sidmaduration = DEFAULT_SI_DMA_DURATION;
             search->entry.aidmamodifier = DEFAULT_AI_DMA_MODIFIER;
             search->entry.set_flags = ROMDATABASE_ENTRY_NONE;
-
-            search->next_entry = NULL;
-            search->next_crc = NULL;
-            /* Index MD5s by first 8 bits. */
-            index = search->entry.md5[0];
-            search->next_md5 = g_romdatabase.md5_lists[index];
-            g_romdatabase.md5_lists[index] = search;
+            search->has_crc = 0;
 
             break;
         }
@@ -684,10 +831,7 @@ void romdatabase_open(void)
                 if (sscanf(l.value, "%X %X%c", &search->entry.crc1,
                     &search->entry.crc2, &garbage_sweeper) == 2)
                 {
-                    /* Index CRCs by first 8 bits. */
-                    index = search->entry.crc1 >> 24;
-                    search->next_crc = g_romdatabase.crc_lists[index];
-                    g_romdatabase.crc_lists[index] = search;
+                    search->has_crc = 1;
                     search->entry.set_flags |= ROMDATABASE_ENTRY_CRC;
                 }
                 else
@@ -870,72 +1014,401 @@ void romdatabase_open(void)
     }
 
     fclose(fPtr);
-    romdatabase_resolve();
+
+    /* sort the entries by MD5, when an MD5 is in the database
+     * more than once, the last entry is used */
+    if (entry_count > 0)
+        qsort(entries, entry_count, sizeof(romdatabase_parse_entry), romdatabase_parse_entry_compare);
+    unique_count = 0;
+    for (counter = 0; counter < entry_count; ++counter)
+    {
+        if (counter + 1 < entry_count && memcmp(entries[counter].entry.md5, entries[counter + 1].entry.md5, 16) == 0)
+        {
+            DebugMessage(M64MSG_WARNING, "ROM Database: Duplicate MD5 entry");
+            free(entries[counter].entry.goodname);
+            free(entries[counter].entry.refmd5);
+            free(entries[counter].entry.cheats);
+            continue;
+        }
+        entries[unique_count++] = entries[counter];
+    }
+
+    romdatabase_resolve(entries, unique_count);
+
+    *count = unique_count;
+    return entries;
 }
 
-void romdatabase_close(void)
+static uint32_t romdatabase_add_string(char* strings, uint32_t* strings_size, const char* string)
 {
-    if (!g_romdatabase.have_database)
+    uint32_t offset = *strings_size;
+    size_t length;
+
+    if (string == NULL)
+        return ROMDATABASE_NO_STRING;
+
+    length = strlen(string) + 1;
+    memcpy(strings + offset, string, length);
+    *strings_size += (uint32_t)length;
+    return offset;
+}
+
+/* compiles the parsed entries into a ROM database image */
+static void* romdatabase_compile(romdatabase_parse_entry* entries, size_t count, uint64_t ini_size, int64_t ini_mtime, size_t* image_size)
+{
+    romdatabase_cache_header* header;
+    romdatabase_cache_entry* cache_entries;
+    romdatabase_crc_key* crc_keys;
+    uint32_t* crc_index;
+    char* strings;
+    size_t strings_size = 0, crc_count = 0, size, i;
+    uint8_t* image;
+
+    for (i = 0; i < count; i++)
+    {
+        if (entries[i].entry.goodname != NULL)
+            strings_size += strlen(entries[i].entry.goodname) + 1;
+        if (entries[i].entry.cheats != NULL)
+            strings_size += strlen(entries[i].entry.cheats) + 1;
+        if (entries[i].has_crc)
+            crc_count++;
+    }
+
+    if (strings_size >= ROMDATABASE_NO_STRING || count > UINT32_MAX)
+        return NULL;
+
+    size = sizeof(romdatabase_cache_header) +
+           count * sizeof(romdatabase_cache_entry) +
+           crc_count * sizeof(uint32_t) +
+           strings_size;
+
+    image = (uint8_t*) calloc(1, size);
+    crc_keys = (romdatabase_crc_key*) malloc((crc_count > 0 ? crc_count : 1) * sizeof(romdatabase_crc_key));
+    if (image == NULL || crc_keys == NULL)
+    {
+        free(image);
+        free(crc_keys);
+        return NULL;
+    }
+
+    header = (romdatabase_cache_header*) image;
+    cache_entries = (romdatabase_cache_entry*) (image + sizeof(romdatabase_cache_header));
+    crc_index = (uint32_t*) (cache_entries + count);
+    strings = (char*) (crc_index + crc_count);
+
+    header->magic = ROMDATABASE_CACHE_MAGIC;
+    header->version = ROMDATABASE_CACHE_VERSION;
+    header->ini_size = ini_size;
+    header->ini_mtime = ini_mtime;
+    header->entry_count = (uint32_t) count;
+    header->crc_count = (uint32_t) crc_count;
+    header->strings_size = 0;
+
+    crc_count = 0;
+    for (i = 0; i < count; i++)
+    {
+        const romdatabase_entry* entry = &entries[i].entry;
+        romdatabase_cache_entry* cache_entry = &cache_entries[i];
+
+        memcpy(cache_entry->md5, entry->md5, 16);
+        cache_entry->crc1 = entry->crc1;
+        cache_entry->crc2 = entry->crc2;
+        cache_entry->goodname = romdatabase_add_string(strings, &header->strings_size, entry->goodname);
+        cache_entry->cheats = romdatabase_add_string(strings, &header->strings_size, entry->cheats);
+        cache_entry->sidmaduration = entry->sidmaduration;
+        cache_entry->aidmamodifier = entry->aidmamodifier;
+        cache_entry->set_flags = entry->set_flags;
+        cache_entry->status = entry->status;
+        cache_entry->savetype = entry->savetype;
+        cache_entry->players = entry->players;
+        cache_entry->rumble = entry->rumble;
+        cache_entry->countperop = entry->countperop;
+        cache_entry->disableextramem = entry->disableextramem;
+        cache_entry->transferpak = entry->transferpak;
+        cache_entry->mempak = entry->mempak;
+        cache_entry->biopak = entry->biopak;
+
+        if (entries[i].has_crc)
+        {
+            crc_keys[crc_count].crc1 = entry->crc1;
+            crc_keys[crc_count].crc2 = entry->crc2;
+            crc_keys[crc_count].index = (uint32_t) i;
+            crc_count++;
+        }
+    }
+
+    if (crc_count > 0)
+        qsort(crc_keys, crc_count, sizeof(romdatabase_crc_key), romdatabase_crc_key_compare);
+    for (i = 0; i < crc_count; i++)
+        crc_index[i] = crc_keys[i].index;
+    free(crc_keys);
+
+    *image_size = size;
+    return image;
+}
+
+/* points the database at the image, returns 0 when the image isn't valid */
+static int romdatabase_load_image(const void* image, size_t image_size, uint64_t ini_size, int64_t ini_mtime)
+{
+    const romdatabase_cache_header* header = (const romdatabase_cache_header*) image;
+    const romdatabase_cache_entry* cache_entries;
+    const uint32_t* crc_index;
+    const char* strings;
+    romdatabase_entry* entries;
+    size_t i;
+
+    if (image_size < sizeof(romdatabase_cache_header) ||
+        header->magic != ROMDATABASE_CACHE_MAGIC ||
+        header->version != ROMDATABASE_CACHE_VERSION ||
+        header->ini_size != ini_size ||
+        header->ini_mtime != ini_mtime ||
+        header->crc_count > header->entry_count)
+        return 0;
+
+    if (image_size != sizeof(romdatabase_cache_header) +
+                      (size_t) header->entry_count * sizeof(romdatabase_cache_entry) +
+                      (size_t) header->crc_count * sizeof(uint32_t) +
+                      header->strings_size)
+        return 0;
+
+    cache_entries = (const romdatabase_cache_entry*) (header + 1);
+    crc_index = (const uint32_t*) (cache_entries + header->entry_count);
+    strings = (const char*) (crc_index + header->crc_count);
+
+    /* the strings have to be terminated for the offsets to be safe to use */
+    if (header->strings_size > 0 && strings[header->strings_size - 1] != '\0')
+        return 0;
+
+    entries = (romdatabase_entry*) malloc((header->entry_count > 0 ? header->entry_count : 1) * sizeof(romdatabase_entry));
+    if (entries == NULL)
+        return 0;
+
+    for (i = 0; i < header->entry_count; i++)
+    {
+        const romdatabase_cache_entry* cache_entry = &cache_entries[i];
+        romdatabase_entry* entry = &entries[i];
+
+        if ((i > 0 && memcmp(cache_entries[i - 1].md5, cache_entry->md5, 16) >= 0) ||
+            (cache_entry->goodname != ROMDATABASE_NO_STRING && cache_entry->goodname >= header->strings_size) ||
+            (cache_entry->cheats != ROMDATABASE_NO_STRING && cache_entry->cheats >= header->strings_size))
+        {
+            free(entries);
+            return 0;
+        }
+
+        memcpy(entry->md5, cache_entry->md5, 16);
+        entry->goodname = (cache_entry->goodname != ROMDATABASE_NO_STRING) ? (char*) strings + cache_entry->goodname : NULL;
+        entry->refmd5 = NULL;
+        entry->cheats = (cache_entry->cheats != ROMDATABASE_NO_STRING) ? (char*) strings + cache_entry->cheats : NULL;
+        entry->crc1 = cache_entry->crc1;
+        entry->crc2 = cache_entry->crc2;
+        entry->status = cache_entry->status;
+        entry->savetype = cache_entry->savetype;
+        entry->players = cache_entry->players;
+        entry->rumble = cache_entry->rumble;
+        entry->countperop = cache_entry->countperop;
+        entry->disableextramem = cache_entry->disableextramem;
+        entry->transferpak = cache_entry->transferpak;
+        entry->mempak = cache_entry->mempak;
+        entry->biopak = cache_entry->biopak;
+        entry->sidmaduration = cache_entry->sidmaduration;
+        entry->aidmamodifier = cache_entry->aidmamodifier;
+        entry->set_flags = cache_entry->set_flags;
+    }
+
+    for (i = 0; i < header->crc_count; i++)
+    {
+        if (crc_index[i] >= header->entry_count)
+        {
+            free(entries);
+            return 0;
+        }
+    }
+
+    g_romdatabase.entries = entries;
+    g_romdatabase.entry_count = header->entry_count;
+    g_romdatabase.crc_index = crc_index;
+    g_romdatabase.crc_count = header->crc_count;
+    g_romdatabase.image = image;
+    g_romdatabase.image_size = image_size;
+    g_romdatabase.have_database = 1;
+    return 1;
+}
+
+/* writes the image to a temporary file first, so a
+ * partially written cache is never mapped */
+static void romdatabase_write_cache(const char* cachepath, const void* image, size_t image_size)
+{
+    char* temppath;
+    FILE* fPtr;
+    int failed;
+
+    temppath = formatstr("%s.tmp", cachepath);
+    if (temppath == NULL)
         return;
 
-    while (g_romdatabase.list != NULL)
+    fPtr = osal_file_open(temppath, "wb");
+    if (fPtr == NULL)
+    {
+        DebugMessage(M64MSG_WARNING, "Unable to write rom database cache '%s'.", temppath);
+        free(temppath);
+        return;
+    }
+
+    failed = fwrite(image, 1, image_size, fPtr) != image_size;
+    failed |= fclose(fPtr) != 0;
+
+    if (failed || osal_file_replace(temppath, cachepath) != 0)
+    {
+        DebugMessage(M64MSG_WARNING, "Unable to write rom database cache '%s'.", cachepath);
+        remove(temppath);
+    }
+
+    free(temppath);
+}
+
+void romdatabase_open(void)
+{
+    const char *pathname = ConfigGetSharedDataFilepath("mupen64plus.ini");
+    const char *cachedir;
+    char *cachepath = NULL;
+    romdatabase_parse_entry* entries;
+    size_t entry_count;
+    uint64_t ini_size;
+    int64_t ini_mtime;
+    const void* image;
+    size_t image_size;
+
+    if(g_romdatabase.have_database)
+        return;
+
+    if (pathname == NULL || osal_file_info(pathname, &ini_size, &ini_mtime) != 0)
+    {
+        DebugMessage(M64MSG_ERROR, "Unable to open rom database file '%s'.", pathname);
+        return;
+    }
+
+    /* use the compiled database when it's up to date */
+    cachedir = ConfigGetUserCachePath();
+    if (cachedir != NULL)
+        cachepath = combinepath(cachedir, ROMDATABASE_CACHE_NAME);
+    if (cachepath != NULL)
+    {
+        image = osal_file_map(cachepath, &image_size);
+        if (image != NULL)
         {
-        romdatabase_search* search = g_romdatabase.list->next_entry;
-        if(g_romdatabase.list->entry.goodname)
-            free(g_romdatabase.list->entry.goodname);
-        if(g_romdatabase.list->entry.refmd5)
-            free(g_romdatabase.list->entry.refmd5);
-        free(g_romdatabase.list->entry.cheats);
-        free(g_romdatabase.list);
-        g_romdatabase.list = search;
+            if (romdatabase_load_image(image, image_size, ini_size, ini_mtime))
+            {
+                g_romdatabase.image_mapped = 1;
+                free(cachepath);
+                return;
+            }
+            osal_file_unmap(image, image_size);
         }
+    }
+
+    entries = romdatabase_parse_ini(pathname, &entry_count);
+    if (entries == NULL)
+    {
+        free(cachepath);
+        return;
+    }
+
+    image = romdatabase_compile(entries, entry_count, ini_size, ini_mtime, &image_size);
+    romdatabase_parse_free(entries, entry_count);
+    if (image == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "Unable to compile rom database.");
+        free(cachepath);
+        return;
+    }
+
+    if (cachepath != NULL)
+        romdatabase_write_cache(cachepath, image, image_size);
+    free(cachepath);
 
-    g_romdatabase.have_database = 0;
+    if (!romdatabase_load_image(image, image_size, ini_size, ini_mtime))
+    {
+        DebugMessage(M64MSG_ERROR, "Unable to load rom database.");
+        free((void*) image);
+        return;
+    }
+    g_romdatabase.image_mapped = 0;
 }
 
-static romdatabase_entry* ini_search_by_md5(md5_byte_t* md5)
+void romdatabase_close(void)
 {
-    romdatabase_search* search;
+    if (!g_romdatabase.have_database)
+        return;
 
-    if(!g_romdatabase.have_database)
-        return NULL;
+    free(g_romdatabase.entries);
+    if (g_romdatabase.image_mapped)
+        osal_file_unmap(g_romdatabase.image, g_romdatabase.image_size);
+    else
+        free((void*) g_romdatabase.image);
 
-    search = g_romdatabase.md5_lists[md5[0]];
+    memset(&g_romdatabase, 0, sizeof(g_romdatabase));
+}
 
-    while (search != NULL && memcmp(search->entry.md5, md5, 16) != 0)
-        search = search->next_md5;
+static romdatabase_entry* ini_search_by_md5(md5_byte_t* md5)
+{
+    size_t low = 0, high;
 
-    if(search==NULL)
+    if(!g_romdatabase.have_database)
         return NULL;
 
-    return &(search->entry);
+    high = g_romdatabase.entry_count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        int result = memcmp(g_romdatabase.entries[mid].md5, md5, 16);
+        if (result == 0)
+            return &g_romdatabase.entries[mid];
+        if (result < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return NULL;
 }
 
 romdatabase_entry* ini_search_by_crc(unsigned int crc1, unsigned int crc2)
 {
-    romdatabase_search* search;
-    romdatabase_entry* found_entry = NULL;
+    romdatabase_entry* entry;
+    size_t low = 0, high;
 
-    if(!g_romdatabase.have_database) 
+    if(!g_romdatabase.have_database)
         return NULL;
 
-    search = g_romdatabase.crc_lists[((crc1 >> 24) & 0xff)];
+    /* find the first entry with this CRC */
+    high = g_romdatabase.crc_count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        entry = &g_romdatabase.entries[g_romdatabase.crc_index[mid]];
+        if (entry->crc1 < crc1 || (entry->crc1 == crc1 && entry->crc2 < crc2))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == g_romdatabase.crc_count)
+        return NULL;
+
+    entry = &g_romdatabase.entries[g_romdatabase.crc_index[low]];
+    if (entry->crc1 != crc1 || entry->crc2 != crc2)
+        return NULL;
 
     // because CRCs can be ambiguous (there can be multiple database entries with the same CRC),
     // we will prefer MD5 hashes instead. If the given CRC matches more than one entry in the
     // database, we will return no match.
-    while (search != NULL)
+    if (low + 1 < g_romdatabase.crc_count)
     {
-        if (search->entry.crc1 == crc1 && search->entry.crc2 == crc2)
-        {
-            if (found_entry != NULL)
-                return NULL;
-            found_entry = &search->entry;
-        }
-        search = search->next_crc;
+        const romdatabase_entry* next_entry = &g_romdatabase.entries[g_romdatabase.crc_index[low + 1]];
+        if (next_entry->crc1 == crc1 && next_entry->crc2 == crc2)
+            return NULL;
     }
 
-    return found_entry;
+    return entry;
 }
-
-
@@ -24,6 +24,7 @@
 #define __ROM_H__
 
 #include <md5.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "api/m64p_types.h"
@@ -136,20 +137,21 @@ typedef struct
 #define ROMDATABASE_ENTRY_SIDMADURATION BIT(12)
 #define ROMDATABASE_ENTRY_AIDMAMODIFIER BIT(13)
 
-typedef struct _romdatabase_search
-{
-    romdatabase_entry entry;
-    struct _romdatabase_search* next_entry;
-    struct _romdatabase_search* next_crc;
-    struct _romdatabase_search* next_md5;
-} romdatabase_search;
-
+/* The ROM database is compiled from mupen64plus.ini into a flat image, which is
+ * cached in the user cache directory, so it only has to be parsed again when
+ * mupen64plus.ini changes. The entries are sorted by MD5 and are looked up
+ * with a binary search, the goodnames and cheats point into the image.
+ */
 typedef struct
 {
     int have_database;
-    romdatabase_search* crc_lists[256];
-    romdatabase_search* md5_lists[256];
-    romdatabase_search* list;
+    romdatabase_entry* entries; /* sorted by MD5 */
+    size_t entry_count;
+    const uint32_t* crc_index; /* indices of the entries with a CRC, sorted by CRC */
+    size_t crc_count;
+    const void* image;
+    size_t image_size;
+    int image_mapped;
 } _romdatabase;
 
 void romdatabase_open(void);
@@ -159,5 +161,14 @@ void romdatabase_close(void);
  */
 romdatabase_entry* ini_search_by_crc(unsigned int crc1, unsigned int crc2);
 
+/* Fills in the MD5, goodname and settings of a ROM from the ROM database
+ * without opening it, header is the ROM header in N64 native byte order
+ * and md5 the 16 byte MD5 digest of the whole ROM in N64 native byte order.
+ * The database is only read, so this can be called from any thread after
+ * CoreStartup. Returns 1 when the ROM is in the database, 0 when the
+ * defaults have been filled in.
+ */
+EXPORT int CALL romdatabase_lookup_rom(const void* header, const unsigned char* md5, m64p_rom_settings* settings);
+
 #endif /* __ROM_H__ */
 
@@ -70,6 +70,10 @@ static savestates_job job = savestates_job_nothing;
 static savestates_type type = savestates_type_unknown;
 static char *fname = NULL;
 
+static savestates_job memory_job = savestates_job_nothing;
+static void *memory_buffer = NULL;
+static size_t memory_size = 0;
+
 static unsigned int slot = 0;
 static int autoinc_save_slot = 0;
 
@@ -179,6 +183,18 @@ static void savestates_clear_job(void)
     savestates_set_job(savestates_job_nothing, savestates_type_unknown, NULL);
 }
 
+savestates_job savestates_get_memory_job(void)
+{
+    return memory_job;
+}
+
+void savestates_set_memory_job(savestates_job j, void *buffer, size_t size)
+{
+    memory_buffer = buffer;
+    memory_size = size;
+    memory_job = j;
+}
+
 #define GETARRAY(buff, type, count) \
     (to_little_endian_buffer(buff, sizeof(type),count), \
      buff += count*sizeof(type), \
@@ -194,125 +210,17 @@ static void savestates_clear_job(void)
 #define PUTDATA(buff, type, value) \
     do { type x = value; PUTARRAY(&x, buff, type, 1); } while(0)
 
-static int savestates_load_m64p(struct device* dev, char *filepath)
+/* Restores the device from the uncompressed m64p savestate data which
+ * follows the 44 byte header, the event queue, using_tlb flags and the
+ * extra state from v1.2 are passed separately as older versions lack them */
+static void savestates_load_m64p_data(struct device* dev, unsigned int version, unsigned char *curr,
+                                      char *queue, unsigned char *using_tlb_data, unsigned char *data_0001_0200)
 {
-    unsigned char header[44];
-    gzFile f;
-    unsigned int version;
     int i;
     uint32_t FCR31;
 
-    size_t savestateSize;
-    unsigned char *savestateData, *curr;
-    char queue[1024];
-    unsigned char using_tlb_data[4];
-    unsigned char data_0001_0200[4096]; // 4k for extra state from v1.2
-
     uint32_t* cp0_regs = r4300_cp0_regs(&dev->r4300.cp0);
 
-    SDL_LockMutex(savestates_lock);
-
-    f = osal_gzopen(filepath, "rb");
-    if(f==NULL)
-    {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not open state file: %s", filepath);
-        SDL_UnlockMutex(savestates_lock);
-        return 0;
-    }
-
-    /* Read and check Mupen64Plus magic number. */
-    if (gzread(f, header, 44) != 44)
-    {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read header from state file %s", filepath);
-        gzclose(f);
-        SDL_UnlockMutex(savestates_lock);
-        return 0;
-    }
-    curr = header;
-
-    if(strncmp((char *)curr, savestate_magic, 8)!=0)
-    {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State file: %s is not a valid Mupen64plus savestate.", filepath);
-        gzclose(f);
-        SDL_UnlockMutex(savestates_lock);
-        return 0;
-    }
-    curr += 8;
-
-    version = *curr++;
-    version = (version << 8) | *curr++;
-    version = (version << 8) | *curr++;
-    version = (version << 8) | *curr++;
-    if((version >> 16) != (savestate_latest_version >> 16))
-    {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State version (%08x) isn't compatible. Please update Mupen64Plus.", version);
-        gzclose(f);
-        SDL_UnlockMutex(savestates_lock);
-        return 0;
-    }
-
-    if(memcmp((char *)curr, ROM_SETTINGS.MD5, 32))
-    {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State ROM MD5 does not match current ROM.");
-        gzclose(f);
-        SDL_UnlockMutex(savestates_lock);
-        return 0;
-    }
-    curr += 32;
-
-    /* Read the rest of the savestate */
-    savestateSize = 16788244;
-    savestateData = curr = (unsigned char *)malloc(savestateSize);
-    if (savestateData == NULL)
-    {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to load state.");
-        gzclose(f);
-        SDL_UnlockMutex(savestates_lock);
-        return 0;
-    }
-    if (version == 0x00010000) /* original savestate version */
-    {
-        if (gzread(f, savestateData, savestateSize) != (int)savestateSize ||
-            (gzread(f, queue, sizeof(queue)) % 4) != 0)
-        {
-            main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read Mupen64Plus savestate 1.0 data from %s", filepath);
-            free(savestateData);
-            gzclose(f);
-            SDL_UnlockMutex(savestates_lock);
-            return 0;
-        }
-    }
-    else if (version == 0x00010100) // saves entire eventqueue plus 4-byte using_tlb flags
-    {
-        if (gzread(f, savestateData, savestateSize) != (int)savestateSize ||
-            gzread(f, queue, sizeof(queue)) != sizeof(queue) ||
-            gzread(f, using_tlb_data, sizeof(using_tlb_data)) != sizeof(using_tlb_data))
-        {
-            main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read Mupen64Plus savestate 1.1 data from %s", filepath);
-            free(savestateData);
-            gzclose(f);
-            SDL_UnlockMutex(savestates_lock);
-            return 0;
-        }
-    }
-    else // version >= 0x00010200  saves entire eventqueue, 4-byte using_tlb flags and extra state
-    {
-        if (gzread(f, savestateData, savestateSize) != (int)savestateSize ||
-            gzread(f, queue, sizeof(queue)) != sizeof(queue) ||
-            gzread(f, using_tlb_data, sizeof(using_tlb_data)) != sizeof(using_tlb_data) ||
-            gzread(f, data_0001_0200, sizeof(data_0001_0200)) != sizeof(data_0001_0200))
-        {
-            main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read Mupen64Plus savestate 1.2+ data from %s", filepath);
-            free(savestateData);
-            gzclose(f);
-            SDL_UnlockMutex(savestates_lock);
-            return 0;
-        }
-    }
-
-    gzclose(f);
-    SDL_UnlockMutex(savestates_lock);
-
     // Parse savestate
     dev->rdram.regs[0][RDRAM_CONFIG_REG]       = GETDATA(curr, uint32_t);
     dev->rdram.regs[0][RDRAM_DEVICE_ID_REG]    = GETDATA(curr, uint32_t);
@@ -439,6 +347,7 @@ static int savestates_load_m64p(struct device* dev, char *filepath)
 
     COPYARRAY(dev->r4300.cp0.tlb.LUT_r, curr, uint32_t, 0x100000);
     COPYARRAY(dev->r4300.cp0.tlb.LUT_w, curr, uint32_t, 0x100000);
+    memset(dev->r4300.cp0.tlb.LUT_dirty, 1, TLB_LUT_DIRTY_PAGES_COUNT);
 
     *r4300_llbit(&dev->r4300) = GETDATA(curr, uint32_t);
     COPYARRAY(r4300_regs(&dev->r4300), curr, int64_t, 32);
@@ -969,6 +878,124 @@ static int savestates_load_m64p(struct device* dev, char *filepath)
     dev->r4300.cp0.interrupt_unsafe_state = 0;
 
     *r4300_cp0_last_addr(&dev->r4300.cp0) = *r4300_pc(&dev->r4300);
+}
+
+static int savestates_load_m64p(struct device* dev, char *filepath)
+{
+    unsigned char header[44];
+    gzFile f;
+    unsigned int version;
+
+    size_t savestateSize;
+    unsigned char *savestateData, *curr;
+    char queue[1024];
+    unsigned char using_tlb_data[4];
+    unsigned char data_0001_0200[4096]; // 4k for extra state from v1.2
+
+    SDL_LockMutex(savestates_lock);
+
+    f = osal_gzopen(filepath, "rb");
+    if(f==NULL)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not open state file: %s", filepath);
+        SDL_UnlockMutex(savestates_lock);
+        return 0;
+    }
+
+    /* Read and check Mupen64Plus magic number. */
+    if (gzread(f, header, 44) != 44)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read header from state file %s", filepath);
+        gzclose(f);
+        SDL_UnlockMutex(savestates_lock);
+        return 0;
+    }
+    curr = header;
+
+    if(strncmp((char *)curr, savestate_magic, 8)!=0)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State file: %s is not a valid Mupen64plus savestate.", filepath);
+        gzclose(f);
+        SDL_UnlockMutex(savestates_lock);
+        return 0;
+    }
+    curr += 8;
+
+    version = *curr++;
+    version = (version << 8) | *curr++;
+    version = (version << 8) | *curr++;
+    version = (version << 8) | *curr++;
+    if((version >> 16) != (savestate_latest_version >> 16))
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State version (%08x) isn't compatible. Please update Mupen64Plus.", version);
+        gzclose(f);
+        SDL_UnlockMutex(savestates_lock);
+        return 0;
+    }
+
+    if(memcmp((char *)curr, ROM_SETTINGS.MD5, 32))
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State ROM MD5 does not match current ROM.");
+        gzclose(f);
+        SDL_UnlockMutex(savestates_lock);
+        return 0;
+    }
+    curr += 32;
+
+    /* Read the rest of the savestate */
+    savestateSize = 16788244;
+    savestateData = curr = (unsigned char *)malloc(savestateSize);
+    if (savestateData == NULL)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to load state.");
+        gzclose(f);
+        SDL_UnlockMutex(savestates_lock);
+        return 0;
+    }
+    if (version == 0x00010000) /* original savestate version */
+    {
+        if (gzread(f, savestateData, savestateSize) != (int)savestateSize ||
+            (gzread(f, queue, sizeof(queue)) % 4) != 0)
+        {
+            main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read Mupen64Plus savestate 1.0 data from %s", filepath);
+            free(savestateData);
+            gzclose(f);
+            SDL_UnlockMutex(savestates_lock);
+            return 0;
+        }
+    }
+    else if (version == 0x00010100) // saves entire eventqueue plus 4-byte using_tlb flags
+    {
+        if (gzread(f, savestateData, savestateSize) != (int)savestateSize ||
+            gzread(f, queue, sizeof(queue)) != sizeof(queue) ||
+            gzread(f, using_tlb_data, sizeof(using_tlb_data)) != sizeof(using_tlb_data))
+        {
+            main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read Mupen64Plus savestate 1.1 data from %s", filepath);
+            free(savestateData);
+            gzclose(f);
+            SDL_UnlockMutex(savestates_lock);
+            return 0;
+        }
+    }
+    else // version >= 0x00010200  saves entire eventqueue, 4-byte using_tlb flags and extra state
+    {
+        if (gzread(f, savestateData, savestateSize) != (int)savestateSize ||
+            gzread(f, queue, sizeof(queue)) != sizeof(queue) ||
+            gzread(f, using_tlb_data, sizeof(using_tlb_data)) != sizeof(using_tlb_data) ||
+            gzread(f, data_0001_0200, sizeof(data_0001_0200)) != sizeof(data_0001_0200))
+        {
+            main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Could not read Mupen64Plus savestate 1.2+ data from %s", filepath);
+            free(savestateData);
+            gzclose(f);
+            SDL_UnlockMutex(savestates_lock);
+            return 0;
+        }
+    }
+
+    gzclose(f);
+    SDL_UnlockMutex(savestates_lock);
+
+    savestates_load_m64p_data(dev, version, savestateData, queue, using_tlb_data, data_0001_0200);
 
     free(savestateData);
     main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State loaded from: %s", namefrompath(filepath));
@@ -1199,6 +1226,7 @@ static int savestates_load_pj64(struct device* dev,
     // tlb
     memset(dev->r4300.cp0.tlb.LUT_r, 0, 0x400000);
     memset(dev->r4300.cp0.tlb.LUT_w, 0, 0x400000);
+    memset(dev->r4300.cp0.tlb.LUT_dirty, 1, TLB_LUT_DIRTY_PAGES_COUNT);
     for (i=0; i < 32; i++)
     {
         unsigned int MyPageMask, MyEntryHi, MyEntryLo0, MyEntryLo1;
@@ -1533,48 +1561,24 @@ static void savestates_save_m64p_work(struct work_struct *work)
     StateChanged(M64CORE_STATE_SAVECOMPLETE, 1);
 }
 
-static int savestates_save_m64p(const struct device* dev, char *filepath)
+/* Writes the uncompressed m64p savestate (header included) to data,
+ * which has to be at least SAVESTATE_M64P_SIZE bytes, when skip_bulk
+ * is set RDRAM and the TLB lookup tables are left untouched, returns 0
+ * when the layout doesn't match the offsets in savestates.h */
+static int savestates_save_m64p_data(const struct device* dev, char *data, int skip_bulk)
 {
     unsigned char outbuf[4];
+    int layout_ok = 1;
     int i;
 
     char queue[1024];
-
-    struct savestate_work *save;
-    char *curr;
+    char *curr = data;
 
     /* OK to cast away const qualifier */
     const uint32_t* cp0_regs = r4300_cp0_regs((struct cp0*)&dev->r4300.cp0);
 
-    save = malloc(sizeof(*save));
-    if (!save) {
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to save state.");
-        StateChanged(M64CORE_STATE_SAVECOMPLETE, 0);
-        return 0;
-    }
-
-    save->filepath = strdup(filepath);
-
-    if(autoinc_save_slot)
-        savestates_inc_slot();
-
     save_eventqueue_infos(&dev->r4300.cp0, queue);
 
-    // Allocate memory for the save state data
-    save->size = 16788288 + sizeof(queue) + 4 + 4096;
-    save->data = curr = malloc(save->size);
-    if (save->data == NULL)
-    {
-        free(save->filepath);
-        free(save);
-        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to save state.");
-        StateChanged(M64CORE_STATE_SAVECOMPLETE, 0);
-        return 0;
-    }
-
-    memset(save->data, 0, save->size);
-
-    // Write the save state data to memory
     PUTARRAY(savestate_magic, curr, unsigned char, 8);
 
     outbuf[0] = (savestate_latest_version >> 24) & 0xff;
@@ -1725,15 +1729,39 @@ static int savestates_save_m64p(const struct device* dev, char *filepath)
     PUTDATA(curr, uint32_t, dev->dp.dps_regs[DPS_BUFTEST_ADDR_REG]);
     PUTDATA(curr, uint32_t, dev->dp.dps_regs[DPS_BUFTEST_DATA_REG]);
 
-    PUTARRAY(dev->rdram.dram, curr, uint32_t, RDRAM_MAX_SIZE/4);
+    /* the delta snapshots copy RDRAM and the TLB lookup
+     * tables from these offsets, so they have to match */
+    if ((curr - data) != SAVESTATE_M64P_RDRAM_OFFSET)
+    {
+        DebugMessage(M64MSG_ERROR, "savestate RDRAM is at offset %d instead of SAVESTATE_M64P_RDRAM_OFFSET", (int)(curr - data));
+        layout_ok = 0;
+    }
+
+    if (skip_bulk)
+        curr += RDRAM_MAX_SIZE;
+    else
+    {
+        PUTARRAY(dev->rdram.dram, curr, uint32_t, RDRAM_MAX_SIZE/4);
+    }
     PUTARRAY(dev->sp.mem, curr, uint32_t, SP_MEM_SIZE/4);
     PUTARRAY(dev->pif.ram, curr, uint8_t, PIF_RAM_SIZE);
 
     PUTDATA(curr, int32_t, dev->cart.use_flashram);
     curr += 4+8+4+4; // Here used to be flashram state
 
-    PUTARRAY(dev->r4300.cp0.tlb.LUT_r, curr, uint32_t, 0x100000);
-    PUTARRAY(dev->r4300.cp0.tlb.LUT_w, curr, uint32_t, 0x100000);
+    if ((curr - data) != SAVESTATE_M64P_LUT_OFFSET)
+    {
+        DebugMessage(M64MSG_ERROR, "savestate TLB LUT is at offset %d instead of SAVESTATE_M64P_LUT_OFFSET", (int)(curr - data));
+        layout_ok = 0;
+    }
+
+    if (skip_bulk)
+        curr += SAVESTATE_M64P_LUT_SIZE;
+    else
+    {
+        PUTARRAY(dev->r4300.cp0.tlb.LUT_r, curr, uint32_t, 0x100000);
+        PUTARRAY(dev->r4300.cp0.tlb.LUT_w, curr, uint32_t, 0x100000);
+    }
 
     /* OK to cast away const qualifier */
     PUTDATA(curr, uint32_t, *r4300_llbit((struct r4300_core*)&dev->r4300));
@@ -1936,6 +1964,41 @@ static int savestates_save_m64p(const struct device* dev, char *filepath)
     PUTDATA(curr, uint32_t, dev->sp.first_run);
     PUTDATA(curr, uint32_t, dev->sp.rsp_wait);
 
+    return layout_ok;
+}
+
+static int savestates_save_m64p(const struct device* dev, char *filepath)
+{
+    struct savestate_work *save;
+
+    save = malloc(sizeof(*save));
+    if (!save) {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to save state.");
+        StateChanged(M64CORE_STATE_SAVECOMPLETE, 0);
+        return 0;
+    }
+
+    save->filepath = strdup(filepath);
+
+    if(autoinc_save_slot)
+        savestates_inc_slot();
+
+    // Allocate memory for the save state data
+    save->size = SAVESTATE_M64P_SIZE;
+    save->data = malloc(save->size);
+    if (save->data == NULL)
+    {
+        free(save->filepath);
+        free(save);
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to save state.");
+        StateChanged(M64CORE_STATE_SAVECOMPLETE, 0);
+        return 0;
+    }
+
+    memset(save->data, 0, save->size);
+
+    savestates_save_m64p_data(dev, save->data, 0);
+
     init_work(&save->work, savestates_save_m64p_work);
     queue_work(&save->work);
 
@@ -2220,6 +2283,64 @@ int savestates_save(void)
     return ret;
 }
 
+int savestates_save_m64p_memory(void *data, size_t size, int skip_bulk)
+{
+    if (data == NULL || size < SAVESTATE_M64P_SIZE)
+        return 0;
+
+    return savestates_save_m64p_data(&g_dev, (char *)data, skip_bulk);
+}
+
+int savestates_load_m64p_memory(void *data, size_t size)
+{
+    unsigned char *curr = (unsigned char *)data;
+    unsigned int version;
+
+    if (data == NULL || size < SAVESTATE_M64P_SIZE)
+        return 0;
+
+    if (strncmp((char *)curr, savestate_magic, 8) != 0)
+        return 0;
+    curr += 8;
+
+    version = *curr++;
+    version = (version << 8) | *curr++;
+    version = (version << 8) | *curr++;
+    version = (version << 8) | *curr++;
+    if (version != savestate_latest_version)
+        return 0;
+
+    if (memcmp((char *)curr, ROM_SETTINGS.MD5, 32) != 0)
+        return 0;
+    curr += 32;
+
+    savestates_load_m64p_data(&g_dev, version, curr,
+                              (char *)(curr + 16788244),
+                              curr + 16788244 + 1024,
+                              curr + 16788244 + 1024 + 4);
+    return 1;
+}
+
+/* Memory savestates skip compression and the workqueue, the caller
+ * provided buffer is written directly so nothing is allocated */
+int savestates_load_memory(void)
+{
+    int ret = savestates_load_m64p_memory(memory_buffer, memory_size);
+
+    StateChanged(M64CORE_STATE_MEMORY_LOADCOMPLETE, ret);
+    savestates_set_memory_job(savestates_job_nothing, NULL, 0);
+    return ret;
+}
+
+int savestates_save_memory(void)
+{
+    int ret = savestates_save_m64p_memory(memory_buffer, memory_size, 0);
+
+    StateChanged(M64CORE_STATE_MEMORY_SAVECOMPLETE, ret);
+    savestates_set_memory_job(savestates_job_nothing, NULL, 0);
+    return ret;
+}
+
 void savestates_init(void)
 {
     savestates_lock = SDL_CreateMutex();
@@ -2233,4 +2354,5 @@ void savestates_deinit(void)
 {
     SDL_DestroyMutex(savestates_lock);
     savestates_clear_job();
+    savestates_set_memory_job(savestates_job_nothing, NULL, 0);
 }
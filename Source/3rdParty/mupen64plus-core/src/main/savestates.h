@@ -25,6 +25,8 @@
 #ifndef __SAVESTAVES_H__
 #define __SAVESTAVES_H__
 
+#include <stddef.h>
+
 typedef enum _savestates_job
 {
     savestates_job_nothing,
@@ -40,13 +42,36 @@ typedef enum _savestates_type
     savestates_type_pj64_unc
 } savestates_type;
 
+/* size of an uncompressed m64p savestate, header included */
+enum { SAVESTATE_M64P_SIZE = 16788288 + 1024 + 4 + 4096 };
+
+/* RDRAM follows the 44 byte header and 400 bytes of device registers, the
+ * TLB lookup tables follow RDRAM, SP memory, PIF RAM and 24 bytes of
+ * flashram state, the delta snapshots copy both page by page,
+ * savestates_save_m64p_data() checks that these match what it writes */
+enum { SAVESTATE_M64P_HEADER_SIZE = 44 };
+enum { SAVESTATE_M64P_REGS_SIZE = 400 };
+enum { SAVESTATE_M64P_RDRAM_OFFSET = SAVESTATE_M64P_HEADER_SIZE + SAVESTATE_M64P_REGS_SIZE };
+enum { SAVESTATE_M64P_LUT_OFFSET = SAVESTATE_M64P_RDRAM_OFFSET + 0x800000 + 0x2000 + 0x40 + 24 };
+enum { SAVESTATE_M64P_LUT_SIZE = 2 * 0x400000 };
+
 savestates_job savestates_get_job(void);
 void savestates_set_job(savestates_job j, savestates_type t, const char *fn);
+savestates_job savestates_get_memory_job(void);
+void savestates_set_memory_job(savestates_job j, void *buffer, size_t size);
 void savestates_init(void);
 void savestates_deinit(void);
 
 int savestates_load(void);
 int savestates_save(void);
+int savestates_load_memory(void);
+int savestates_save_memory(void);
+
+/* uncompressed m64p savestates in memory, both are only safe
+ * to call from the emulation thread when not in an unsafe state,
+ * skip_bulk leaves RDRAM and the TLB lookup tables in data untouched */
+int savestates_save_m64p_memory(void *data, size_t size, int skip_bulk);
+int savestates_load_m64p_memory(void *data, size_t size);
 
 void savestates_select_slot(unsigned int s);
 unsigned int savestates_get_slot(void);
@@ -0,0 +1,82 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - sync_snapshot.c                                         *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+
+#include "sync_snapshot.h"
+
+#include "device/device.h"
+#include "main/main.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#define PUTARRAY(src, buff, type, count) \
+    memcpy(buff, src, sizeof(type)*count); \
+    buff += count*sizeof(type);
+
+/* writes the CPU registers padded to SYNC_SNAPSHOT_CPU_SIZE bytes */
+static void copy_cpu_registers(unsigned char *curr)
+{
+    struct r4300_core* r4300 = &g_dev.r4300;
+
+    memset(curr, 0, SYNC_SNAPSHOT_CPU_SIZE);
+    PUTARRAY(r4300_regs(r4300), curr, int64_t, 32);
+    PUTARRAY(r4300_mult_hi(r4300), curr, int64_t, 1);
+    PUTARRAY(r4300_mult_lo(r4300), curr, int64_t, 1);
+    PUTARRAY(r4300_pc(r4300), curr, uint32_t, 1);
+    PUTARRAY(r4300_llbit(r4300), curr, uint32_t, 1);
+    PUTARRAY(r4300_cp0_regs(&r4300->cp0), curr, uint32_t, CP0_REGS_COUNT);
+    PUTARRAY(&r4300_cp1_regs(&r4300->cp1)->dword, curr, int64_t, 32);
+    PUTARRAY(r4300_cp1_fcr0(&r4300->cp1), curr, uint32_t, 1);
+    PUTARRAY(r4300_cp1_fcr31(&r4300->cp1), curr, uint32_t, 1);
+}
+
+size_t sync_snapshot_copy(void *buffer, size_t size)
+{
+    size_t required = SYNC_SNAPSHOT_CPU_SIZE + SYNC_SNAPSHOT_DMEM_SIZE + g_dev.rdram.dram_size;
+    unsigned char *curr = (unsigned char *)buffer;
+
+    if (buffer == NULL || size < required)
+        return required;
+
+    copy_cpu_registers(curr);
+
+    curr += SYNC_SNAPSHOT_CPU_SIZE;
+    PUTARRAY(g_dev.sp.mem, curr, uint32_t, SYNC_SNAPSHOT_DMEM_SIZE/4);
+    PUTARRAY(g_dev.rdram.dram, curr, uint32_t, g_dev.rdram.dram_size/4);
+
+    return required;
+}
+
+void sync_snapshot_hash(uint64_t *cpu, uint64_t *rsp, uint64_t *rdram)
+{
+    unsigned char registers[SYNC_SNAPSHOT_CPU_SIZE];
+
+    copy_cpu_registers(registers);
+
+    *cpu   = XXH3_64bits(registers, SYNC_SNAPSHOT_CPU_SIZE);
+    *rsp   = XXH3_64bits(g_dev.sp.mem, SYNC_SNAPSHOT_DMEM_SIZE);
+    *rdram = XXH3_64bits(g_dev.rdram.dram, g_dev.rdram.dram_size);
+}
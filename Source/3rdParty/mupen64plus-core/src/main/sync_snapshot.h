@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - sync_snapshot.h                                         *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+
+#ifndef M64P_MAIN_SYNC_SNAPSHOT_H
+#define M64P_MAIN_SYNC_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api/m64p_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The state which is hashed by RMG-Core to find netplay desyncs,
+ * the CPU registers are padded to SYNC_SNAPSHOT_CPU_SIZE bytes and
+ * followed by RSP DMEM and the installed RDRAM
+ */
+enum { SYNC_SNAPSHOT_CPU_SIZE = 0x400 };
+enum { SYNC_SNAPSHOT_DMEM_SIZE = 0x1000 };
+
+/* Copies the state into buffer and returns the amount of bytes which are
+ * needed, nothing is copied when size is smaller than that (call this from
+ * the frame callback, the state isn't consistent from another thread)
+ */
+EXPORT size_t CALL sync_snapshot_copy(void *buffer, size_t size);
+
+/* Hashes the CPU registers, RSP DMEM and the installed RDRAM of the state
+ * in place with XXH3, the hashes match the ones of the same parts of a
+ * snapshot copied by sync_snapshot_copy() (call this from the frame callback)
+ */
+EXPORT void CALL sync_snapshot_hash(uint64_t *cpu, uint64_t *rsp, uint64_t *rdram);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
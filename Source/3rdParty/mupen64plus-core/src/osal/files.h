@@ -26,6 +26,8 @@
 #if !defined (OSAL_FILES_H)
 #define OSAL_FILES_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <zlib.h>
 
 /* some file-related preprocessor definitions */
@@ -67,5 +69,21 @@ extern const char * osal_get_user_cachepath(void);
 extern FILE * osal_file_open (const char *filename, const char *mode);
 extern gzFile osal_gzopen(const char *filename, const char *mode);
 
+/* Replaces newpath with oldpath, when newpath exists it's atomically replaced.
+ * Returns zero on success, nonzero on failure.
+ */
+extern int osal_file_replace(const char *oldpath, const char *newpath);
+
+/* Retrieves the size and the modification time of a file.
+ * Returns zero on success, nonzero on failure.
+ */
+extern int osal_file_info(const char *filename, uint64_t *size, int64_t *mtime);
+
+/* Maps a whole file read-only into memory, the size of the mapping is stored in size.
+ * Returns NULL on failure, the mapping has to be released with osal_file_unmap().
+ */
+extern const void * osal_file_map(const char *filename, size_t *size);
+extern void osal_file_unmap(const void *data, size_t size);
+
 #endif /* OSAL_FILES_H */
 
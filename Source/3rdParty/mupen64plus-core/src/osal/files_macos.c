@@ -23,12 +23,14 @@
  * functions
  */
 
+#include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sysdir.h>
 #include <pwd.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -232,3 +234,51 @@ gzFile osal_gzopen(const char *filename, const char *mode)
 {
     return gzopen(filename, mode);
 }
+
+int osal_file_replace(const char *oldpath, const char *newpath)
+{
+    return rename(oldpath, newpath);
+}
+
+int osal_file_info(const char *filename, uint64_t *size, int64_t *mtime)
+{
+    struct stat fileinfo;
+
+    if (stat(filename, &fileinfo) != 0)
+        return -1;
+
+    *size = (uint64_t) fileinfo.st_size;
+    *mtime = (int64_t) fileinfo.st_mtime;
+    return 0;
+}
+
+const void * osal_file_map(const char *filename, size_t *size)
+{
+    struct stat fileinfo;
+    void *data;
+    int fd;
+
+    fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return NULL;
+
+    if (fstat(fd, &fileinfo) != 0 || fileinfo.st_size <= 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    data = mmap(NULL, (size_t) fileinfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    *size = (size_t) fileinfo.st_size;
+    return data;
+}
+
+void osal_file_unmap(const void *data, size_t size)
+{
+    if (data != NULL)
+        munmap((void *) data, size);
+}
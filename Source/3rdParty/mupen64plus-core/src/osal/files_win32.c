@@ -220,3 +220,65 @@ gzFile osal_gzopen(const char *filename, const char *mode)
     MultiByteToWideChar(CP_UTF8, 0, filename, -1, wstr_filename, PATH_MAX);
     return gzopen_w(wstr_filename, mode);
 }
+
+int osal_file_replace(const char *oldpath, const char *newpath)
+{
+    wchar_t wstr_oldpath[PATH_MAX];
+    wchar_t wstr_newpath[PATH_MAX];
+    MultiByteToWideChar(CP_UTF8, 0, oldpath, -1, wstr_oldpath, PATH_MAX);
+    MultiByteToWideChar(CP_UTF8, 0, newpath, -1, wstr_newpath, PATH_MAX);
+    return MoveFileExW(wstr_oldpath, wstr_newpath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ? 0 : -1;
+}
+
+int osal_file_info(const char *filename, uint64_t *size, int64_t *mtime)
+{
+    wchar_t wstr_filename[PATH_MAX];
+    struct _stat64 fileinfo;
+
+    MultiByteToWideChar(CP_UTF8, 0, filename, -1, wstr_filename, PATH_MAX);
+    if (_wstat64(wstr_filename, &fileinfo) != 0)
+        return -1;
+
+    *size = (uint64_t) fileinfo.st_size;
+    *mtime = (int64_t) fileinfo.st_mtime;
+    return 0;
+}
+
+const void * osal_file_map(const char *filename, size_t *size)
+{
+    wchar_t wstr_filename[PATH_MAX];
+    LARGE_INTEGER filesize;
+    HANDLE file, mapping;
+    void *data;
+
+    MultiByteToWideChar(CP_UTF8, 0, filename, -1, wstr_filename, PATH_MAX);
+    file = CreateFileW(wstr_filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    if (!GetFileSizeEx(file, &filesize) || filesize.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+        return NULL;
+
+    /* the view keeps the mapping alive */
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL)
+        return NULL;
+
+    *size = (size_t) filesize.QuadPart;
+    return data;
+}
+
+void osal_file_unmap(const void *data, size_t size)
+{
+    if (data != NULL)
+        UnmapViewOfFile(data);
+}
@@ -0,0 +1,203 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - netplay_event_bench.c                                   *
+ *   Mupen64Plus homepage: https://mupen64plus.org/                        *
+ *   Copyright (C) 2025 RMG Contributors                                   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/* Microbenchmark comparing the netplay input event storage: the linked
+ * list which netplay.c used to allocate an event for every received input
+ * in, and the fixed-capacity ring in src/main/netplay_event_ring.h.
+ *
+ * Every emulated frame the server sends each of the 4 players a number of
+ * packets which repeat the events of the current buffer window, like the
+ * gratuitous key info packets do, after which the input of every player
+ * is consumed.
+ *
+ * Build with:
+ *   gcc -O2 -I../src -o netplay_event_bench netplay_event_bench.c
+ * Usage:
+ *   ./netplay_event_bench [frames] [packets per frame] [events per packet]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "main/netplay_event_ring.h"
+
+#define PLAYERS 4
+
+struct list_event {
+    uint32_t buttons;
+    uint8_t plugin;
+    uint32_t count;
+    struct list_event* next;
+};
+
+static struct list_event* l_list_first[PLAYERS];
+static struct netplay_event_ring l_rings[PLAYERS];
+static uint32_t l_counts[PLAYERS];
+
+static double get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t get_buttons(uint32_t count, int player)
+{
+    return (count * 2654435761u) ^ (uint32_t)player;
+}
+
+static int list_check_valid(int player, uint32_t count)
+{
+    struct list_event* current = l_list_first[player];
+    while (current != NULL)
+    {
+        if (current->count == count)
+            return 1;
+        current = current->next;
+    }
+    return 0;
+}
+
+static void list_insert(int player, uint32_t count, uint32_t buttons)
+{
+    if (((count - l_counts[player]) > (UINT32_MAX / 2)) || list_check_valid(player, count))
+        return;
+
+    struct list_event* new_event = (struct list_event*)malloc(sizeof(struct list_event));
+    new_event->count = count;
+    new_event->buttons = buttons;
+    new_event->plugin = 0;
+    new_event->next = l_list_first[player];
+    l_list_first[player] = new_event;
+}
+
+static uint32_t list_take(int player)
+{
+    struct list_event* current = l_list_first[player];
+    struct list_event* find = l_list_first[player];
+    uint32_t buttons;
+
+    while (current->count != l_counts[player])
+        current = current->next;
+    buttons = current->buttons;
+
+    while (find != NULL)
+    {
+        if (find->next == current)
+        {
+            find->next = current->next;
+            break;
+        }
+        find = find->next;
+    }
+    if (current == l_list_first[player])
+        l_list_first[player] = l_list_first[player]->next;
+    free(current);
+
+    ++l_counts[player];
+    return buttons;
+}
+
+static uint32_t ring_take(int player)
+{
+    struct netplay_event* current = netplay_event_ring_find(&l_rings[player], l_counts[player]);
+    uint32_t buttons = current->buttons;
+    netplay_event_ring_remove(&l_rings[player], current);
+    ++l_counts[player];
+    return buttons;
+}
+
+static double run(int use_ring, uint32_t frames, uint32_t packets, uint32_t events, uint32_t* checksum)
+{
+    double start = get_time();
+
+    for (int player = 0; player < PLAYERS; ++player)
+        l_counts[player] = 0;
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        for (uint32_t packet = 0; packet < packets; ++packet)
+        {
+            for (int player = 0; player < PLAYERS; ++player)
+            {
+                for (uint32_t event = 0; event < events; ++event)
+                {
+                    uint32_t count = frame + event;
+                    if (use_ring)
+                        netplay_event_ring_insert(&l_rings[player], l_counts[player], count, get_buttons(count, player), 0);
+                    else
+                        list_insert(player, count, get_buttons(count, player));
+                }
+            }
+        }
+
+        for (int player = 0; player < PLAYERS; ++player)
+            *checksum += use_ring ? ring_take(player) : list_take(player);
+    }
+
+    return get_time() - start;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t frames  = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 100000;
+    uint32_t packets = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 8;
+    uint32_t events  = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 32;
+    uint32_t list_checksum = 0;
+    uint32_t ring_checksum = 0;
+
+    if (frames == 0 || packets == 0 || events == 0 || events > NETPLAY_EVENT_RING_SIZE)
+    {
+        fprintf(stderr, "usage: %s [frames] [packets per frame] [events per packet (1-%u)]\n", argv[0], NETPLAY_EVENT_RING_SIZE);
+        return 1;
+    }
+
+    for (int player = 0; player < PLAYERS; ++player)
+        netplay_event_ring_clear(&l_rings[player]);
+
+    double list_time = run(0, frames, packets, events, &list_checksum);
+    double ring_time = run(1, frames, packets, events, &ring_checksum);
+
+    for (int player = 0; player < PLAYERS; ++player)
+    {
+        while (l_list_first[player] != NULL)
+        {
+            struct list_event* next = l_list_first[player]->next;
+            free(l_list_first[player]);
+            l_list_first[player] = next;
+        }
+    }
+
+    if (list_checksum != ring_checksum)
+    {
+        fprintf(stderr, "checksum mismatch: %08x != %08x\n", list_checksum, ring_checksum);
+        return 1;
+    }
+
+    double received = (double)frames * packets * events * PLAYERS;
+    printf("%u frames, %u players, %u packets per frame, %u events per packet\n", frames, PLAYERS, packets, events);
+    printf("linked list: %8.3f s, %7.1f ns per received event\n", list_time, list_time * 1e9 / received);
+    printf("event ring:  %8.3f s, %7.1f ns per received event\n", ring_time, ring_time * 1e9 / received);
+    return 0;
+}
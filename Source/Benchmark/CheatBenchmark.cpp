@@ -0,0 +1,149 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+extern "C"
+{
+#include "device/r4300/r4300_core.h"
+#include "device/rdram/rdram.h"
+#include "main/cheat.h"
+}
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdarg>
+#include <chrono>
+#include <string>
+#include <vector>
+
+//
+// cheat benchmark, runs the cheat engine of the mupen64plus-core
+// (main/cheat.c) against a fake RDRAM and reports how long applying
+// the cheats takes on every VI, which is what gs_apply_cheats()
+// does for every frame, and how long decoding them takes
+//
+// every cheat consists of conditional codes followed by writes,
+// like the cheats in the mupen64plus cheat database do
+//
+// usage: CheatBenchmark [cheats] [codes per cheat] [VIs]
+//
+
+//
+// Local Variables
+//
+
+// these are too large for the stack
+static uint32_t          l_Dram[0x800000 / sizeof(uint32_t)];
+static struct rdram      l_Rdram;
+static struct r4300_core l_R4300;
+
+static uint64_t l_InvalidatedCount = 0;
+
+//
+// mupen64plus-core Functions
+//
+
+extern "C" int event_gameshark_active(void)
+{
+    return 0;
+}
+
+extern "C" void invalidate_r4300_cached_code(struct r4300_core*, uint32_t, size_t)
+{
+    l_InvalidatedCount++;
+}
+
+extern "C" void DebugMessage(int level, const char* message, ...)
+{
+    va_list args;
+    va_start(args, message);
+    std::vfprintf(stderr, message, args);
+    std::fputc('\n', stderr);
+    va_end(args);
+    (void)level;
+}
+
+//
+// Local Functions
+//
+
+static void add_cheats(struct cheat_ctx* ctx, int cheats, int codesPerCheat)
+{
+    std::vector<m64p_cheat_code> codes(codesPerCheat);
+    uint32_t address = 0x100000;
+
+    for (int i = 0; i < cheats; i++)
+    {
+        for (int j = 0; j < codesPerCheat; j++)
+        {
+            // every 4th code is a condition on the
+            // value which the previous cheat writes
+            if ((j % 4) == 0 && j != (codesPerCheat - 1))
+            {
+                codes[j].address = 0xD1000000 | (address - 2);
+                codes[j].value   = 0x0063;
+            }
+            else
+            {
+                codes[j].address = 0x81000000 | address;
+                codes[j].value   = 0x0063;
+                address += 2;
+            }
+        }
+
+        std::string name = "Cheat " + std::to_string(i);
+        cheat_add_new(ctx, name.c_str(), codes.data(), codesPerCheat);
+    }
+}
+
+//
+// Main
+//
+
+int main(int argc, char** argv)
+{
+    int cheats        = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int codesPerCheat = argc > 2 ? std::atoi(argv[2]) : 8;
+    int vis           = argc > 3 ? std::atoi(argv[3]) : 10000;
+
+    struct cheat_ctx ctx = {};
+
+    l_Rdram.dram      = l_Dram;
+    l_Rdram.dram_size = sizeof(l_Dram);
+    l_R4300.rdram     = &l_Rdram;
+    l_R4300.emumode   = EMUMODE_PURE_INTERPRETER;
+
+    cheat_init(&ctx);
+    add_cheats(&ctx, cheats, codesPerCheat);
+
+    // the first VI decodes the cheats
+    auto start = std::chrono::steady_clock::now();
+    cheat_apply_cheats(&ctx, &l_R4300, ENTRY_VI);
+    auto end = std::chrono::steady_clock::now();
+    double firstViUs = std::chrono::duration<double, std::micro>(end - start).count();
+
+    l_InvalidatedCount = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < vis; i++)
+    {
+        cheat_apply_cheats(&ctx, &l_R4300, ENTRY_VI);
+    }
+    end = std::chrono::steady_clock::now();
+    double viNs = std::chrono::duration<double, std::nano>(end - start).count() / vis;
+
+    std::cout << "cheats:            " << cheats << " (" << (cheats * codesPerCheat) << " codes)" << std::endl;
+    std::cout << "first VI:          " << firstViUs << " us" << std::endl;
+    std::cout << "VI:                " << viNs << " ns" << std::endl;
+    std::cout << "code:              " << (viNs / (cheats * codesPerCheat)) << " ns" << std::endl;
+    std::cout << "invalidations/VI:  " << (static_cast<double>(l_InvalidatedCount) / vis) << std::endl;
+
+    cheat_delete_all(&ctx);
+    cheat_uninit(&ctx);
+    return EXIT_SUCCESS;
+}
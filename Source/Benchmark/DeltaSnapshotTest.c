@@ -0,0 +1,282 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+
+#include "api/callbacks.h"
+#include "api/config.h"
+#include "device/device.h"
+#include "main/delta_snapshot.h"
+#include "main/main.h"
+#include "main/rom.h"
+#include "main/savestates.h"
+#include "main/util.h"
+#include "osal/files.h"
+#include "plugin/plugin.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+//
+// delta snapshot test, runs the m64p savestate serializer (main/savestates.c)
+// and the delta snapshots (main/delta_snapshot.c) of the mupen64plus-core
+// against a fake device, it takes a full savestate, changes RDRAM, the TLB
+// lookup tables and the registers over a few frames while taking delta
+// snapshots, loads the first snapshot back through the deltas and checks
+// that a full savestate taken afterwards is identical byte for byte
+//
+// the rest of the core is stubbed out below, the device
+// state which these stubs would touch isn't part of the test
+//
+// usage: DeltaSnapshotTest [frames]
+//
+
+//
+// Local Variables
+//
+
+static uint32_t l_Dram[RDRAM_MAX_SIZE / 4];
+static uint32_t l_SpMem[SP_MEM_SIZE / 4];
+static uint8_t  l_PifRam[PIF_RAM_SIZE];
+static struct precomp_instr l_Pc;
+static unsigned int l_Random = 0x12345678;
+
+//
+// Core Stubs
+//
+
+struct device g_dev;
+m64p_handle g_CoreConfig;
+m64p_rom_settings ROM_SETTINGS;
+rom_params ROM_PARAMS;
+CONTROL Controls[NUM_CONTROLLER];
+gfx_plugin_functions gfx;
+input_plugin_functions input;
+
+void DebugMessage(int level, const char *message, ...)
+{
+    va_list args;
+
+    if (level > M64MSG_WARNING)
+    {
+        return;
+    }
+
+    va_start(args, message);
+    vfprintf(stderr, message, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void StateChanged(m64p_core_param param_type, int new_value) { (void)param_type; (void)new_value; }
+void main_message(m64p_msg_level level, unsigned int osd_corner, const char *format, ...) { (void)level; (void)osd_corner; (void)format; }
+m64p_error ConfigSetParameter(m64p_handle handle, const char *name, m64p_type type, const void *value) { (void)handle; (void)name; (void)type; (void)value; return M64ERR_SUCCESS; }
+
+const char* get_savestatepath(void) { return ""; }
+const char* get_savestatefilename(void) { return ""; }
+char* formatstr(const char *fmt, ...) { (void)fmt; return NULL; }
+const char* namefrompath(const char* path) { return path; }
+file_status_t get_file_size(const char *filename, size_t *size) { (void)filename; *size = 0; return file_open_error; }
+FILE* osal_file_open(const char *filename, const char *mode) { (void)filename; (void)mode; return NULL; }
+gzFile osal_gzopen(const char *filename, const char *mode) { (void)filename; (void)mode; return NULL; }
+
+// the host is assumed to be little endian, like the targets of RMG
+void to_little_endian_buffer(void *buffer, size_t length, size_t count) { (void)buffer; (void)length; (void)count; }
+
+// the event queue is serialized as an empty queue
+int save_eventqueue_infos(const struct cp0* cp0, char* buf) { (void)cp0; memset(buf, 0xff, 1024); return 0; }
+void load_eventqueue_infos(struct cp0* cp0, const char* buf) { (void)cp0; (void)buf; }
+unsigned int* get_event(const struct interrupt_queue* q, int type) { (void)q; (void)type; return NULL; }
+int get_next_event_type(const struct interrupt_queue* q) { (void)q; return 0; }
+
+int64_t* r4300_regs(struct r4300_core* r4300) { return r4300->regs; }
+int64_t* r4300_mult_hi(struct r4300_core* r4300) { return &r4300->hi; }
+int64_t* r4300_mult_lo(struct r4300_core* r4300) { return &r4300->lo; }
+unsigned int* r4300_llbit(struct r4300_core* r4300) { return &r4300->llbit; }
+uint32_t* r4300_pc(struct r4300_core* r4300) { (void)r4300; return &l_Pc.addr; }
+void savestates_load_set_pc(struct r4300_core* r4300, uint32_t pc) { (void)r4300; l_Pc.addr = pc; }
+uint32_t* r4300_cp0_regs(struct cp0* cp0) { return cp0->regs; }
+uint64_t* r4300_cp0_latch(struct cp0* cp0) { return &cp0->latch; }
+uint32_t* r4300_cp0_last_addr(struct cp0* cp0) { return &cp0->last_addr; }
+unsigned int* r4300_cp0_next_interrupt(struct cp0* cp0) { return &cp0->next_interrupt; }
+cp1_reg* r4300_cp1_regs(struct cp1* cp1) { return cp1->regs; }
+uint32_t* r4300_cp1_fcr0(struct cp1* cp1) { return &cp1->fcr0; }
+uint32_t* r4300_cp1_fcr31(struct cp1* cp1) { return &cp1->fcr31; }
+uint64_t* r4300_cp2_latch(struct cp2* cp2) { return &cp2->latch; }
+void set_fpr_pointers(struct cp1* cp1, uint32_t newStatus) { (void)cp1; (void)newStatus; }
+void update_x86_rounding_mode(struct cp1* cp1) { (void)cp1; }
+void tlb_map(struct tlb* tlb, size_t entry) { (void)tlb; (void)entry; }
+
+static void vi_changed(void) { }
+
+void poweron_dd(struct dd_controller* dd) { (void)dd; }
+void poweron_fb(struct fb* fb) { (void)fb; }
+void poweron_flashram(struct flashram* flashram) { (void)flashram; }
+void poweron_gb_cart(struct gb_cart* gb_cart) { (void)gb_cart; }
+void poweron_rumblepak(struct rumblepak* rpk) { (void)rpk; }
+void poweron_transferpak(struct transferpak* tpk) { (void)tpk; }
+void set_rumble_reg(struct rumblepak* rpk, uint8_t value) { (void)rpk; (void)value; }
+void disable_pif_channel(struct pif_channel* channel) { (void)channel; }
+void setup_channels_format(struct pif* pif) { (void)pif; }
+size_t setup_pif_channel(struct pif_channel* channel, uint8_t* buf) { (void)channel; (void)buf; return 0; }
+
+//
+// Local Functions
+//
+
+static uint32_t random_u32(void)
+{
+    l_Random ^= l_Random << 13;
+    l_Random ^= l_Random >> 17;
+    l_Random ^= l_Random << 5;
+    return l_Random;
+}
+
+// changes RDRAM, the TLB lookup tables and the
+// registers like a frame of emulation would
+static void run_frame(void)
+{
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t address = (random_u32() % RDRAM_MAX_SIZE) & ~3u;
+        l_Dram[address / 4] = random_u32();
+        // some writes bypass the write handler, which
+        // the delta snapshots find through the page hashes
+        if (i & 1)
+        {
+            rdram_mark_dirty(&g_dev.rdram, address, 4);
+        }
+    }
+
+    uint32_t lut = random_u32() % 0x100000;
+    g_dev.r4300.cp0.tlb.LUT_r[lut] = random_u32();
+    g_dev.r4300.cp0.tlb.LUT_w[lut] = random_u32();
+    g_dev.r4300.cp0.tlb.LUT_dirty[lut / (DELTA_SNAPSHOT_PAGE_SIZE / 4)] = 1;
+
+    for (int i = 0; i < 32; i++)
+    {
+        g_dev.r4300.regs[i] = (int64_t)(((uint64_t)random_u32() << 32) | random_u32());
+    }
+    g_dev.vi.regs[VI_ORIGIN_REG] = random_u32();
+    g_dev.ai.regs[AI_DRAM_ADDR_REG] = random_u32();
+    g_dev.sp.regs[SP_STATUS_REG] = random_u32();
+    l_SpMem[random_u32() % (SP_MEM_SIZE / 4)] = random_u32();
+    l_PifRam[random_u32() % PIF_RAM_SIZE] = (uint8_t)random_u32();
+    l_Pc.addr = random_u32();
+}
+
+static size_t compare_states(const unsigned char* expected, const unsigned char* actual)
+{
+    size_t differences = 0;
+
+    for (size_t i = 0; i < SAVESTATE_M64P_SIZE; i++)
+    {
+        if (expected[i] != actual[i])
+        {
+            if (differences < 8)
+            {
+                fprintf(stderr, "byte %zu differs: expected 0x%02x, got 0x%02x\n", i, expected[i], actual[i]);
+            }
+            differences++;
+        }
+    }
+
+    return differences;
+}
+
+//
+// Main Function
+//
+
+int main(int argc, char** argv)
+{
+    struct delta_snapshot_ring ring;
+    unsigned char* expected;
+    unsigned char* actual;
+    unsigned int frames = 8;
+    size_t differences;
+
+    if (argc > 1)
+    {
+        frames = (unsigned int)strtoul(argv[1], NULL, 10);
+    }
+
+    if (frames < 2)
+    {
+        fprintf(stderr, "usage: %s [frames >= 2]\n", argv[0]);
+        return 1;
+    }
+
+    g_dev.rdram.dram      = l_Dram;
+    g_dev.rdram.dram_size = sizeof(l_Dram);
+    g_dev.sp.mem          = l_SpMem;
+    g_dev.pif.ram         = l_PifRam;
+    gfx.viStatusChanged   = vi_changed;
+    gfx.viWidthChanged    = vi_changed;
+
+    expected = calloc(1, SAVESTATE_M64P_SIZE);
+    actual   = calloc(1, SAVESTATE_M64P_SIZE);
+    if (expected == NULL || actual == NULL ||
+        !delta_snapshot_ring_init(&ring, frames))
+    {
+        fprintf(stderr, "failed to allocate memory\n");
+        return 1;
+    }
+
+    // start from a state where every byte is used
+    for (size_t i = 0; i < (sizeof(l_Dram) / 4); i++)
+    {
+        l_Dram[i] = random_u32();
+    }
+    run_frame();
+
+    if (!savestates_save_m64p_memory(expected, SAVESTATE_M64P_SIZE, 0) ||
+        !delta_snapshot_ring_save(&ring, 0))
+    {
+        fprintf(stderr, "failed to save frame 0\n");
+        return 1;
+    }
+
+    for (unsigned int frame = 1; frame < frames; frame++)
+    {
+        run_frame();
+        if (!delta_snapshot_ring_save(&ring, frame))
+        {
+            fprintf(stderr, "failed to save frame %u\n", frame);
+            return 1;
+        }
+    }
+
+    if (!delta_snapshot_ring_load(&ring, 0))
+    {
+        fprintf(stderr, "failed to load frame 0\n");
+        return 1;
+    }
+
+    if (!savestates_save_m64p_memory(actual, SAVESTATE_M64P_SIZE, 0))
+    {
+        fprintf(stderr, "failed to save the loaded state\n");
+        return 1;
+    }
+
+    differences = compare_states(expected, actual);
+    if (differences != 0)
+    {
+        fprintf(stderr, "FAILED: %zu bytes differ after loading frame 0 through %u deltas\n", differences, frames - 1);
+        return 1;
+    }
+
+    printf("OK: frame 0 restored through %u deltas is identical to its full savestate\n", frames - 1);
+
+    delta_snapshot_ring_deinit(&ring);
+    free(expected);
+    free(actual);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <RMG-Core/KailleraServer.hpp>
+#include <RMG-Core/Kaillera.hpp>
+#include <RMG-Core/Error.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//
+// Kaillera per-frame sync benchmark, runs the native
+// client against the loopback server and reports how
+// long every CoreModifyKailleraPlayValues call blocks
+//
+// usage: KailleraBenchmark [frames] [bot players] [connection type] [port]
+//
+
+//
+// Local Functions
+//
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+static int fail(const std::string& message)
+{
+    std::cerr << "KailleraBenchmark: " << message << ": " << CoreGetError() << std::endl;
+    CoreShutdownKaillera();
+    CoreStopKailleraLoopbackServer();
+    return EXIT_FAILURE;
+}
+
+//
+// Main
+//
+
+int main(int argc, char** argv)
+{
+    int frames         = argc > 1 ? std::atoi(argv[1]) : 3600;
+    int botPlayers     = argc > 2 ? std::atoi(argv[2]) : 1;
+    int connectionType = argc > 3 ? std::atoi(argv[3]) : 1;
+    int port           = argc > 4 ? std::atoi(argv[4]) : 27999;
+
+    std::atomic<bool> gameStarted = false;
+    std::atomic<int>  numPlayers  = 0;
+
+    if (!CoreStartKailleraLoopbackServer(port, botPlayers))
+    {
+        return fail("failed to start loopback server");
+    }
+
+    if (!CoreInitKaillera())
+    {
+        return fail("failed to initialize Kaillera");
+    }
+
+    CoreSetKailleraCallbacks(
+        [&](std::string, int, int players)
+        {
+            numPlayers  = players;
+            gameStarted = true;
+        },
+        nullptr, nullptr, nullptr);
+
+    if (!CoreConnectKailleraServer("127.0.0.1", port, "Benchmark", connectionType) ||
+        !CoreCreateKailleraGame("Benchmark") ||
+        !CoreStartKailleraGame())
+    {
+        return fail("failed to start game");
+    }
+
+    while (!gameStarted)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<double> times;
+    uint32_t values[8];
+    int delayFrames = 0;
+
+    times.reserve(frames);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        values[0] = static_cast<uint32_t>(frame);
+
+        auto callStart = std::chrono::steady_clock::now();
+        int ret = CoreModifyKailleraPlayValues(values, sizeof(uint32_t));
+        auto callEnd = std::chrono::steady_clock::now();
+
+        if (ret < 0)
+        {
+            return fail("game ended at frame " + std::to_string(frame));
+        }
+        else if (ret == 0)
+        {
+            delayFrames++;
+            continue;
+        }
+
+        times.push_back(std::chrono::duration<double, std::micro>(callEnd - callStart).count());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    CoreEndKailleraGame();
+    CoreShutdownKaillera();
+    CoreStopKailleraLoopbackServer();
+
+    std::sort(times.begin(), times.end());
+    double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "players:        " << numPlayers << std::endl;
+    std::cout << "frame delay:    " << delayFrames << std::endl;
+    std::cout << "synced frames:  " << times.size() << std::endl;
+    std::cout << "total time:     " << totalMs << " ms" << std::endl;
+    std::cout << "throughput:     " << (frames / (totalMs / 1000.0)) << " frames/s" << std::endl;
+    std::cout << "sync p50:       " << percentile(times, 0.50) << " us" << std::endl;
+    std::cout << "sync p95:       " << percentile(times, 0.95) << " us" << std::endl;
+    std::cout << "sync p99:       " << percentile(times, 0.99) << " us" << std::endl;
+    std::cout << "sync max:       " << (times.empty() ? 0.0 : times.back()) << " us" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,570 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "NetplayServer.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <map>
+
+//
+// mupen64plus netplay benchmark, runs headless clients which
+// speak the protocol of netplay.c in the mupen64plus-core
+// against the loopback server, with optional latency, jitter
+// and loss, and reports how long every client waited on input
+//
+// the server decides which input belongs to which frame, every
+// client checks that it received the same input as the other
+// clients, so it fails when the clients would've desynced, which
+// makes it usable as a regression test
+//
+// usage: NetplayBenchmark [frames] [clients] [latency ms] [jitter ms] [loss %] [input delay] [fps] [port]
+//
+
+//
+// Local Defines
+//
+
+// see netplay.c in the mupen64plus-core
+#define UDP_SEND_KEY_INFO 0
+#define UDP_RECEIVE_KEY_INFO 1
+#define UDP_REQUEST_KEY_INFO 2
+#define UDP_RECEIVE_KEY_INFO_GRATUITOUS 3
+#define UDP_SYNC_DATA 4
+
+#define TCP_SEND_SAVE 1
+#define TCP_RECEIVE_SAVE 2
+#define TCP_SEND_SETTINGS 3
+#define TCP_RECEIVE_SETTINGS 4
+#define TCP_REGISTER_PLAYER 5
+#define TCP_GET_REGISTRATION 6
+#define TCP_DISCONNECT_NOTICE 7
+
+#define NETPLAY_PLUGIN_NONE 1
+#define NETPLAY_SETTINGS_SIZE 24
+#define NETPLAY_SAVE_SIZE 2048
+#define NETPLAY_REQUEST_MS 5
+#define NETPLAY_TIMEOUT_MS 10000
+#define NETPLAY_SYNC_INTERVAL 600
+
+//
+// Local Structures
+//
+
+struct l_ClientResult
+{
+    bool        Success = false;
+    std::string Error;
+    uint32_t    Checksum    = 0;
+    uint32_t    Requests    = 0;
+    uint32_t    StallFrames = 0;
+    double      TimeMs      = 0.0;
+    std::vector<double> Waits;
+};
+
+struct l_BenchmarkOptions
+{
+    int      Frames  = 3600;
+    int      Clients = 2;
+    int      Fps     = 0;
+    int      Port    = 45000;
+    NetplayServerOptions Server;
+};
+
+//
+// Local Variables
+//
+
+static std::atomic<int> l_RegisteredClients = 0;
+
+//
+// Local Functions
+//
+
+static void write32(uint32_t value, uint8_t* data)
+{
+    data[0] = static_cast<uint8_t>(value >> 24);
+    data[1] = static_cast<uint8_t>(value >> 16);
+    data[2] = static_cast<uint8_t>(value >> 8);
+    data[3] = static_cast<uint8_t>(value);
+}
+
+static uint32_t read32(const uint8_t* data)
+{
+    return (static_cast<uint32_t>(data[0]) << 24) |
+           (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8)  |
+            static_cast<uint32_t>(data[3]);
+}
+
+static uint32_t get_buttons(int player, uint32_t count)
+{
+    uint32_t value = (count * 2654435761u) ^ (static_cast<uint32_t>(player) * 40503u);
+    return value ^ (value >> 15);
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+static bool send_all(int socket, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0)
+    {
+        ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        bytes += sent;
+        size  -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static bool recv_all(int socket, void* data, size_t size)
+{
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    while (size > 0)
+    {
+        pollfd pfd = { socket, POLLIN, 0 };
+        if (poll(&pfd, 1, NETPLAY_TIMEOUT_MS) <= 0)
+        {
+            return false;
+        }
+
+        ssize_t received = recv(socket, bytes, size, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        bytes += received;
+        size  -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+static int connect_socket(int type, int port)
+{
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int sock = socket(AF_INET, type, 0);
+    if (sock == -1)
+    {
+        return -1;
+    }
+
+    if (type == SOCK_STREAM)
+    {
+        int noDelay = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+
+    if (connect(sock, (sockaddr*)&address, sizeof(address)) != 0)
+    {
+        close(sock);
+        return -1;
+    }
+
+    return sock;
+}
+
+// sets up the game like the core does before emulation starts:
+// registration, settings and save synchronization
+static bool setup_client(int tcpSocket, int player, int clients, uint32_t regId, bool players[4], std::string& error)
+{
+    uint8_t buffer[64];
+
+    buffer[0] = TCP_REGISTER_PLAYER;
+    buffer[1] = static_cast<uint8_t>(player);
+    buffer[2] = NETPLAY_PLUGIN_NONE;
+    buffer[3] = 0;
+    write32(regId, &buffer[4]);
+    if (!send_all(tcpSocket, buffer, 8) || !recv_all(tcpSocket, buffer, 2) || buffer[0] != 1)
+    {
+        error = "registration failed";
+        return false;
+    }
+
+    // the registration is retrieved once every player has registered
+    l_RegisteredClients++;
+    while (l_RegisteredClients < clients)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    buffer[0] = TCP_GET_REGISTRATION;
+    if (!send_all(tcpSocket, buffer, 1) || !recv_all(tcpSocket, buffer, 24))
+    {
+        error = "retrieving registration failed";
+        return false;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        players[i] = read32(&buffer[i * 6]) != 0;
+    }
+
+    // player 1 is the source of the settings and saves
+    std::vector<uint8_t> save(NETPLAY_SAVE_SIZE);
+    for (size_t i = 0; i < save.size(); i++)
+    {
+        save[i] = static_cast<uint8_t>(get_buttons(-1, static_cast<uint32_t>(i)));
+    }
+
+    if (player == 0)
+    {
+        std::vector<uint8_t> message;
+        message.push_back(TCP_SEND_SETTINGS);
+        for (int i = 0; i < NETPLAY_SETTINGS_SIZE; i++)
+        {
+            message.push_back(static_cast<uint8_t>(i));
+        }
+
+        const char extension[] = ".eep";
+        message.push_back(TCP_SEND_SAVE);
+        message.insert(message.end(), extension, extension + sizeof(extension));
+        message.resize(message.size() + 4);
+        write32(static_cast<uint32_t>(save.size()), &message[message.size() - 4]);
+        message.insert(message.end(), save.begin(), save.end());
+
+        if (!send_all(tcpSocket, message.data(), message.size()))
+        {
+            error = "sending settings failed";
+            return false;
+        }
+    }
+    else
+    {
+        std::vector<uint8_t> received(save.size());
+        const uint8_t request[] = { TCP_RECEIVE_SETTINGS, TCP_RECEIVE_SAVE, '.', 'e', 'e', 'p', '\0' };
+
+        if (!send_all(tcpSocket, request, sizeof(request)) ||
+            !recv_all(tcpSocket, buffer, NETPLAY_SETTINGS_SIZE) ||
+            !recv_all(tcpSocket, received.data(), received.size()))
+        {
+            error = "receiving settings failed";
+            return false;
+        }
+
+        for (int i = 0; i < NETPLAY_SETTINGS_SIZE; i++)
+        {
+            if (buffer[i] != i)
+            {
+                error = "received corrupted settings";
+                return false;
+            }
+        }
+
+        if (received != save)
+        {
+            error = "received corrupted save";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void send_request(int udpSocket, int player, uint32_t regId, uint32_t count, uint8_t bufferSize)
+{
+    uint8_t packet[12];
+    packet[0] = UDP_REQUEST_KEY_INFO;
+    packet[1] = static_cast<uint8_t>(player);
+    write32(regId, &packet[2]);
+    write32(count, &packet[6]);
+    packet[10] = 0;
+    packet[11] = bufferSize;
+    send(udpSocket, packet, sizeof(packet), 0);
+}
+
+// receives every pending packet, returns false on desync
+static bool receive_packets(int udpSocket, std::map<uint32_t, uint32_t> events[4], const uint32_t counts[4], uint8_t lag[4])
+{
+    uint8_t packet[512];
+    ssize_t size;
+
+    while ((size = recv(udpSocket, packet, sizeof(packet), MSG_DONTWAIT)) >= 5)
+    {
+        if (packet[0] != UDP_RECEIVE_KEY_INFO && packet[0] != UDP_RECEIVE_KEY_INFO_GRATUITOUS)
+        {
+            continue;
+        }
+
+        if (packet[2] & 0x1)
+        {
+            return false;
+        }
+
+        uint8_t player = packet[1] & 0x3;
+        size_t  offset = 5;
+
+        if (packet[0] == UDP_RECEIVE_KEY_INFO)
+        {
+            lag[player] = packet[3];
+        }
+
+        for (uint8_t i = 0; i < packet[4] && (offset + 9) <= static_cast<size_t>(size); i++, offset += 9)
+        {
+            uint32_t count = read32(&packet[offset]);
+            if ((count - counts[player]) < (UINT32_MAX / 2))
+            {
+                events[player].emplace(count, read32(&packet[offset + 4]));
+            }
+        }
+    }
+
+    return true;
+}
+
+static void client_thread(const l_BenchmarkOptions& options, int player, l_ClientResult& result)
+{
+    std::map<uint32_t, uint32_t> events[4];
+    uint32_t counts[4] = { 0, 0, 0, 0 };
+    uint8_t  lag[4]    = { 0, 0, 0, 0 };
+    bool     players[4];
+    bool     fastForward = false;
+    uint32_t regId = 0x1000 + static_cast<uint32_t>(player);
+    uint8_t  packet[512];
+
+    int tcpSocket = connect_socket(SOCK_STREAM, options.Port);
+    int udpSocket = connect_socket(SOCK_DGRAM, options.Port);
+    if (tcpSocket == -1 || udpSocket == -1)
+    {
+        result.Error = "failed to connect";
+        l_RegisteredClients++;
+        return;
+    }
+
+    if (!setup_client(tcpSocket, player, options.Clients, regId, players, result.Error))
+    {
+        close(tcpSocket);
+        close(udpSocket);
+        return;
+    }
+
+    result.Waits.reserve(options.Frames * options.Clients);
+
+    auto frameTime = options.Fps > 0 ? std::chrono::nanoseconds(1000000000 / options.Fps) : std::chrono::nanoseconds(0);
+    auto start     = std::chrono::steady_clock::now();
+    auto nextFrame = start;
+
+    for (uint32_t frame = 0; frame < static_cast<uint32_t>(options.Frames); frame++)
+    {
+        // like the core, the speed limiter is disabled while
+        // we're behind and have more input than the buffer target
+        if (options.Fps > 0)
+        {
+            if (fastForward)
+            {
+                nextFrame = std::chrono::steady_clock::now();
+            }
+            else
+            {
+                std::this_thread::sleep_until(nextFrame);
+            }
+            nextFrame += frameTime;
+        }
+        fastForward = false;
+
+        // send our own input
+        packet[0] = UDP_SEND_KEY_INFO;
+        packet[1] = static_cast<uint8_t>(player);
+        write32(counts[player], &packet[2]);
+        write32(get_buttons(player, counts[player]), &packet[6]);
+        packet[10] = NETPLAY_PLUGIN_NONE;
+        send(udpSocket, packet, 11, 0);
+
+        // retrieve the input of every player
+        for (int i = 0; i < 4; i++)
+        {
+            if (!players[i])
+            {
+                continue;
+            }
+
+            auto waitStart = std::chrono::steady_clock::now();
+            auto timeout   = waitStart + std::chrono::milliseconds(NETPLAY_TIMEOUT_MS);
+
+            if (!receive_packets(udpSocket, events, counts, lag))
+            {
+                result.Error = "server reported a desync at frame " + std::to_string(frame);
+                break;
+            }
+
+            fastForward |= lag[i] > 0 && events[i].size() > static_cast<size_t>(options.Server.BufferTarget);
+
+            send_request(udpSocket, i, regId, counts[i], static_cast<uint8_t>(std::min<size_t>(events[i].size(), UINT8_MAX)));
+            result.Requests++;
+
+            while (events[i].find(counts[i]) == events[i].end())
+            {
+                if (std::chrono::steady_clock::now() >= timeout)
+                {
+                    result.Error = "timed out waiting on input of player " + std::to_string(i + 1) +
+                                   " at frame " + std::to_string(frame);
+                    break;
+                }
+
+                pollfd pfd = { udpSocket, POLLIN, 0 };
+                if (poll(&pfd, 1, NETPLAY_REQUEST_MS) == 0)
+                {
+                    send_request(udpSocket, i, regId, counts[i], 0);
+                    result.Requests++;
+                }
+
+                if (!receive_packets(udpSocket, events, counts, lag))
+                {
+                    result.Error = "server reported a desync at frame " + std::to_string(frame);
+                    break;
+                }
+            }
+
+            if (!result.Error.empty())
+            {
+                break;
+            }
+
+            double wait = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - waitStart).count();
+            result.Waits.push_back(wait);
+            if (wait >= 1000.0)
+            {
+                result.StallFrames++;
+            }
+
+            result.Checksum = (result.Checksum * 31) + events[i][counts[i]];
+            events[i].erase(counts[i]);
+            counts[i]++;
+        }
+
+        if (!result.Error.empty())
+        {
+            break;
+        }
+
+        // let the server compare the state of every client
+        if ((frame % NETPLAY_SYNC_INTERVAL) == 0)
+        {
+            packet[0] = UDP_SYNC_DATA;
+            write32(frame, &packet[1]);
+            write32(result.Checksum, &packet[5]);
+            send(udpSocket, packet, 9, 0);
+        }
+    }
+
+    result.TimeMs  = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.Success = result.Error.empty();
+
+    packet[0] = TCP_DISCONNECT_NOTICE;
+    write32(regId, &packet[1]);
+    send_all(tcpSocket, packet, 5);
+
+    close(tcpSocket);
+    close(udpSocket);
+}
+
+//
+// Main
+//
+
+int main(int argc, char** argv)
+{
+    l_BenchmarkOptions options;
+
+    options.Frames            = argc > 1 ? std::atoi(argv[1]) : 3600;
+    options.Clients           = argc > 2 ? std::clamp(std::atoi(argv[2]), 1, 4) : 2;
+    options.Server.Latency    = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 0;
+    options.Server.Jitter     = argc > 4 ? static_cast<uint32_t>(std::atoi(argv[4])) : 0;
+    options.Server.PacketLoss = argc > 5 ? std::atof(argv[5]) / 100.0 : 0.0;
+    options.Server.InputDelay = argc > 6 ? std::atoi(argv[6]) : 0;
+    options.Fps               = argc > 7 ? std::atoi(argv[7]) : 0;
+    options.Port              = argc > 8 ? std::atoi(argv[8]) : 45000;
+
+    if (!StartNetplayLoopbackServer(options.Port, options.Server))
+    {
+        std::cerr << "NetplayBenchmark: failed to start loopback server: " << GetNetplayLoopbackServerError() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<l_ClientResult> results(options.Clients);
+    std::vector<std::thread>    threads;
+    for (int i = 0; i < options.Clients; i++)
+    {
+        threads.emplace_back(client_thread, std::cref(options), i, std::ref(results[i]));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    StopNetplayLoopbackServer();
+
+    bool success = true;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "frames: " << options.Frames << ", clients: " << options.Clients
+              << ", latency: " << options.Server.Latency << " ms, jitter: " << options.Server.Jitter
+              << " ms, loss: " << (options.Server.PacketLoss * 100.0) << "%, input delay: "
+              << options.Server.InputDelay << ", fps: " << options.Fps << std::endl;
+
+    for (int i = 0; i < options.Clients; i++)
+    {
+        l_ClientResult& result = results[i];
+        std::sort(result.Waits.begin(), result.Waits.end());
+
+        if (!result.Success)
+        {
+            std::cout << "client " << (i + 1) << ": failed: " << result.Error << std::endl;
+            success = false;
+            continue;
+        }
+
+        if (result.Checksum != results[0].Checksum)
+        {
+            std::cout << "client " << (i + 1) << ": received different input than client 1" << std::endl;
+            success = false;
+        }
+
+        std::cout << "client " << (i + 1) << ": "
+                  << (options.Frames / (result.TimeMs / 1000.0)) << " frames/s, "
+                  << result.StallFrames << " stalls, "
+                  << result.Requests << " requests, wait p50 "
+                  << percentile(result.Waits, 0.50) << " us, p95 "
+                  << percentile(result.Waits, 0.95) << " us, p99 "
+                  << percentile(result.Waits, 0.99) << " us, max "
+                  << (result.Waits.empty() ? 0.0 : result.Waits.back()) << " us" << std::endl;
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,75 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "NetplayServer.hpp"
+
+#include <iostream>
+#include <cstdlib>
+#include <csignal>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+//
+// Runs the mupen64plus netplay loopback server until it's
+// interrupted, so RMG instances on the same machine can
+// play against each other through 127.0.0.1:port
+//
+// usage: NetplayLoopbackServer [port] [buffer target] [input delay] [latency ms] [jitter ms] [loss %]
+//
+
+//
+// Local Variables
+//
+
+static std::atomic<bool> l_Running = true;
+
+//
+// Local Functions
+//
+
+static void signal_handler(int)
+{
+    l_Running = false;
+}
+
+//
+// Main
+//
+
+int main(int argc, char** argv)
+{
+    NetplayServerOptions options;
+
+    int port             = argc > 1 ? std::atoi(argv[1]) : 45000;
+    options.BufferTarget = argc > 2 ? std::atoi(argv[2]) : 2;
+    options.InputDelay   = argc > 3 ? std::atoi(argv[3]) : 0;
+    options.Latency      = argc > 4 ? static_cast<uint32_t>(std::atoi(argv[4])) : 0;
+    options.Jitter       = argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 0;
+    options.PacketLoss   = argc > 6 ? std::atof(argv[6]) / 100.0 : 0.0;
+
+    if (!StartNetplayLoopbackServer(port, options))
+    {
+        std::cerr << "NetplayLoopbackServer: failed to start server: " << GetNetplayLoopbackServerError() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    std::cout << "NetplayLoopbackServer: listening on 127.0.0.1:" << port << std::endl;
+
+    while (l_Running)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    StopNetplayLoopbackServer();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,940 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "NetplayServer.hpp"
+
+#include <string>
+
+// error of the last StartNetplayLoopbackServer() call which failed,
+// shared by both implementations below
+static std::string l_Error;
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <vector>
+#include <array>
+#include <map>
+
+//
+// Local Defines
+//
+
+#define SERVER_PLAYERS 4
+#define SERVER_POLL_MS 100
+
+// maximum amount of events in a key info packet,
+// the core receives packets of at most 512 bytes
+#define SERVER_MAX_EVENTS 32
+
+// events this far behind every player are discarded
+#define SERVER_EVENT_HISTORY 1024
+
+// amount of desync check entries which are kept
+#define SERVER_SYNC_HISTORY 16
+
+#define SERVER_SETTINGS_SIZE 24
+
+// UDP packet formats, see netplay.c in the mupen64plus-core
+#define UDP_SEND_KEY_INFO 0
+#define UDP_RECEIVE_KEY_INFO 1
+#define UDP_REQUEST_KEY_INFO 2
+#define UDP_RECEIVE_KEY_INFO_GRATUITOUS 3
+#define UDP_SYNC_DATA 4
+
+// TCP packet formats
+#define TCP_SEND_SAVE 1
+#define TCP_RECEIVE_SAVE 2
+#define TCP_SEND_SETTINGS 3
+#define TCP_RECEIVE_SETTINGS 4
+#define TCP_REGISTER_PLAYER 5
+#define TCP_GET_REGISTRATION 6
+#define TCP_DISCONNECT_NOTICE 7
+
+//
+// Local Structures
+//
+
+struct l_ServerEvent
+{
+    uint32_t Buttons = 0;
+    uint8_t  Plugin  = 0;
+};
+
+struct l_ServerPlayer
+{
+    uint32_t RegId   = 0;
+    uint8_t  Plugin  = 0;
+    uint8_t  RawData = 0;
+    int      Socket  = -1; // TCP connection which registered the player
+
+    // the event of input is its count plus the offset, the offset
+    // starts at the input delay and grows when input arrives late
+    uint32_t Offset        = 0;
+    uint32_t LastSentCount = 0;
+    bool     HasSent       = false;
+
+    // events which have been assigned, NextCount
+    // is the count of the next event to assign
+    std::map<uint32_t, l_ServerEvent> Events;
+    uint32_t NextCount = 0;
+};
+
+struct l_ServerConnection
+{
+    int Socket = -1;
+    std::vector<uint8_t> Buffer;
+
+    // requests which are answered once the
+    // data has been sent by another player
+    std::vector<std::string> PendingSaves;
+    int PendingSettings = 0;
+};
+
+struct l_ServerPeer
+{
+    sockaddr_in Address;
+    uint32_t    RegId = 0;
+    uint32_t    Count = 0; // highest event count requested
+    bool        Spectator = true;
+};
+
+struct l_DelayedPacket
+{
+    bool        Outgoing = false;
+    sockaddr_in Address;
+    std::vector<uint8_t> Data;
+};
+
+//
+// Local Variables
+//
+
+static std::thread       l_ServerThread;
+static std::atomic<bool> l_ServerRunning = false;
+static int               l_ServerUdpSocket = -1;
+static int               l_ServerTcpSocket = -1;
+
+static NetplayServerOptions l_Options;
+static std::mt19937             l_Random;
+
+static std::array<l_ServerPlayer, SERVER_PLAYERS> l_Players;
+static std::vector<l_ServerConnection> l_Connections;
+static std::vector<l_ServerPeer> l_Peers;
+static std::multimap<std::chrono::steady_clock::time_point, l_DelayedPacket> l_DelayedPackets;
+
+static std::map<std::string, std::vector<uint8_t>> l_Saves;
+static std::vector<uint8_t> l_Settings;
+static std::map<uint32_t, std::vector<uint8_t>> l_SyncData;
+static uint8_t l_Status = 0;
+
+//
+// Local Functions
+//
+
+static void write32(uint32_t value, uint8_t* data)
+{
+    data[0] = static_cast<uint8_t>(value >> 24);
+    data[1] = static_cast<uint8_t>(value >> 16);
+    data[2] = static_cast<uint8_t>(value >> 8);
+    data[3] = static_cast<uint8_t>(value);
+}
+
+static uint32_t read32(const uint8_t* data)
+{
+    return (static_cast<uint32_t>(data[0]) << 24) |
+           (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8)  |
+            static_cast<uint32_t>(data[3]);
+}
+
+static bool is_same_address(const sockaddr_in& a, const sockaddr_in& b)
+{
+    return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+static void send_tcp(int socket, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0)
+    {
+        ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return;
+        }
+        bytes += sent;
+        size  -= static_cast<size_t>(sent);
+    }
+}
+
+// applies the configured latency, jitter and
+// loss to a packet, returns false when it's dropped
+static bool impair_packet(bool outgoing, const sockaddr_in& address, const uint8_t* data, size_t size)
+{
+    if (l_Options.PacketLoss > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(l_Random) < l_Options.PacketLoss)
+    {
+        return false;
+    }
+
+    uint32_t delay = l_Options.Latency;
+    if (l_Options.Jitter > 0)
+    {
+        delay += std::uniform_int_distribution<uint32_t>(0, l_Options.Jitter)(l_Random);
+    }
+
+    if (delay == 0)
+    {
+        return true;
+    }
+
+    l_DelayedPacket packet;
+    packet.Outgoing = outgoing;
+    packet.Address  = address;
+    packet.Data.assign(data, data + size);
+    l_DelayedPackets.emplace(std::chrono::steady_clock::now() + std::chrono::milliseconds(delay), std::move(packet));
+    return false;
+}
+
+static void send_udp(const sockaddr_in& address, const uint8_t* data, size_t size)
+{
+    if (impair_packet(true, address, data, size))
+    {
+        sendto(l_ServerUdpSocket, data, size, 0, (const sockaddr*)&address, sizeof(address));
+    }
+}
+
+static bool get_event(int player, uint32_t count, l_ServerEvent& event)
+{
+    auto iter = l_Players[player].Events.find(count);
+    if (iter == l_Players[player].Events.end())
+    {
+        return false;
+    }
+
+    event = iter->second;
+    return true;
+}
+
+static uint8_t get_lag(uint32_t count)
+{
+    uint32_t leadCount = count;
+    for (const l_ServerPeer& peer : l_Peers)
+    {
+        if (!peer.Spectator && (peer.Count - leadCount) < (UINT32_MAX / 2))
+        {
+            leadCount = peer.Count;
+        }
+    }
+
+    return static_cast<uint8_t>(std::min<uint32_t>(leadCount - count, UINT8_MAX));
+}
+
+// sends the events of a player starting at count
+static void send_key_info(const sockaddr_in& address, uint8_t type, uint8_t player, uint32_t count)
+{
+    uint8_t packet[5 + (SERVER_MAX_EVENTS * 9)];
+    size_t  size   = 5;
+    uint8_t events = 0;
+    l_ServerEvent event;
+
+    packet[0] = type;
+    packet[1] = player;
+    packet[2] = l_Status;
+    packet[3] = get_lag(count);
+
+    while (events < SERVER_MAX_EVENTS && get_event(player, count, event))
+    {
+        write32(count, &packet[size]);
+        write32(event.Buttons, &packet[size + 4]);
+        packet[size + 8] = event.Plugin;
+        size += 9;
+        count++;
+        events++;
+    }
+
+    packet[4] = events;
+
+    // an empty response is still sent, it tells
+    // the player about the status and lag
+    send_udp(address, packet, size);
+}
+
+// assigns input to the next event of a player, like the mupen64plus
+// netplay server the server decides which input belongs to an event,
+// when an event is needed before the input of the player has arrived,
+// or when the input got lost, the previous input is repeated so
+// a late or lost packet doesn't stall the game
+static void assign_event(l_ServerPlayer& serverPlayer, const l_ServerEvent* event)
+{
+    l_ServerEvent assignedEvent;
+
+    if (event != nullptr)
+    {
+        assignedEvent = *event;
+    }
+    else
+    {
+        auto iter = serverPlayer.Events.find(serverPlayer.NextCount - 1);
+        if (iter != serverPlayer.Events.end())
+        {
+            assignedEvent = iter->second;
+        }
+        else
+        { // the input of the first frames is neutral
+            assignedEvent.Plugin = serverPlayer.Plugin;
+        }
+    }
+
+    serverPlayer.Events[serverPlayer.NextCount] = assignedEvent;
+    serverPlayer.NextCount++;
+}
+
+// sends the events starting at count to every peer
+static void send_new_events(uint8_t player, uint32_t count, const sockaddr_in* skipAddress)
+{
+    for (const l_ServerPeer& peer : l_Peers)
+    {
+        if (skipAddress == nullptr || !is_same_address(peer.Address, *skipAddress))
+        {
+            send_key_info(peer.Address, UDP_RECEIVE_KEY_INFO_GRATUITOUS, player, count);
+        }
+    }
+}
+
+static void prune_events(void)
+{
+    uint32_t minCount = UINT32_MAX;
+
+    // only prune when every registered player has
+    // requested input, so nobody misses events
+    for (const l_ServerPlayer& player : l_Players)
+    {
+        if (player.RegId == 0)
+        {
+            continue;
+        }
+
+        auto iter = std::find_if(l_Peers.begin(), l_Peers.end(),
+                                 [&](const l_ServerPeer& peer) { return peer.RegId == player.RegId; });
+        if (iter == l_Peers.end())
+        {
+            return;
+        }
+
+        minCount = std::min(minCount, iter->Count);
+    }
+
+    if (minCount == UINT32_MAX || minCount < SERVER_EVENT_HISTORY)
+    {
+        return;
+    }
+
+    for (l_ServerPlayer& player : l_Players)
+    {
+        player.Events.erase(player.Events.begin(), player.Events.lower_bound(minCount - SERVER_EVENT_HISTORY));
+    }
+}
+
+static void handle_udp_packet(const sockaddr_in& address, const uint8_t* data, size_t size)
+{
+    if (size < 1)
+    {
+        return;
+    }
+
+    switch (data[0])
+    {
+    case UDP_SEND_KEY_INFO:
+    {
+        if (size < 11 || data[1] >= SERVER_PLAYERS)
+        {
+            return;
+        }
+
+        l_ServerPlayer& serverPlayer = l_Players[data[1]];
+        uint32_t count = read32(&data[2]);
+
+        // ignore duplicated and reordered packets
+        if (serverPlayer.HasSent && (count - serverPlayer.LastSentCount - 1) >= (UINT32_MAX / 2))
+        {
+            return;
+        }
+
+        l_ServerEvent event;
+        event.Buttons = read32(&data[6]);
+        event.Plugin  = data[10];
+
+        serverPlayer.HasSent       = true;
+        serverPlayer.LastSentCount = count;
+
+        // input which arrives after its event has been
+        // assigned is delayed until the next event
+        uint32_t eventCount = count + serverPlayer.Offset;
+        if ((eventCount - serverPlayer.NextCount) >= (UINT32_MAX / 2))
+        {
+            serverPlayer.Offset += serverPlayer.NextCount - eventCount;
+            eventCount = serverPlayer.NextCount;
+        }
+        else if ((eventCount - serverPlayer.NextCount) > SERVER_EVENT_HISTORY)
+        {
+            serverPlayer.Offset -= eventCount - serverPlayer.NextCount;
+            eventCount = serverPlayer.NextCount;
+        }
+
+        uint32_t firstCount = serverPlayer.NextCount;
+        while (serverPlayer.NextCount != eventCount)
+        {
+            assign_event(serverPlayer, nullptr);
+        }
+        assign_event(serverPlayer, &event);
+
+        send_new_events(data[1], firstCount, nullptr);
+    } break;
+
+    case UDP_REQUEST_KEY_INFO:
+    {
+        if (size < 12 || data[1] >= SERVER_PLAYERS)
+        {
+            return;
+        }
+
+        uint8_t  player    = data[1];
+        uint32_t regId     = read32(&data[2]);
+        uint32_t count     = read32(&data[6]);
+        bool     spectator = data[10] != 0;
+
+        auto iter = std::find_if(l_Peers.begin(), l_Peers.end(),
+                                 [&](const l_ServerPeer& peer) { return is_same_address(peer.Address, address); });
+        if (iter == l_Peers.end())
+        {
+            l_ServerPeer peer;
+            peer.Address = address;
+            peer.Count   = count;
+            l_Peers.push_back(peer);
+            iter = l_Peers.end() - 1;
+        }
+
+        iter->RegId     = regId;
+        iter->Spectator = spectator;
+        if ((count - iter->Count) < (UINT32_MAX / 2))
+        {
+            iter->Count = count;
+        }
+
+        // the input of events which are requested before the
+        // player's input has arrived is assigned right away
+        l_ServerPlayer& serverPlayer = l_Players[player];
+        if ((count - serverPlayer.NextCount) < SERVER_EVENT_HISTORY)
+        {
+            uint32_t firstCount = serverPlayer.NextCount;
+            while ((count - serverPlayer.NextCount) < SERVER_EVENT_HISTORY)
+            {
+                assign_event(serverPlayer, nullptr);
+            }
+
+            send_new_events(player, firstCount, &address);
+        }
+
+        send_key_info(address, UDP_RECEIVE_KEY_INFO, player, count);
+        prune_events();
+    } break;
+
+    case UDP_SYNC_DATA:
+    {
+        if (size < 5)
+        {
+            return;
+        }
+
+        // the first player to report the registers
+        // of a VI is the reference for the others
+        uint32_t viCount = read32(&data[1]);
+        std::vector<uint8_t> registers(data + 5, data + size);
+        auto iter = l_SyncData.find(viCount);
+        if (iter == l_SyncData.end())
+        {
+            l_SyncData.emplace(viCount, std::move(registers));
+            while (l_SyncData.size() > SERVER_SYNC_HISTORY)
+            {
+                l_SyncData.erase(l_SyncData.begin());
+            }
+        }
+        else if (iter->second != registers)
+        {
+            l_Status |= 0x1;
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+static void send_pending_saves(void)
+{
+    for (l_ServerConnection& connection : l_Connections)
+    {
+        auto iter = connection.PendingSaves.begin();
+        while (iter != connection.PendingSaves.end())
+        {
+            auto save = l_Saves.find(*iter);
+            if (save == l_Saves.end())
+            {
+                ++iter;
+                continue;
+            }
+
+            send_tcp(connection.Socket, save->second.data(), save->second.size());
+            iter = connection.PendingSaves.erase(iter);
+        }
+    }
+}
+
+static void send_pending_settings(void)
+{
+    if (l_Settings.empty())
+    {
+        return;
+    }
+
+    for (l_ServerConnection& connection : l_Connections)
+    {
+        for (; connection.PendingSettings > 0; connection.PendingSettings--)
+        {
+            send_tcp(connection.Socket, l_Settings.data(), l_Settings.size());
+        }
+    }
+}
+
+static void disconnect_player(uint32_t regId)
+{
+    for (int i = 0; i < SERVER_PLAYERS; i++)
+    {
+        if (regId != 0 && l_Players[i].RegId == regId)
+        {
+            l_Status |= static_cast<uint8_t>(0x1 << (i + 1));
+        }
+    }
+}
+
+// handles the next TCP message of a connection, returns the
+// amount of bytes used, 0 when the message isn't complete
+// and -1 when the connection has to be closed
+static int handle_tcp_message(l_ServerConnection& connection)
+{
+    const std::vector<uint8_t>& buffer = connection.Buffer;
+    const uint8_t* nameEnd;
+
+    switch (buffer[0])
+    {
+    case TCP_SEND_SAVE:
+    case TCP_RECEIVE_SAVE:
+    {
+        nameEnd = static_cast<const uint8_t*>(std::memchr(buffer.data() + 1, '\0', buffer.size() - 1));
+        if (nameEnd == nullptr)
+        {
+            return 0;
+        }
+
+        std::string name(reinterpret_cast<const char*>(buffer.data() + 1));
+        size_t offset = static_cast<size_t>(nameEnd - buffer.data()) + 1;
+
+        if (buffer[0] == TCP_RECEIVE_SAVE)
+        {
+            connection.PendingSaves.push_back(name);
+            send_pending_saves();
+            return static_cast<int>(offset);
+        }
+
+        if (buffer.size() < (offset + 4))
+        {
+            return 0;
+        }
+
+        uint32_t size = read32(&buffer[offset]);
+        offset += 4;
+        if (buffer.size() < (offset + size))
+        {
+            return 0;
+        }
+
+        l_Saves[name].assign(buffer.begin() + offset, buffer.begin() + offset + size);
+        send_pending_saves();
+        return static_cast<int>(offset + size);
+    }
+
+    case TCP_SEND_SETTINGS:
+    {
+        if (buffer.size() < (1 + SERVER_SETTINGS_SIZE))
+        {
+            return 0;
+        }
+
+        l_Settings.assign(buffer.begin() + 1, buffer.begin() + 1 + SERVER_SETTINGS_SIZE);
+        send_pending_settings();
+        return 1 + SERVER_SETTINGS_SIZE;
+    }
+
+    case TCP_RECEIVE_SETTINGS:
+    {
+        connection.PendingSettings++;
+        send_pending_settings();
+        return 1;
+    }
+
+    case TCP_REGISTER_PLAYER:
+    {
+        if (buffer.size() < 8)
+        {
+            return 0;
+        }
+
+        uint8_t  player  = buffer[1];
+        uint32_t regId   = read32(&buffer[4]);
+        uint8_t  response[2] = { 0, static_cast<uint8_t>(l_Options.BufferTarget) };
+
+        if (player < SERVER_PLAYERS && regId != 0 &&
+            (l_Players[player].RegId == 0 || l_Players[player].RegId == regId))
+        {
+            l_Players[player].RegId   = regId;
+            l_Players[player].Plugin  = buffer[2];
+            l_Players[player].RawData = buffer[3];
+            l_Players[player].Socket  = connection.Socket;
+            response[0] = 1;
+        }
+
+        send_tcp(connection.Socket, response, sizeof(response));
+        return 8;
+    }
+
+    case TCP_GET_REGISTRATION:
+    {
+        uint8_t response[SERVER_PLAYERS * 6];
+        for (int i = 0; i < SERVER_PLAYERS; i++)
+        {
+            write32(l_Players[i].RegId, &response[i * 6]);
+            response[(i * 6) + 4] = l_Players[i].Plugin;
+            response[(i * 6) + 5] = l_Players[i].RawData;
+        }
+
+        send_tcp(connection.Socket, response, sizeof(response));
+        return 1;
+    }
+
+    case TCP_DISCONNECT_NOTICE:
+    {
+        if (buffer.size() < 5)
+        {
+            return 0;
+        }
+
+        disconnect_player(read32(&buffer[1]));
+        return 5;
+    }
+
+    default:
+        return -1;
+    }
+}
+
+static bool handle_tcp_data(l_ServerConnection& connection)
+{
+    uint8_t buffer[4096];
+
+    ssize_t size = recv(connection.Socket, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+    {
+        return false;
+    }
+
+    connection.Buffer.insert(connection.Buffer.end(), buffer, buffer + size);
+
+    while (!connection.Buffer.empty())
+    {
+        int used = handle_tcp_message(connection);
+        if (used < 0)
+        {
+            return false;
+        }
+        else if (used == 0)
+        {
+            break;
+        }
+
+        connection.Buffer.erase(connection.Buffer.begin(), connection.Buffer.begin() + used);
+    }
+
+    return true;
+}
+
+static void close_connection(size_t index)
+{
+    int socket = l_Connections[index].Socket;
+
+    for (l_ServerPlayer& player : l_Players)
+    {
+        if (player.Socket == socket)
+        {
+            disconnect_player(player.RegId);
+            player.Socket = -1;
+        }
+    }
+
+    close(socket);
+    l_Connections.erase(l_Connections.begin() + index);
+}
+
+static void handle_delayed_packets(void)
+{
+    auto currentTime = std::chrono::steady_clock::now();
+
+    while (!l_DelayedPackets.empty() && l_DelayedPackets.begin()->first <= currentTime)
+    {
+        l_DelayedPacket packet = std::move(l_DelayedPackets.begin()->second);
+        l_DelayedPackets.erase(l_DelayedPackets.begin());
+
+        if (packet.Outgoing)
+        {
+            sendto(l_ServerUdpSocket, packet.Data.data(), packet.Data.size(), 0, (const sockaddr*)&packet.Address, sizeof(packet.Address));
+        }
+        else
+        {
+            handle_udp_packet(packet.Address, packet.Data.data(), packet.Data.size());
+        }
+    }
+}
+
+static int get_poll_timeout(void)
+{
+    if (l_DelayedPackets.empty())
+    {
+        return SERVER_POLL_MS;
+    }
+
+    auto timeUntil = l_DelayedPackets.begin()->first - std::chrono::steady_clock::now();
+    int  timeout   = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeUntil).count());
+    return std::clamp(timeout, 0, SERVER_POLL_MS);
+}
+
+static void server_thread(void)
+{
+    uint8_t buffer[1024];
+    std::vector<pollfd> pfds;
+
+    while (l_ServerRunning)
+    {
+        pfds.clear();
+        pfds.push_back({ l_ServerUdpSocket, POLLIN, 0 });
+        pfds.push_back({ l_ServerTcpSocket, POLLIN, 0 });
+        for (const l_ServerConnection& connection : l_Connections)
+        {
+            pfds.push_back({ connection.Socket, POLLIN, 0 });
+        }
+
+        int ret = poll(pfds.data(), pfds.size(), get_poll_timeout());
+        handle_delayed_packets();
+        if (ret <= 0)
+        {
+            continue;
+        }
+
+        if (pfds[0].revents & POLLIN)
+        {
+            sockaddr_in address;
+            socklen_t   addressLength = sizeof(address);
+            ssize_t size;
+
+            while ((size = recvfrom(l_ServerUdpSocket, buffer, sizeof(buffer), MSG_DONTWAIT, (sockaddr*)&address, &addressLength)) > 0)
+            {
+                if (impair_packet(false, address, buffer, static_cast<size_t>(size)))
+                {
+                    handle_udp_packet(address, buffer, static_cast<size_t>(size));
+                }
+                addressLength = sizeof(address);
+            }
+        }
+
+        if (pfds[1].revents & POLLIN)
+        {
+            int socket = accept(l_ServerTcpSocket, nullptr, nullptr);
+            if (socket != -1)
+            {
+                l_ServerConnection connection;
+                connection.Socket = socket;
+                l_Connections.push_back(std::move(connection));
+            }
+        }
+
+        // closing a connection removes it, so go over them in
+        // reverse order, connections which were accepted in this
+        // iteration are at the end and weren't polled yet
+        for (size_t i = pfds.size() - 2; i > 0; i--)
+        {
+            size_t index = i - 1;
+            if ((pfds[index + 2].revents & (POLLIN | POLLHUP | POLLERR)) &&
+                !handle_tcp_data(l_Connections[index]))
+            {
+                close_connection(index);
+            }
+        }
+    }
+}
+
+static void close_sockets(void)
+{
+    for (const l_ServerConnection& connection : l_Connections)
+    {
+        close(connection.Socket);
+    }
+    l_Connections.clear();
+
+    if (l_ServerUdpSocket != -1)
+    {
+        close(l_ServerUdpSocket);
+        l_ServerUdpSocket = -1;
+    }
+
+    if (l_ServerTcpSocket != -1)
+    {
+        close(l_ServerTcpSocket);
+        l_ServerTcpSocket = -1;
+    }
+}
+
+//
+// Exported Functions
+//
+
+bool StartNetplayLoopbackServer(int port, const NetplayServerOptions& options)
+{
+    sockaddr_in address;
+    int reuse = 1;
+
+    if (l_ServerRunning)
+    {
+        l_Error = "StartNetplayLoopbackServer: server is already running";
+        return false;
+    }
+
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    l_ServerUdpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    l_ServerTcpSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (l_ServerUdpSocket == -1 || l_ServerTcpSocket == -1)
+    {
+        l_Error = "StartNetplayLoopbackServer: socket() failed: " + std::string(strerror(errno));
+        close_sockets();
+        return false;
+    }
+
+    setsockopt(l_ServerTcpSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (bind(l_ServerUdpSocket, (sockaddr*)&address, sizeof(address)) != 0 ||
+        bind(l_ServerTcpSocket, (sockaddr*)&address, sizeof(address)) != 0)
+    {
+        l_Error = "StartNetplayLoopbackServer: bind() failed: " + std::string(strerror(errno));
+        close_sockets();
+        return false;
+    }
+
+    if (listen(l_ServerTcpSocket, SERVER_PLAYERS * 2) != 0)
+    {
+        l_Error = "StartNetplayLoopbackServer: listen() failed: " + std::string(strerror(errno));
+        close_sockets();
+        return false;
+    }
+
+    l_Options = options;
+    l_Options.InputDelay   = std::max(l_Options.InputDelay, 0);
+    l_Options.BufferTarget = std::clamp(l_Options.BufferTarget, 0, UINT8_MAX);
+    l_Options.PacketLoss   = std::clamp(l_Options.PacketLoss, 0.0, 1.0);
+    l_Random.seed(l_Options.Seed);
+
+    l_Players = {};
+    for (l_ServerPlayer& player : l_Players)
+    {
+        player.Offset = static_cast<uint32_t>(l_Options.InputDelay);
+    }
+    l_Peers.clear();
+    l_DelayedPackets.clear();
+    l_Saves.clear();
+    l_Settings.clear();
+    l_SyncData.clear();
+    l_Status = 0;
+
+    l_ServerRunning = true;
+    l_ServerThread  = std::thread(server_thread);
+    return true;
+}
+
+bool IsNetplayLoopbackServerRunning(void)
+{
+    return l_ServerRunning;
+}
+
+void StopNetplayLoopbackServer(void)
+{
+    if (!l_ServerRunning)
+    {
+        return;
+    }
+
+    l_ServerRunning = false;
+    if (l_ServerThread.joinable())
+    {
+        l_ServerThread.join();
+    }
+
+    close_sockets();
+    l_Peers.clear();
+    l_DelayedPackets.clear();
+}
+
+#else // _WIN32
+
+bool StartNetplayLoopbackServer(int port, const NetplayServerOptions& options)
+{
+    (void)port;
+    (void)options;
+    l_Error = "StartNetplayLoopbackServer: the loopback server is not available on windows";
+    return false;
+}
+
+bool IsNetplayLoopbackServerRunning(void)
+{
+    return false;
+}
+
+void StopNetplayLoopbackServer(void)
+{
+}
+
+#endif // _WIN32
+
+std::string GetNetplayLoopbackServerError(void)
+{
+    return l_Error;
+}
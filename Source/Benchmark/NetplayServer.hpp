@@ -0,0 +1,49 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef NETPLAYSERVER_HPP
+#define NETPLAYSERVER_HPP
+
+#include <cstdint>
+#include <string>
+
+//
+// Minimal mupen64plus netplay server which listens on the
+// loopback interface, it speaks the TCP and UDP protocol of
+// the netplay implementation in the mupen64plus-core, used to
+// test and benchmark netplay without an outside server,
+// latency, jitter and loss can be added to the UDP packets,
+// input which is lost or arrives too late is replaced by
+// the previous input of the player
+//
+
+struct NetplayServerOptions
+{
+    int      BufferTarget = 2;   // buffer size target sent to players on registration
+    int      InputDelay   = 0;   // frames the input of every player is delayed by
+    uint32_t Latency      = 0;   // latency added to every UDP packet in milliseconds, in both directions
+    uint32_t Jitter       = 0;   // random latency added on top of Latency in milliseconds
+    double   PacketLoss   = 0.0; // fraction of UDP packets which is dropped, in both directions
+    uint32_t Seed         = 0;   // seed of the jitter and loss randomness
+};
+
+// starts the loopback server on 127.0.0.1:port
+// for both TCP and UDP
+bool StartNetplayLoopbackServer(int port, const NetplayServerOptions& options = {});
+
+// returns whether the loopback server is running
+bool IsNetplayLoopbackServerRunning(void);
+
+// stops the loopback server
+void StopNetplayLoopbackServer(void);
+
+// returns why StartNetplayLoopbackServer() failed
+std::string GetNetplayLoopbackServerError(void);
+
+#endif // NETPLAYSERVER_HPP
@@ -0,0 +1,105 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <RMG-Core/Settings.hpp>
+#include <RMG-Core/Error.hpp>
+#include <RMG-Core/Core.hpp>
+
+#include <functional>
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+
+//
+// Settings benchmark, initializes the core and reports the
+// cost of retrieving settings by their SettingsID, with the
+// settings cache dropped before every call (which is what
+// every call cost before the cache) and with the cache
+//
+// usage: SettingsBenchmark [iterations]
+//
+
+//
+// Local Variables
+//
+
+static volatile int l_Sink = 0;
+
+//
+// Local Functions
+//
+
+static double time_calls(int iterations, bool invalidate, const std::function<int(void)>& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        if (invalidate)
+        {
+            CoreSettingsInvalidateCache();
+        }
+        l_Sink = l_Sink + function();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void run_benchmark(const std::string& name, int iterations, const std::function<int(void)>& function)
+{
+    double uncachedNs = time_calls(iterations, true, function);
+    // fill the cache before timing it
+    function();
+    double cachedNs = time_calls(iterations, false, function);
+
+    std::cout << name << std::endl;
+    std::cout << "  uncached:     " << uncachedNs << " ns/call" << std::endl;
+    std::cout << "  cached:       " << cachedNs << " ns/call" << std::endl;
+    std::cout << "  speedup:      " << (uncachedNs / cachedNs) << "x" << std::endl;
+}
+
+//
+// Main
+//
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    if (!CoreInit())
+    {
+        std::cerr << "SettingsBenchmark: failed to initialize core: " << CoreGetError() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    run_benchmark("int (GUI_OnScreenDisplayDuration)", iterations, []()
+    {
+        return CoreSettingsGetIntValue(SettingsID::GUI_OnScreenDisplayDuration);
+    });
+    run_benchmark("bool (GUI_OnScreenDisplayEnabled)", iterations, []()
+    {
+        return static_cast<int>(CoreSettingsGetBoolValue(SettingsID::GUI_OnScreenDisplayEnabled));
+    });
+    run_benchmark("float (GUI_OnScreenDisplayScale)", iterations, []()
+    {
+        return static_cast<int>(CoreSettingsGetFloatValue(SettingsID::GUI_OnScreenDisplayScale));
+    });
+    run_benchmark("string (GUI_OnScreenDisplayTextColor)", iterations, []()
+    {
+        return static_cast<int>(CoreSettingsGetStringValue(SettingsID::GUI_OnScreenDisplayTextColor).size());
+    });
+    run_benchmark("int list (GUI_OnScreenDisplayBackgroundColor)", iterations, []()
+    {
+        return static_cast<int>(CoreSettingsGetIntListValue(SettingsID::GUI_OnScreenDisplayBackgroundColor).size());
+    });
+
+    CoreShutdown();
+    return EXIT_SUCCESS;
+}
@@ -30,6 +30,7 @@
 
 #include <RMG-Core/m64p/api/m64p_types.h>
 
+#include <RMG-Core/FramePacing.hpp>
 #include <RMG-Core/Settings.hpp>
 #include <RMG-Core/Netplay.hpp>
 
@@ -37,6 +38,16 @@
 #define N64_SAMPLE_BYTES 4
 #define SDL_SAMPLE_BYTES 4
 
+/* speed at which fast-forwarded audio is decimated,
+ * and speed at which decimation stops again */
+#define DECIMATE_START_SPEED 1.25
+#define DECIMATE_STOP_SPEED  1.10
+/* duration of the fades around skipped audio, in seconds */
+#define DECIMATE_FADE_TIME 0.002
+/* pushes which are further apart than this, in nanoseconds,
+ * i.e when emulation has been paused, restart the measurement */
+#define DECIMATE_MAX_PUSH_INTERVAL 100000000
+
 struct sdl_backend
 {
     /* Audio Stream */
@@ -61,6 +72,15 @@ struct sdl_backend
 
     float volume;
 
+    /* Decimation of fast-forwarded audio */
+    Uint64 last_push_time;
+    double push_interval;
+    double push_duration;
+    double input_speed;
+    double keep_credit;
+    bool decimating;
+    bool skipped_previous;
+
     /* Resampler */
     void* resampler;
     const struct resampler_interface* iresampler;
@@ -199,6 +219,72 @@ void sdl_set_frequency(struct sdl_backend* sdl_backend, unsigned int frequency)
     sdl_init_audio_device(sdl_backend);
 }
 
+/* measures the speed at which audio comes in relative to the
+ * speed it's played at, returns whether audio should be decimated */
+static bool sdl_update_decimation(struct sdl_backend* sdl_backend, size_t size)
+{
+    Uint64 now = SDL_GetTicksNS();
+    Uint64 interval = now - sdl_backend->last_push_time;
+    sdl_backend->last_push_time = now;
+
+    double duration = (double)size / (double)(sdl_backend->frequency * N64_SAMPLE_BYTES);
+
+    if (sdl_backend->push_interval <= 0.0 || duration <= 0.0 || interval == 0 ||
+        interval > DECIMATE_MAX_PUSH_INTERVAL)
+    {
+        /* restart at normal speed */
+        sdl_backend->push_interval = duration;
+        sdl_backend->push_duration = duration;
+        sdl_backend->input_speed = 1.0;
+        sdl_backend->decimating = false;
+        return false;
+    }
+
+    /* the time between pushes jitters a lot, so smooth both
+     * the time between pushes and the duration of the audio */
+    sdl_backend->push_interval += (((double)interval / 1000000000.0) - sdl_backend->push_interval) * 0.1;
+    sdl_backend->push_duration += (duration - sdl_backend->push_duration) * 0.1;
+    sdl_backend->input_speed = sdl_backend->push_duration / sdl_backend->push_interval;
+
+    if (!sdl_backend->decimating && sdl_backend->input_speed >= DECIMATE_START_SPEED)
+    {
+        sdl_backend->decimating = true;
+        sdl_backend->keep_credit = 1.0;
+    }
+    else if (sdl_backend->decimating && sdl_backend->input_speed <= DECIMATE_STOP_SPEED)
+    {
+        sdl_backend->decimating = false;
+    }
+
+    return sdl_backend->decimating;
+}
+
+static void sdl_fade_samples(struct sdl_backend* sdl_backend, int16_t* samples, size_t count, bool fade_in, bool fade_out)
+{
+    size_t fade_count = (size_t)(sdl_backend->frequency * DECIMATE_FADE_TIME);
+    if (fade_count > (count / 2))
+    {
+        fade_count = count / 2;
+    }
+
+    for (size_t i = 0; i < fade_count; i++)
+    {
+        float gain = (float)i / (float)fade_count;
+
+        if (fade_in)
+        {
+            samples[(i * 2) + 0] = (int16_t)(samples[(i * 2) + 0] * gain);
+            samples[(i * 2) + 1] = (int16_t)(samples[(i * 2) + 1] * gain);
+        }
+        if (fade_out)
+        {
+            size_t j = count - 1 - i;
+            samples[(j * 2) + 0] = (int16_t)(samples[(j * 2) + 0] * gain);
+            samples[(j * 2) + 1] = (int16_t)(samples[(j * 2) + 1] * gain);
+        }
+    }
+}
+
 void sdl_push_samples(struct sdl_backend* sdl_backend, const void* src, size_t size)
 {
     if (sdl_backend->error != 0)
@@ -207,10 +293,11 @@ void sdl_push_samples(struct sdl_backend* sdl_backend, const void* src, size_t s
     // taken from https://github.com/gopher64/gopher64/blob/f3271cba63571d4d42c84c4c2db891af125b6f8d/src/ui/audio.rs
     double audioQueued = (double)SDL_GetAudioStreamQueued(sdl_backend->stream);
     double acceptableLatency = ((double)sdl_backend->frequency * 0.2) * 4.0;
-    if (audioQueued >= acceptableLatency)
-    {
-        return;
-    }
+
+    /* when the frame pacer follows the audio device, it keeps
+     * the queue at half of the acceptable latency */
+    CoreReportFramePacingAudioQueue(audioQueued / ((double)sdl_backend->frequency * SDL_SAMPLE_BYTES),
+                                    acceptableLatency / 2.0 / ((double)sdl_backend->frequency * SDL_SAMPLE_BYTES));
 
     /* truncate to full samples */
     if (size & 0x3) {
@@ -218,6 +305,38 @@ void sdl_push_samples(struct sdl_backend* sdl_backend, const void* src, size_t s
     }
     size = (size / 4) * 4;
 
+    /* when audio comes in faster than it's played, i.e during fast-forward,
+     * only keep 1 out of every speed buffers, so the audio keeps its pitch
+     * and the queue doesn't run into the latency cap */
+    bool decimate = sdl_update_decimation(sdl_backend, size);
+    bool fade_in  = false;
+    bool fade_out = false;
+
+    if (audioQueued >= acceptableLatency)
+    {
+        sdl_backend->skipped_previous = true;
+        return;
+    }
+
+    if (decimate)
+    {
+        sdl_backend->keep_credit += 1.0 / sdl_backend->input_speed;
+        if (sdl_backend->keep_credit < 1.0)
+        {
+            sdl_backend->skipped_previous = true;
+            return;
+        }
+        sdl_backend->keep_credit -= 1.0;
+
+        fade_in  = sdl_backend->skipped_previous;
+        fade_out = (sdl_backend->keep_credit + (1.0 / sdl_backend->input_speed)) < 1.0;
+    }
+    else if (sdl_backend->skipped_previous)
+    {
+        fade_in = true;
+    }
+    sdl_backend->skipped_previous = false;
+
     /* resize buffers when required */
     if (size > sdl_backend->buffers_size)
     {
@@ -250,6 +369,12 @@ void sdl_push_samples(struct sdl_backend* sdl_backend, const void* src, size_t s
         }
     }
 
+    /* fade around skipped audio to prevent clicks */
+    if (fade_in || fade_out)
+    {
+        sdl_fade_samples(sdl_backend, (int16_t*)sdl_backend->primary_buffer, size / 4, fade_in, fade_out);
+    }
+
     /* resample audio */
     sdl_backend->iresampler->resample(sdl_backend->resampler, 
                                         sdl_backend->primary_buffer, size, 
@@ -10,11 +10,13 @@
 #define CORE_INTERNAL
 #include "Archive.hpp"
 
+#include "ArchiveCache.hpp"
 #include "Directories.hpp"
 #include "Library.hpp"
 #include "String.hpp"
 #include "Error.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 
@@ -42,6 +44,28 @@
 
 #define UNZIP_READ_SIZE 67108860 /* 64 MiB */
 
+//
+// Local Structures
+//
+
+struct l_ArchiveFile
+{
+    std::filesystem::path name;
+    bool     isDisk = false;
+    uint32_t crc    = 0;
+    uint64_t size   = 0;
+    uint32_t index  = 0;
+};
+
+struct l_7zipFile
+{
+    ISzAlloc      allocImp;
+    ISzAlloc      allocTempImp;
+    CFileInStream archiveStream;
+    CLookToRead2  lookStream;
+    CSzArEx       db;
+};
+
 //
 // Local Functions
 //
@@ -110,19 +134,8 @@ static int zlib_filefunc_testerror(voidpf, voidpf)
     return errno;
 }
 
-//
-// Exported Functions
-//
-
-CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer)
+static void init_zip_filefuncs(zlib_filefunc64_def& filefuncs, std::ifstream& fileStream)
 {
-    std::string  error;
-    std::ifstream fileStream;
-
-    unzFile           zipFile;
-    unz_global_info64 zipInfo;
-
-    zlib_filefunc64_def filefuncs;
     filefuncs.zopen64_file = zlib_filefunc_open;
     filefuncs.zread_file   = zlib_filefunc_read;
     filefuncs.zwrite_file  = nullptr;
@@ -131,6 +144,23 @@ CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::pa
     filefuncs.zclose_file  = zlib_filefunc_close;
     filefuncs.zerror_file  = zlib_filefunc_testerror;
     filefuncs.opaque       = &fileStream;
+}
+
+static bool is_supported_file(const std::filesystem::path& fileName, bool& isDisk)
+{
+    std::string fileExtension = fileName.has_extension() ? fileName.extension().string() : "";
+    fileExtension = CoreLowerString(fileExtension);
+
+    isDisk = (fileExtension == ".ndd" || fileExtension == ".d64");
+    return isDisk ||
+            fileExtension == ".z64" ||
+            fileExtension == ".v64" ||
+            fileExtension == ".n64";
+}
+
+static bool open_zip_file(const std::filesystem::path& file, zlib_filefunc64_def& filefuncs, unzFile& zipFile)
+{
+    std::string error;
 
     zipFile = unzOpen2_64(&file, &filefuncs);
     if (zipFile == nullptr)
@@ -152,6 +182,16 @@ CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::pa
         return false;
     }
 
+    return true;
+}
+
+// moves to the first supported file in the zip file,
+// this only reads the central directory of the zip file
+static bool find_zip_file(unzFile zipFile, l_ArchiveFile& archiveFile)
+{
+    std::string       error;
+    unz_global_info64 zipInfo;
+
     if (unzGetGlobalInfo64(zipFile, &zipInfo) != UNZ_OK)
     {
         error = "CoreReadZipFile: unzGetGlobalInfo Failed!";
@@ -161,18 +201,16 @@ CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::pa
 
     for (uint64_t i = 0; i < zipInfo.number_entry; i++)
     {
-        unz_file_info fileInfo;
-        char          fileName[CORE_DIR_MAX_LEN];
+        unz_file_info64 fileInfo;
+        char            fileName[CORE_DIR_MAX_LEN];
 
         // if we can't retrieve file info,
         // skip the file
-        if (unzGetCurrentFileInfo(zipFile, &fileInfo, fileName, CORE_DIR_MAX_LEN, nullptr, 0, nullptr, 0) != UNZ_OK)
+        if (unzGetCurrentFileInfo64(zipFile, &fileInfo, fileName, CORE_DIR_MAX_LEN, nullptr, 0, nullptr, 0) != UNZ_OK)
         {
             continue;
         }
 
-        // make sure file has supported file format,
-        // if it does, read it in memory
         std::filesystem::path fileNamePath;
         // Windows sometimes throws an exception when assigning a string to a path
         // due to being unable to convert the character sequence.
@@ -185,48 +223,19 @@ CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::pa
         {
             // ignore exception
         }
-        std::string fileExtension = fileNamePath.has_extension() ? fileNamePath.extension().string() : "";
-        fileExtension = CoreLowerString(fileExtension);
-        if (fileExtension == ".z64" ||
-            fileExtension == ".v64" ||
-            fileExtension == ".n64" ||
-            fileExtension == ".ndd" ||
-            fileExtension == ".d64")
-        {
-            std::vector<char> buffer(UNZIP_READ_SIZE);
-            int bytes_read = 0;
-
-            outBuffer.reserve(UNZIP_READ_SIZE);
 
-            if (unzOpenCurrentFile(zipFile) != UNZ_OK)
+        if (is_supported_file(fileNamePath, archiveFile.isDisk))
+        {
+            if (fileInfo.uncompressed_size > CORE_ARCHIVE_FILE_SIZE_MAX)
             {
-                error = "CoreReadZipFile Failed: unzOpenCurrentFile Failed!";
+                error = "CoreReadZipFile Failed: ROM in zip is too large!";
                 CoreSetError(error);
                 return false;
             }
 
-            do
-            {
-                bytes_read = unzReadCurrentFile(zipFile, buffer.data(), UNZIP_READ_SIZE);
-                if (bytes_read < 0)
-                {
-                    unzCloseCurrentFile(zipFile);
-                    unzClose(zipFile);
-                    error = "CoreReadZipFile Failed: unzReadCurrentFile Failed: ";
-                    error += std::to_string(bytes_read);
-                    CoreSetError(error);
-                    return false;
-                }
-                else if (bytes_read > 0)
-                {
-                    outBuffer.insert(outBuffer.end(), buffer.begin(), std::next(buffer.begin(), bytes_read));
-                }
-            } while (bytes_read > 0);
-
-            extractedFileName = fileNamePath;
-            isDisk            = (fileExtension == ".ndd" || fileExtension == ".d64");
-            unzCloseCurrentFile(zipFile);
-            unzClose(zipFile);
+            archiveFile.name = fileNamePath;
+            archiveFile.crc  = static_cast<uint32_t>(fileInfo.crc);
+            archiveFile.size = fileInfo.uncompressed_size;
             return true;
         }
 
@@ -239,7 +248,6 @@ CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::pa
         // move to next file
         if (unzGoToNextFile(zipFile) != UNZ_OK)
         {
-            unzClose(zipFile);
             error = "CoreReadZipFile Failed: unzGoToNextFile Failed!";
             CoreSetError(error);
             return false;
@@ -248,34 +256,91 @@ CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::pa
 
     error = "CoreReadZipFile Failed: no valid ROMs found in zip!";
     CoreSetError(error);
-    unzClose(zipFile);
     return false;
 }
 
-CORE_EXPORT bool CoreRead7zipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer)
+static bool read_zip_file(unzFile zipFile, const l_ArchiveFile& archiveFile, std::vector<char>& outBuffer)
 {
-    std::string  error;
+    std::string error;
+    size_t      offset     = 0;
+    int         bytes_read = 0;
+    int         ret;
 
-    const ISzAlloc alloc = { SzAlloc, SzFree };
-    const size_t bufSize = (static_cast<size_t>(1) << 18);
+    if (unzOpenCurrentFile(zipFile) != UNZ_OK)
+    {
+        error = "CoreReadZipFile Failed: unzOpenCurrentFile Failed!";
+        CoreSetError(error);
+        return false;
+    }
 
-    ISzAlloc allocImp;
-    ISzAlloc allocTempImp;
+    // the size in the central directory can't be
+    // trusted, so grow the buffer when needed, up to
+    // one byte more than the largest ROM/disk we accept
+    outBuffer.resize(std::max(archiveFile.size, static_cast<uint64_t>(1)));
 
-    CFileInStream archiveStream;
-    CLookToRead2 lookStream;
-    CSzArEx db;
+    do
+    {
+        if (offset == outBuffer.size())
+        {
+            if (offset > CORE_ARCHIVE_FILE_SIZE_MAX)
+            {
+                unzCloseCurrentFile(zipFile);
+                outBuffer.clear();
+                error = "CoreReadZipFile Failed: ROM in zip is too large!";
+                CoreSetError(error);
+                return false;
+            }
+
+            outBuffer.resize(std::min(outBuffer.size() + UNZIP_READ_SIZE, static_cast<size_t>(CORE_ARCHIVE_FILE_SIZE_MAX) + 1));
+        }
+
+        size_t readSize = std::min(outBuffer.size() - offset, static_cast<size_t>(UNZIP_READ_SIZE));
+        bytes_read = unzReadCurrentFile(zipFile, outBuffer.data() + offset, static_cast<unsigned int>(readSize));
+        if (bytes_read < 0)
+        {
+            unzCloseCurrentFile(zipFile);
+            outBuffer.clear();
+            error = "CoreReadZipFile Failed: unzReadCurrentFile Failed: ";
+            error += std::to_string(bytes_read);
+            CoreSetError(error);
+            return false;
+        }
+
+        offset += bytes_read;
+    } while (bytes_read > 0);
+
+    outBuffer.resize(offset);
+
+    // the CRC is only verified when closing the file,
+    // don't hand out (and cache) corrupted data
+    ret = unzCloseCurrentFile(zipFile);
+    if (ret != UNZ_OK)
+    {
+        outBuffer.clear();
+        error = "CoreReadZipFile Failed: unzCloseCurrentFile Failed: ";
+        error += std::to_string(ret);
+        CoreSetError(error);
+        return false;
+    }
+
+    return true;
+}
+
+static bool open_7zip_file(const std::filesystem::path& file, l_7zipFile& archive)
+{
+    std::string error;
+    const size_t bufSize = (static_cast<size_t>(1) << 18);
     SRes res;
 
-    // initialize allocator 
-    allocImp     = alloc;
-    allocTempImp = alloc;
+    // initialize allocator
+    archive.allocImp     = { SzAlloc, SzFree };
+    archive.allocTempImp = { SzAlloc, SzFree };
 
     // try to open file
 #ifdef _WIN32
-    WRes wres = InFile_OpenW(&archiveStream.file, file.wstring().c_str());
+    WRes wres = InFile_OpenW(&archive.archiveStream.file, file.wstring().c_str());
 #else
-    WRes wres = InFile_Open(&archiveStream.file, file.string().c_str());
+    WRes wres = InFile_Open(&archive.archiveStream.file, file.string().c_str());
 #endif // _WIN32
     if (wres != 0)
     {
@@ -286,62 +351,79 @@ CORE_EXPORT bool CoreRead7zipFile(std::filesystem::path file, std::filesystem::p
     }
 
     // create vtables for streams
-    FileInStream_CreateVTable(&archiveStream);
-    archiveStream.wres = 0;
-    LookToRead2_CreateVTable(&lookStream, 0);
-    lookStream.buf = nullptr;
+    FileInStream_CreateVTable(&archive.archiveStream);
+    archive.archiveStream.wres = 0;
+    LookToRead2_CreateVTable(&archive.lookStream, 0);
+    archive.lookStream.buf = nullptr;
 
     // allocate memory look reader
-    lookStream.buf = static_cast<Byte*>(ISzAlloc_Alloc(&allocImp, bufSize));
-    if (lookStream.buf == nullptr)
+    archive.lookStream.buf = static_cast<Byte*>(ISzAlloc_Alloc(&archive.allocImp, bufSize));
+    if (archive.lookStream.buf == nullptr)
     {
+        File_Close(&archive.archiveStream.file);
         error = "CoreRead7zipFile Failed: ISzAlloc_Alloc Failed!";
         CoreSetError(error);
         return false;
     }
 
     // initialize look reader
-    lookStream.bufSize = bufSize;
-    lookStream.realStream = &archiveStream.vt;
-    LookToRead2_INIT(&lookStream);
+    archive.lookStream.bufSize = bufSize;
+    archive.lookStream.realStream = &archive.archiveStream.vt;
+    LookToRead2_INIT(&archive.lookStream);
 
     // initialize CRC table
     CrcGenerateTable();
 
     // initialize archive
-    SzArEx_Init(&db);
+    SzArEx_Init(&archive.db);
 
-    // try to open file
-    res = SzArEx_Open(&db, &lookStream.vt, &allocImp, &allocTempImp);
+    // try to open file, this only
+    // reads the headers of the archive
+    res = SzArEx_Open(&archive.db, &archive.lookStream.vt, &archive.allocImp, &archive.allocTempImp);
     if (res != SZ_OK)
     {
         error = "CoreRead7zipFile Failed: SzArEx_Open Failed: ";
         error += std::to_string(res);
         CoreSetError(error);
-        SzArEx_Free(&db, &allocImp);
-        ISzAlloc_Free(&allocImp, lookStream.buf);
+        SzArEx_Free(&archive.db, &archive.allocImp);
+        ISzAlloc_Free(&archive.allocImp, archive.lookStream.buf);
+        File_Close(&archive.archiveStream.file);
         return false;
     }
 
-    for (uint32_t i = 0; i < db.NumFiles; i++)
+    return true;
+}
+
+static void close_7zip_file(l_7zipFile& archive)
+{
+    SzArEx_Free(&archive.db, &archive.allocImp);
+    ISzAlloc_Free(&archive.allocImp, archive.lookStream.buf);
+    File_Close(&archive.archiveStream.file);
+}
+
+static bool find_7zip_file(l_7zipFile& archive, l_ArchiveFile& archiveFile)
+{
+    std::string error;
+
+    for (uint32_t i = 0; i < archive.db.NumFiles; i++)
     {
         size_t filename_size = 0;
         uint16_t fileName[CORE_DIR_MAX_LEN];
 
         // skip directories
-        if (SzArEx_IsDir(&db, i))
+        if (SzArEx_IsDir(&archive.db, i))
         {
             continue;
         }
 
         // skip when filename size exceeds our buffer size
-        filename_size = SzArEx_GetFileNameUtf16(&db, i, nullptr);
+        filename_size = SzArEx_GetFileNameUtf16(&archive.db, i, nullptr);
         if (filename_size > CORE_DIR_MAX_LEN)
         {
             continue;
         }
 
-        SzArEx_GetFileNameUtf16(&db, i, fileName);
+        SzArEx_GetFileNameUtf16(&archive.db, i, fileName);
 
         std::filesystem::path fileNamePath;
         // Windows sometimes throws an exception when assigning a string to a path
@@ -355,86 +437,221 @@ CORE_EXPORT bool CoreRead7zipFile(std::filesystem::path file, std::filesystem::p
         {
             // ignore exception
         }
-        std::string fileExtension = fileNamePath.has_extension() ? fileNamePath.extension().string() : "";
-        fileExtension = CoreLowerString(fileExtension);
-        if (fileExtension == ".z64" ||
-            fileExtension == ".v64" ||
-            fileExtension == ".n64" ||
-            fileExtension == ".ndd" ||
-            fileExtension == ".d64")
+
+        if (is_supported_file(fileNamePath, archiveFile.isDisk))
         {
-            uint32_t blockIndex = 0xFFFFFFFF;
-            uint8_t* readBuffer = nullptr;
-            size_t   readBufferSize = 0;
-            size_t   offset = 0;
-            size_t   outSizeProcessed = 0;
-
-            res = SzArEx_Extract(&db, &lookStream.vt, i,
-                                    &blockIndex, &readBuffer, &readBufferSize,
-                                    &offset, &outSizeProcessed,
-                                    &allocImp, &allocTempImp);
-            if (res != SZ_OK)
+            if (SzArEx_GetFileSize(&archive.db, i) > CORE_ARCHIVE_FILE_SIZE_MAX)
             {
-                error = "CoreRead7zipFile Failed: SzArEx_Extract Failed: ";
-                error += std::to_string(res);
+                error = "CoreRead7zipFile Failed: ROM in 7zip is too large!";
                 CoreSetError(error);
-
-                SzArEx_Free(&db, &allocImp);
-                ISzAlloc_Free(&allocImp, lookStream.buf);
-                File_Close(&archiveStream.file);
-                ISzAlloc_Free(&allocImp, readBuffer);
                 return false;
             }
 
-            outBuffer.insert(outBuffer.begin(), readBuffer, readBuffer + outSizeProcessed);
-            extractedFileName = fileNamePath;
-            isDisk            = (fileExtension == ".ndd" || fileExtension == ".d64");
-
-            SzArEx_Free(&db, &allocImp);
-            ISzAlloc_Free(&allocImp, lookStream.buf);
-            File_Close(&archiveStream.file);
-            ISzAlloc_Free(&allocImp, readBuffer);
+            archiveFile.name  = fileNamePath;
+            archiveFile.crc   = SzBitWithVals_Check(&archive.db.CRCs, i) ? archive.db.CRCs.Vals[i] : 0;
+            archiveFile.size  = SzArEx_GetFileSize(&archive.db, i);
+            archiveFile.index = i;
             return true;
         }
     }
 
-    // cleanup
-    SzArEx_Free(&db, &allocImp);
-    ISzAlloc_Free(&allocImp, lookStream.buf);
-    File_Close(&archiveStream.file);
-
     error = "CoreRead7zipFile Failed: no valid ROMs found in 7zip!";
     CoreSetError(error);
     return false;
 }
 
-CORE_EXPORT bool CoreReadArchiveFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer)
+static bool read_7zip_file(l_7zipFile& archive, const l_ArchiveFile& archiveFile, std::vector<char>& outBuffer)
 {
-	std::string file_extension;
+    std::string error;
+    uint32_t blockIndex = 0xFFFFFFFF;
+    uint8_t* readBuffer = nullptr;
+    size_t   readBufferSize = 0;
+    size_t   offset = 0;
+    size_t   outSizeProcessed = 0;
+    SRes     res;
+
+    res = SzArEx_Extract(&archive.db, &archive.lookStream.vt, archiveFile.index,
+                            &blockIndex, &readBuffer, &readBufferSize,
+                            &offset, &outSizeProcessed,
+                            &archive.allocImp, &archive.allocTempImp);
+    if (res != SZ_OK)
+    {
+        error = "CoreRead7zipFile Failed: SzArEx_Extract Failed: ";
+        error += std::to_string(res);
+        CoreSetError(error);
+        ISzAlloc_Free(&archive.allocImp, readBuffer);
+        return false;
+    }
 
-	file_extension = file.has_extension() ? file.extension().string() : "";
-    file_extension = CoreLowerString(file_extension);
+    // the file starts at offset in the extracted block
+    outBuffer.assign(readBuffer + offset, readBuffer + offset + outSizeProcessed);
+    ISzAlloc_Free(&archive.allocImp, readBuffer);
+    return true;
+}
 
-    if (file_extension != ".zip" && file_extension != ".7z")
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreReadZipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer, bool addToCache)
+{
+    std::ifstream       fileStream;
+    zlib_filefunc64_def filefuncs;
+    unzFile             zipFile;
+    l_ArchiveFile       archiveFile;
+    uint64_t            cacheKey;
+
+    init_zip_filefuncs(filefuncs, fileStream);
+
+    if (!open_zip_file(file, filefuncs, zipFile))
     {
         return false;
     }
 
+    if (!find_zip_file(zipFile, archiveFile))
+    {
+        unzClose(zipFile);
+        return false;
+    }
+
+    extractedFileName = archiveFile.name;
+    isDisk            = archiveFile.isDisk;
+
+    cacheKey = CoreGetArchiveCacheKey(file, archiveFile.name, archiveFile.crc, archiveFile.size);
+    if (CoreReadArchiveCacheFile(cacheKey, archiveFile.size, outBuffer))
+    {
+        unzClose(zipFile);
+        return true;
+    }
+
+    if (!read_zip_file(zipFile, archiveFile, outBuffer))
+    {
+        unzClose(zipFile);
+        return false;
+    }
+
+    unzClose(zipFile);
+
+    if (addToCache && outBuffer.size() == archiveFile.size)
+    {
+        CoreWriteArchiveCacheFile(cacheKey, outBuffer);
+    }
+    return true;
+}
+
+CORE_EXPORT bool CoreRead7zipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer, bool addToCache)
+{
+    l_7zipFile    archive;
+    l_ArchiveFile archiveFile;
+    uint64_t      cacheKey;
+
+    if (!open_7zip_file(file, archive))
+    {
+        return false;
+    }
+
+    if (!find_7zip_file(archive, archiveFile))
+    {
+        close_7zip_file(archive);
+        return false;
+    }
+
+    extractedFileName = archiveFile.name;
+    isDisk            = archiveFile.isDisk;
+
+    cacheKey = CoreGetArchiveCacheKey(file, archiveFile.name, archiveFile.crc, archiveFile.size);
+    if (CoreReadArchiveCacheFile(cacheKey, archiveFile.size, outBuffer))
+    {
+        close_7zip_file(archive);
+        return true;
+    }
+
+    if (!read_7zip_file(archive, archiveFile, outBuffer))
+    {
+        close_7zip_file(archive);
+        return false;
+    }
+
+    close_7zip_file(archive);
+
+    if (addToCache)
+    {
+        CoreWriteArchiveCacheFile(cacheKey, outBuffer);
+    }
+    return true;
+}
+
+CORE_EXPORT bool CoreReadArchiveFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer, bool addToCache)
+{
+    std::string file_extension;
+
+    file_extension = file.has_extension() ? file.extension().string() : "";
+    file_extension = CoreLowerString(file_extension);
+
+    if (file_extension == ".zip")
+    {
+        return CoreReadZipFile(file, extractedFileName, isDisk, outBuffer, addToCache);
+    }
+    else if (file_extension == ".7z")
+    {
+        return CoreRead7zipFile(file, extractedFileName, isDisk, outBuffer, addToCache);
+    }
+
+    return false;
+}
+
+CORE_EXPORT bool CoreGetArchiveFileInfo(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, uint64_t& size)
+{
+    std::string   file_extension;
+    l_ArchiveFile archiveFile;
+
+    file_extension = file.has_extension() ? file.extension().string() : "";
+    file_extension = CoreLowerString(file_extension);
+
     if (file_extension == ".zip")
     {
-    	if (!CoreReadZipFile(file, extractedFileName, isDisk, outBuffer))
+        std::ifstream       fileStream;
+        zlib_filefunc64_def filefuncs;
+        unzFile             zipFile;
+
+        init_zip_filefuncs(filefuncs, fileStream);
+
+        if (!open_zip_file(file, filefuncs, zipFile))
+        {
+            return false;
+        }
+
+        bool ret = find_zip_file(zipFile, archiveFile);
+        unzClose(zipFile);
+        if (!ret)
         {
             return false;
         }
     }
-    else
+    else if (file_extension == ".7z")
     {
-        if (!CoreRead7zipFile(file, extractedFileName, isDisk, outBuffer))
+        l_7zipFile archive;
+
+        if (!open_7zip_file(file, archive))
+        {
+            return false;
+        }
+
+        bool ret = find_7zip_file(archive, archiveFile);
+        close_7zip_file(archive);
+        if (!ret)
         {
             return false;
         }
     }
+    else
+    {
+        return false;
+    }
 
+    extractedFileName = archiveFile.name;
+    isDisk            = archiveFile.isDisk;
+    size              = archiveFile.size;
     return true;
 }
 
@@ -453,14 +670,7 @@ CORE_EXPORT bool CoreUnzip(std::filesystem::path file, std::filesystem::path pat
     int bytes_read = 0;
 
     zlib_filefunc64_def filefuncs;
-    filefuncs.zopen64_file = zlib_filefunc_open;
-    filefuncs.zread_file   = zlib_filefunc_read;
-    filefuncs.zwrite_file  = nullptr;
-    filefuncs.ztell64_file = zlib_filefunc_tell;
-    filefuncs.zseek64_file = zlib_filefunc_seek;
-    filefuncs.zclose_file  = zlib_filefunc_close;
-    filefuncs.zerror_file  = zlib_filefunc_testerror;
-    filefuncs.opaque       = &fileStream;
+    init_zip_filefuncs(filefuncs, fileStream);
 
     zipFile = unzOpen2_64(&file, &filefuncs);
     if (zipFile == nullptr)
@@ -11,16 +11,31 @@
 #define CORE_ARCHIVE_HPP
 
 #include <filesystem>
+#include <cstdint>
 #include <vector>
 
-// attempts to read the ROM/disk in a zip file into outBuffer
-bool CoreReadZipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer);
+// largest ROM/disk which is read from an archive, the sizes
+// in the directory of an archive can't be trusted, so larger
+// ROMs/disks are rejected instead of allocating memory for them
+#define CORE_ARCHIVE_FILE_SIZE_MAX 0x20000000 /* 512 MiB */
 
-// attempts to read the ROM/disk in a 7zip file into outBuffer
-bool CoreRead7zipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer);
+// attempts to read the ROM/disk in a zip file into outBuffer,
+// the extracted ROM/disk is read from and added to the archive
+// cache, addToCache can be used to only read from it
+bool CoreReadZipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer, bool addToCache = true);
 
-// attempts to read the ROM/disk in a supported archive file into outBuffer
-bool CoreReadArchiveFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer);
+// attempts to read the ROM/disk in a 7zip file into outBuffer,
+// see CoreReadZipFile() for the archive cache
+bool CoreRead7zipFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer, bool addToCache = true);
+
+// attempts to read the ROM/disk in a supported archive file into outBuffer,
+// see CoreReadZipFile() for the archive cache
+bool CoreReadArchiveFile(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, std::vector<char>& outBuffer, bool addToCache = true);
+
+// attempts to retrieve the name, type and size of the ROM/disk
+// in a supported archive file, only the directory of the archive
+// is read, so the ROM/disk isn't extracted
+bool CoreGetArchiveFileInfo(std::filesystem::path file, std::filesystem::path& extractedFileName, bool& isDisk, uint64_t& size);
 
 // attempts to unzip the file to path
 bool CoreUnzip(std::filesystem::path file, std::filesystem::path path);
@@ -0,0 +1,284 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "ArchiveCache.hpp"
+#include "Directories.hpp"
+#include "Settings.hpp"
+#include "Library.hpp"
+#include "Error.hpp"
+#include "File.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+//
+// Local Defines
+//
+
+#define ARCHIVE_CACHE_MAGIC     "RMGArchiveCache1"
+#define ARCHIVE_CACHE_DIRECTORY "ArchiveCache"
+#define ARCHIVE_CACHE_EXTENSION ".rom"
+
+//
+// Local Structures
+//
+
+struct l_ArchiveCacheFileHeader
+{
+    char     magic[sizeof(ARCHIVE_CACHE_MAGIC)];
+    uint64_t key;
+    uint64_t size;
+};
+
+struct l_ArchiveCacheFile
+{
+    std::filesystem::path           path;
+    uint64_t                        size;
+    std::filesystem::file_time_type time;
+};
+
+//
+// Local Variables
+//
+
+// guards the archive cache directory,
+// the ROM browser reads from it on multiple threads
+static std::mutex l_ArchiveCacheMutex;
+
+//
+// Local Functions
+//
+
+static std::filesystem::path get_archive_cache_directory(void)
+{
+    return CoreGetUserCacheDirectory() / ARCHIVE_CACHE_DIRECTORY;
+}
+
+static std::filesystem::path get_archive_cache_file(uint64_t key)
+{
+    char fileName[17];
+    std::snprintf(fileName, sizeof(fileName), "%016llx", static_cast<unsigned long long>(key));
+    return get_archive_cache_directory() / (std::string(fileName) + ARCHIVE_CACHE_EXTENSION);
+}
+
+static void hash_archive_cache_key(uint64_t& hash, const void* data, size_t size)
+{
+    // 64-bit FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+static uint64_t get_archive_cache_size_max(void)
+{
+    int size = CoreSettingsGetIntValue(SettingsID::RomBrowser_ArchiveCacheSize);
+    return size <= 0 ? 0 : (static_cast<uint64_t>(size) * 1024 * 1024);
+}
+
+// removes the least recently used files until the total
+// size of the archive cache doesn't exceed sizeMax
+static void prune_archive_cache(uint64_t sizeMax)
+{
+    std::error_code errorCode;
+    std::vector<l_ArchiveCacheFile> files;
+    uint64_t totalSize = 0;
+
+    for (const auto& entry : std::filesystem::directory_iterator(get_archive_cache_directory(), errorCode))
+    {
+        if (!entry.is_regular_file(errorCode) ||
+            entry.path().extension() != ARCHIVE_CACHE_EXTENSION)
+        {
+            continue;
+        }
+
+        l_ArchiveCacheFile file;
+        file.path = entry.path();
+        file.size = entry.file_size(errorCode);
+        file.time = entry.last_write_time(errorCode);
+        if (errorCode)
+        {
+            continue;
+        }
+
+        totalSize += file.size;
+        files.push_back(file);
+    }
+
+    if (totalSize <= sizeMax)
+    {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const l_ArchiveCacheFile& a, const l_ArchiveCacheFile& b)
+    {
+        return a.time < b.time;
+    });
+
+    for (const l_ArchiveCacheFile& file : files)
+    {
+        if (totalSize <= sizeMax)
+        {
+            break;
+        }
+
+        if (std::filesystem::remove(file.path, errorCode))
+        {
+            totalSize -= file.size;
+        }
+    }
+}
+
+//
+// Internal Functions
+//
+
+uint64_t CoreGetArchiveCacheKey(const std::filesystem::path& archive, const std::filesystem::path& fileName, uint32_t fileCrc, uint64_t fileSize)
+{
+    std::u8string archivePath  = archive.u8string();
+    std::u8string fileNamePath = fileName.u8string();
+    CoreFileTime  archiveTime  = CoreGetFileTime(archive);
+    uint64_t      hash         = 0xcbf29ce484222325ULL;
+
+    hash_archive_cache_key(hash, archivePath.data(), archivePath.size());
+    hash_archive_cache_key(hash, &archiveTime, sizeof(archiveTime));
+    hash_archive_cache_key(hash, fileNamePath.data(), fileNamePath.size());
+    hash_archive_cache_key(hash, &fileCrc, sizeof(fileCrc));
+    hash_archive_cache_key(hash, &fileSize, sizeof(fileSize));
+    return hash;
+}
+
+bool CoreReadArchiveCacheFile(uint64_t key, uint64_t size, std::vector<char>& outBuffer)
+{
+    std::lock_guard<std::mutex> lock(l_ArchiveCacheMutex);
+    std::filesystem::path file = get_archive_cache_file(key);
+    std::error_code errorCode;
+    std::ifstream inputStream;
+    l_ArchiveCacheFileHeader header;
+
+    if (get_archive_cache_size_max() == 0)
+    {
+        return false;
+    }
+
+    inputStream.open(file, std::ios::binary);
+    if (!inputStream.is_open())
+    {
+        return false;
+    }
+
+    inputStream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!inputStream ||
+        std::memcmp(header.magic, ARCHIVE_CACHE_MAGIC, sizeof(ARCHIVE_CACHE_MAGIC)) != 0 ||
+        header.key != key ||
+        header.size != size)
+    {
+        return false;
+    }
+
+    outBuffer.resize(size);
+    inputStream.read(outBuffer.data(), size);
+    if (!inputStream)
+    {
+        outBuffer.clear();
+        return false;
+    }
+
+    inputStream.close();
+
+    // mark the file as recently used
+    std::filesystem::last_write_time(file, std::filesystem::file_time_type::clock::now(), errorCode);
+    return true;
+}
+
+bool CoreWriteArchiveCacheFile(uint64_t key, const std::vector<char>& buffer)
+{
+    std::lock_guard<std::mutex> lock(l_ArchiveCacheMutex);
+    std::filesystem::path file = get_archive_cache_file(key);
+    std::filesystem::path tmpFile = file;
+    std::error_code errorCode;
+    std::ofstream outputStream;
+    l_ArchiveCacheFileHeader header;
+    uint64_t sizeMax = get_archive_cache_size_max();
+
+    // files which don't fit aren't cached
+    if (buffer.size() + sizeof(header) > sizeMax)
+    {
+        return false;
+    }
+
+    if (!std::filesystem::is_directory(file.parent_path(), errorCode) &&
+        !std::filesystem::create_directories(file.parent_path(), errorCode))
+    {
+        return false;
+    }
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ARCHIVE_CACHE_MAGIC, sizeof(ARCHIVE_CACHE_MAGIC));
+    header.key  = key;
+    header.size = buffer.size();
+
+    // write to a temporary file first, so a
+    // partially written file is never read
+    tmpFile += ".tmp";
+
+    outputStream.open(tmpFile, std::ios::binary | std::ios::trunc);
+    if (!outputStream.is_open())
+    {
+        return false;
+    }
+
+    outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outputStream.write(buffer.data(), buffer.size());
+    outputStream.close();
+
+    if (outputStream.fail())
+    {
+        std::filesystem::remove(tmpFile, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(tmpFile, file, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(tmpFile, errorCode);
+        return false;
+    }
+
+    prune_archive_cache(sizeMax);
+    return true;
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreClearArchiveCache(void)
+{
+    std::lock_guard<std::mutex> lock(l_ArchiveCacheMutex);
+    std::string error;
+    std::error_code errorCode;
+
+    std::filesystem::remove_all(get_archive_cache_directory(), errorCode);
+    if (errorCode)
+    {
+        error = "CoreClearArchiveCache Failed: ";
+        error += errorCode.message();
+        CoreSetError(error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,36 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ARCHIVECACHE_HPP
+#define CORE_ARCHIVECACHE_HPP
+
+#include <filesystem>
+#include <cstdint>
+#include <vector>
+
+#ifdef CORE_INTERNAL
+// returns the key of the extracted file in the archive cache,
+// it's derived from the archive path and file time and the
+// name, CRC32 and size of the file in the archive
+uint64_t CoreGetArchiveCacheKey(const std::filesystem::path& archive, const std::filesystem::path& fileName, uint32_t fileCrc, uint64_t fileSize);
+
+// attempts to read the extracted file with the given key
+// and size from the archive cache into outBuffer
+bool CoreReadArchiveCacheFile(uint64_t key, uint64_t size, std::vector<char>& outBuffer);
+
+// attempts to add the extracted file to the archive cache,
+// when the archive cache exceeds its maximum size, the least
+// recently used files are removed
+bool CoreWriteArchiveCacheFile(uint64_t key, const std::vector<char>& buffer);
+#endif // CORE_INTERNAL
+
+// returns whether clearing the archive cache succeeds
+bool CoreClearArchiveCache(void);
+
+#endif // CORE_ARCHIVECACHE_HPP
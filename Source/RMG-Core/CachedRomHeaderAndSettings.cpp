@@ -12,39 +12,38 @@
 #include "Directories.hpp"
 #include "RomSettings.hpp"
 #include "RomHeader.hpp"
+#include "RomProbe.hpp"
 #include "Library.hpp"
 #include "File.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <vector>
+#include <mutex>
 
 //
 // Local Defines
 //
 
-#define ROMHEADER_NAME_LEN 256
-#define GOODNAME_LEN 256
-#define MD5_LEN 33
-#define GAMEID_LEN 5
-#define REGION_LEN 18
-
-#ifdef _WIN32
-#define CACHE_FILE_MAGIC "RMGCoreHeaderAndSettingsCacheWindows_10"
-#else // Linux
-#define CACHE_FILE_MAGIC "RMGCoreHeaderAndSettingsCacheLinux_10"
-#endif // _WIN32
+#define CACHE_FILE_MAGIC "RMGCoreHeaderAndSettingsCache_11"
 #define CACHE_FILE_ITEMS_MAX 250000
 
+// marks an empty bucket in the hash index
+#define CACHE_FILE_BUCKET_EMPTY 0xFFFFFFFF
+
 //
 // Local Structures
 //
 
 struct l_CacheEntry
 {
-    std::filesystem::path fileName;
     CoreFileTime fileTime;
+    // entries with a higher sequence have been added
+    // more recently, used to evict the oldest entries
+    uint64_t sequence;
 
     bool valid;
 
@@ -54,12 +53,93 @@ struct l_CacheEntry
     CoreRomSettings defaultSettings;
 };
 
+//
+// The cache file consists of the header, fixed-size records,
+// the hash index and the string pool. The hash index is an
+// open addressing table (linear probing) of record indices,
+// keyed by the hash of the UTF-8 path, which allows looking
+// entries up directly in the mapped file without parsing it
+//
+
+struct l_CacheFileString
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct l_CacheFileHeader
+{
+    char     magic[sizeof(CACHE_FILE_MAGIC)];
+    uint32_t recordCount;
+    uint32_t bucketCount; // power of 2
+    uint64_t recordsOffset;
+    uint64_t bucketsOffset;
+    uint64_t stringPoolOffset;
+    uint64_t stringPoolSize;
+    uint64_t nextSequence;
+};
+
+struct l_CacheFileRecord
+{
+    uint64_t pathHash;
+    l_CacheFileString path;
+    uint64_t fileTime;
+    uint64_t sequence;
+
+    uint8_t valid;
+    uint8_t type;
+    uint8_t systemType;
+    uint8_t padding;
+
+    // header
+    uint32_t crc1;
+    uint32_t crc2;
+    uint32_t countryCode;
+    l_CacheFileString name;
+    l_CacheFileString gameID;
+    l_CacheFileString region;
+
+    // shared settings
+    l_CacheFileString goodName;
+    l_CacheFileString md5;
+
+    // default & current settings
+    struct
+    {
+        uint16_t saveType;
+        uint8_t  disableExtraMem;
+        uint8_t  transferPak;
+        int32_t  countPerOp;
+        int32_t  siDMADuration;
+    } defaultSettings, settings;
+};
+
 //
 // Local Variables
 //
 
-static bool                      l_CacheEntriesChanged = false;
-static std::vector<l_CacheEntry> l_CacheEntries;
+static bool l_CacheEntriesChanged = false;
+
+// cache file which has been loaded
+static CoreMappedFile           l_CacheFile;
+static const l_CacheFileHeader* l_CacheFileHeaderPtr = nullptr;
+
+// entries which have been added or updated after loading
+// the cache file, these take precedence over the file
+static std::unordered_map<std::string, l_CacheEntry> l_CacheEntries;
+
+// entries which have been removed after loading the
+// cache file, these are ignored in the cache file
+static std::unordered_set<std::string> l_RemovedCacheEntries;
+
+static uint64_t l_NextSequence = 0;
+
+// protects all of the above
+static std::mutex l_CacheMutex;
+
+// serializes retrieving ROMs which can't be probed,
+// those have to be opened in the core
+static std::mutex l_OpenRomMutex;
 
 //
 // Internal Functions
@@ -76,323 +156,511 @@ static std::filesystem::path get_cache_file_name(void)
     return file;
 }
 
-static std::vector<l_CacheEntry>::iterator get_cache_entry_iter(const std::filesystem::path& file, bool checkFileTime = true)
+static std::string get_cache_key(const std::filesystem::path& file)
 {
-    CoreFileTime fileTime = (checkFileTime ? CoreGetFileTime(file) : 0);
+    std::u8string key = file.u8string();
+    return std::string(reinterpret_cast<const char*>(key.data()), key.size());
+}
 
-    auto predicate = [file, fileTime, checkFileTime](const auto& entry)
+static uint64_t get_cache_key_hash(const std::string& key)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key)
     {
-        return entry.fileName == file &&
-                (!checkFileTime || entry.fileTime == fileTime);
-    };
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
 
-    return std::find_if(l_CacheEntries.begin(), l_CacheEntries.end(), predicate);
+static const l_CacheFileRecord* get_cache_file_records(void)
+{
+    return reinterpret_cast<const l_CacheFileRecord*>(l_CacheFile.Data + l_CacheFileHeaderPtr->recordsOffset);
 }
 
-static void add_cache_entry(const std::filesystem::path& file, CoreRomType type, 
-                            const CoreRomHeader& header, const CoreRomSettings& defaultSettings,
-                            const CoreRomSettings& settings)
+static const uint32_t* get_cache_file_buckets(void)
 {
-    l_CacheEntry cacheEntry;
+    return reinterpret_cast<const uint32_t*>(l_CacheFile.Data + l_CacheFileHeaderPtr->bucketsOffset);
+}
 
-    // try to find existing entry with same filename,
-    // when found, remove it from the cache
-    auto iter = get_cache_entry_iter(file, false);
+static bool get_cache_file_string(const l_CacheFileString& string, std::string& out)
+{
+    if (static_cast<uint64_t>(string.offset) + string.size > l_CacheFileHeaderPtr->stringPoolSize)
+    {
+        return false;
+    }
+
+    out.assign(l_CacheFile.Data + l_CacheFileHeaderPtr->stringPoolOffset + string.offset, string.size);
+    return true;
+}
+
+static bool validate_cache_file(void)
+{
+    const l_CacheFileHeader* header = reinterpret_cast<const l_CacheFileHeader*>(l_CacheFile.Data);
+    uint64_t recordsSize;
+    uint64_t bucketsSize;
+
+    if (l_CacheFile.Size < sizeof(l_CacheFileHeader))
+    {
+        return false;
+    }
+
+    // when magic doesn't match, don't use cache file
+    if (std::memcmp(header->magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    // bucket count must be a power of 2 and
+    // larger than the record count
+    if (header->bucketCount == 0 ||
+        (header->bucketCount & (header->bucketCount - 1)) != 0 ||
+        header->recordCount >= header->bucketCount)
+    {
+        return false;
+    }
+
+    recordsSize = static_cast<uint64_t>(header->recordCount) * sizeof(l_CacheFileRecord);
+    bucketsSize = static_cast<uint64_t>(header->bucketCount) * sizeof(uint32_t);
+
+    return header->recordsOffset % alignof(l_CacheFileRecord) == 0 &&
+           header->bucketsOffset % alignof(uint32_t) == 0 &&
+           header->recordsOffset <= l_CacheFile.Size &&
+           recordsSize <= (l_CacheFile.Size - header->recordsOffset) &&
+           header->bucketsOffset <= l_CacheFile.Size &&
+           bucketsSize <= (l_CacheFile.Size - header->bucketsOffset) &&
+           header->stringPoolOffset <= l_CacheFile.Size &&
+           header->stringPoolSize <= (l_CacheFile.Size - header->stringPoolOffset);
+}
+
+static void close_cache_file(void)
+{
+    CoreUnmapFile(l_CacheFile);
+    l_CacheFileHeaderPtr = nullptr;
+}
+
+static const l_CacheFileRecord* find_cache_file_record(const std::string& key)
+{
+    const l_CacheFileRecord* records;
+    const uint32_t* buckets;
+    uint64_t hash;
+    uint32_t mask;
+    uint32_t index;
+    std::string path;
+
+    if (l_CacheFileHeaderPtr == nullptr)
+    {
+        return nullptr;
+    }
+
+    records = get_cache_file_records();
+    buckets = get_cache_file_buckets();
+    hash    = get_cache_key_hash(key);
+    mask    = l_CacheFileHeaderPtr->bucketCount - 1;
+
+    // there's always at least one empty bucket,
+    // so the probing always terminates
+    for (index = hash & mask; buckets[index] != CACHE_FILE_BUCKET_EMPTY; index = (index + 1) & mask)
+    {
+        if (buckets[index] >= l_CacheFileHeaderPtr->recordCount)
+        {
+            return nullptr;
+        }
+
+        const l_CacheFileRecord* record = &records[buckets[index]];
+        if (record->pathHash == hash &&
+            record->path.size == key.size() &&
+            get_cache_file_string(record->path, path) &&
+            path == key)
+        {
+            return record;
+        }
+    }
+
+    return nullptr;
+}
+
+static bool decode_cache_file_record(const l_CacheFileRecord* record, l_CacheEntry& cacheEntry)
+{
+    cacheEntry = {};
+
+    cacheEntry.fileTime = record->fileTime;
+    cacheEntry.sequence = record->sequence;
+    cacheEntry.valid    = record->valid != 0;
+
+    // invalid entries have less data
+    if (!cacheEntry.valid)
+    {
+        return true;
+    }
+
+    cacheEntry.type = static_cast<CoreRomType>(record->type);
+    // header
+    cacheEntry.header.CRC1        = record->crc1;
+    cacheEntry.header.CRC2        = record->crc2;
+    cacheEntry.header.CountryCode = record->countryCode;
+    cacheEntry.header.SystemType  = static_cast<CoreSystemType>(record->systemType);
+    // shared settings
+    if (!get_cache_file_string(record->name, cacheEntry.header.Name) ||
+        !get_cache_file_string(record->gameID, cacheEntry.header.GameID) ||
+        !get_cache_file_string(record->region, cacheEntry.header.Region) ||
+        !get_cache_file_string(record->goodName, cacheEntry.settings.GoodName) ||
+        !get_cache_file_string(record->md5, cacheEntry.settings.MD5))
+    {
+        return false;
+    }
+    cacheEntry.defaultSettings.GoodName = cacheEntry.settings.GoodName;
+    cacheEntry.defaultSettings.MD5      = cacheEntry.settings.MD5;
+    // default settings
+    cacheEntry.defaultSettings.SaveType        = record->defaultSettings.saveType;
+    cacheEntry.defaultSettings.DisableExtraMem = record->defaultSettings.disableExtraMem != 0;
+    cacheEntry.defaultSettings.TransferPak     = record->defaultSettings.transferPak != 0;
+    cacheEntry.defaultSettings.CountPerOp      = record->defaultSettings.countPerOp;
+    cacheEntry.defaultSettings.SiDMADuration   = record->defaultSettings.siDMADuration;
+    // current settings
+    cacheEntry.settings.SaveType        = record->settings.saveType;
+    cacheEntry.settings.DisableExtraMem = record->settings.disableExtraMem != 0;
+    cacheEntry.settings.TransferPak     = record->settings.transferPak != 0;
+    cacheEntry.settings.CountPerOp      = record->settings.countPerOp;
+    cacheEntry.settings.SiDMADuration   = record->settings.siDMADuration;
+    return true;
+}
+
+static bool get_cache_entry(const std::filesystem::path& file, l_CacheEntry& cacheEntry, CoreFileTime fileTime, bool checkFileTime = true)
+{
+    std::string key = get_cache_key(file);
+    bool found = false;
+
+    auto iter = l_CacheEntries.find(key);
     if (iter != l_CacheEntries.end())
     {
-        l_CacheEntries.erase(iter);
+        cacheEntry = iter->second;
+        found      = true;
     }
-    else if (l_CacheEntries.size() >= CACHE_FILE_ITEMS_MAX)
-    { // delete first item when we're over the item limit
-        l_CacheEntries.erase(l_CacheEntries.begin());
+    else if (!l_RemovedCacheEntries.contains(key))
+    {
+        const l_CacheFileRecord* record = find_cache_file_record(key);
+        found = record != nullptr && decode_cache_file_record(record, cacheEntry);
     }
 
-    cacheEntry.fileName = file;
-    cacheEntry.fileTime = CoreGetFileTime(file);
+    return found && (!checkFileTime || cacheEntry.fileTime == fileTime);
+}
+
+static void add_cache_entry(const std::filesystem::path& file, CoreFileTime fileTime, CoreRomType type,
+                            const CoreRomHeader& header, const CoreRomSettings& defaultSettings,
+                            const CoreRomSettings& settings)
+{
+    l_CacheEntry cacheEntry;
+
+    cacheEntry.fileTime = fileTime;
+    cacheEntry.sequence = l_NextSequence++;
     cacheEntry.type     = type;
     cacheEntry.header   = header;
     cacheEntry.settings = settings;
     cacheEntry.defaultSettings = defaultSettings;
     cacheEntry.valid    = true;
 
-    l_CacheEntries.push_back(cacheEntry);
+    // replaces any existing entry with the same filename
+    std::string key = get_cache_key(file);
+    l_RemovedCacheEntries.erase(key);
+    l_CacheEntries[key] = cacheEntry;
     l_CacheEntriesChanged = true;
 }
 
-static void add_invalid_cache_entry(const std::filesystem::path& file)
+static void add_invalid_cache_entry(const std::filesystem::path& file, CoreFileTime fileTime)
 {
-    l_CacheEntry cacheEntry;
+    l_CacheEntry cacheEntry = {};
 
-    // try to find existing entry with same filename,
-    // when found, remove it from the cache
-    auto iter = get_cache_entry_iter(file, false);
-    if (iter != l_CacheEntries.end())
-    {
-        l_CacheEntries.erase(iter);
-    }
-    else if (l_CacheEntries.size() >= CACHE_FILE_ITEMS_MAX)
-    { // delete first item when we're over the item limit
-        l_CacheEntries.erase(l_CacheEntries.begin());
-    }
-
-    cacheEntry.fileName = file;
-    cacheEntry.fileTime = CoreGetFileTime(file);
+    cacheEntry.fileTime = fileTime;
+    cacheEntry.sequence = l_NextSequence++;
     cacheEntry.valid    = false;
 
-    l_CacheEntries.push_back(cacheEntry);
+    // replaces any existing entry with the same filename
+    std::string key = get_cache_key(file);
+    l_RemovedCacheEntries.erase(key);
+    l_CacheEntries[key] = cacheEntry;
     l_CacheEntriesChanged = true;
 }
 
-//
-// Exported Functions
-//
+static l_CacheFileString add_cache_file_string(std::vector<char>& stringPool, const std::string& string)
+{
+    l_CacheFileString fileString;
 
-CORE_EXPORT void CoreReadRomHeaderAndSettingsCache(void)
+    fileString.offset = static_cast<uint32_t>(stringPool.size());
+    fileString.size   = static_cast<uint32_t>(string.size());
+    stringPool.insert(stringPool.end(), string.begin(), string.end());
+
+    return fileString;
+}
+
+static uint64_t align_offset(uint64_t offset, uint64_t alignment)
 {
-    std::ifstream inputStream;
-    char magicBuf[sizeof(CACHE_FILE_MAGIC)];
-    wchar_t fileNameBuf[CORE_DIR_MAX_LEN];
-    char headerNameBuf[ROMHEADER_NAME_LEN];
-    char gameIDBuf[GAMEID_LEN];
-    char regionBuf[REGION_LEN];
-    char goodNameBuf[GOODNAME_LEN];
-    char md5Buf[MD5_LEN];
-    uint32_t size;
-    l_CacheEntry cacheEntry;
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+static bool map_cache_file(void)
+{
+    if (!CoreMapFile(get_cache_file_name(), l_CacheFile))
+    {
+        return false;
+    }
 
-    inputStream.open(get_cache_file_name(), std::ios::binary);
-    if (!inputStream.good())
+    // the records are only decoded when they're
+    // looked up, so loading is constant time
+    if (!validate_cache_file())
     {
-        return;
+        close_cache_file();
+        return false;
     }
 
-    // when magic doesn't match, don't read cache file
-    inputStream.read((char*)magicBuf, sizeof(CACHE_FILE_MAGIC));
-    if (std::string(magicBuf) != std::string(CACHE_FILE_MAGIC))
+    l_CacheFileHeaderPtr = reinterpret_cast<const l_CacheFileHeader*>(l_CacheFile.Data);
+    return true;
+}
+
+static void read_cache_file(void)
+{
+    close_cache_file();
+    l_CacheEntries.clear();
+    l_RemovedCacheEntries.clear();
+    l_CacheEntriesChanged = false;
+    l_NextSequence = 0;
+
+    if (!map_cache_file())
     {
-        inputStream.close();
         return;
     }
 
-    // read entry count
-    size = l_CacheEntries.size();
-    inputStream.read((char*)&size, sizeof(size));
-
-    // reserve items
-    l_CacheEntries.reserve(size);
-
-    // read all file entries
-#define FREAD(x) inputStream.read((char*)&x, sizeof(x))
-#define FREAD_STR(x, y) inputStream.read((char*)x, y)
-    while (!inputStream.eof())
-    {
-        // reset state
-        size = 0;
-        cacheEntry = {};
-        memset(fileNameBuf, 0, sizeof(fileNameBuf));
-        memset(headerNameBuf, 0, sizeof(headerNameBuf));
-        memset(gameIDBuf, 0, sizeof(gameIDBuf));
-        memset(regionBuf, 0, sizeof(regionBuf));
-        memset(goodNameBuf, 0, sizeof(goodNameBuf));
-        memset(md5Buf, 0, sizeof(md5Buf));
-
-        // file info
-        FREAD(size);
-        FREAD_STR(fileNameBuf, size);
-        cacheEntry.fileName = std::filesystem::path(fileNameBuf);
-        FREAD(cacheEntry.fileTime);
-        // validity
-        FREAD(cacheEntry.valid);
-        // invalid entries have less data
-        // so we don't need to read further
-        if (!cacheEntry.valid)
-        {
-            l_CacheEntries.push_back(cacheEntry);
-            continue;
-        }
-        // type
-        FREAD(cacheEntry.type);
-        // header
-        FREAD(size);
-        FREAD_STR(headerNameBuf, size);
-        FREAD(size);
-        FREAD_STR(gameIDBuf, size);
-        FREAD(size);
-        FREAD_STR(regionBuf, size);
-        cacheEntry.header.Name = std::string(headerNameBuf);
-        cacheEntry.header.GameID = std::string(gameIDBuf);
-        cacheEntry.header.Region = std::string(regionBuf);
-        FREAD(cacheEntry.header.CRC1);
-        FREAD(cacheEntry.header.CRC2);
-        FREAD(cacheEntry.header.CountryCode);
-        FREAD(cacheEntry.header.SystemType);
-        // shared settings
-        FREAD(size);
-        FREAD_STR(goodNameBuf, size);
-        FREAD(size);
-        FREAD_STR(md5Buf, size);
-        cacheEntry.defaultSettings.GoodName = std::string(goodNameBuf);
-        cacheEntry.defaultSettings.MD5 = std::string(md5Buf);
-        cacheEntry.settings.GoodName = std::string(goodNameBuf);
-        cacheEntry.settings.MD5 = std::string(md5Buf);
-        // default settings
-        FREAD(cacheEntry.defaultSettings.SaveType);
-        FREAD(cacheEntry.defaultSettings.DisableExtraMem);
-        FREAD(cacheEntry.defaultSettings.TransferPak);
-        FREAD(cacheEntry.defaultSettings.CountPerOp);
-        FREAD(cacheEntry.defaultSettings.SiDMADuration);
-        // current settings
-        FREAD(cacheEntry.settings.SaveType);
-        FREAD(cacheEntry.settings.DisableExtraMem);
-        FREAD(cacheEntry.settings.TransferPak);
-        FREAD(cacheEntry.settings.CountPerOp);
-        FREAD(cacheEntry.settings.SiDMADuration);
-
-        // add to cached entries
-        l_CacheEntries.push_back(cacheEntry);
-    }
-#undef FREAD
-#undef FREAD_STR
-
-    inputStream.close();
+    l_NextSequence = l_CacheFileHeaderPtr->nextSequence;
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT void CoreReadRomHeaderAndSettingsCache(void)
+{
+    std::lock_guard<std::mutex> lock(l_CacheMutex);
+    read_cache_file();
 }
 
 CORE_EXPORT bool CoreSaveRomHeaderAndSettingsCache(void)
 {
+    std::vector<std::pair<std::string, l_CacheEntry>> entries;
+    std::vector<l_CacheFileRecord> records;
+    std::vector<uint32_t> buckets;
+    std::vector<char> stringPool;
+    l_CacheFileHeader header = {};
+    std::filesystem::path cacheFile;
+    std::filesystem::path tempCacheFile;
     std::ofstream outputStream;
-    wchar_t fileNameBuf[CORE_DIR_MAX_LEN];
-    char headerNameBuf[ROMHEADER_NAME_LEN];
-    char gameIDBuf[GAMEID_LEN];
-    char regionBuf[REGION_LEN];
-    char goodNameBuf[GOODNAME_LEN];
-    char md5Buf[MD5_LEN];
-    uint32_t size;
+    std::error_code errorCode;
+    std::string key;
     l_CacheEntry cacheEntry;
 
+    std::lock_guard<std::mutex> lock(l_CacheMutex);
+
     // only save cache when the entries have changed
     if (!l_CacheEntriesChanged)
     {
         return true;
     }
 
-    outputStream.open(get_cache_file_name(), std::ios::binary);
-    if (!outputStream.good())
+    // merge the entries from the cache file which
+    // haven't been replaced with the changed entries
+    entries.reserve(l_CacheEntries.size() + (l_CacheFileHeaderPtr != nullptr ? l_CacheFileHeaderPtr->recordCount : 0));
+    if (l_CacheFileHeaderPtr != nullptr)
     {
-        return false;
+        const l_CacheFileRecord* fileRecords = get_cache_file_records();
+        for (uint32_t i = 0; i < l_CacheFileHeaderPtr->recordCount; i++)
+        {
+            if (!get_cache_file_string(fileRecords[i].path, key) ||
+                l_CacheEntries.contains(key) ||
+                l_RemovedCacheEntries.contains(key) ||
+                !decode_cache_file_record(&fileRecords[i], cacheEntry))
+            {
+                continue;
+            }
+
+            entries.emplace_back(key, cacheEntry);
+        }
     }
+    entries.insert(entries.end(), l_CacheEntries.begin(), l_CacheEntries.end());
 
-    // write magic header
-    outputStream.write((char*)CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
-
-    // write entry count
-    size = l_CacheEntries.size();
-    outputStream.write((char*)&size, sizeof(size));
-
-    // write each entry in the file
-#define FWRITE(x) outputStream.write((char*)&x, sizeof(x))
-#define FWRITE_STR(x, y) outputStream.write((char*)x, y)
-    for (auto iter = l_CacheEntries.cbegin(); iter != l_CacheEntries.end(); iter++)
-    {
-        cacheEntry = (*iter);
-
-        // reset buffers
-        size = 0;
-        memset(fileNameBuf, 0, sizeof(fileNameBuf));
-        memset(headerNameBuf, 0, sizeof(headerNameBuf));
-        memset(gameIDBuf, 0, sizeof(gameIDBuf));
-        memset(regionBuf, 0, sizeof(regionBuf));
-        memset(goodNameBuf, 0, sizeof(goodNameBuf));
-        memset(md5Buf, 0, sizeof(md5Buf));
-
-        // copy strings into buffers
-        wcsncpy(fileNameBuf, cacheEntry.fileName.wstring().c_str(), CORE_DIR_MAX_LEN);
-        strncpy(headerNameBuf, cacheEntry.header.Name.c_str(), sizeof(headerNameBuf));
-        strncpy(gameIDBuf, cacheEntry.header.GameID.c_str(), sizeof(gameIDBuf));
-        strncpy(regionBuf, cacheEntry.header.Region.c_str(), sizeof(regionBuf));
-        strncpy(goodNameBuf, cacheEntry.settings.GoodName.c_str(), sizeof(goodNameBuf));
-        strncpy(md5Buf, cacheEntry.settings.MD5.c_str(), sizeof(md5Buf));
-
-        // file info
-        size = cacheEntry.fileName.wstring().size() * sizeof(wchar_t);
-        FWRITE(size);
-        FWRITE_STR(fileNameBuf, size);
-        FWRITE(cacheEntry.fileTime);
-        // validity
-        FWRITE(cacheEntry.valid);
-        // skip writing more data
-        // when the entry is invalid
-        if (!cacheEntry.valid)
+    // only keep the most recent entries when we're over the item limit
+    if (entries.size() > CACHE_FILE_ITEMS_MAX)
+    {
+        auto predicate = [](const auto& a, const auto& b)
         {
-            continue;
+            return a.second.sequence > b.second.sequence;
+        };
+
+        std::nth_element(entries.begin(), entries.begin() + CACHE_FILE_ITEMS_MAX, entries.end(), predicate);
+        entries.resize(CACHE_FILE_ITEMS_MAX);
+    }
+
+    // build records, the hash index and the string pool
+    uint32_t bucketCount = 16;
+    while (bucketCount < (entries.size() * 2))
+    {
+        bucketCount *= 2;
+    }
+    buckets.resize(bucketCount, CACHE_FILE_BUCKET_EMPTY);
+    records.reserve(entries.size());
+
+    for (const auto& [entryKey, entry] : entries)
+    {
+        l_CacheFileRecord record = {};
+
+        record.pathHash = get_cache_key_hash(entryKey);
+        record.path     = add_cache_file_string(stringPool, entryKey);
+        record.fileTime = entry.fileTime;
+        record.sequence = entry.sequence;
+        record.valid    = entry.valid ? 1 : 0;
+
+        if (entry.valid)
+        {
+            record.type        = static_cast<uint8_t>(entry.type);
+            record.systemType  = static_cast<uint8_t>(entry.header.SystemType);
+            record.crc1        = entry.header.CRC1;
+            record.crc2        = entry.header.CRC2;
+            record.countryCode = entry.header.CountryCode;
+            record.name        = add_cache_file_string(stringPool, entry.header.Name);
+            record.gameID      = add_cache_file_string(stringPool, entry.header.GameID);
+            record.region      = add_cache_file_string(stringPool, entry.header.Region);
+            record.goodName    = add_cache_file_string(stringPool, entry.settings.GoodName);
+            record.md5         = add_cache_file_string(stringPool, entry.settings.MD5);
+
+            record.defaultSettings.saveType        = entry.defaultSettings.SaveType;
+            record.defaultSettings.disableExtraMem = entry.defaultSettings.DisableExtraMem ? 1 : 0;
+            record.defaultSettings.transferPak     = entry.defaultSettings.TransferPak ? 1 : 0;
+            record.defaultSettings.countPerOp      = entry.defaultSettings.CountPerOp;
+            record.defaultSettings.siDMADuration   = entry.defaultSettings.SiDMADuration;
+
+            record.settings.saveType        = entry.settings.SaveType;
+            record.settings.disableExtraMem = entry.settings.DisableExtraMem ? 1 : 0;
+            record.settings.transferPak     = entry.settings.TransferPak ? 1 : 0;
+            record.settings.countPerOp      = entry.settings.CountPerOp;
+            record.settings.siDMADuration   = entry.settings.SiDMADuration;
+        }
+
+        uint32_t index = record.pathHash & (bucketCount - 1);
+        while (buckets[index] != CACHE_FILE_BUCKET_EMPTY)
+        {
+            index = (index + 1) & (bucketCount - 1);
         }
-        // type
-        FWRITE(cacheEntry.type);
-        // header
-        size = cacheEntry.header.Name.size();
-        FWRITE(size);
-        FWRITE_STR(headerNameBuf, size);
-        size = cacheEntry.header.GameID.size();
-        FWRITE(size);
-        FWRITE_STR(gameIDBuf, size);
-        size = cacheEntry.header.Region.size();
-        FWRITE(size);
-        FWRITE_STR(regionBuf, size);
-        FWRITE(cacheEntry.header.CRC1);
-        FWRITE(cacheEntry.header.CRC2);
-        FWRITE(cacheEntry.header.CountryCode);
-        FWRITE(cacheEntry.header.SystemType);
-        // shared settings
-        size = cacheEntry.settings.GoodName.size();
-        FWRITE(size);
-        FWRITE_STR(goodNameBuf, size);
-        size = cacheEntry.settings.MD5.size();
-        FWRITE(size);
-        FWRITE_STR(md5Buf, size);
-        // default settings
-        FWRITE(cacheEntry.defaultSettings.SaveType);
-        FWRITE(cacheEntry.defaultSettings.DisableExtraMem);
-        FWRITE(cacheEntry.defaultSettings.TransferPak);
-        FWRITE(cacheEntry.defaultSettings.CountPerOp);
-        FWRITE(cacheEntry.defaultSettings.SiDMADuration);
-        // current settings
-        FWRITE(cacheEntry.settings.SaveType);
-        FWRITE(cacheEntry.settings.DisableExtraMem);
-        FWRITE(cacheEntry.settings.TransferPak);
-        FWRITE(cacheEntry.settings.CountPerOp);
-        FWRITE(cacheEntry.settings.SiDMADuration);
-    }
-#undef FWRITE
-#undef FWRITE_STR
+        buckets[index] = static_cast<uint32_t>(records.size());
+
+        records.push_back(record);
+    }
+
+    std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+    header.recordCount      = static_cast<uint32_t>(records.size());
+    header.bucketCount      = bucketCount;
+    header.recordsOffset    = align_offset(sizeof(l_CacheFileHeader), alignof(l_CacheFileRecord));
+    header.bucketsOffset    = align_offset(header.recordsOffset + (records.size() * sizeof(l_CacheFileRecord)), alignof(uint32_t));
+    header.stringPoolOffset = header.bucketsOffset + (buckets.size() * sizeof(uint32_t));
+    header.stringPoolSize   = stringPool.size();
+    header.nextSequence     = l_NextSequence;
+
+    // write to a temporary file first so an interrupted
+    // save doesn't leave a truncated cache file behind
+    cacheFile     = get_cache_file_name();
+    tempCacheFile = cacheFile;
+    tempCacheFile += ".tmp";
+
+    outputStream.open(tempCacheFile, std::ios::binary);
+    if (!outputStream.good())
+    {
+        return false;
+    }
+
+#define FWRITE_AT(offset, data, size) \
+    outputStream.seekp(offset); \
+    outputStream.write((const char*)data, size)
+    FWRITE_AT(0, &header, sizeof(header));
+    FWRITE_AT(header.recordsOffset, records.data(), records.size() * sizeof(l_CacheFileRecord));
+    FWRITE_AT(header.bucketsOffset, buckets.data(), buckets.size() * sizeof(uint32_t));
+    FWRITE_AT(header.stringPoolOffset, stringPool.data(), stringPool.size());
+#undef FWRITE_AT
 
     outputStream.close();
+    if (outputStream.fail())
+    {
+        std::filesystem::remove(tempCacheFile, errorCode);
+        return false;
+    }
+
+    // the cache file has to be unmapped before
+    // it can be replaced on windows
+    close_cache_file();
+
+    std::filesystem::rename(tempCacheFile, cacheFile, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(tempCacheFile, errorCode);
+        // the old cache file is still there, map it again so
+        // its entries aren't lost, the changed entries are kept
+        map_cache_file();
+        return false;
+    }
+
+    // use the new cache file from now on
+    read_cache_file();
     return true;
 }
 
 CORE_EXPORT bool CoreGetCachedRomHeaderAndSettings(std::filesystem::path file, CoreRomType* type, CoreRomHeader* header, CoreRomSettings* defaultSettings, CoreRomSettings* settings)
 {
     bool ret = false;
-    auto iter = get_cache_entry_iter(file);
-    if (iter == l_CacheEntries.end())
+    bool found;
+    l_CacheEntry cachedEntry;
+    CoreFileTime fileTime = CoreGetFileTime(file);
+
+    {
+        std::lock_guard<std::mutex> lock(l_CacheMutex);
+        found = get_cache_entry(file, cachedEntry, fileTime);
+    }
+
+    if (!found)
     {
         CoreRomType romType;
         CoreRomHeader romHeader;
         CoreRomSettings romSettings;
         CoreRomSettings romDefaultSettings;
+        CoreRomProbeResult probeResult;
 
         // when we haven't found a cached entry,
         // we're gonna attempt to retrieve the
         // rom header and settings and add it
-        // to the cache
-        ret = CoreOpenRom(file) &&
-                CoreGetRomType(romType) &&
-                CoreGetCurrentRomHeader(romHeader) &&
-                CoreGetCurrentRomSettings(romSettings) &&
-                CoreGetCurrentDefaultRomSettings(romDefaultSettings);
-        // always close ROM
-        if (CoreHasRomOpen() && !CoreCloseRom())
+        // to the cache, probing the ROM doesn't
+        // need the core so that's attempted first
+        probeResult = CoreProbeRom(file, romType, romHeader, romDefaultSettings);
+        if (probeResult == CoreRomProbeResult::Success)
         {
-            ret = false;
+            // the settings aren't safe to
+            // access from multiple threads
+            std::lock_guard<std::mutex> lock(l_OpenRomMutex);
+            CoreGetRomSettingsOverlay(romDefaultSettings, romSettings);
+            ret = true;
         }
+        else if (probeResult == CoreRomProbeResult::Unsupported)
+        {
+            std::lock_guard<std::mutex> lock(l_OpenRomMutex);
+            ret = CoreOpenRom(file) &&
+                    CoreGetRomType(romType) &&
+                    CoreGetCurrentRomHeader(romHeader) &&
+                    CoreGetCurrentRomSettings(romSettings) &&
+                    CoreGetCurrentDefaultRomSettings(romDefaultSettings);
+            // always close ROM
+            if (CoreHasRomOpen() && !CoreCloseRom())
+            {
+                ret = false;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(l_CacheMutex);
+
         // add file to cache
         if (ret)
         {
@@ -413,36 +681,36 @@ CORE_EXPORT bool CoreGetCachedRomHeaderAndSettings(std::filesystem::path file, C
                 *defaultSettings = romDefaultSettings;
             }
 
-            add_cache_entry(file, romType, romHeader, romSettings, romDefaultSettings);
+            add_cache_entry(file, fileTime, romType, romHeader, romDefaultSettings, romSettings);
             return true;
         }
         else
         {
-            add_invalid_cache_entry(file);
+            add_invalid_cache_entry(file, fileTime);
             return false;
         }
     }
 
-    if (!(*iter).valid)
+    if (!cachedEntry.valid)
     {
         return false;
     }
 
     if (type != nullptr)
     {
-        *type = (*iter).type;
+        *type = cachedEntry.type;
     }
     if (header != nullptr)
     {
-        *header = (*iter).header;
+        *header = cachedEntry.header;
     }
     if (settings != nullptr)
     {
-        *settings = (*iter).settings;
+        *settings = cachedEntry.settings;
     }
     if (defaultSettings != nullptr)
     {
-        *defaultSettings = (*iter).defaultSettings;
+        *defaultSettings = cachedEntry.defaultSettings;
     }
     return true;
 }
@@ -451,16 +719,15 @@ CORE_EXPORT bool CoreUpdateCachedRomHeaderAndSettings(std::filesystem::path file
 {
     l_CacheEntry cachedEntry;
 
+    std::lock_guard<std::mutex> lock(l_CacheMutex);
+
     // try to find existing entry with same filename,
     // when not found, do nothing
-    auto iter = get_cache_entry_iter(file, false);
-    if (iter == l_CacheEntries.end())
+    if (!get_cache_entry(file, cachedEntry, 0, false))
     {
         return true;
     }
 
-    cachedEntry = (*iter);
-
     // check if the cached entry needs to be updated,
     // if it does, then update the entry
     if (cachedEntry.type != type ||
@@ -468,12 +735,13 @@ CORE_EXPORT bool CoreUpdateCachedRomHeaderAndSettings(std::filesystem::path file
         cachedEntry.defaultSettings != defaultSettings ||
         cachedEntry.settings != settings)
     {
-        (*iter).type            = type;
-        (*iter).header          = header;
-        (*iter).defaultSettings = defaultSettings;
-        (*iter).settings        = settings;
-        (*iter).valid           = true;
-        l_CacheEntriesChanged   = true;
+        cachedEntry.type            = type;
+        cachedEntry.header          = header;
+        cachedEntry.defaultSettings = defaultSettings;
+        cachedEntry.settings        = settings;
+        cachedEntry.valid           = true;
+        l_CacheEntries[get_cache_key(file)] = cachedEntry;
+        l_CacheEntriesChanged = true;
     }
 
     return true;
@@ -485,11 +753,16 @@ CORE_EXPORT bool CoreUpdateCachedRomHeaderAndSettings(std::filesystem::path file
     CoreRomHeader header;
     CoreRomSettings defaultSettings;
     CoreRomSettings settings;
+    l_CacheEntry cachedEntry;
+    bool found;
 
     // try to find existing entry with same filename,
     // when not found, do nothing
-    auto iter = get_cache_entry_iter(file, false);
-    if (iter == l_CacheEntries.end())
+    {
+        std::lock_guard<std::mutex> lock(l_CacheMutex);
+        found = get_cache_entry(file, cachedEntry, 0, false);
+    }
+    if (!found)
     {
         return true;
     }
@@ -506,9 +779,31 @@ CORE_EXPORT bool CoreUpdateCachedRomHeaderAndSettings(std::filesystem::path file
     return CoreUpdateCachedRomHeaderAndSettings(file, type, header, defaultSettings, settings);
 }
 
+CORE_EXPORT bool CoreRemoveCachedRomHeaderAndSettings(std::filesystem::path file)
+{
+    std::lock_guard<std::mutex> lock(l_CacheMutex);
+
+    std::string key = get_cache_key(file);
+
+    // entries in the cache file can't be removed
+    // until it's saved, so keep track of them
+    if (l_CacheEntries.erase(key) > 0 ||
+        find_cache_file_record(key) != nullptr)
+    {
+        l_RemovedCacheEntries.insert(key);
+        l_CacheEntriesChanged = true;
+    }
+
+    return true;
+}
+
 CORE_EXPORT bool CoreClearRomHeaderAndSettingsCache(void)
 {
+    std::lock_guard<std::mutex> lock(l_CacheMutex);
+
+    close_cache_file();
     l_CacheEntries.clear();
+    l_RemovedCacheEntries.clear();
     l_CacheEntriesChanged = false; // No need to save since we're deleting the file
 
     // Delete the cache file from disk
@@ -27,7 +27,8 @@ bool CoreSaveRomHeaderAndSettingsCache(void);
 
 // returns whether retrieving the rom header & settings
 // for given filename succeeds, it also attempts to add
-// an entry if there's no cached entry found
+// an entry if there's no cached entry found, this is
+// safe to call from multiple threads
 bool CoreGetCachedRomHeaderAndSettings(std::filesystem::path file, CoreRomType* type, CoreRomHeader* header, CoreRomSettings* defaultSettings, CoreRomSettings* settings);
 
 // returns whether updating the cached rom header & settings succeeds
@@ -39,6 +40,10 @@ bool CoreUpdateCachedRomHeaderAndSettings(std::filesystem::path file, CoreRomTyp
 bool CoreUpdateCachedRomHeaderAndSettings(std::filesystem::path file);
 #endif // CORE_INTERNAL
 
+// returns whether removing the cached rom header & settings
+// for given filename succeeds
+bool CoreRemoveCachedRomHeaderAndSettings(std::filesystem::path file);
+
 // returns whether clearing rom header & settings cache
 // succeeds
 bool CoreClearRomHeaderAndSettingsCache(void);
@@ -46,6 +46,8 @@ enum class CoreStateCallbackType
     SaveStateLoaded,
     SaveStateSaved,
     ScreenshotCaptured,
+    MemoryStateLoaded,
+    MemoryStateSaved,
 };
 
 // attempts to setup callbacks with the provided functions
@@ -16,14 +16,28 @@
 #include "Library.hpp"
 #include "Cheats.hpp"
 #include "Error.hpp"
+#include "File.hpp"
 
 #include "m64p/Api.hpp"
 
+#include <unordered_map>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <format>
+#include <mutex>
+
+//
+// Local Defines
+//
+
+#define CHEATS_CACHE_FILE_MAGIC "RMGCoreCheatsCache_1"
+#define CHEATS_CACHE_FILE_ITEMS_MAX 5000
+
+// marks an empty bucket in the hash index
+#define CHEATS_CACHE_FILE_BUCKET_EMPTY 0xFFFFFFFF
 
 //
 // Local Structs
@@ -35,6 +49,50 @@ struct l_LoadedCheat
     CoreCheatOption cheatOption;
 };
 
+struct l_CheatsCacheEntry
+{
+    CoreFileTime fileTime;
+    uint64_t     fileSize;
+    // entries with a higher sequence have been added
+    // more recently, used to evict the oldest entries
+    uint64_t     sequence;
+
+    CoreCheatFile cheatFile;
+};
+
+//
+// The cheats cache file consists of the header, fixed-size records,
+// the hash index and the data of the parsed cheat files, the hash
+// index is an open addressing table (linear probing) of record indices
+// keyed by the hash of the UTF-8 path of the cheat file, so only the
+// cheat file which is looked up has to be decoded
+//
+
+struct l_CheatsCacheFileHeader
+{
+    char     magic[sizeof(CHEATS_CACHE_FILE_MAGIC)];
+    uint32_t recordCount;
+    uint32_t bucketCount; // power of 2
+    uint64_t recordsOffset;
+    uint64_t bucketsOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint64_t nextSequence;
+};
+
+struct l_CheatsCacheFileRecord
+{
+    uint64_t pathHash;
+    uint64_t fileTime;
+    uint64_t fileSize;
+    uint64_t sequence;
+    // the path is stored at the start of the data,
+    // followed by the encoded cheat file
+    uint64_t dataOffset;
+    uint32_t pathSize;
+    uint32_t dataSize;
+};
+
 //
 // Local Variables
 //
@@ -44,6 +102,19 @@ static CoreCheatFile l_UserCheatFile;
 static std::vector<l_LoadedCheat> l_LoadedCheats;
 static std::vector<CoreCheat> l_NetplayCheats;
 
+// cheats cache file which has been loaded
+static CoreMappedFile                 l_CheatsCacheFile;
+static const l_CheatsCacheFileHeader* l_CheatsCacheFileHeaderPtr = nullptr;
+
+// entries which have been added or updated after loading
+// the cache file, these take precedence over the file
+static std::unordered_map<std::string, l_CheatsCacheEntry> l_CheatsCacheEntries;
+static bool     l_CheatsCacheEntriesChanged = false;
+static uint64_t l_CheatsCacheNextSequence = 0;
+
+// protects the cheats cache
+static std::mutex l_CheatsCacheMutex;
+
 //
 // Local Functions
 //
@@ -422,6 +493,563 @@ static bool parse_cheat_file(const std::vector<std::string>& lines, CoreCheatFil
     return true;
 }
 
+static std::filesystem::path get_cheats_cache_file_name(void)
+{
+    std::filesystem::path file;
+
+    file = CoreGetUserCacheDirectory();
+    file += CORE_DIR_SEPERATOR_STR;
+    file += "CheatsCache.cache";
+
+    return file;
+}
+
+static std::string get_cheats_cache_key(const std::filesystem::path& file)
+{
+    std::u8string key = file.u8string();
+    return std::string(reinterpret_cast<const char*>(key.data()), key.size());
+}
+
+static uint64_t get_cheats_cache_key_hash(const std::string& key)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void encode_u32(std::vector<char>& data, uint32_t value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+static void encode_string(std::vector<char>& data, const std::string& string)
+{
+    encode_u32(data, static_cast<uint32_t>(string.size()));
+    data.insert(data.end(), string.begin(), string.end());
+}
+
+static bool decode_u32(const char* data, size_t size, size_t& offset, uint32_t& value)
+{
+    if (size - offset < sizeof(value))
+    {
+        return false;
+    }
+
+    std::memcpy(&value, data + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+static bool decode_string(const char* data, size_t size, size_t& offset, std::string& string)
+{
+    uint32_t stringSize;
+
+    if (!decode_u32(data, size, offset, stringSize) ||
+        size - offset < stringSize)
+    {
+        return false;
+    }
+
+    string.assign(data + offset, stringSize);
+    offset += stringSize;
+    return true;
+}
+
+static void encode_cheat_file(const CoreCheatFile& cheatFile, std::vector<char>& data)
+{
+    encode_u32(data, cheatFile.CRC1);
+    encode_u32(data, cheatFile.CRC2);
+    encode_u32(data, cheatFile.CountryCode);
+    encode_string(data, cheatFile.MD5);
+    encode_string(data, cheatFile.Name);
+
+    encode_u32(data, static_cast<uint32_t>(cheatFile.Cheats.size()));
+    for (const CoreCheat& cheat : cheatFile.Cheats)
+    {
+        encode_string(data, cheat.Name);
+        encode_string(data, cheat.Author);
+        encode_string(data, cheat.Note);
+        encode_u32(data, cheat.HasOptions ? 1 : 0);
+
+        encode_u32(data, static_cast<uint32_t>(cheat.CheatOptions.size()));
+        for (const CoreCheatOption& option : cheat.CheatOptions)
+        {
+            encode_string(data, option.Name);
+            encode_u32(data, option.Value);
+            encode_u32(data, static_cast<uint32_t>(option.Size));
+        }
+
+        encode_u32(data, static_cast<uint32_t>(cheat.CheatCodes.size()));
+        for (const CoreCheatCode& code : cheat.CheatCodes)
+        {
+            encode_u32(data, code.Address);
+            encode_u32(data, static_cast<uint32_t>(code.Value));
+            encode_u32(data, code.UseOptions ? 1 : 0);
+            encode_u32(data, static_cast<uint32_t>(code.OptionIndex));
+            encode_u32(data, static_cast<uint32_t>(code.OptionSize));
+        }
+    }
+}
+
+static bool decode_cheat_file(const char* data, size_t size, CoreCheatFile& cheatFile)
+{
+    size_t   offset = 0;
+    uint32_t count;
+    uint32_t value;
+
+    cheatFile = {};
+
+    if (!decode_u32(data, size, offset, cheatFile.CRC1) ||
+        !decode_u32(data, size, offset, cheatFile.CRC2) ||
+        !decode_u32(data, size, offset, cheatFile.CountryCode) ||
+        !decode_string(data, size, offset, cheatFile.MD5) ||
+        !decode_string(data, size, offset, cheatFile.Name) ||
+        !decode_u32(data, size, offset, count))
+    {
+        return false;
+    }
+
+    // every cheat takes at least 24 bytes, so a
+    // corrupted count can't make us allocate a lot
+    if (count > (size - offset) / 24)
+    {
+        return false;
+    }
+
+    cheatFile.Cheats.resize(count);
+    for (CoreCheat& cheat : cheatFile.Cheats)
+    {
+        if (!decode_string(data, size, offset, cheat.Name) ||
+            !decode_string(data, size, offset, cheat.Author) ||
+            !decode_string(data, size, offset, cheat.Note) ||
+            !decode_u32(data, size, offset, value))
+        {
+            return false;
+        }
+        cheat.HasOptions = value != 0;
+
+        if (!decode_u32(data, size, offset, count) ||
+            count > (size - offset) / 12)
+        {
+            return false;
+        }
+
+        cheat.CheatOptions.resize(count);
+        for (CoreCheatOption& option : cheat.CheatOptions)
+        {
+            if (!decode_string(data, size, offset, option.Name) ||
+                !decode_u32(data, size, offset, option.Value) ||
+                !decode_u32(data, size, offset, value))
+            {
+                return false;
+            }
+            option.Size = static_cast<int32_t>(value);
+        }
+
+        if (!decode_u32(data, size, offset, count) ||
+            count > (size - offset) / 20)
+        {
+            return false;
+        }
+
+        cheat.CheatCodes.resize(count);
+        for (CoreCheatCode& code : cheat.CheatCodes)
+        {
+            uint32_t codeValue, useOptions, optionIndex, optionSize;
+
+            if (!decode_u32(data, size, offset, code.Address) ||
+                !decode_u32(data, size, offset, codeValue) ||
+                !decode_u32(data, size, offset, useOptions) ||
+                !decode_u32(data, size, offset, optionIndex) ||
+                !decode_u32(data, size, offset, optionSize))
+            {
+                return false;
+            }
+            code.Value       = static_cast<int32_t>(codeValue);
+            code.UseOptions  = useOptions != 0;
+            code.OptionIndex = static_cast<int>(optionIndex);
+            code.OptionSize  = static_cast<int>(optionSize);
+        }
+    }
+
+    return offset == size;
+}
+
+static const l_CheatsCacheFileRecord* get_cheats_cache_file_records(void)
+{
+    return reinterpret_cast<const l_CheatsCacheFileRecord*>(l_CheatsCacheFile.Data + l_CheatsCacheFileHeaderPtr->recordsOffset);
+}
+
+static const uint32_t* get_cheats_cache_file_buckets(void)
+{
+    return reinterpret_cast<const uint32_t*>(l_CheatsCacheFile.Data + l_CheatsCacheFileHeaderPtr->bucketsOffset);
+}
+
+static const char* get_cheats_cache_file_record_data(const l_CheatsCacheFileRecord* record)
+{
+    if (record->dataOffset > l_CheatsCacheFileHeaderPtr->dataSize ||
+        (static_cast<uint64_t>(record->pathSize) + record->dataSize) > (l_CheatsCacheFileHeaderPtr->dataSize - record->dataOffset))
+    {
+        return nullptr;
+    }
+
+    return l_CheatsCacheFile.Data + l_CheatsCacheFileHeaderPtr->dataOffset + record->dataOffset;
+}
+
+static bool validate_cheats_cache_file(void)
+{
+    const l_CheatsCacheFileHeader* header = reinterpret_cast<const l_CheatsCacheFileHeader*>(l_CheatsCacheFile.Data);
+    uint64_t recordsSize;
+    uint64_t bucketsSize;
+
+    if (l_CheatsCacheFile.Size < sizeof(l_CheatsCacheFileHeader))
+    {
+        return false;
+    }
+
+    // when magic doesn't match, don't use cache file
+    if (std::memcmp(header->magic, CHEATS_CACHE_FILE_MAGIC, sizeof(CHEATS_CACHE_FILE_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    // bucket count must be a power of 2 and
+    // larger than the record count
+    if (header->bucketCount == 0 ||
+        (header->bucketCount & (header->bucketCount - 1)) != 0 ||
+        header->recordCount >= header->bucketCount)
+    {
+        return false;
+    }
+
+    recordsSize = static_cast<uint64_t>(header->recordCount) * sizeof(l_CheatsCacheFileRecord);
+    bucketsSize = static_cast<uint64_t>(header->bucketCount) * sizeof(uint32_t);
+
+    return header->recordsOffset % alignof(l_CheatsCacheFileRecord) == 0 &&
+           header->bucketsOffset % alignof(uint32_t) == 0 &&
+           header->recordsOffset <= l_CheatsCacheFile.Size &&
+           recordsSize <= (l_CheatsCacheFile.Size - header->recordsOffset) &&
+           header->bucketsOffset <= l_CheatsCacheFile.Size &&
+           bucketsSize <= (l_CheatsCacheFile.Size - header->bucketsOffset) &&
+           header->dataOffset <= l_CheatsCacheFile.Size &&
+           header->dataSize <= (l_CheatsCacheFile.Size - header->dataOffset);
+}
+
+static void close_cheats_cache_file(void)
+{
+    CoreUnmapFile(l_CheatsCacheFile);
+    l_CheatsCacheFileHeaderPtr = nullptr;
+}
+
+static const l_CheatsCacheFileRecord* find_cheats_cache_file_record(const std::string& key)
+{
+    const l_CheatsCacheFileRecord* records;
+    const uint32_t* buckets;
+    const char* recordData;
+    uint64_t hash;
+    uint32_t mask;
+    uint32_t index;
+
+    if (l_CheatsCacheFileHeaderPtr == nullptr)
+    {
+        return nullptr;
+    }
+
+    records = get_cheats_cache_file_records();
+    buckets = get_cheats_cache_file_buckets();
+    hash    = get_cheats_cache_key_hash(key);
+    mask    = l_CheatsCacheFileHeaderPtr->bucketCount - 1;
+
+    // there's always at least one empty bucket,
+    // so the probing always terminates
+    for (index = hash & mask; buckets[index] != CHEATS_CACHE_FILE_BUCKET_EMPTY; index = (index + 1) & mask)
+    {
+        if (buckets[index] >= l_CheatsCacheFileHeaderPtr->recordCount)
+        {
+            return nullptr;
+        }
+
+        const l_CheatsCacheFileRecord* record = &records[buckets[index]];
+        if (record->pathHash == hash &&
+            record->pathSize == key.size() &&
+            (recordData = get_cheats_cache_file_record_data(record)) != nullptr &&
+            std::memcmp(recordData, key.data(), key.size()) == 0)
+        {
+            return record;
+        }
+    }
+
+    return nullptr;
+}
+
+static bool map_cheats_cache_file(void)
+{
+    if (!CoreMapFile(get_cheats_cache_file_name(), l_CheatsCacheFile))
+    {
+        return false;
+    }
+
+    // the cheat files are only decoded when
+    // they're looked up, so loading is constant time
+    if (!validate_cheats_cache_file())
+    {
+        close_cheats_cache_file();
+        return false;
+    }
+
+    l_CheatsCacheFileHeaderPtr = reinterpret_cast<const l_CheatsCacheFileHeader*>(l_CheatsCacheFile.Data);
+    return true;
+}
+
+static void read_cheats_cache_file(void)
+{
+    close_cheats_cache_file();
+    l_CheatsCacheEntries.clear();
+    l_CheatsCacheEntriesChanged = false;
+    l_CheatsCacheNextSequence = 0;
+
+    if (!map_cheats_cache_file())
+    {
+        return;
+    }
+
+    l_CheatsCacheNextSequence = l_CheatsCacheFileHeaderPtr->nextSequence;
+}
+
+static bool get_cheats_cache_entry(const std::filesystem::path& file, CoreFileTime fileTime, uint64_t fileSize, CoreCheatFile& cheatFile)
+{
+    std::string key = get_cheats_cache_key(file);
+
+    auto iter = l_CheatsCacheEntries.find(key);
+    if (iter != l_CheatsCacheEntries.end())
+    {
+        if (iter->second.fileTime != fileTime ||
+            iter->second.fileSize != fileSize)
+        {
+            return false;
+        }
+
+        cheatFile = iter->second.cheatFile;
+        return true;
+    }
+
+    const l_CheatsCacheFileRecord* record = find_cheats_cache_file_record(key);
+    if (record == nullptr ||
+        record->fileTime != fileTime ||
+        record->fileSize != fileSize)
+    {
+        return false;
+    }
+
+    return decode_cheat_file(get_cheats_cache_file_record_data(record) + record->pathSize, record->dataSize, cheatFile);
+}
+
+static void add_cheats_cache_entry(const std::filesystem::path& file, const CoreCheatFile& cheatFile)
+{
+    l_CheatsCacheEntry cacheEntry;
+    std::error_code errorCode;
+
+    cacheEntry.fileTime  = CoreGetFileTime(file);
+    cacheEntry.fileSize  = std::filesystem::file_size(file, errorCode);
+    cacheEntry.sequence  = l_CheatsCacheNextSequence++;
+    cacheEntry.cheatFile = cheatFile;
+
+    if (errorCode)
+    {
+        return;
+    }
+
+    // replaces any existing entry with the same filename
+    l_CheatsCacheEntries[get_cheats_cache_key(file)] = cacheEntry;
+    l_CheatsCacheEntriesChanged = true;
+}
+
+static bool save_cheats_cache_file(void)
+{
+    struct l_Record
+    {
+        l_CheatsCacheFileRecord record;
+        const char* data; // encoded cheat file, when it's from the mapped cache file
+        std::vector<char> encodedData;
+    };
+
+    std::vector<l_Record> records;
+    std::vector<uint32_t> buckets;
+    std::vector<char> data;
+    l_CheatsCacheFileHeader header = {};
+    std::filesystem::path cacheFile;
+    std::filesystem::path tempCacheFile;
+    std::ofstream outputStream;
+    std::error_code errorCode;
+
+    // only save cache when the entries have changed
+    if (!l_CheatsCacheEntriesChanged)
+    {
+        return true;
+    }
+
+    // merge the records from the cache file which
+    // haven't been replaced with the changed entries,
+    // those can be copied without decoding them
+    if (l_CheatsCacheFileHeaderPtr != nullptr)
+    {
+        const l_CheatsCacheFileRecord* fileRecords = get_cheats_cache_file_records();
+        for (uint32_t i = 0; i < l_CheatsCacheFileHeaderPtr->recordCount; i++)
+        {
+            const char* recordData = get_cheats_cache_file_record_data(&fileRecords[i]);
+            if (recordData == nullptr ||
+                l_CheatsCacheEntries.contains(std::string(recordData, fileRecords[i].pathSize)))
+            {
+                continue;
+            }
+
+            records.push_back({ fileRecords[i], recordData, {} });
+        }
+    }
+    for (const auto& [key, entry] : l_CheatsCacheEntries)
+    {
+        l_Record record = {};
+
+        record.record.pathHash = get_cheats_cache_key_hash(key);
+        record.record.fileTime = entry.fileTime;
+        record.record.fileSize = entry.fileSize;
+        record.record.sequence = entry.sequence;
+        record.record.pathSize = static_cast<uint32_t>(key.size());
+        record.encodedData.assign(key.begin(), key.end());
+        encode_cheat_file(entry.cheatFile, record.encodedData);
+        record.record.dataSize = static_cast<uint32_t>(record.encodedData.size() - key.size());
+
+        records.push_back(std::move(record));
+    }
+
+    // only keep the most recent entries when we're over the item limit
+    if (records.size() > CHEATS_CACHE_FILE_ITEMS_MAX)
+    {
+        auto predicate = [](const l_Record& a, const l_Record& b)
+        {
+            return a.record.sequence > b.record.sequence;
+        };
+
+        std::nth_element(records.begin(), records.begin() + CHEATS_CACHE_FILE_ITEMS_MAX, records.end(), predicate);
+        records.resize(CHEATS_CACHE_FILE_ITEMS_MAX);
+    }
+
+    // build the hash index and the data
+    uint32_t bucketCount = 16;
+    while (bucketCount < (records.size() * 2))
+    {
+        bucketCount *= 2;
+    }
+    buckets.resize(bucketCount, CHEATS_CACHE_FILE_BUCKET_EMPTY);
+
+    for (uint32_t i = 0; i < records.size(); i++)
+    {
+        l_Record& record = records[i];
+        const char* recordData = record.data != nullptr ? record.data : record.encodedData.data();
+
+        record.record.dataOffset = data.size();
+        data.insert(data.end(), recordData, recordData + record.record.pathSize + record.record.dataSize);
+
+        uint32_t index = record.record.pathHash & (bucketCount - 1);
+        while (buckets[index] != CHEATS_CACHE_FILE_BUCKET_EMPTY)
+        {
+            index = (index + 1) & (bucketCount - 1);
+        }
+        buckets[index] = i;
+    }
+
+    std::memcpy(header.magic, CHEATS_CACHE_FILE_MAGIC, sizeof(CHEATS_CACHE_FILE_MAGIC));
+    header.recordCount   = static_cast<uint32_t>(records.size());
+    header.bucketCount   = bucketCount;
+    header.recordsOffset = sizeof(l_CheatsCacheFileHeader);
+    header.bucketsOffset = header.recordsOffset + (records.size() * sizeof(l_CheatsCacheFileRecord));
+    header.dataOffset    = header.bucketsOffset + (buckets.size() * sizeof(uint32_t));
+    header.dataSize      = data.size();
+    header.nextSequence  = l_CheatsCacheNextSequence;
+
+    // write to a temporary file first so an interrupted
+    // save doesn't leave a truncated cache file behind
+    cacheFile     = get_cheats_cache_file_name();
+    tempCacheFile = cacheFile;
+    tempCacheFile += ".tmp";
+
+    outputStream.open(tempCacheFile, std::ios::binary);
+    if (!outputStream.good())
+    {
+        return false;
+    }
+
+    outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const l_Record& record : records)
+    {
+        outputStream.write(reinterpret_cast<const char*>(&record.record), sizeof(l_CheatsCacheFileRecord));
+    }
+    outputStream.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(uint32_t));
+    outputStream.write(data.data(), data.size());
+
+    outputStream.close();
+    if (outputStream.fail())
+    {
+        std::filesystem::remove(tempCacheFile, errorCode);
+        return false;
+    }
+
+    // the cache file has to be unmapped before
+    // it can be replaced on windows
+    records.clear();
+    close_cheats_cache_file();
+
+    std::filesystem::rename(tempCacheFile, cacheFile, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(tempCacheFile, errorCode);
+        // the old cache file is still there, map it again so
+        // its cheat files aren't lost, the changed ones are kept
+        map_cheats_cache_file();
+        return false;
+    }
+
+    // use the new cache file from now on
+    read_cheats_cache_file();
+    return true;
+}
+
+// reads and parses the cheat file, unless
+// there's an up-to-date parsed copy in the cache
+static bool read_cheat_file(const std::filesystem::path& file, CoreCheatFile& cheatFile)
+{
+    std::vector<std::string> lines;
+    std::error_code errorCode;
+    CoreFileTime fileTime = CoreGetFileTime(file);
+    uint64_t     fileSize = std::filesystem::file_size(file, errorCode);
+
+    if (!errorCode)
+    {
+        std::lock_guard<std::mutex> lock(l_CheatsCacheMutex);
+        if (get_cheats_cache_entry(file, fileTime, fileSize, cheatFile))
+        {
+            return true;
+        }
+    }
+
+    cheatFile = {};
+    if (!read_file_lines(file, lines) ||
+        !parse_cheat_file(lines, cheatFile))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(l_CheatsCacheMutex);
+    add_cheats_cache_entry(file, cheatFile);
+    return true;
+}
+
 static bool write_cheat_file(const CoreCheatFile& cheatFile, const std::filesystem::path& path)
 {
     std::string lines;
@@ -495,6 +1123,11 @@ static bool write_cheat_file(const CoreCheatFile& cheatFile, const std::filesyst
 
     outputStream << lines;
     outputStream.close();
+
+    // the cache has to be updated here because
+    // the file time might not have changed
+    std::lock_guard<std::mutex> lock(l_CheatsCacheMutex);
+    add_cheats_cache_entry(path, cheatFile);
     return true;
 }
 
@@ -558,6 +1191,18 @@ static bool get_romheader_and_romsettings(const std::filesystem::path& file, Cor
 // Exported Functions
 //
 
+CORE_EXPORT void CoreReadCheatsCache(void)
+{
+    std::lock_guard<std::mutex> lock(l_CheatsCacheMutex);
+    read_cheats_cache_file();
+}
+
+CORE_EXPORT bool CoreSaveCheatsCache(void)
+{
+    std::lock_guard<std::mutex> lock(l_CheatsCacheMutex);
+    return save_cheats_cache_file();
+}
+
 CORE_EXPORT bool CoreGetCurrentCheats(std::filesystem::path file, std::vector<CoreCheat>& cheats)
 {
     CoreRomHeader romHeader;
@@ -568,8 +1213,6 @@ CORE_EXPORT bool CoreGetCurrentCheats(std::filesystem::path file, std::vector<Co
     std::filesystem::path userCheatFilePath;
     bool hasSharedCheatFile = false;
     bool hasUserCheatFile   = false;
-    std::vector<std::string> sharedCheatFilelines;
-    std::vector<std::string> userCheatFileLines;
 
     if (!get_romheader_and_romsettings(file, romHeader, romSettings))
     {
@@ -587,16 +1230,9 @@ CORE_EXPORT bool CoreGetCurrentCheats(std::filesystem::path file, std::vector<Co
         return true;
     }
 
-    // fail when we fail to the shared or user cheat file
-    if ((hasSharedCheatFile && !read_file_lines(sharedCheatFilePath, sharedCheatFilelines)) ||
-        (hasUserCheatFile   && !read_file_lines(userCheatFilePath, userCheatFileLines)))
-    {
-        return false;
-    }
-
-    // fail when we fail to parse the shared or user cheat file
-    if ((hasSharedCheatFile && !parse_cheat_file(sharedCheatFilelines, sharedCheatFile)) ||
-        (hasUserCheatFile   && !parse_cheat_file(userCheatFileLines, userCheatFile)))
+    // fail when we fail to read the shared or user cheat file
+    if ((hasSharedCheatFile && !read_cheat_file(sharedCheatFilePath, sharedCheatFile)) ||
+        (hasUserCheatFile   && !read_cheat_file(userCheatFilePath, userCheatFile)))
     {
         return false;
     }
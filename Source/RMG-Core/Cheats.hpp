@@ -99,6 +99,12 @@ struct CoreCheatFile
 
     std::vector<CoreCheat> Cheats;
 };
+
+// attempts to read the cheats cache
+void CoreReadCheatsCache(void);
+
+// returns whether saving the cheats cache succeeds
+bool CoreSaveCheatsCache(void);
 #endif // CORE_INTERNAL
 
 // attempts to retrieve the cheats for the currently opened ROM
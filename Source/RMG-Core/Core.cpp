@@ -9,6 +9,7 @@
  */
 #define CORE_INTERNAL
 #include "CachedRomHeaderAndSettings.hpp"
+#include "Cheats.hpp"
 #include "Directories.hpp"
 #include "MediaLoader.hpp"
 #include "Callback.hpp"
@@ -164,6 +165,7 @@ CORE_EXPORT bool CoreInit(void)
     }
 
     CoreReadRomHeaderAndSettingsCache();
+    CoreReadCheatsCache();
     return true;
 }
 
@@ -172,11 +174,15 @@ CORE_EXPORT void CoreShutdown(void)
     CorePluginsShutdown();
 
     CoreSaveRomHeaderAndSettingsCache();
+    CoreSaveCheatsCache();
 
     m64p::Core.Shutdown();
 
     m64p::Core.Unhook();
     m64p::Config.Unhook();
 
+    // the config is read again on the next CoreInit()
+    CoreSettingsInvalidateCache();
+
     CoreCloseLibrary(l_CoreLibHandle);
 }
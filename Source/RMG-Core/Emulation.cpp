@@ -14,9 +14,16 @@
 #include "RomHeader.hpp"
 #include "Settings.hpp"
 #include "Library.hpp"
+#include "NetplayTelemetry.hpp"
+#include "FramePacing.hpp"
 #include "Netplay.hpp"
+#include "KailleraRollback.hpp"
+#include "KailleraReplay.hpp"
+#include "Directories.hpp"
+#include "StateHash.hpp"
 #include "Kaillera.hpp"
 #include "Plugins.hpp"
+#include "Callback.hpp"
 #include "Cheats.hpp"
 #include "Error.hpp"
 #include "File.hpp"
@@ -24,12 +31,8 @@
 
 #include "m64p/Api.hpp"
 
-// Windows/POSIX dynamic loading
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <dlfcn.h>
-#endif
+#include <chrono>
+#include <ctime>
 
 // Forward declarations for PIF structures
 extern "C" {
@@ -87,10 +90,19 @@ static bool s_SyncedThisFrame = false;
 static void FrameCallback(unsigned int frameIndex)
 {
     s_CurrentFrame = frameIndex;
+
+    // Hash the state of this frame (no-op when state hashing is inactive)
+    CoreStateHashFrame();
+
+    // Finish the netplay telemetry of the previous frame
+    CoreNetplayTelemetryFrame();
 #ifdef NETPLAY
     // Reset sync flag at the start of each new frame
     // This ensures we sync exactly once per frame regardless of PIF polling timing
     s_SyncedThisFrame = false;
+
+    // Take a rollback snapshot at the frame boundary (no-op when rollback is inactive)
+    CoreKailleraRollbackFrame();
 #endif
 }
 
@@ -98,17 +110,26 @@ static void FrameCallback(unsigned int frameIndex)
 static void KailleraPifSyncCallback(struct pif* pif)
 {
 #ifdef NETPLAY
-    if (!CoreHasInitKaillera()) {
+    // Replays feed recorded input back without a Kaillera session
+    bool replay = CoreIsKailleraReplayPlaying();
+
+    if (!replay && !CoreHasInitKaillera()) {
         return;
     }
 
     int player_num = CoreGetKailleraPlayerNumber();
     int num_players = CoreGetKailleraNumPlayers();
 
-    if (player_num < 1 || player_num > MAX_PLAYERS) {
+    if (!replay && (player_num < 1 || player_num > MAX_PLAYERS)) {
         return; // Invalid player number
     }
 
+    // A rollback snapshot was restored, the next controller read
+    // belongs to the restored frame and has to be synced again
+    if (CoreKailleraRollbackHasRestored()) {
+        s_SyncedThisFrame = false;
+    }
+
     // Check if this is a controller read command for channel 0 (local player)
     // We only want to sync on actual input reads, not status queries or other commands
     bool isControllerRead = (pif->channels[0].tx &&
@@ -130,7 +151,30 @@ static void KailleraPifSyncCallback(struct pif* pif)
         sync_buffer[0] = local_input;
 
         // Synchronize with Kaillera - this must be called exactly ONCE per emulator frame
-        int ret = CoreModifyKailleraPlayValues(sync_buffer, sizeof(uint32_t));
+        // With rollback the remote input is predicted instead of waiting for it
+        int ret;
+        auto sync_start = std::chrono::steady_clock::now();
+        if (replay) {
+            int replay_players = 0;
+            if (!CoreKailleraReplayPlayInput(sync_buffer, replay_players)) {
+                // Every recorded frame has been played
+                CoreStopEmulation();
+                return;
+            }
+            ret = replay_players * (int)sizeof(uint32_t);
+        } else if (CoreIsKailleraRollbackActive()) {
+            int rollback_players = 0;
+            ret = CoreKailleraRollbackSyncInput(local_input, sync_buffer, rollback_players) ?
+                    rollback_players * (int)sizeof(uint32_t) : -1;
+        } else {
+            ret = CoreModifyKailleraPlayValues(sync_buffer, sizeof(uint32_t));
+        }
+
+        // Report how long the sync blocked (replays don't wait on anyone)
+        if (!replay) {
+            CoreNetplayTelemetryAddWait(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - sync_start).count(), ret);
+        }
 
         if (ret < 0) {
             // Game ended or network error - cache zeros and continue
@@ -144,6 +188,11 @@ static void KailleraPifSyncCallback(struct pif* pif)
             return;
         }
 
+        // Record the synced input (no-op when recording is inactive)
+        if (!replay) {
+            CoreKailleraReplayRecordInput(sync_buffer, ret / (int)sizeof(uint32_t));
+        }
+
         if (ret == 0) {
             // Frame delay period - n02 returns 0 while buffering initial frames
             // Use cached input from previous sync (or zeros if none yet)
@@ -309,6 +358,18 @@ static void apply_kaillera_deterministic_settings(void)
     // This prevents desync from players having different in-game settings saved
     CoreSettingsSetValue(SettingsID::Core_DisableSaveFileLoading, true);
 }
+
+// every game gets its own state hash log and replay,
+// so the files of earlier games aren't overwritten
+static std::filesystem::path get_kaillera_game_file_path(std::string directory, std::string extension, int player)
+{
+    char timeBuf[32] = {0};
+    std::time_t currentTime = std::time(nullptr);
+    std::strftime(timeBuf, sizeof(timeBuf), "%Y%m%d-%H%M%S", std::localtime(&currentTime));
+
+    std::string fileName = std::string(timeBuf) + "-p" + std::to_string(player) + extension;
+    return CoreGetUserDataDirectory() / directory / fileName;
+}
 #endif
 
 static void apply_pif_rom_settings(void)
@@ -377,10 +438,14 @@ CORE_EXPORT bool CoreStartEmulation(std::filesystem::path n64rom, std::filesyste
     bool        netplay_ret = false;
     CoreRomType type;
     bool        netplay = !address.empty();
+    bool        replay  = false;
 
 #ifdef NETPLAY
+    // Kaillera replays are played with the settings of the recorded game
+    replay = !netplay && CoreIsKailleraReplayPlaying();
+
     // Apply RSP plugin override and reload plugins BEFORE ROM open
-    if (netplay && address == "KAILLERA")
+    if ((netplay && address == "KAILLERA") || replay)
     {
         apply_kaillera_rsp_override();
         CoreApplyPluginSettings();  // Force reload with HLE RSP
@@ -423,7 +488,7 @@ CORE_EXPORT bool CoreStartEmulation(std::filesystem::path n64rom, std::filesyste
             return false;
         }
     }
-    else
+    else if (!replay)
     { // local cheats
         if (!CoreApplyCheats())
         {
@@ -466,6 +531,17 @@ CORE_EXPORT bool CoreStartEmulation(std::filesystem::path n64rom, std::filesyste
         apply_kaillera_deterministic_settings();
     }
 
+    // Replays apply the deterministic settings which were recorded
+    if (replay && !CoreStartKailleraReplayPlayback())
+    {
+        CoreClearCheats();
+        CoreDetachPlugins();
+        CoreApplyPluginSettings();
+        CoreCloseRom();
+        CoreResetMediaLoader();
+        return false;
+    }
+
     // Kaillera connection happens BEFORE emulation via kailleraSelectServerDialog
     // Just verify it's initialized if netplay was requested
     if (netplay)
@@ -505,6 +581,8 @@ CORE_EXPORT bool CoreStartEmulation(std::filesystem::path n64rom, std::filesyste
         // Register frame callback for frame counter (used by Kaillera)
         s_CurrentFrame = 0;
         m64p::Core.DoCommand(M64CMD_SET_FRAME_CALLBACK, 0, (void*)FrameCallback);
+        CoreStartNetplayTelemetry();
+        CoreStartFramePacing();
 
 #ifdef NETPLAY
         // Reset Kaillera sync state to prevent stale cache from previous sessions
@@ -520,19 +598,49 @@ CORE_EXPORT bool CoreStartEmulation(std::filesystem::path n64rom, std::filesyste
         // Register Kaillera PIF sync callback (works with any input plugin)
         // Get function pointer dynamically since mupen64plus is loaded at runtime
         typedef void (*set_pif_sync_callback_t)(pif_sync_callback_t);
-        void* coreHandle = m64p::Core.GetHandle();
-        if (coreHandle)
+        set_pif_sync_callback_t set_pif_sync_callback =
+            (set_pif_sync_callback_t)CoreGetLibrarySymbol((CoreLibraryHandle)m64p::Core.GetHandle(), "set_pif_sync_callback");
+        if (set_pif_sync_callback != nullptr)
         {
-#ifdef _WIN32
-            set_pif_sync_callback_t set_callback =
-                (set_pif_sync_callback_t)GetProcAddress((HMODULE)coreHandle, "set_pif_sync_callback");
-#else
-            set_pif_sync_callback_t set_callback =
-                (set_pif_sync_callback_t)dlsym(coreHandle, "set_pif_sync_callback");
-#endif
-            if (set_callback)
+            set_pif_sync_callback(KailleraPifSyncCallback);
+        }
+        else if ((netplay && address == "KAILLERA") || replay)
+        {
+            // without the callback the synced input never reaches the PIF
+            CoreAddCallbackMessage(CoreDebugMessageType::Warning,
+                "CoreStartEmulation: core doesn't support the PIF sync callback, Kaillera input won't be synced!");
+        }
+
+        // Rollback is opt-in, every player in the game has to enable it
+        if (netplay && address == "KAILLERA" &&
+            CoreSettingsGetBoolValue(SettingsID::Netplay_KailleraRollback))
+        {
+            if (!CoreStartKailleraRollback(CoreSettingsGetIntValue(SettingsID::Netplay_KailleraRollbackFrames)))
             {
-                set_callback(KailleraPifSyncCallback);
+                CoreAddCallbackMessage(CoreDebugMessageType::Warning,
+                    "CoreStartEmulation: falling back to delay based Kaillera netplay: " + CoreGetError());
+            }
+        }
+
+        // State hashes let the players find the frame which desynced
+        if (netplay && address == "KAILLERA" &&
+            CoreSettingsGetBoolValue(SettingsID::Netplay_KailleraStateHashLog))
+        {
+            if (!CoreStartStateHashLog(get_kaillera_game_file_path("StateHash", ".rmghash", player)))
+            {
+                CoreAddCallbackMessage(CoreDebugMessageType::Warning,
+                    "CoreStartEmulation: failed to start state hash log: " + CoreGetError());
+            }
+        }
+
+        // Replays contain the synced input of every frame
+        if (netplay && address == "KAILLERA" &&
+            CoreSettingsGetBoolValue(SettingsID::Netplay_KailleraReplayRecord))
+        {
+            if (!CoreStartKailleraReplayRecording(get_kaillera_game_file_path("Replays", ".rmgreplay", player)))
+            {
+                CoreAddCallbackMessage(CoreDebugMessageType::Warning,
+                    "CoreStartEmulation: failed to start Kaillera replay recording: " + CoreGetError());
             }
         }
 #endif
@@ -553,12 +661,20 @@ CORE_EXPORT bool CoreStartEmulation(std::filesystem::path n64rom, std::filesyste
         {
             // Don't shutdown Kaillera here - keep connection alive for restart
             // Kaillera will be shutdown when user leaves the server dialog
+            CoreStopKailleraRollback();
+            CoreStopStateHashLog();
+            CoreStopKailleraReplayRecording();
         }
         else
         {
             CoreShutdownNetplay();
         }
     }
+
+    if (replay)
+    {
+        CoreStopKailleraReplayPlayback();
+    }
 #endif // NETPLAY
 
     CoreClearCheats();
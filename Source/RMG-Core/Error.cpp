@@ -11,11 +11,14 @@
 
 #include "Library.hpp"
 
+#include <mutex>
+
 //
 // Local Variables
 //
 
 static std::string l_ErrorMessage;
+static std::mutex  l_ErrorMutex;
 
 //
 // Exported Functions
@@ -23,10 +26,12 @@ static std::string l_ErrorMessage;
 
 void CoreSetError(std::string error)
 {
+    std::lock_guard<std::mutex> lock(l_ErrorMutex);
     l_ErrorMessage = error;
 }
 
 CORE_EXPORT std::string CoreGetError(void)
 {
+    std::lock_guard<std::mutex> lock(l_ErrorMutex);
     return l_ErrorMessage;
 }
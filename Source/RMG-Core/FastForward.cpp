@@ -0,0 +1,80 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "FastForward.hpp"
+#include "Kaillera.hpp"
+#include "Netplay.hpp"
+#include "Library.hpp"
+#include "Error.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <string>
+
+//
+// Local Structures
+//
+
+typedef void (*main_set_fastforward_t)(int enable);
+typedef int  (*main_get_fastforward_t)(void);
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreIsFastForwardEnabled(void)
+{
+    main_get_fastforward_t main_get_fastforward;
+
+    if (!m64p::Core.IsHooked())
+    {
+        return false;
+    }
+
+    main_get_fastforward = (main_get_fastforward_t)CoreGetLibrarySymbol((CoreLibraryHandle)m64p::Core.GetHandle(), "main_get_fastforward");
+    if (main_get_fastforward == nullptr)
+    {
+        return false;
+    }
+
+    return main_get_fastforward() != 0;
+}
+
+CORE_EXPORT bool CoreSetFastForwardState(bool enabled)
+{
+    std::string error;
+    main_set_fastforward_t main_set_fastforward;
+
+    if (!m64p::Core.IsHooked())
+    {
+        return false;
+    }
+
+    // every peer has to run at the same speed
+    if (CoreHasInitNetplay() || CoreHasInitKaillera())
+    {
+        error = "CoreSetFastForwardState Failed: ";
+        error += "cannot fast-forward during netplay!";
+        CoreSetError(error);
+        return false;
+    }
+
+    main_set_fastforward = (main_set_fastforward_t)CoreGetLibrarySymbol((CoreLibraryHandle)m64p::Core.GetHandle(), "main_set_fastforward");
+    if (main_set_fastforward == nullptr)
+    {
+        error = "CoreSetFastForwardState Failed: ";
+        error += "core doesn't support fast-forward!";
+        CoreSetError(error);
+        return false;
+    }
+
+    main_set_fastforward(enabled ? 1 : 0);
+    return true;
+}
@@ -0,0 +1,21 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_FASTFORWARD_HPP
+#define CORE_FASTFORWARD_HPP
+
+// returns whether fast-forward is enabled
+bool CoreIsFastForwardEnabled(void);
+
+// sets the fast-forward state, while it's enabled
+// the core runs at the fast-forward speed factor and
+// skips presenting frames as configured in the settings
+bool CoreSetFastForwardState(bool enabled);
+
+#endif // CORE_FASTFORWARD_HPP
@@ -21,6 +21,9 @@
 #include <fileapi.h>
 #else
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 //
@@ -87,6 +90,125 @@ CORE_EXPORT bool CoreWriteFile(std::filesystem::path file, std::vector<char>& bu
     return true;
 }
 
+CORE_EXPORT bool CoreMapFile(std::filesystem::path file, CoreMappedFile& mappedFile)
+{
+    std::string error;
+
+    mappedFile = {};
+
+#ifdef _WIN32
+    HANDLE file_handle;
+    HANDLE mapping_handle;
+    LARGE_INTEGER file_size;
+    void* data;
+
+    file_handle = CreateFileW(file.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        error = "CoreMapFile Failed: ";
+        error += "failed to open file: ";
+        error += std::to_string(GetLastError());
+        CoreSetError(error);
+        return false;
+    }
+
+    if (GetFileSizeEx(file_handle, &file_size) != TRUE || file_size.QuadPart == 0)
+    {
+        CloseHandle(file_handle);
+        CoreSetError("CoreMapFile Failed: file is empty or its size cannot be retrieved!");
+        return false;
+    }
+
+    // the mapping keeps its own reference to the file
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file_handle);
+    if (mapping_handle == nullptr)
+    {
+        error = "CoreMapFile Failed: ";
+        error += "failed to create file mapping: ";
+        error += std::to_string(GetLastError());
+        CoreSetError(error);
+        return false;
+    }
+
+    data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping_handle);
+        error = "CoreMapFile Failed: ";
+        error += "failed to map view of file: ";
+        error += std::to_string(GetLastError());
+        CoreSetError(error);
+        return false;
+    }
+
+    mappedFile.Data   = static_cast<const char*>(data);
+    mappedFile.Size   = static_cast<size_t>(file_size.QuadPart);
+    mappedFile.Handle = mapping_handle;
+    return true;
+#else // Linux
+    int fd;
+    struct stat file_stat;
+    void* data;
+
+    fd = open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        error = "CoreMapFile Failed: ";
+        error += "failed to open file: ";
+        error += strerror(errno);
+        error += " (";
+        error += std::to_string(errno);
+        error += ")";
+        CoreSetError(error);
+        return false;
+    }
+
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+        close(fd);
+        CoreSetError("CoreMapFile Failed: file is empty or its size cannot be retrieved!");
+        return false;
+    }
+
+    // the mapping stays valid after closing the file
+    data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        error = "CoreMapFile Failed: ";
+        error += "failed to map file: ";
+        error += strerror(errno);
+        error += " (";
+        error += std::to_string(errno);
+        error += ")";
+        CoreSetError(error);
+        return false;
+    }
+
+    mappedFile.Data = static_cast<const char*>(data);
+    mappedFile.Size = static_cast<size_t>(file_stat.st_size);
+    return true;
+#endif // _WIN32
+}
+
+CORE_EXPORT void CoreUnmapFile(CoreMappedFile& mappedFile)
+{
+    if (mappedFile.Data == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedFile.Data);
+    CloseHandle(mappedFile.Handle);
+#else // Linux
+    munmap(const_cast<char*>(mappedFile.Data), mappedFile.Size);
+#endif // _WIN32
+
+    mappedFile = {};
+}
+
 CORE_EXPORT CoreFileTime CoreGetFileTime(std::filesystem::path file)
 {
 #ifdef _WIN32
@@ -15,12 +15,27 @@
 
 typedef uint64_t CoreFileTime;
 
+struct CoreMappedFile
+{
+    const char* Data = nullptr;
+    size_t      Size = 0;
+#ifdef _WIN32
+    void*       Handle = nullptr;
+#endif // _WIN32
+};
+
 // attempts to read the file into the buffer
 bool CoreReadFile(std::filesystem::path file, std::vector<char>& outBuffer);
 
 // attempts to write the buffer to file
 bool CoreWriteFile(std::filesystem::path file, std::vector<char>& buffer);
 
+// attempts to map the file read-only into memory
+bool CoreMapFile(std::filesystem::path file, CoreMappedFile& mappedFile);
+
+// unmaps the file mapped by CoreMapFile
+void CoreUnmapFile(CoreMappedFile& mappedFile);
+
 // attempts to retrieve the file time
 CoreFileTime CoreGetFileTime(std::filesystem::path file);
 
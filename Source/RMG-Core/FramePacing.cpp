@@ -0,0 +1,100 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "FramePacing.hpp"
+#include "Library.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <atomic>
+
+//
+// Local Structures
+//
+
+typedef void (*frame_pacer_set_display_rate_t)(double refresh_rate);
+typedef void (*frame_pacer_report_audio_queue_t)(double queued_seconds, double target_seconds);
+typedef int  (*frame_pacer_get_errors_t)(int64_t* errors_ns, int count);
+
+//
+// Local Variables
+//
+
+// the refresh rate is kept, so it can be set
+// before the frame pacer has been hooked
+static std::atomic<double> l_DisplayRefreshRate = 0.0;
+
+static std::atomic<frame_pacer_set_display_rate_t>   l_frame_pacer_set_display_rate   = nullptr;
+static std::atomic<frame_pacer_report_audio_queue_t> l_frame_pacer_report_audio_queue = nullptr;
+static std::atomic<frame_pacer_get_errors_t>         l_frame_pacer_get_errors         = nullptr;
+
+//
+// Internal Functions
+//
+
+void CoreStartFramePacing(void)
+{
+    CoreLibraryHandle handle = (CoreLibraryHandle)m64p::Core.GetHandle();
+    if (handle == nullptr)
+    {
+        return;
+    }
+
+    // cores without a frame pacer don't export these
+    l_frame_pacer_set_display_rate   = (frame_pacer_set_display_rate_t)CoreGetLibrarySymbol(handle, "frame_pacer_set_display_rate");
+    l_frame_pacer_report_audio_queue = (frame_pacer_report_audio_queue_t)CoreGetLibrarySymbol(handle, "frame_pacer_report_audio_queue");
+    l_frame_pacer_get_errors         = (frame_pacer_get_errors_t)CoreGetLibrarySymbol(handle, "frame_pacer_get_errors");
+
+    frame_pacer_set_display_rate_t set_display_rate = l_frame_pacer_set_display_rate;
+    if (set_display_rate != nullptr)
+    {
+        set_display_rate(l_DisplayRefreshRate);
+    }
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT void CoreSetFramePacingDisplayRefreshRate(double refreshRate)
+{
+    l_DisplayRefreshRate = refreshRate;
+
+    frame_pacer_set_display_rate_t set_display_rate = l_frame_pacer_set_display_rate;
+    if (set_display_rate != nullptr)
+    {
+        set_display_rate(refreshRate);
+    }
+}
+
+CORE_EXPORT void CoreReportFramePacingAudioQueue(double queuedSeconds, double targetSeconds)
+{
+    frame_pacer_report_audio_queue_t report_audio_queue = l_frame_pacer_report_audio_queue;
+    if (report_audio_queue != nullptr)
+    {
+        report_audio_queue(queuedSeconds, targetSeconds);
+    }
+}
+
+CORE_EXPORT bool CoreGetFramePacingErrors(std::vector<int64_t>& errors, uint32_t frames)
+{
+    frame_pacer_get_errors_t get_errors = l_frame_pacer_get_errors;
+
+    errors.clear();
+
+    if (get_errors == nullptr || frames == 0)
+    {
+        return false;
+    }
+
+    errors.resize(frames);
+    errors.resize(get_errors(errors.data(), static_cast<int>(frames)));
+    return !errors.empty();
+}
@@ -0,0 +1,41 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_FRAMEPACING_HPP
+#define CORE_FRAMEPACING_HPP
+
+#include <cstdint>
+#include <vector>
+
+//
+// Frame pacing of the mupen64plus-core, which clock it follows
+// is set by SettingsID::Core_FramePacingClock, the display and
+// audio device clocks need the display refresh rate and the
+// amount of queued audio respectively
+//
+
+#ifdef CORE_INTERNAL
+// hooks the frame pacer of the mupen64plus-core,
+// has to be called before emulation starts
+void CoreStartFramePacing(void);
+#endif // CORE_INTERNAL
+
+// sets the refresh rate of the display which the emulation is shown on
+void CoreSetFramePacingDisplayRefreshRate(double refreshRate);
+
+// reports how much audio is queued on the audio device
+// and how much should be queued, both in seconds
+void CoreReportFramePacingAudioQueue(double queuedSeconds, double targetSeconds);
+
+// retrieves the pacing error of the most recent frames in nanoseconds,
+// oldest first, a positive error means the frame was late,
+// returns false when there are none
+bool CoreGetFramePacingErrors(std::vector<int64_t>& errors, uint32_t frames = 600);
+
+#endif // CORE_FRAMEPACING_HPP
@@ -445,55 +445,906 @@ CORE_EXPORT int CoreGetKailleraFrameDelay(void)
     return 0; // Fallback if function not available
 }
 
+
+CORE_EXPORT bool CoreConnectKailleraServer(std::string address, int port, std::string username, int connectionType)
+{
+    (void)address;
+    (void)port;
+    (void)username;
+    (void)connectionType;
+    CoreSetError("CoreConnectKailleraServer: use CoreShowKailleraServerDialog() with kailleraclient.dll");
+    return false;
+}
+
+CORE_EXPORT bool CoreDisconnectKailleraServer(void)
+{
+    return true;
+}
+
+CORE_EXPORT bool CoreIsKailleraServerConnected(void)
+{
+    return false;
+}
+
+CORE_EXPORT bool CoreGetKailleraGameList(std::vector<CoreKailleraGame>& games)
+{
+    games.clear();
+    return false;
+}
+
+CORE_EXPORT bool CoreCreateKailleraGame(std::string gameName)
+{
+    (void)gameName;
+    return false;
+}
+
+CORE_EXPORT bool CoreJoinKailleraGame(uint32_t gameId)
+{
+    (void)gameId;
+    return false;
+}
+
+CORE_EXPORT bool CoreStartKailleraGame(void)
+{
+    return false;
+}
+
+CORE_EXPORT int CoreSendKailleraPlayValues(void* values, int size)
+{
+    (void)values;
+    (void)size;
+    CoreSetError("CoreSendKailleraPlayValues: not supported by kailleraclient.dll");
+    return -1;
+}
+
+CORE_EXPORT int CoreReceiveKailleraPlayValues(void* values, int size, bool wait)
+{
+    (void)values;
+    (void)size;
+    (void)wait;
+    CoreSetError("CoreReceiveKailleraPlayValues: not supported by kailleraclient.dll");
+    return -1;
+}
+
 #else // !_WIN32
 
-// Stub implementations for non-Windows platforms
-// Kaillera is Windows-only (requires kailleraclient.dll)
+//
+// Native Kaillera client
+//
+// Implements the client side of the Kaillera v0.83 UDP protocol,
+// the server dialog of kailleraclient.dll is replaced by the
+// CoreConnectKailleraServer() family of functions
+//
+
+#include "KailleraProtocol.hpp"
+#include "KailleraDelay.hpp"
 
-CORE_EXPORT bool CoreInitKaillera(void)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <poll.h>
+
+#include <condition_variable>
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <deque>
+
+using namespace CoreKaillera;
+
+//
+// Local Defines
+//
+
+#define KAILLERA_CONNECT_TIMEOUT_MS   5000
+#define KAILLERA_LOGIN_TIMEOUT_MS     10000
+#define KAILLERA_GAME_TIMEOUT_MS      15000
+#define KAILLERA_KEEPALIVE_MS         5000
+#define KAILLERA_POLL_MS              100
+
+//
+// Local Enums
+//
+
+enum class l_ClientState
+{
+    Disconnected,
+    LoggingIn,
+    Connected,
+    Rejected
+};
+
+//
+// Static Variables
+//
+
+static bool s_Initialized = false;
+static std::atomic<bool> s_GameActive = false;
+static std::atomic<int> s_PlayerNumber = 0; // 0 = not in netplay, 1-8 = player number
+static std::atomic<int> s_NumPlayers = 0;   // Total number of players in the game
+static std::atomic<int> s_FrameDelay = 0;
+static std::string s_AppName;
+static std::string s_GameList;
+
+// Callback storage
+static CoreKaillera::GameStartCallback s_GameStartCallback;
+static CoreKaillera::ChatReceivedCallback s_ChatReceivedCallback;
+static CoreKaillera::ClientDroppedCallback s_ClientDroppedCallback;
+static CoreKaillera::MoreInfosCallback s_MoreInfosCallback;
+
+// Connection state, protected by s_Mutex
+static std::mutex s_Mutex;
+static std::condition_variable s_Condition;
+static l_ClientState s_State = l_ClientState::Disconnected;
+static std::string s_Username;
+static std::string s_RejectMessage;
+static int s_ConnectionType = 1;
+static std::string s_ServerName;
+static uint16_t s_UserId = 0xFFFF;
+static uint32_t s_Ping = 0;
+static std::vector<CoreKailleraGame> s_Games;
+static bool s_InGame = false;
+static bool s_GameOwner = false;
+static uint32_t s_GameId = 0;
+static std::string s_GameName;
+
+// Game data state, protected by s_Mutex
+static bool s_AllPlayersReady = false;
+static int s_BufferedFrames = 0;
+static int s_OutgoingFrames = 0;
+static int s_InputSize = 0;
+static size_t s_IncomingBytes = 0;
+static std::vector<uint8_t> s_OutgoingInput;
+static std::deque<uint8_t> s_IncomingInput;
+static GameCache s_InCache;
+static GameCache s_OutCache;
+
+// Socket state, protected by s_SendMutex
+static std::mutex s_SendMutex;
+static int s_Socket = -1;
+static sockaddr_in s_ServerAddress;
+static MessageSender s_Sender;
+static std::chrono::steady_clock::time_point s_LastSendTime;
+
+// Receive thread
+static std::thread s_Thread;
+static std::atomic<bool> s_ThreadRunning = false;
+static MessageReceiver s_Receiver;
+
+//
+// Helper Functions
+//
+
+static void send_raw(const void* data, size_t size)
+{
+    sendto(s_Socket, data, size, 0, (sockaddr*)&s_ServerAddress, sizeof(s_ServerAddress));
+}
+
+static void send_message(MessageType type, const MessageWriter& writer)
+{
+    std::lock_guard<std::mutex> lock(s_SendMutex);
+
+    if (s_Socket == -1)
+    {
+        return;
+    }
+
+    std::vector<uint8_t> packet = s_Sender.Build(type, writer.Data());
+    send_raw(packet.data(), packet.size());
+    s_LastSendTime = std::chrono::steady_clock::now();
+}
+
+static void send_empty_message(MessageType type)
+{
+    MessageWriter writer;
+    writer.PutString("");
+    send_message(type, writer);
+}
+
+// sends the buffered local input, as a cache
+// index when the server has seen it before,
+// expects s_Mutex to be locked
+static void send_game_data(void)
+{
+    MessageWriter writer;
+    writer.PutString("");
+
+    int index = s_OutCache.Find(s_OutgoingInput);
+    if (index != -1)
+    {
+        writer.PutU8(static_cast<uint8_t>(index));
+        send_message(MessageType::GameCache, writer);
+    }
+    else
+    {
+        writer.PutU16(static_cast<uint16_t>(s_OutgoingInput.size()));
+        writer.PutBytes(s_OutgoingInput.data(), s_OutgoingInput.size());
+        send_message(MessageType::GameData, writer);
+        s_OutCache.Add(s_OutgoingInput);
+    }
+
+    s_OutgoingInput.clear();
+    s_OutgoingFrames = 0;
+}
+
+// resets game data state, expects s_Mutex to be locked
+static void reset_game_data(void)
+{
+    s_AllPlayersReady = false;
+    s_BufferedFrames  = 0;
+    s_OutgoingFrames  = 0;
+    s_InputSize       = 0;
+    s_IncomingBytes   = 0;
+    s_OutgoingInput.clear();
+    s_IncomingInput.clear();
+    s_InCache.Reset();
+    s_OutCache.Reset();
+}
+
+// waits until every player has loaded the game,
+// returns false when the game has ended
+static bool wait_for_players(std::unique_lock<std::mutex>& lock)
+{
+    auto timeout = std::chrono::milliseconds(KAILLERA_GAME_TIMEOUT_MS);
+
+    if (!s_Condition.wait_for(lock, timeout, [] { return s_AllPlayersReady || !s_GameActive; }) ||
+        !s_GameActive)
+    {
+        s_GameActive = false;
+        return false;
+    }
+
+    return true;
+}
+
+// queues local input, it's sent to the server once we have
+// one packet worth of frames, expects s_Mutex to be locked
+static void queue_local_input(const void* values, int size)
+{
+    const uint8_t* input = static_cast<const uint8_t*>(values);
+    s_OutgoingInput.insert(s_OutgoingInput.end(), input, input + size);
+    s_InputSize = size;
+    CoreKailleraDelayFrameQueued();
+    if (++s_OutgoingFrames >= s_ConnectionType)
+    {
+        send_game_data();
+    }
+}
+
+// copies the synchronized input of the oldest frame to values,
+// returns 0 when it hasn't arrived and wait is false
+static int take_synced_input(std::unique_lock<std::mutex>& lock, void* values, int size, bool wait)
+{
+    auto timeout = std::chrono::milliseconds(KAILLERA_GAME_TIMEOUT_MS);
+    size_t frameSize = static_cast<size_t>(size) * s_NumPlayers;
+
+    if (!wait && s_IncomingInput.size() < frameSize)
+    {
+        return s_GameActive ? 0 : -1;
+    }
+
+    bool stalled = s_IncomingInput.size() < frameSize;
+    auto waitStart = std::chrono::steady_clock::now();
+
+    if (!s_Condition.wait_for(lock, timeout, [frameSize] { return s_IncomingInput.size() >= frameSize || !s_GameActive; }) ||
+        !s_GameActive)
+    {
+        s_GameActive = false;
+        return -1;
+    }
+
+    CoreKailleraDelayFrameTaken(stalled,
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count());
+
+    std::copy(s_IncomingInput.begin(), s_IncomingInput.begin() + frameSize, static_cast<uint8_t*>(values));
+    s_IncomingInput.erase(s_IncomingInput.begin(), s_IncomingInput.begin() + frameSize);
+    return static_cast<int>(frameSize);
+}
+
+static CoreKailleraGame* find_game(uint32_t gameId)
+{
+    for (CoreKailleraGame& game : s_Games)
+    {
+        if (game.Id == gameId)
+        {
+            return &game;
+        }
+    }
+
+    return nullptr;
+}
+
+static void handle_message(const Message& message)
+{
+    MessageReader reader(message.Data);
+
+    switch (message.Type)
+    {
+    default:
+        break;
+
+    case MessageType::ServerAck:
+    { // server measures our ping by bouncing acks,
+      // holding them back raises the frame delay
+      // the server assigns when the game starts
+        int connectionType;
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            connectionType = s_ConnectionType;
+        }
+        uint32_t holdTime = CoreGetKailleraDelayAckHoldTime(connectionType);
+        if (holdTime > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(holdTime));
+        }
+
+        MessageWriter writer;
+        writer.PutString("");
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            writer.PutU32(i);
+        }
+        send_message(MessageType::ClientAck, writer);
+    } break;
+
+    case MessageType::UserJoined:
+    {
+        std::string username = reader.GetString();
+        uint16_t userId      = reader.GetU16();
+        uint32_t ping        = reader.GetU32();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (s_State == l_ClientState::LoggingIn && username == s_Username)
+        {
+            s_UserId = userId;
+            s_Ping   = ping;
+            s_State  = l_ClientState::Connected;
+            s_Condition.notify_all();
+        }
+    } break;
+
+    case MessageType::ConnectionRejected:
+    {
+        reader.GetString();
+        reader.GetU16();
+        std::string reason = reader.GetString();
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        s_RejectMessage = reason;
+        s_State = l_ClientState::Rejected;
+        s_Condition.notify_all();
+    } break;
+
+    case MessageType::ServerStatus:
+    {
+        reader.GetString();
+        uint32_t users = reader.GetU32();
+        uint32_t games = reader.GetU32();
+
+        for (uint32_t i = 0; i < users && reader.IsValid(); i++)
+        {
+            reader.GetString(); // username
+            reader.GetU32();    // ping
+            reader.GetU8();     // status
+            reader.GetU16();    // user id
+            reader.GetU8();     // connection type
+        }
+
+        std::vector<CoreKailleraGame> gameList;
+        for (uint32_t i = 0; i < games && reader.IsValid(); i++)
+        {
+            CoreKailleraGame game;
+            game.Name     = reader.GetString();
+            game.Id       = reader.GetU32();
+            game.Emulator = reader.GetString();
+            game.Owner    = reader.GetString();
+            game.Users    = reader.GetString();
+            game.Status   = reader.GetU8();
+            gameList.push_back(game);
+        }
+
+        if (reader.IsValid())
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_Games = gameList;
+        }
+    } break;
+
+    case MessageType::CreateGame:
+    {
+        CoreKailleraGame game;
+        game.Owner    = reader.GetString();
+        game.Name     = reader.GetString();
+        game.Emulator = reader.GetString();
+        game.Id       = reader.GetU32();
+        game.Users    = "1";
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (find_game(game.Id) == nullptr)
+        {
+            s_Games.push_back(game);
+        }
+        if (!s_InGame && s_GameOwner && game.Owner == s_Username)
+        {
+            s_InGame   = true;
+            s_GameId   = game.Id;
+            s_GameName = game.Name;
+            s_Condition.notify_all();
+        }
+    } break;
+
+    case MessageType::UpdateGameStatus:
+    {
+        reader.GetString();
+        uint32_t gameId    = reader.GetU32();
+        uint8_t status     = reader.GetU8();
+        uint8_t numPlayers = reader.GetU8();
+        uint8_t maxPlayers = reader.GetU8();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        CoreKailleraGame* game = find_game(gameId);
+        if (game != nullptr)
+        {
+            game->Status = status;
+            game->Users  = std::to_string(numPlayers) + "/" + std::to_string(maxPlayers);
+        }
+    } break;
+
+    case MessageType::CloseGame:
+    {
+        reader.GetString();
+        uint32_t gameId = reader.GetU32();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        std::erase_if(s_Games, [gameId](const CoreKailleraGame& game) { return game.Id == gameId; });
+        if (s_InGame && s_GameId == gameId)
+        {
+            s_InGame    = false;
+            s_GameOwner = false;
+            s_GameActive = false;
+            s_Condition.notify_all();
+        }
+    } break;
+
+    case MessageType::JoinGame:
+    {
+        reader.GetString();
+        uint32_t gameId      = reader.GetU32();
+        std::string username = reader.GetString();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (!s_InGame && username == s_Username)
+        {
+            CoreKailleraGame* game = find_game(gameId);
+            s_InGame   = true;
+            s_GameId   = gameId;
+            s_GameName = (game != nullptr ? game->Name : "");
+            s_Condition.notify_all();
+        }
+    } break;
+
+    case MessageType::QuitGame:
+    {
+        std::string username = reader.GetString();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (username == s_Username)
+        {
+            s_InGame    = false;
+            s_GameOwner = false;
+            s_Condition.notify_all();
+        }
+    } break;
+
+    case MessageType::StartGame:
+    {
+        reader.GetString();
+        uint16_t frameDelay = reader.GetU16();
+        uint8_t player      = reader.GetU8();
+        uint8_t numPlayers  = reader.GetU8();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        std::string gameName;
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            reset_game_data();
+            gameName = s_GameName;
+        }
+
+        // Store player number and total player count
+        s_PlayerNumber = player;
+        s_NumPlayers   = numPlayers;
+        s_FrameDelay   = frameDelay;
+        CoreKailleraDelayStartGame(frameDelay);
+
+        // Set game active BEFORE callback so emulation thread sees it immediately
+        s_GameActive = true;
+
+        if (s_GameStartCallback)
+        {
+            try
+            {
+                s_GameStartCallback(gameName, player, numPlayers);
+            }
+            catch (...)
+            {
+                s_GameActive = false;
+                break;
+            }
+        }
+
+        send_empty_message(MessageType::ReadyToPlay);
+    } break;
+
+    case MessageType::ReadyToPlay:
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        s_AllPlayersReady = true;
+        s_Condition.notify_all();
+    } break;
+
+    case MessageType::GameData:
+    case MessageType::GameCache:
+    {
+        std::vector<uint8_t> data;
+
+        reader.GetString();
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (message.Type == MessageType::GameData)
+        {
+            uint16_t length = reader.GetU16();
+            data = reader.GetBytes(length);
+            if (!reader.IsValid())
+            {
+                break;
+            }
+            s_InCache.Add(data);
+        }
+        else
+        {
+            uint8_t index = reader.GetU8();
+            if (!reader.IsValid() || !s_InCache.Get(index, data))
+            {
+                break;
+            }
+        }
+
+        s_IncomingInput.insert(s_IncomingInput.end(), data.begin(), data.end());
+        s_Condition.notify_all();
+
+        // every frame of synced input completes a round trip
+        size_t frameSize = static_cast<size_t>(s_InputSize) * s_NumPlayers;
+        if (frameSize > 0)
+        {
+            s_IncomingBytes += data.size();
+            CoreKailleraDelayFramesArrived(static_cast<int>(s_IncomingBytes / frameSize));
+            s_IncomingBytes %= frameSize;
+        }
+    } break;
+
+    case MessageType::GameChat:
+    {
+        std::string username = reader.GetString();
+        std::string text     = reader.GetString();
+        if (!reader.IsValid() || !s_ChatReceivedCallback)
+        {
+            break;
+        }
+
+        try
+        {
+            s_ChatReceivedCallback(username, text);
+        }
+        catch (...)
+        {
+            // Ignore errors in callback
+        }
+    } break;
+
+    case MessageType::DropGame:
+    {
+        std::string username = reader.GetString();
+        uint8_t player       = reader.GetU8();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        if (player == s_PlayerNumber)
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_GameActive = false;
+            s_Condition.notify_all();
+        }
+
+        if (s_ClientDroppedCallback)
+        {
+            try
+            {
+                s_ClientDroppedCallback(username, player);
+            }
+            catch (...)
+            {
+                // Ignore errors in callback
+            }
+        }
+    } break;
+    }
+}
+
+static void receive_thread(void)
+{
+    uint8_t buffer[KAILLERA_MAX_PACKET_SIZE];
+    std::vector<Message> messages;
+
+    while (s_ThreadRunning)
+    {
+        pollfd pfd;
+        pfd.fd      = s_Socket;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+
+        if (poll(&pfd, 1, KAILLERA_POLL_MS) > 0 && (pfd.revents & POLLIN))
+        {
+            ssize_t size = recv(s_Socket, buffer, sizeof(buffer), 0);
+            if (size > 0)
+            {
+                messages.clear();
+                if (s_Receiver.Parse(buffer, size, messages))
+                {
+                    for (const Message& message : messages)
+                    {
+                        handle_message(message);
+                    }
+                }
+            }
+        }
+
+        // keep the connection alive while idle in the lobby
+        bool sendKeepAlive;
+        {
+            std::lock_guard<std::mutex> lock(s_SendMutex);
+            sendKeepAlive = (std::chrono::steady_clock::now() - s_LastSendTime) > std::chrono::milliseconds(KAILLERA_KEEPALIVE_MS);
+        }
+        if (sendKeepAlive)
+        {
+            send_empty_message(MessageType::KeepAlive);
+        }
+    }
+}
+
+// performs the HELLO handshake, on success
+// s_ServerAddress points to the game port
+static bool do_handshake(void)
 {
-    CoreSetError("Kaillera is only supported on Windows");
+    char buffer[64];
+    std::string hello = "HELLO" KAILLERA_PROTOCOL_VERSION;
+    auto start = std::chrono::steady_clock::now();
+
+    while ((std::chrono::steady_clock::now() - start) < std::chrono::milliseconds(KAILLERA_CONNECT_TIMEOUT_MS))
+    {
+        send_raw(hello.c_str(), hello.size() + 1);
+
+        pollfd pfd;
+        pfd.fd      = s_Socket;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+
+        if (poll(&pfd, 1, 1000) <= 0)
+        {
+            continue;
+        }
+
+        ssize_t size = recv(s_Socket, buffer, sizeof(buffer) - 1, 0);
+        if (size <= 0)
+        {
+            continue;
+        }
+        buffer[size] = '\0';
+
+        std::string reply = buffer;
+        if (reply.starts_with("HELLOD00D"))
+        {
+            int port = std::atoi(reply.c_str() + 9);
+            if (port <= 0 || port > 65535)
+            {
+                CoreSetError("CoreConnectKailleraServer: server returned an invalid port");
+                return false;
+            }
+
+            s_ServerAddress.sin_port = htons(static_cast<uint16_t>(port));
+            return true;
+        }
+        else if (reply == "TOO")
+        {
+            CoreSetError("CoreConnectKailleraServer: server is full");
+            return false;
+        }
+        else if (reply == "VER")
+        {
+            CoreSetError("CoreConnectKailleraServer: server protocol version mismatch");
+            return false;
+        }
+    }
+
+    CoreSetError("CoreConnectKailleraServer: server did not respond");
     return false;
 }
 
+static void close_connection(void)
+{
+    s_ThreadRunning = false;
+    if (s_Thread.joinable())
+    {
+        s_Thread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_SendMutex);
+        if (s_Socket != -1)
+        {
+            close(s_Socket);
+            s_Socket = -1;
+        }
+        s_Sender.Reset();
+    }
+
+    s_Receiver.Reset();
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_State     = l_ClientState::Disconnected;
+    s_InGame    = false;
+    s_GameOwner = false;
+    s_GameActive = false;
+    s_Games.clear();
+    reset_game_data();
+    s_Condition.notify_all();
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreInitKaillera(void)
+{
+    if (s_Initialized)
+    {
+        return true; // Already initialized
+    }
+
+    s_Initialized = true;
+    s_GameActive = false;
+
+    return true;
+}
+
 CORE_EXPORT bool CoreShutdownKaillera(void)
 {
+    if (!s_Initialized)
+    {
+        return true; // Not initialized, nothing to do
+    }
+
+    CoreDisconnectKailleraServer();
+
+    s_Initialized = false;
+    s_GameActive = false;
+
     return true;
 }
 
 CORE_EXPORT bool CoreHasInitKaillera(void)
 {
-    return false;
+    return s_Initialized && s_GameActive;
 }
 
 CORE_EXPORT bool CoreShowKailleraServerDialog(void* parentHwnd)
 {
     (void)parentHwnd;
-    CoreSetError("Kaillera is only supported on Windows");
+    CoreSetError("CoreShowKailleraServerDialog: the native Kaillera client has no server dialog, use CoreConnectKailleraServer()");
     return false;
 }
 
 CORE_EXPORT int CoreModifyKailleraPlayValues(void* values, int size)
 {
-    (void)values;
-    (void)size;
-    return -1;
+    if (!s_Initialized || !s_GameActive || size <= 0)
+    {
+        return -1; // Not in netplay mode
+    }
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+
+    if (!wait_for_players(lock))
+    {
+        return -1;
+    }
+
+    queue_local_input(values, size);
+
+    // the first frames are used to fill the delay buffer
+    if (s_BufferedFrames < s_FrameDelay)
+    {
+        s_BufferedFrames++;
+        return 0;
+    }
+
+    return take_synced_input(lock, values, size, true);
 }
 
 CORE_EXPORT bool CoreKailleraSendChat(std::string text)
 {
-    (void)text;
-    return false;
+    if (!s_Initialized || !s_GameActive)
+    {
+        return false;
+    }
+
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutString(text);
+    send_message(MessageType::GameChat, writer);
+    return true;
 }
 
 CORE_EXPORT bool CoreEndKailleraGame(void)
 {
+    if (!s_GameActive)
+    {
+        return true; // No game active
+    }
+
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU8(0);
+    send_message(MessageType::DropGame, writer);
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_GameActive = false;
+    s_Condition.notify_all();
     return true;
 }
 
 CORE_EXPORT void CoreMarkKailleraGameInactive(void)
 {
-    // No-op on non-Windows
+    // Mark game as inactive without dropping from the game
+    // Used when the game ends due to network issues or another player dropping
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_GameActive = false;
+    s_Condition.notify_all();
 }
 
 CORE_EXPORT void CoreSetKailleraCallbacks(
@@ -502,37 +1353,278 @@ CORE_EXPORT void CoreSetKailleraCallbacks(
     CoreKaillera::ClientDroppedCallback clientDroppedCallback,
     CoreKaillera::MoreInfosCallback moreInfosCallback)
 {
-    (void)gameStartCallback;
-    (void)chatReceivedCallback;
-    (void)clientDroppedCallback;
-    (void)moreInfosCallback;
+    s_GameStartCallback = gameStartCallback;
+    s_ChatReceivedCallback = chatReceivedCallback;
+    s_ClientDroppedCallback = clientDroppedCallback;
+    s_MoreInfosCallback = moreInfosCallback;
 }
 
 CORE_EXPORT bool CoreSetKailleraAppInfo(std::string appName, std::string gameList)
 {
-    (void)appName;
-    (void)gameList;
-    return false;
+    s_AppName = appName;
+    s_GameList = gameList;
+    return true;
 }
 
 CORE_EXPORT void CoreSetKailleraPlayerNumber(int playerNumber)
 {
-    (void)playerNumber;
+    s_PlayerNumber = playerNumber;
 }
 
 CORE_EXPORT int CoreGetKailleraPlayerNumber(void)
 {
-    return 0;
+    return s_PlayerNumber;
 }
 
 CORE_EXPORT int CoreGetKailleraNumPlayers(void)
 {
-    return 0;
+    return s_NumPlayers;
 }
 
 CORE_EXPORT int CoreGetKailleraFrameDelay(void)
 {
+    if (!s_Initialized || !s_GameActive)
+    {
+        return 0;
+    }
+
+    return s_FrameDelay;
+}
+
+CORE_EXPORT bool CoreConnectKailleraServer(std::string address, int port, std::string username, int connectionType)
+{
+    addrinfo  hints;
+    addrinfo* result = nullptr;
+
+    if (!s_Initialized)
+    {
+        CoreSetError("Kaillera not initialized. Call CoreInitKaillera() first");
+        return false;
+    }
+
+    CoreDisconnectKailleraServer();
+
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    if (getaddrinfo(address.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 ||
+        result == nullptr)
+    {
+        CoreSetError("CoreConnectKailleraServer: failed to resolve " + address);
+        return false;
+    }
+
+    std::memcpy(&s_ServerAddress, result->ai_addr, sizeof(s_ServerAddress));
+    freeaddrinfo(result);
+
+    // round trip times of another server are meaningless
+    std::string serverName = address + ":" + std::to_string(port);
+    if (serverName != s_ServerName)
+    {
+        CoreKailleraDelayReset();
+        s_ServerName = serverName;
+    }
+
+    s_Socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s_Socket == -1)
+    {
+        CoreSetError("CoreConnectKailleraServer: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    if (!do_handshake())
+    {
+        close_connection();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        s_State          = l_ClientState::LoggingIn;
+        s_Username       = username;
+        s_ConnectionType = std::clamp(connectionType, 1, 6);
+        s_RejectMessage.clear();
+    }
+
+    s_ThreadRunning = true;
+    s_Thread = std::thread(receive_thread);
+
+    MessageWriter writer;
+    writer.PutString(username);
+    writer.PutString(s_AppName.empty() ? "RMG-K" : s_AppName);
+    writer.PutU8(static_cast<uint8_t>(s_ConnectionType));
+    send_message(MessageType::UserInformation, writer);
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    s_Condition.wait_for(lock, std::chrono::milliseconds(KAILLERA_LOGIN_TIMEOUT_MS),
+                         [] { return s_State != l_ClientState::LoggingIn; });
+    l_ClientState state = s_State;
+    std::string rejectMessage = s_RejectMessage;
+    lock.unlock();
+
+    if (state != l_ClientState::Connected)
+    {
+        close_connection();
+        if (state == l_ClientState::Rejected)
+        {
+            CoreSetError("CoreConnectKailleraServer: connection rejected: " + rejectMessage);
+        }
+        else
+        {
+            CoreSetError("CoreConnectKailleraServer: login timed out");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+CORE_EXPORT bool CoreDisconnectKailleraServer(void)
+{
+    if (s_Socket == -1)
+    {
+        return true;
+    }
+
+    CoreEndKailleraGame();
+
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU16(0xFFFF);
+    writer.PutString("Leaving");
+    send_message(MessageType::UserQuit, writer);
+
+    close_connection();
+    return true;
+}
+
+CORE_EXPORT bool CoreIsKailleraServerConnected(void)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_State == l_ClientState::Connected;
+}
+
+CORE_EXPORT bool CoreGetKailleraGameList(std::vector<CoreKailleraGame>& games)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_State != l_ClientState::Connected)
+    {
+        CoreSetError("CoreGetKailleraGameList: not connected to a Kaillera server");
+        return false;
+    }
+
+    games = s_Games;
+    return true;
+}
+
+CORE_EXPORT bool CoreCreateKailleraGame(std::string gameName)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (s_State != l_ClientState::Connected || s_InGame)
+        {
+            CoreSetError("CoreCreateKailleraGame: not connected or already in a game");
+            return false;
+        }
+        s_GameOwner = true;
+    }
+
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutString(gameName);
+    writer.PutString("");
+    writer.PutU32(0xFFFFFFFF);
+    send_message(MessageType::CreateGame, writer);
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    if (!s_Condition.wait_for(lock, std::chrono::milliseconds(KAILLERA_CONNECT_TIMEOUT_MS), [] { return s_InGame; }))
+    {
+        s_GameOwner = false;
+        CoreSetError("CoreCreateKailleraGame: server did not create the game");
+        return false;
+    }
+
+    return true;
+}
+
+CORE_EXPORT bool CoreJoinKailleraGame(uint32_t gameId)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (s_State != l_ClientState::Connected || s_InGame)
+        {
+            CoreSetError("CoreJoinKailleraGame: not connected or already in a game");
+            return false;
+        }
+    }
+
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU32(gameId);
+    writer.PutString("");
+    writer.PutU32(0);
+    writer.PutU16(0xFFFF);
+    writer.PutU8(static_cast<uint8_t>(s_ConnectionType));
+    send_message(MessageType::JoinGame, writer);
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    if (!s_Condition.wait_for(lock, std::chrono::milliseconds(KAILLERA_CONNECT_TIMEOUT_MS), [] { return s_InGame; }))
+    {
+        CoreSetError("CoreJoinKailleraGame: server did not let us join the game");
+        return false;
+    }
+
+    return true;
+}
+
+CORE_EXPORT bool CoreStartKailleraGame(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (!s_InGame || !s_GameOwner)
+        {
+            CoreSetError("CoreStartKailleraGame: only the owner of a game can start it");
+            return false;
+        }
+    }
+
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU16(0xFFFF);
+    writer.PutU8(0xFF);
+    writer.PutU8(0xFF);
+    send_message(MessageType::StartGame, writer);
+    return true;
+}
+
+CORE_EXPORT int CoreSendKailleraPlayValues(void* values, int size)
+{
+    if (!s_Initialized || !s_GameActive || size <= 0)
+    {
+        return -1;
+    }
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+
+    if (!wait_for_players(lock))
+    {
+        return -1;
+    }
+
+    queue_local_input(values, size);
     return 0;
 }
 
+CORE_EXPORT int CoreReceiveKailleraPlayValues(void* values, int size, bool wait)
+{
+    if (!s_Initialized || !s_GameActive || size <= 0)
+    {
+        return -1;
+    }
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    return take_synced_input(lock, values, size, wait);
+}
+
 #endif // _WIN32
@@ -13,6 +13,8 @@
 #include "Library.hpp"
 
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <functional>
 
 namespace CoreKaillera
@@ -24,6 +26,17 @@ namespace CoreKaillera
     using MoreInfosCallback = std::function<void(std::string gameName)>;
 }
 
+// Game listed on a Kaillera server (native client only)
+struct CoreKailleraGame
+{
+    uint32_t    Id = 0;
+    std::string Name;
+    std::string Emulator;
+    std::string Owner;
+    std::string Users;
+    int         Status = 0; // 0 = waiting, 1 = playing, 2 = netsync
+};
+
 //
 // Exported Functions
 //
@@ -88,4 +101,48 @@ CORE_EXPORT int CoreGetKailleraNumPlayers(void);
 // Returns the number of frames to buffer inputs (0 if not in game)
 CORE_EXPORT int CoreGetKailleraFrameDelay(void);
 
+//
+// Native Client Functions
+//
+// The Windows build talks to kailleraclient.dll which brings its own
+// server dialog, other platforms use a native implementation of the
+// Kaillera v0.83 UDP protocol which is driven through these functions
+//
+
+// Connect to a Kaillera server and log in
+// connectionType: 1 (LAN) - 6 (Bad), amount of frames sent per packet
+// Returns true once the server has accepted the login
+CORE_EXPORT bool CoreConnectKailleraServer(std::string address, int port, std::string username, int connectionType);
+
+// Disconnect from the current Kaillera server
+CORE_EXPORT bool CoreDisconnectKailleraServer(void);
+
+// Check if connected to a Kaillera server
+CORE_EXPORT bool CoreIsKailleraServerConnected(void);
+
+// Retrieve the games listed on the current server
+CORE_EXPORT bool CoreGetKailleraGameList(std::vector<CoreKailleraGame>& games);
+
+// Create a game on the current server, the game start
+// callback is invoked once CoreStartKailleraGame() is called
+CORE_EXPORT bool CoreCreateKailleraGame(std::string gameName);
+
+// Join a game on the current server
+CORE_EXPORT bool CoreJoinKailleraGame(uint32_t gameId);
+
+// Start the created game (owner only)
+CORE_EXPORT bool CoreStartKailleraGame(void);
+
+// Send local input for the next frame without waiting
+// for the other players (used by rollback netplay)
+// Returns 0 on success, -1 on error
+CORE_EXPORT int CoreSendKailleraPlayValues(void* values, int size);
+
+// Receive the synchronized data of the oldest frame which
+// hasn't been received yet, in the order it was sent
+// wait: whether to block until the frame has arrived
+// Returns number of bytes received, 0 when the frame
+// hasn't arrived yet and wait is false, or -1 on error
+CORE_EXPORT int CoreReceiveKailleraPlayValues(void* values, int size, bool wait);
+
 #endif // CORE_KAILLERA_HPP
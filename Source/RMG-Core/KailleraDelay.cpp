@@ -0,0 +1,285 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "KailleraProtocol.hpp"
+#include "KailleraDelay.hpp"
+#include "Settings.hpp"
+#include "Library.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <mutex>
+#include <deque>
+
+//
+// Local Defines
+//
+
+// amount of frames used for the round trip
+// time distribution and the stall rate
+#define DELAY_WINDOW_FRAMES 600
+
+// frame delay the recommendation is clamped to
+#define DELAY_MAX_FRAMES 30
+
+// longest time the server acks are held back
+#define DELAY_MAX_ACK_HOLD_MS 250
+
+// frame time before it has been measured
+#define DELAY_DEFAULT_FRAME_TIME_MS (1000.0 / 60.0)
+
+//
+// Local Variables
+//
+
+static std::mutex l_DelayMutex;
+
+// time at which the local input of every
+// frame which hasn't arrived yet was queued
+static std::deque<std::chrono::steady_clock::time_point> l_QueuedFrames;
+
+// round trip times and stalls of the most recent frames
+static std::array<float, DELAY_WINDOW_FRAMES> l_RoundTripTimes;
+static size_t l_RoundTripTimesCount = 0;
+static size_t l_RoundTripTimesIndex = 0;
+static std::array<bool, DELAY_WINDOW_FRAMES> l_Stalls;
+static size_t l_StallsCount = 0;
+static size_t l_StallsIndex = 0;
+
+// smoothed estimates, as used for TCP retransmission timers
+static double l_RoundTripTime = 0.0;
+static double l_Jitter        = 0.0;
+static double l_FrameTime     = DELAY_DEFAULT_FRAME_TIME_MS;
+
+static std::chrono::steady_clock::time_point l_LastQueueTime;
+static bool   l_HasLastQueueTime = false;
+static double l_WaitedSinceQueue = 0.0;
+
+static int      l_FrameDelay  = 0;
+static uint32_t l_Frames      = 0;
+static uint32_t l_StallFrames = 0;
+
+//
+// Local Functions
+//
+
+static double get_target_stall_rate(void)
+{
+    int percent = CoreSettingsGetIntValue(SettingsID::Netplay_KailleraTargetStallRate);
+    return std::clamp(percent, 0, 100) / 100.0;
+}
+
+// returns the lowest frame delay for which the fraction of
+// recent frames which arrived later than the delay covers
+// is under the target rate, expects l_DelayMutex to be locked
+static int get_recommended_frame_delay(void)
+{
+    if (l_RoundTripTimesCount == 0)
+    {
+        return 0;
+    }
+
+    std::vector<float> roundTripTimes(l_RoundTripTimes.begin(), l_RoundTripTimes.begin() + l_RoundTripTimesCount);
+    double targetStallRate = get_target_stall_rate();
+
+    size_t index = static_cast<size_t>(std::ceil((1.0 - targetStallRate) * roundTripTimes.size()));
+    index = std::clamp(index, static_cast<size_t>(1), roundTripTimes.size()) - 1;
+    std::nth_element(roundTripTimes.begin(), roundTripTimes.begin() + index, roundTripTimes.end());
+
+    // the synced input of a frame is used frameDelay frames
+    // after its local input was queued, so a frame stalls
+    // when its round trip takes longer than that
+    int frameDelay = static_cast<int>(std::ceil(roundTripTimes[index] / l_FrameTime));
+    return std::clamp(frameDelay, 0, DELAY_MAX_FRAMES);
+}
+
+//
+// Internal Functions
+//
+
+void CoreKailleraDelayStartGame(int frameDelay)
+{
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+
+    l_QueuedFrames.clear();
+    l_StallsCount      = 0;
+    l_StallsIndex      = 0;
+    l_HasLastQueueTime = false;
+    l_WaitedSinceQueue = 0.0;
+    l_FrameDelay       = frameDelay;
+    l_Frames           = 0;
+    l_StallFrames      = 0;
+}
+
+void CoreKailleraDelayReset(void)
+{
+    CoreKailleraDelayStartGame(0);
+
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+    l_RoundTripTimesCount = 0;
+    l_RoundTripTimesIndex = 0;
+    l_RoundTripTime       = 0.0;
+    l_Jitter              = 0.0;
+    l_FrameTime           = DELAY_DEFAULT_FRAME_TIME_MS;
+}
+
+void CoreKailleraDelayFrameQueued(void)
+{
+    auto currentTime = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+
+    // the time between frames without the time spent waiting
+    // on input is the time the emulation needs for a frame
+    if (l_HasLastQueueTime)
+    {
+        double frameTime = std::chrono::duration<double, std::milli>(currentTime - l_LastQueueTime).count();
+        frameTime = std::clamp(frameTime - l_WaitedSinceQueue, 1.0, 100.0);
+        l_FrameTime += (frameTime - l_FrameTime) / 8.0;
+    }
+
+    l_LastQueueTime    = currentTime;
+    l_HasLastQueueTime = true;
+    l_WaitedSinceQueue = 0.0;
+
+    l_QueuedFrames.push_back(currentTime);
+}
+
+void CoreKailleraDelayFramesArrived(int frames)
+{
+    auto currentTime = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+
+    for (int i = 0; i < frames && !l_QueuedFrames.empty(); i++)
+    {
+        double roundTripTime = std::chrono::duration<double, std::milli>(currentTime - l_QueuedFrames.front()).count();
+        l_QueuedFrames.pop_front();
+
+        l_RoundTripTimes[l_RoundTripTimesIndex] = static_cast<float>(roundTripTime);
+        l_RoundTripTimesIndex = (l_RoundTripTimesIndex + 1) % DELAY_WINDOW_FRAMES;
+        l_RoundTripTimesCount = std::min(l_RoundTripTimesCount + 1, static_cast<size_t>(DELAY_WINDOW_FRAMES));
+
+        if (l_RoundTripTime == 0.0)
+        {
+            l_RoundTripTime = roundTripTime;
+            l_Jitter        = roundTripTime / 2.0;
+        }
+        else
+        {
+            l_Jitter        += (std::abs(l_RoundTripTime - roundTripTime) - l_Jitter) / 4.0;
+            l_RoundTripTime += (roundTripTime - l_RoundTripTime) / 8.0;
+        }
+    }
+}
+
+void CoreKailleraDelayFrameTaken(bool stalled, double waitedMs)
+{
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+
+    l_Stalls[l_StallsIndex] = stalled;
+    l_StallsIndex = (l_StallsIndex + 1) % DELAY_WINDOW_FRAMES;
+    l_StallsCount = std::min(l_StallsCount + 1, static_cast<size_t>(DELAY_WINDOW_FRAMES));
+
+    l_WaitedSinceQueue += waitedMs;
+    l_Frames++;
+    if (stalled)
+    {
+        l_StallFrames++;
+    }
+}
+
+uint32_t CoreGetKailleraDelayAckHoldTime(int connectionType)
+{
+    if (!CoreSettingsGetBoolValue(SettingsID::Netplay_KailleraAutoFrameDelay))
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+
+    if (l_RoundTripTimesCount == 0)
+    {
+        return 0;
+    }
+
+    int frameDelay = get_recommended_frame_delay();
+
+    // the fastest round trip is the closest
+    // we have to the ping the server measures
+    float pingMs = *std::min_element(l_RoundTripTimes.begin(), l_RoundTripTimes.begin() + l_RoundTripTimesCount);
+
+    // find the range of pings for which the server assigns the
+    // lowest frame delay which is at least the recommended one,
+    // and aim for the middle of it to be robust against jitter
+    uint32_t lowPing  = 0;
+    uint32_t highPing = 0;
+    bool     found    = false;
+    for (uint32_t ping = 0; ping <= static_cast<uint32_t>(pingMs) + DELAY_MAX_ACK_HOLD_MS; ping++)
+    {
+        int assignedFrameDelay = CoreKaillera::GetFrameDelay(ping, connectionType);
+        if (!found && assignedFrameDelay >= frameDelay)
+        {
+            found      = true;
+            lowPing    = ping;
+            frameDelay = assignedFrameDelay;
+        }
+        if (found)
+        {
+            if (assignedFrameDelay != frameDelay)
+            {
+                break;
+            }
+            highPing = ping;
+        }
+    }
+
+    if (!found)
+    {
+        return DELAY_MAX_ACK_HOLD_MS;
+    }
+
+    double holdTime = ((lowPing + highPing) / 2.0) - pingMs;
+    return static_cast<uint32_t>(std::clamp(holdTime, 0.0, static_cast<double>(DELAY_MAX_ACK_HOLD_MS)));
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreGetKailleraDelayStats(CoreKailleraDelayStats& stats)
+{
+    std::lock_guard<std::mutex> lock(l_DelayMutex);
+
+    if (l_RoundTripTimesCount == 0)
+    {
+        return false;
+    }
+
+    stats = CoreKailleraDelayStats();
+    stats.FrameDelay            = l_FrameDelay;
+    stats.RecommendedFrameDelay = get_recommended_frame_delay();
+    stats.RoundTripTime         = l_RoundTripTime;
+    stats.Jitter                = l_Jitter;
+    stats.FrameTime             = l_FrameTime;
+    stats.Frames                = l_Frames;
+    stats.StallFrames           = l_StallFrames;
+
+    if (l_StallsCount > 0)
+    {
+        size_t stalls = std::count(l_Stalls.begin(), l_Stalls.begin() + l_StallsCount, true);
+        stats.StallRate = static_cast<double>(stalls) / l_StallsCount;
+    }
+
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_KAILLERADELAY_HPP
+#define CORE_KAILLERADELAY_HPP
+
+#include <cstdint>
+
+//
+// Frame delay estimation for Kaillera games, the time between
+// queueing local input and receiving the synced input of that
+// frame is measured for every frame, the lowest frame delay
+// which keeps the amount of stalled frames under the target
+// rate is recommended, when automatic frame delay is enabled
+// the server is made to assign that delay on the next login
+//
+
+struct CoreKailleraDelayStats
+{
+    int      FrameDelay            = 0;   // frame delay of the current game
+    int      RecommendedFrameDelay = 0;   // lowest frame delay which keeps stalls under the target rate
+    double   RoundTripTime         = 0.0; // smoothed input round trip time in milliseconds
+    double   Jitter                = 0.0; // smoothed round trip time variation in milliseconds
+    double   FrameTime             = 0.0; // smoothed emulated frame time in milliseconds
+    double   StallRate             = 0.0; // fraction of recent frames which waited on input
+    uint32_t Frames                = 0;   // frames synced in the current game
+    uint32_t StallFrames           = 0;   // frames which waited on input in the current game
+};
+
+#ifdef CORE_INTERNAL
+// resets the statistics of the current game,
+// the round trip time estimate is kept
+void CoreKailleraDelayStartGame(int frameDelay);
+
+// clears every estimate, used when
+// disconnecting from the server
+void CoreKailleraDelayReset(void);
+
+// has to be called when local input of a frame is queued
+void CoreKailleraDelayFrameQueued(void);
+
+// has to be called when synced input of frames has arrived
+void CoreKailleraDelayFramesArrived(int frames);
+
+// has to be called when synced input is taken by the
+// emulation, stalled is whether it had to wait for it
+void CoreKailleraDelayFrameTaken(bool stalled, double waitedMs);
+
+// returns the amount of milliseconds to hold back the
+// acks which the server uses to measure our ping, so
+// that the assigned frame delay matches the recommended
+// frame delay, returns 0 when it's disabled
+uint32_t CoreGetKailleraDelayAckHoldTime(int connectionType);
+#endif // CORE_INTERNAL
+
+// retrieves frame delay statistics, returns
+// false when no frames have been measured yet
+bool CoreGetKailleraDelayStats(CoreKailleraDelayStats& stats);
+
+#endif // CORE_KAILLERADELAY_HPP
@@ -0,0 +1,285 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "KailleraProtocol.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace CoreKaillera;
+
+//
+// MessageWriter
+//
+
+void MessageWriter::PutU8(uint8_t value)
+{
+    this->data.push_back(value);
+}
+
+void MessageWriter::PutU16(uint16_t value)
+{
+    this->data.push_back(value & 0xFF);
+    this->data.push_back((value >> 8) & 0xFF);
+}
+
+void MessageWriter::PutU32(uint32_t value)
+{
+    this->PutU16(value & 0xFFFF);
+    this->PutU16((value >> 16) & 0xFFFF);
+}
+
+void MessageWriter::PutString(const std::string& value)
+{
+    this->data.insert(this->data.end(), value.begin(), value.end());
+    this->data.push_back('\0');
+}
+
+void MessageWriter::PutBytes(const uint8_t* data, size_t size)
+{
+    this->data.insert(this->data.end(), data, data + size);
+}
+
+//
+// MessageReader
+//
+
+uint8_t MessageReader::GetU8(void)
+{
+    if (this->offset + 1 > this->data.size())
+    {
+        this->valid = false;
+        return 0;
+    }
+
+    return this->data[this->offset++];
+}
+
+uint16_t MessageReader::GetU16(void)
+{
+    uint16_t low  = this->GetU8();
+    uint16_t high = this->GetU8();
+    return low | (high << 8);
+}
+
+uint32_t MessageReader::GetU32(void)
+{
+    uint32_t low  = this->GetU16();
+    uint32_t high = this->GetU16();
+    return low | (high << 16);
+}
+
+std::string MessageReader::GetString(void)
+{
+    std::string value;
+
+    while (this->offset < this->data.size() &&
+           this->data[this->offset] != '\0')
+    {
+        value += static_cast<char>(this->data[this->offset++]);
+    }
+
+    if (this->offset >= this->data.size())
+    { // missing null terminator
+        this->valid = false;
+        return value;
+    }
+
+    this->offset++;
+    return value;
+}
+
+std::vector<uint8_t> MessageReader::GetBytes(size_t size)
+{
+    if (this->offset + size > this->data.size())
+    {
+        this->valid = false;
+        return {};
+    }
+
+    std::vector<uint8_t> bytes(this->data.begin() + this->offset,
+                               this->data.begin() + this->offset + size);
+    this->offset += size;
+    return bytes;
+}
+
+//
+// MessageSender
+//
+
+std::vector<uint8_t> MessageSender::Build(MessageType type, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> packet;
+    Message message;
+
+    message.Sequence = this->sequence++;
+    message.Type     = type;
+    message.Data     = data;
+
+    this->history.push_front(message);
+    if (this->history.size() > KAILLERA_PACKET_REDUNDANCY)
+    {
+        this->history.pop_back();
+    }
+
+    // packet layout: [count] followed by count messages,
+    // newest first, each [sequence:2][length:2][type:1][data]
+    packet.push_back(static_cast<uint8_t>(this->history.size()));
+    for (const Message& entry : this->history)
+    {
+        uint16_t length = static_cast<uint16_t>(entry.Data.size() + 1);
+
+        // don't exceed the maximum packet size with old messages
+        if (packet.size() + 5 + entry.Data.size() > KAILLERA_MAX_PACKET_SIZE &&
+            entry.Sequence != message.Sequence)
+        {
+            packet[0]--;
+            continue;
+        }
+
+        packet.push_back(entry.Sequence & 0xFF);
+        packet.push_back((entry.Sequence >> 8) & 0xFF);
+        packet.push_back(length & 0xFF);
+        packet.push_back((length >> 8) & 0xFF);
+        packet.push_back(static_cast<uint8_t>(entry.Type));
+        packet.insert(packet.end(), entry.Data.begin(), entry.Data.end());
+    }
+
+    return packet;
+}
+
+void MessageSender::Reset(void)
+{
+    this->sequence = 0;
+    this->history.clear();
+}
+
+//
+// MessageReceiver
+//
+
+bool MessageReceiver::Parse(const uint8_t* packet, size_t size, std::vector<Message>& messages)
+{
+    std::vector<Message> parsedMessages;
+    size_t offset = 1;
+
+    if (size < 1)
+    {
+        return false;
+    }
+
+    uint8_t count = packet[0];
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (offset + 5 > size)
+        {
+            return false;
+        }
+
+        Message message;
+        message.Sequence = packet[offset] | (packet[offset + 1] << 8);
+        uint16_t length  = packet[offset + 2] | (packet[offset + 3] << 8);
+        if (length < 1 || offset + 4 + length > size)
+        {
+            return false;
+        }
+
+        message.Type = static_cast<MessageType>(packet[offset + 4]);
+        message.Data.assign(packet + offset + 5, packet + offset + 4 + length);
+        offset += 4 + length;
+
+        parsedMessages.push_back(message);
+    }
+
+    // messages are stored newest first
+    std::reverse(parsedMessages.begin(), parsedMessages.end());
+
+    for (Message& message : parsedMessages)
+    {
+        // sequence numbers wrap around, treat anything
+        // within half the range ahead of us as new
+        uint16_t distance = message.Sequence - this->lastSequence;
+        if (this->hasSequence && (distance == 0 || distance >= 0x8000))
+        {
+            continue;
+        }
+
+        this->hasSequence  = true;
+        this->lastSequence = message.Sequence;
+        messages.push_back(std::move(message));
+    }
+
+    return true;
+}
+
+void MessageReceiver::Reset(void)
+{
+    this->hasSequence  = false;
+    this->lastSequence = 0;
+}
+
+//
+// GameCache
+//
+
+int GameCache::Find(const std::vector<uint8_t>& data) const
+{
+    size_t entries = std::min(this->count, static_cast<size_t>(KAILLERA_CACHE_SIZE));
+
+    for (size_t i = 0; i < entries; i++)
+    {
+        if (this->entries[i] == data)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+void GameCache::Add(const std::vector<uint8_t>& data)
+{
+    this->entries[this->count % KAILLERA_CACHE_SIZE] = data;
+    this->count++;
+}
+
+bool GameCache::Get(uint8_t index, std::vector<uint8_t>& data) const
+{
+    if (index >= this->count)
+    {
+        return false;
+    }
+
+    data = this->entries[index];
+    return true;
+}
+
+void GameCache::Reset(void)
+{
+    for (auto& entry : this->entries)
+    {
+        entry.clear();
+    }
+    this->count = 0;
+}
+
+//
+// Internal Functions
+//
+
+int CoreKaillera::GetFrameDelay(uint32_t pingMs, int connectionType)
+{
+    connectionType = std::clamp(connectionType, 1, 6);
+
+    // amount of packets which are in flight during one round trip,
+    // every packet carries connectionType frames of input
+    int delay = static_cast<int>(std::ceil((pingMs / (1000.0 / 60.0)) / connectionType));
+    return ((delay + 1) * connectionType) - 1;
+}
@@ -0,0 +1,166 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_KAILLERAPROTOCOL_HPP
+#define CORE_KAILLERAPROTOCOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <deque>
+
+//
+// Kaillera v0.83 UDP protocol (as spoken by EmuLinker and n02),
+// shared between the native client and the loopback server
+//
+
+#define KAILLERA_PROTOCOL_VERSION   "0.83"
+#define KAILLERA_DEFAULT_PORT       27888
+#define KAILLERA_MAX_PACKET_SIZE    4096
+#define KAILLERA_PACKET_REDUNDANCY  3
+#define KAILLERA_CACHE_SIZE         256
+#define KAILLERA_ACK_COUNT          4
+
+namespace CoreKaillera
+{
+enum class MessageType : uint8_t
+{
+    UserQuit           = 0x01,
+    UserJoined         = 0x02,
+    UserInformation    = 0x03,
+    ServerStatus       = 0x04,
+    ServerAck          = 0x05,
+    ClientAck          = 0x06,
+    GlobalChat         = 0x07,
+    GameChat           = 0x08,
+    KeepAlive          = 0x09,
+    CreateGame         = 0x0A,
+    QuitGame           = 0x0B,
+    JoinGame           = 0x0C,
+    PlayerInformation  = 0x0D,
+    UpdateGameStatus   = 0x0E,
+    KickUser           = 0x0F,
+    CloseGame          = 0x10,
+    StartGame          = 0x11,
+    GameData           = 0x12,
+    GameCache          = 0x13,
+    DropGame           = 0x14,
+    ReadyToPlay        = 0x15,
+    ConnectionRejected = 0x16,
+    ServerInformation  = 0x17,
+};
+
+enum class GameStatus : uint8_t
+{
+    Waiting = 0,
+    Playing = 1,
+    NetSync = 2,
+};
+
+struct Message
+{
+    uint16_t Sequence = 0;
+    MessageType Type  = MessageType::KeepAlive;
+    std::vector<uint8_t> Data;
+};
+
+// little endian message payload writer
+class MessageWriter
+{
+public:
+    void PutU8(uint8_t value);
+    void PutU16(uint16_t value);
+    void PutU32(uint32_t value);
+    void PutString(const std::string& value);
+    void PutBytes(const uint8_t* data, size_t size);
+
+    const std::vector<uint8_t>& Data(void) const { return this->data; }
+
+private:
+    std::vector<uint8_t> data;
+};
+
+// little endian message payload reader,
+// reads past the end return 0/empty and
+// mark the reader as failed
+class MessageReader
+{
+public:
+    MessageReader(const std::vector<uint8_t>& data) : data(data) {}
+
+    uint8_t     GetU8(void);
+    uint16_t    GetU16(void);
+    uint32_t    GetU32(void);
+    std::string GetString(void);
+    std::vector<uint8_t> GetBytes(size_t size);
+
+    bool IsValid(void) const { return this->valid; }
+
+private:
+    const std::vector<uint8_t>& data;
+    size_t offset = 0;
+    bool valid = true;
+};
+
+// outgoing message stream, every packet carries the
+// latest KAILLERA_PACKET_REDUNDANCY messages so a
+// lost datagram is recovered by the next one
+class MessageSender
+{
+public:
+    // queues message and returns the packet to send
+    std::vector<uint8_t> Build(MessageType type, const std::vector<uint8_t>& data);
+
+    void Reset(void);
+
+private:
+    uint16_t sequence = 0;
+    std::deque<Message> history;
+};
+
+// incoming message stream, drops messages which
+// have already been handled and returns the new
+// ones in sequence order
+class MessageReceiver
+{
+public:
+    bool Parse(const uint8_t* packet, size_t size, std::vector<Message>& messages);
+
+    void Reset(void);
+
+private:
+    bool hasSequence = false;
+    uint16_t lastSequence = 0;
+};
+
+// game data cache, both ends keep one cache per
+// direction and add entries in the same order so
+// repeated input can be sent as a single index
+class GameCache
+{
+public:
+    // returns index of data or -1 when not cached
+    int  Find(const std::vector<uint8_t>& data) const;
+    void Add(const std::vector<uint8_t>& data);
+    bool Get(uint8_t index, std::vector<uint8_t>& data) const;
+
+    void Reset(void);
+
+private:
+    std::array<std::vector<uint8_t>, KAILLERA_CACHE_SIZE> entries;
+    size_t count = 0;
+};
+
+// returns the frame delay for the given ping and connection type,
+// this matches the calculation done by EmuLinker
+int GetFrameDelay(uint32_t pingMs, int connectionType);
+}
+
+#endif // CORE_KAILLERAPROTOCOL_HPP
@@ -0,0 +1,491 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "KailleraReplay.hpp"
+#include "SpeedLimiter.hpp"
+#include "RomHeader.hpp"
+#include "Settings.hpp"
+#include "Callback.hpp"
+#include "Library.hpp"
+#include "Error.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+//
+// Local Defines
+//
+
+#define REPLAY_FILE_MAGIC "RMGCoreKailleraReplay_1"
+
+#define REPLAY_MAX_PLAYERS 8
+
+// frame tag, the lower bits contain the amount of
+// players, when the repeat bit is set the inputs
+// are the same as the previous frame and aren't stored
+#define REPLAY_TAG_PLAYERS_MASK 0x0F
+#define REPLAY_TAG_REPEAT       0x80
+
+//
+// Local Structures
+//
+
+struct l_ReplayFrame
+{
+    uint32_t Offset     = 0; // offset in l_Inputs
+    uint8_t  NumPlayers = 0;
+};
+
+struct l_ReplaySetting
+{
+    SettingsID Id;
+    bool       IsBool;
+};
+
+//
+// Local Variables
+//
+
+// settings which apply_kaillera_deterministic_settings forces,
+// the order is part of the file format, so only append to it
+static const l_ReplaySetting l_ReplaySettings[] =
+{
+    { SettingsID::Core_RandomizeInterrupt,     true  },
+    { SettingsID::Core_CPU_Emulator,           false },
+    { SettingsID::Core_CountPerOp,             false },
+    { SettingsID::Core_CountPerOpDenomPot,     false },
+    { SettingsID::Core_SiDmaDuration,          false },
+    { SettingsID::Core_DisableExtraMem,        true  },
+    { SettingsID::Core_DisableSaveFileLoading, true  },
+};
+
+static bool l_Recording = false;
+static std::atomic<bool> l_Playing = false;
+static std::filesystem::path l_RecordingPath;
+
+static uint32_t l_CRC1 = 0;
+static uint32_t l_CRC2 = 0;
+static std::vector<int32_t> l_SettingValues;
+
+// frames of the replay, the inputs
+// of every frame are stored in l_Inputs
+static std::vector<l_ReplayFrame> l_Frames;
+static std::vector<uint32_t> l_Inputs;
+static uint32_t l_Frame = 0;
+
+static bool l_PlaybackStarted     = false;
+static bool l_SpeedLimiterEnabled = true;
+static std::chrono::steady_clock::time_point l_PlaybackStartTime;
+
+static std::mutex l_StatsMutex;
+static CoreKailleraReplayStats l_Stats;
+
+//
+// Local Functions
+//
+
+static void clear_replay(void)
+{
+    l_Frames.clear();
+    l_Frames.shrink_to_fit();
+    l_Inputs.clear();
+    l_Inputs.shrink_to_fit();
+    l_SettingValues.clear();
+    l_Frame = 0;
+}
+
+static bool write_replay(std::filesystem::path file)
+{
+    std::ofstream outputStream;
+    uint32_t settingsCount = static_cast<uint32_t>(l_SettingValues.size());
+    uint32_t framesCount   = static_cast<uint32_t>(l_Frames.size());
+    const l_ReplayFrame* previousFrame = nullptr;
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(file.parent_path(), errorCode);
+
+    outputStream.open(file, std::ios::binary | std::ios::trunc);
+    if (!outputStream.is_open())
+    {
+        CoreSetError("CoreStopKailleraReplayRecording: failed to open " + file.string());
+        return false;
+    }
+
+#define FWRITE(x) outputStream.write((char*)&x, sizeof(x))
+    outputStream.write((char*)REPLAY_FILE_MAGIC, sizeof(REPLAY_FILE_MAGIC));
+    FWRITE(l_CRC1);
+    FWRITE(l_CRC2);
+    FWRITE(settingsCount);
+    for (int32_t value : l_SettingValues)
+    {
+        FWRITE(value);
+    }
+
+    FWRITE(framesCount);
+    for (const l_ReplayFrame& frame : l_Frames)
+    {
+        uint8_t tag = frame.NumPlayers;
+
+        // most frames have the same input as the frame before them
+        if (previousFrame != nullptr && frame.NumPlayers > 0 &&
+            previousFrame->NumPlayers == frame.NumPlayers &&
+            std::memcmp(l_Inputs.data() + previousFrame->Offset, l_Inputs.data() + frame.Offset,
+                        sizeof(uint32_t) * frame.NumPlayers) == 0)
+        {
+            tag |= REPLAY_TAG_REPEAT;
+        }
+
+        FWRITE(tag);
+        if (!(tag & REPLAY_TAG_REPEAT))
+        {
+            outputStream.write((char*)(l_Inputs.data() + frame.Offset), sizeof(uint32_t) * frame.NumPlayers);
+        }
+
+        if (frame.NumPlayers > 0)
+        {
+            previousFrame = &frame;
+        }
+    }
+#undef FWRITE
+
+    if (!outputStream)
+    {
+        CoreSetError("CoreStopKailleraReplayRecording: failed to write " + file.string());
+        return false;
+    }
+
+    return true;
+}
+
+static bool read_replay(std::filesystem::path file)
+{
+    std::ifstream inputStream;
+    char magicBuf[sizeof(REPLAY_FILE_MAGIC)];
+    uint32_t settingsCount = 0;
+    uint32_t framesCount   = 0;
+    int previousFrame = -1;
+    int32_t value;
+    uint8_t tag;
+
+    inputStream.open(file, std::ios::binary);
+    if (!inputStream.is_open())
+    {
+        CoreSetError("CoreLoadKailleraReplay: failed to open " + file.string());
+        return false;
+    }
+
+#define FREAD(x) inputStream.read((char*)&x, sizeof(x))
+    inputStream.read(magicBuf, sizeof(magicBuf));
+    if (!inputStream || std::memcmp(magicBuf, REPLAY_FILE_MAGIC, sizeof(magicBuf)) != 0)
+    {
+        CoreSetError("CoreLoadKailleraReplay: " + file.string() + " isn't a Kaillera replay");
+        return false;
+    }
+
+    FREAD(l_CRC1);
+    FREAD(l_CRC2);
+    FREAD(settingsCount);
+    if (!inputStream || settingsCount > std::size(l_ReplaySettings))
+    {
+        CoreSetError("CoreLoadKailleraReplay: " + file.string() + " is corrupt");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < settingsCount; i++)
+    {
+        FREAD(value);
+        l_SettingValues.push_back(value);
+    }
+
+    FREAD(framesCount);
+    for (uint32_t i = 0; i < framesCount && FREAD(tag); i++)
+    {
+        l_ReplayFrame frame;
+        frame.NumPlayers = tag & REPLAY_TAG_PLAYERS_MASK;
+
+        if (frame.NumPlayers > REPLAY_MAX_PLAYERS ||
+            ((tag & REPLAY_TAG_REPEAT) && (previousFrame == -1 || l_Frames[previousFrame].NumPlayers != frame.NumPlayers)))
+        {
+            break;
+        }
+
+        if (tag & REPLAY_TAG_REPEAT)
+        {
+            frame.Offset = l_Frames[previousFrame].Offset;
+        }
+        else
+        {
+            frame.Offset = static_cast<uint32_t>(l_Inputs.size());
+            l_Inputs.resize(l_Inputs.size() + frame.NumPlayers);
+            inputStream.read((char*)(l_Inputs.data() + frame.Offset), sizeof(uint32_t) * frame.NumPlayers);
+        }
+
+        if (frame.NumPlayers > 0)
+        {
+            previousFrame = static_cast<int>(l_Frames.size());
+        }
+        l_Frames.push_back(frame);
+    }
+#undef FREAD
+
+    if (!inputStream || l_Frames.size() != framesCount)
+    {
+        CoreSetError("CoreLoadKailleraReplay: " + file.string() + " is corrupt");
+        return false;
+    }
+
+    return true;
+}
+
+//
+// Internal Functions
+//
+
+bool CoreStartKailleraReplayRecording(std::filesystem::path file)
+{
+    CoreRomHeader header;
+
+    if (l_Recording)
+    {
+        CoreStopKailleraReplayRecording();
+    }
+
+    if (l_Playing)
+    {
+        CoreSetError("CoreStartKailleraReplayRecording: a replay is being played");
+        return false;
+    }
+
+    if (!CoreGetCurrentRomHeader(header))
+    {
+        return false;
+    }
+
+    clear_replay();
+
+    for (const l_ReplaySetting& setting : l_ReplaySettings)
+    {
+        l_SettingValues.push_back(setting.IsBool ?
+            CoreSettingsGetBoolValue(setting.Id) :
+            CoreSettingsGetIntValue(setting.Id));
+    }
+
+    l_CRC1          = header.CRC1;
+    l_CRC2          = header.CRC2;
+    l_RecordingPath = file;
+    l_Recording     = true;
+    return true;
+}
+
+void CoreStopKailleraReplayRecording(void)
+{
+    if (!l_Recording)
+    {
+        return;
+    }
+
+    l_Recording = false;
+
+    if (!write_replay(l_RecordingPath))
+    {
+        CoreAddCallbackMessage(CoreDebugMessageType::Warning, CoreGetError());
+    }
+
+    clear_replay();
+}
+
+void CoreKailleraReplayRecordInput(const uint32_t* inputs, int numPlayers)
+{
+    l_ReplayFrame frame;
+
+    if (!l_Recording)
+    {
+        return;
+    }
+
+    numPlayers = std::clamp(numPlayers, 0, REPLAY_MAX_PLAYERS);
+
+    // frames which are simulated again after
+    // a rollback replace the frames after them
+    if (l_Frame < l_Frames.size())
+    {
+        l_Inputs.resize(l_Frames[l_Frame].Offset);
+        l_Frames.resize(l_Frame);
+    }
+
+    frame.Offset     = static_cast<uint32_t>(l_Inputs.size());
+    frame.NumPlayers = static_cast<uint8_t>(numPlayers);
+    l_Inputs.insert(l_Inputs.end(), inputs, inputs + numPlayers);
+    l_Frames.push_back(frame);
+    l_Frame++;
+}
+
+void CoreSetKailleraReplayFrame(uint32_t frame)
+{
+    l_Frame = std::min(frame, static_cast<uint32_t>(l_Frames.size()));
+}
+
+bool CoreIsKailleraReplayPlaying(void)
+{
+    return l_Playing;
+}
+
+bool CoreStartKailleraReplayPlayback(void)
+{
+    CoreRomHeader header;
+
+    if (!l_Playing)
+    {
+        return false;
+    }
+
+    if (!CoreGetCurrentRomHeader(header))
+    {
+        CoreStopKailleraReplayPlayback();
+        return false;
+    }
+
+    if (header.CRC1 != l_CRC1 || header.CRC2 != l_CRC2)
+    {
+        CoreSetError("CoreStartKailleraReplayPlayback: replay was recorded with a different ROM");
+        CoreStopKailleraReplayPlayback();
+        return false;
+    }
+
+    for (size_t i = 0; i < l_SettingValues.size(); i++)
+    {
+        const l_ReplaySetting& setting = l_ReplaySettings[i];
+        if (setting.IsBool)
+        {
+            CoreSettingsSetValue(setting.Id, l_SettingValues[i] != 0);
+        }
+        else
+        {
+            CoreSettingsSetValue(setting.Id, static_cast<int>(l_SettingValues[i]));
+        }
+    }
+
+    l_Frame           = 0;
+    l_PlaybackStarted = false;
+
+    std::lock_guard<std::mutex> lock(l_StatsMutex);
+    l_Stats = CoreKailleraReplayStats();
+    l_Stats.TotalFrames = static_cast<uint32_t>(l_Frames.size());
+    return true;
+}
+
+void CoreStopKailleraReplayPlayback(void)
+{
+    if (!l_Playing)
+    {
+        return;
+    }
+
+    if (l_PlaybackStarted && l_SpeedLimiterEnabled)
+    {
+        CoreSetSpeedLimiterState(true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(l_StatsMutex);
+        if (l_Stats.Frames > 0)
+        {
+            CoreAddCallbackMessage(CoreDebugMessageType::Info,
+                "CoreStopKailleraReplayPlayback: played " + std::to_string(l_Stats.Frames) + "/" +
+                std::to_string(l_Stats.TotalFrames) + " frames in " + std::to_string(l_Stats.Seconds) + " seconds (" +
+                std::to_string(l_Stats.Seconds > 0.0 ? l_Stats.Frames / l_Stats.Seconds : 0.0) + " frames per second)");
+        }
+    }
+
+    l_Playing = false;
+    clear_replay();
+}
+
+bool CoreKailleraReplayPlayInput(uint32_t* inputs, int& numPlayers)
+{
+    if (!l_Playing)
+    {
+        return false;
+    }
+
+    auto currentTime = std::chrono::steady_clock::now();
+
+    // the replay runs as fast as possible,
+    // the speed limiter is restored once it stops
+    if (!l_PlaybackStarted)
+    {
+        l_PlaybackStarted     = true;
+        l_SpeedLimiterEnabled = CoreIsSpeedLimiterEnabled();
+        if (l_SpeedLimiterEnabled)
+        {
+            CoreSetSpeedLimiterState(false);
+        }
+        l_PlaybackStartTime = currentTime;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(l_StatsMutex);
+        l_Stats.Frames  = l_Frame;
+        l_Stats.Seconds = std::chrono::duration<double>(currentTime - l_PlaybackStartTime).count();
+    }
+
+    if (l_Frame >= l_Frames.size())
+    {
+        return false;
+    }
+
+    const l_ReplayFrame& frame = l_Frames[l_Frame++];
+    numPlayers = frame.NumPlayers;
+    std::copy_n(l_Inputs.data() + frame.Offset, frame.NumPlayers, inputs);
+    return true;
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreLoadKailleraReplay(std::filesystem::path file)
+{
+    if (l_Recording)
+    {
+        CoreSetError("CoreLoadKailleraReplay: a replay is being recorded");
+        return false;
+    }
+
+    l_Playing = false;
+    clear_replay();
+
+    if (!read_replay(file))
+    {
+        clear_replay();
+        return false;
+    }
+
+    l_Playing = true;
+    return true;
+}
+
+CORE_EXPORT bool CoreGetKailleraReplayStats(CoreKailleraReplayStats& stats)
+{
+    if (!l_Playing)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(l_StatsMutex);
+    stats = l_Stats;
+    return true;
+}
@@ -0,0 +1,70 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_KAILLERAREPLAY_HPP
+#define CORE_KAILLERAREPLAY_HPP
+
+#include <filesystem>
+#include <cstdint>
+
+//
+// Kaillera replays contain the synced input of every frame and
+// the deterministic settings which were forced for the game,
+// playing a replay feeds the input back into the emulation
+// without speed limiter, which makes it a reproducible desync
+// report and a repeatable emulation benchmark
+//
+
+struct CoreKailleraReplayStats
+{
+    uint32_t Frames      = 0;   // frames which have been played
+    uint32_t TotalFrames = 0;   // frames in the replay
+    double   Seconds     = 0.0; // time spent playing
+};
+
+#ifdef CORE_INTERNAL
+// starts recording the synced input of the current game,
+// the replay is written to file once recording stops
+bool CoreStartKailleraReplayRecording(std::filesystem::path file);
+
+// stops recording and writes the replay
+void CoreStopKailleraReplayRecording(void);
+
+// records the synced input of the next frame, numPlayers
+// is 0 for frames which are in the initial frame delay
+void CoreKailleraReplayRecordInput(const uint32_t* inputs, int numPlayers);
+
+// sets the frame which is recorded next, used when
+// a snapshot of an earlier frame is restored
+void CoreSetKailleraReplayFrame(uint32_t frame);
+
+// returns whether a replay has been loaded for
+// the next emulation start or is being played
+bool CoreIsKailleraReplayPlaying(void);
+
+// verifies that the replay belongs to the opened ROM
+// and applies the settings which were recorded
+bool CoreStartKailleraReplayPlayback(void);
+
+// stops playback and unloads the replay
+void CoreStopKailleraReplayPlayback(void);
+
+// retrieves the input of the next frame, numPlayers is set
+// to 0 for frames which are in the initial frame delay,
+// returns false once every frame has been played
+bool CoreKailleraReplayPlayInput(uint32_t* inputs, int& numPlayers);
+#endif // CORE_INTERNAL
+
+// loads a replay, the next emulation start plays it
+bool CoreLoadKailleraReplay(std::filesystem::path file);
+
+// retrieves playback statistics of the current replay
+bool CoreGetKailleraReplayStats(CoreKailleraReplayStats& stats);
+
+#endif // CORE_KAILLERAREPLAY_HPP
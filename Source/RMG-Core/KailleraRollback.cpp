@@ -0,0 +1,390 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "KailleraRollback.hpp"
+#include "KailleraReplay.hpp"
+#include "SpeedLimiter.hpp"
+#include "StateHash.hpp"
+#include "Kaillera.hpp"
+#include "Callback.hpp"
+#include "Library.hpp"
+#include "Error.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+//
+// Local Defines
+//
+
+#define ROLLBACK_MAX_PLAYERS 8
+#define ROLLBACK_MAX_FRAMES  30
+
+//
+// Local Structures
+//
+
+struct l_FrameInput
+{
+    uint32_t Inputs[ROLLBACK_MAX_PLAYERS] = {0};
+    uint32_t LocalInput = 0;
+    bool     Confirmed  = false;
+};
+
+typedef void (*rollback_load_callback_t)(unsigned int frame);
+typedef int  (*rollback_init_t)(unsigned int count, rollback_load_callback_t callback);
+typedef void (*rollback_deinit_t)(void);
+typedef void (*rollback_request_save_t)(unsigned int frame);
+typedef int  (*rollback_request_load_t)(unsigned int frame);
+
+//
+// Local Variables
+//
+
+static std::atomic<bool> l_Active = false;
+static int  l_MaxFrames = 0;
+static int  l_NumPlayers = 0;
+static int  l_PlayerIndex = 0;
+
+// frames are counted in synced input reads,
+// l_Frame is the frame which reads input next
+static uint32_t l_Frame          = 0;
+static uint32_t l_SentFrames     = 0;
+static uint32_t l_ConfirmedFrames = 0;
+
+// input history, indexed by frame modulo its size,
+// it holds every frame which hasn't been confirmed yet
+static std::vector<l_FrameInput> l_History;
+static uint32_t l_LastConfirmedInputs[ROLLBACK_MAX_PLAYERS] = {0};
+
+// state hash frame of every snapshot, indexed like
+// the input history, so restored frames are hashed
+// with the same frame number again
+static std::vector<uint32_t> l_HashFrames;
+
+static std::atomic<bool> l_Restored = false;
+static bool l_SpeedLimiterDisabled = false;
+static bool l_SpeedLimiterEnabled  = true;
+
+static std::mutex l_StatsMutex;
+static CoreKailleraRollbackStats l_Stats;
+
+static rollback_init_t         l_rollback_init         = nullptr;
+static rollback_deinit_t       l_rollback_deinit       = nullptr;
+static rollback_request_save_t l_rollback_request_save = nullptr;
+static rollback_request_load_t l_rollback_request_load = nullptr;
+
+//
+// Local Functions
+//
+
+static l_FrameInput& get_frame_input(uint32_t frame)
+{
+    return l_History[frame % l_History.size()];
+}
+
+static bool hook_core_functions(void)
+{
+    CoreLibraryHandle handle = (CoreLibraryHandle)m64p::Core.GetHandle();
+    if (handle == nullptr)
+    {
+        return false;
+    }
+
+    l_rollback_init         = (rollback_init_t)CoreGetLibrarySymbol(handle, "rollback_init");
+    l_rollback_deinit       = (rollback_deinit_t)CoreGetLibrarySymbol(handle, "rollback_deinit");
+    l_rollback_request_save = (rollback_request_save_t)CoreGetLibrarySymbol(handle, "rollback_request_save");
+    l_rollback_request_load = (rollback_request_load_t)CoreGetLibrarySymbol(handle, "rollback_request_load");
+
+    return l_rollback_init != nullptr && l_rollback_deinit != nullptr &&
+           l_rollback_request_save != nullptr && l_rollback_request_load != nullptr;
+}
+
+// simulating frames again shouldn't be limited
+// to the normal speed, so turn off the speed
+// limiter until we've caught up
+static void set_resimulating(bool resimulating)
+{
+    if (resimulating == l_SpeedLimiterDisabled)
+    {
+        return;
+    }
+
+    if (resimulating)
+    {
+        l_SpeedLimiterEnabled = CoreIsSpeedLimiterEnabled();
+        if (l_SpeedLimiterEnabled)
+        {
+            CoreSetSpeedLimiterState(false);
+        }
+    }
+    else if (l_SpeedLimiterEnabled)
+    {
+        CoreSetSpeedLimiterState(true);
+    }
+
+    l_SpeedLimiterDisabled = resimulating;
+}
+
+// called on the emulation thread by the core
+// once a snapshot has been restored
+static void snapshot_restored_callback(unsigned int frame)
+{
+    l_Frame    = frame;
+    l_Restored = true;
+    CoreSetStateHashFrame(l_HashFrames[frame % l_HashFrames.size()]);
+    CoreSetKailleraReplayFrame(frame);
+    set_resimulating(l_Frame < l_SentFrames);
+}
+
+// stores confirmed input of frame, returns whether
+// it differs from the input which was used for it
+static bool confirm_frame(uint32_t frame, const uint32_t* inputs, int numPlayers)
+{
+    l_FrameInput& frameInput = get_frame_input(frame);
+    bool mismatch = false;
+
+    // frames which haven't been simulated
+    // yet will use the confirmed input
+    if (frame < l_Frame)
+    {
+        mismatch = std::memcmp(frameInput.Inputs, inputs, sizeof(uint32_t) * numPlayers) != 0;
+    }
+
+    std::memcpy(frameInput.Inputs, inputs, sizeof(uint32_t) * numPlayers);
+    std::memcpy(l_LastConfirmedInputs, inputs, sizeof(uint32_t) * numPlayers);
+    frameInput.Confirmed = true;
+    l_NumPlayers = numPlayers;
+    return mismatch;
+}
+
+//
+// Internal Functions
+//
+
+bool CoreStartKailleraRollback(int maxFrames)
+{
+    int playerNumber = CoreGetKailleraPlayerNumber();
+    int numPlayers   = CoreGetKailleraNumPlayers();
+
+    if (l_Active)
+    {
+        CoreStopKailleraRollback();
+    }
+
+    if (playerNumber < 1 || playerNumber > ROLLBACK_MAX_PLAYERS ||
+        numPlayers < 1 || numPlayers > ROLLBACK_MAX_PLAYERS)
+    {
+        CoreSetError("CoreStartKailleraRollback: invalid player number");
+        return false;
+    }
+
+    if (!hook_core_functions())
+    {
+        CoreSetError("CoreStartKailleraRollback: core doesn't support rollback snapshots");
+        return false;
+    }
+
+    l_MaxFrames = std::clamp(maxFrames, 1, ROLLBACK_MAX_FRAMES);
+
+    // we need a snapshot for every frame which can be
+    // predicted and one for the frame which is in progress
+    if (!l_rollback_init(static_cast<unsigned int>(l_MaxFrames + 2), snapshot_restored_callback))
+    {
+        CoreSetError("CoreStartKailleraRollback: failed to allocate snapshots");
+        return false;
+    }
+
+    l_History.assign(l_MaxFrames + 2, l_FrameInput());
+    l_HashFrames.assign(l_MaxFrames + 2, 0);
+    std::fill(std::begin(l_LastConfirmedInputs), std::end(l_LastConfirmedInputs), 0);
+
+    l_PlayerIndex          = playerNumber - 1;
+    l_NumPlayers           = numPlayers;
+    l_Frame                = 0;
+    l_SentFrames           = 0;
+    l_ConfirmedFrames      = 0;
+    l_Restored             = false;
+    l_SpeedLimiterDisabled = false;
+    l_Active               = true;
+
+    std::lock_guard<std::mutex> lock(l_StatsMutex);
+    l_Stats = CoreKailleraRollbackStats();
+    return true;
+}
+
+void CoreStopKailleraRollback(void)
+{
+    if (!l_Active)
+    {
+        return;
+    }
+
+    set_resimulating(false);
+    l_rollback_deinit();
+    l_History.clear();
+    l_HashFrames.clear();
+    l_Active = false;
+}
+
+bool CoreIsKailleraRollbackActive(void)
+{
+    return l_Active;
+}
+
+void CoreKailleraRollbackFrame(void)
+{
+    if (!l_Active)
+    {
+        return;
+    }
+
+    // frames without an input read take a snapshot
+    // with the same number, which is fine because
+    // they don't depend on the input of that frame
+    l_HashFrames[l_Frame % l_HashFrames.size()] = CoreGetStateHashFrame();
+    l_rollback_request_save(l_Frame);
+}
+
+bool CoreKailleraRollbackSyncInput(uint32_t localInput, uint32_t* inputs, int& numPlayers)
+{
+    uint32_t confirmedInputs[ROLLBACK_MAX_PLAYERS] = {0};
+    uint32_t frame = l_Frame;
+    bool rollback = false;
+    uint32_t rollbackFrame = 0;
+    bool stalled = false;
+    int ret;
+
+    if (!l_Active)
+    {
+        return false;
+    }
+
+    // send local input of new frames, frames which are
+    // simulated again use the input which was sent before
+    if (frame >= l_SentFrames)
+    {
+        set_resimulating(false);
+
+        l_FrameInput& frameInput = get_frame_input(frame);
+        frameInput = l_FrameInput();
+        frameInput.LocalInput = localInput;
+
+        if (CoreSendKailleraPlayValues(&localInput, sizeof(uint32_t)) < 0)
+        {
+            return false;
+        }
+
+        l_SentFrames = frame + 1;
+    }
+
+    // retrieve every confirmed frame which has arrived,
+    // wait when we've predicted too far ahead
+    while (l_ConfirmedFrames < l_SentFrames)
+    {
+        bool wait = (l_SentFrames - l_ConfirmedFrames) > static_cast<uint32_t>(l_MaxFrames);
+
+        ret = CoreReceiveKailleraPlayValues(confirmedInputs, sizeof(uint32_t), wait);
+        if (ret < 0)
+        {
+            return false;
+        }
+        else if (ret == 0)
+        {
+            break;
+        }
+
+        stalled |= wait;
+
+        int confirmedPlayers = std::min(ret / static_cast<int>(sizeof(uint32_t)), ROLLBACK_MAX_PLAYERS);
+        if (confirm_frame(l_ConfirmedFrames, confirmedInputs, confirmedPlayers) && !rollback)
+        {
+            rollback      = true;
+            rollbackFrame = l_ConfirmedFrames;
+        }
+
+        l_ConfirmedFrames++;
+    }
+
+    // use confirmed input when we have it, else predict
+    // that the other players hold the same input as the
+    // last confirmed frame
+    l_FrameInput& frameInput = get_frame_input(frame);
+    bool predicted = !frameInput.Confirmed;
+    if (predicted)
+    {
+        std::memcpy(frameInput.Inputs, l_LastConfirmedInputs, sizeof(l_LastConfirmedInputs));
+        frameInput.Inputs[l_PlayerIndex] = frameInput.LocalInput;
+    }
+
+    numPlayers = l_NumPlayers;
+    std::memcpy(inputs, frameInput.Inputs, sizeof(uint32_t) * numPlayers);
+    l_Frame = frame + 1;
+
+    // restore the snapshot of the first frame
+    // which used the wrong input, the current
+    // frame continues until the next interrupt
+    if (rollback)
+    {
+        if (!l_rollback_request_load(rollbackFrame))
+        {
+            CoreAddCallbackMessage(CoreDebugMessageType::Error,
+                "CoreKailleraRollbackSyncInput: no snapshot of frame " + std::to_string(rollbackFrame) + ", emulation will desync");
+            rollback = false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(l_StatsMutex);
+    l_Stats.Frames++;
+    if (predicted)
+    {
+        l_Stats.PredictedFrames++;
+    }
+    if (stalled)
+    {
+        l_Stats.Stalls++;
+    }
+    if (rollback)
+    {
+        uint32_t rollbackFrames = l_Frame - rollbackFrame;
+        l_Stats.Rollbacks++;
+        l_Stats.RollbackFrames += rollbackFrames;
+        l_Stats.MaxRollback = std::max(l_Stats.MaxRollback, rollbackFrames);
+    }
+
+    return true;
+}
+
+bool CoreKailleraRollbackHasRestored(void)
+{
+    return l_Restored.exchange(false);
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreGetKailleraRollbackStats(CoreKailleraRollbackStats& stats)
+{
+    if (!l_Active)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(l_StatsMutex);
+    stats = l_Stats;
+    return true;
+}
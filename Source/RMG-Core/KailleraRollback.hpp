@@ -0,0 +1,62 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_KAILLERAROLLBACK_HPP
+#define CORE_KAILLERAROLLBACK_HPP
+
+#include <cstdint>
+
+//
+// Rollback netplay on top of the Kaillera lockstep protocol,
+// local input is applied right away and the input of the other
+// players is predicted, once the server confirms a frame which
+// was predicted wrong the emulation state is restored from an
+// in-memory snapshot and the frames are simulated again
+//
+
+struct CoreKailleraRollbackStats
+{
+    uint32_t Frames          = 0; // frames synced
+    uint32_t PredictedFrames = 0; // frames which used predicted input
+    uint32_t Rollbacks       = 0; // amount of rollbacks
+    uint32_t RollbackFrames  = 0; // frames which were simulated again
+    uint32_t MaxRollback     = 0; // longest rollback in frames
+    uint32_t Stalls          = 0; // frames which waited on the other players
+};
+
+#ifdef CORE_INTERNAL
+// attempts to start rollback for the current Kaillera game,
+// maxFrames is the amount of frames which can be predicted
+// before the emulation waits for the other players
+bool CoreStartKailleraRollback(int maxFrames);
+
+// stops rollback and frees the snapshots
+void CoreStopKailleraRollback(void);
+
+// returns whether rollback is active
+bool CoreIsKailleraRollbackActive(void);
+
+// requests a snapshot, has to be called
+// at the start of every emulated frame
+void CoreKailleraRollbackFrame(void);
+
+// retrieves the inputs for the next frame, localInput is
+// the input of the local controller, numPlayers is set to
+// the amount of inputs, returns false when the game ended
+bool CoreKailleraRollbackSyncInput(uint32_t localInput, uint32_t* inputs, int& numPlayers);
+
+// returns whether a snapshot has been restored since the
+// last call, which means the next input read starts a new frame
+bool CoreKailleraRollbackHasRestored(void);
+#endif // CORE_INTERNAL
+
+// retrieves rollback statistics of the current game
+bool CoreGetKailleraRollbackStats(CoreKailleraRollbackStats& stats);
+
+#endif // CORE_KAILLERAROLLBACK_HPP
@@ -0,0 +1,908 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "KailleraProtocol.hpp"
+#include "KailleraServer.hpp"
+#include "Library.hpp"
+#include "Error.hpp"
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <map>
+
+using namespace CoreKaillera;
+
+//
+// Local Defines
+//
+
+#define SERVER_MAX_PLAYERS 8
+#define SERVER_POLL_MS     100
+
+//
+// Local Structures
+//
+
+struct l_ServerUser
+{
+    sockaddr_in address;
+    uint16_t    id = 0;
+    std::string name;
+    std::string emulator;
+    int         connectionType = 1;
+    bool        bot = false;
+
+    // login state
+    bool     loggedIn = false;
+    int      acks = 0;
+    uint32_t ping = 0;
+    std::chrono::steady_clock::time_point ackTime;
+
+    MessageSender   sender;
+    MessageReceiver receiver;
+    GameCache       inCache;
+    GameCache       outCache;
+
+    // game state
+    uint32_t gameId  = 0;
+    int      player  = 0;
+    bool     ready   = false;
+    bool     dropped = false;
+    uint64_t sentFrames = 0;
+    std::deque<std::vector<uint8_t>> frames;
+};
+
+struct l_ServerGame
+{
+    uint32_t    id = 0;
+    std::string name;
+    std::string emulator;
+    uint16_t    ownerId = 0;
+    GameStatus  status = GameStatus::Waiting;
+    std::vector<uint16_t> players;
+
+    // combined input of all players, combinedBase
+    // is the frame number of the first entry
+    size_t   frameSize = 0;
+    uint64_t combinedBase = 0;
+    std::deque<std::vector<uint8_t>> combined;
+};
+
+//
+// Local Variables
+//
+
+static std::thread       l_ServerThread;
+static std::atomic<bool> l_ServerRunning = false;
+static int               l_ServerSocket = -1;
+static int               l_ServerPort = 0;
+static int               l_ServerBots = 0;
+static uint16_t          l_NextUserId = 1;
+static uint32_t          l_NextGameId = 1;
+
+static std::map<uint16_t, std::unique_ptr<l_ServerUser>> l_Users;
+static std::map<uint32_t, l_ServerGame> l_Games;
+
+//
+// Internal Functions
+//
+
+static bool is_same_address(const sockaddr_in& a, const sockaddr_in& b)
+{
+    return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+static l_ServerUser* find_user(const sockaddr_in& address)
+{
+    for (auto& [id, user] : l_Users)
+    {
+        if (!user->bot && is_same_address(user->address, address))
+        {
+            return user.get();
+        }
+    }
+
+    return nullptr;
+}
+
+static l_ServerUser* get_user(uint16_t id)
+{
+    auto iter = l_Users.find(id);
+    return iter == l_Users.end() ? nullptr : iter->second.get();
+}
+
+static void send_to(l_ServerUser* user, MessageType type, const MessageWriter& writer)
+{
+    if (user->bot)
+    {
+        return;
+    }
+
+    std::vector<uint8_t> packet = user->sender.Build(type, writer.Data());
+    sendto(l_ServerSocket, packet.data(), packet.size(), 0, (sockaddr*)&user->address, sizeof(user->address));
+}
+
+static void send_to_all(MessageType type, const MessageWriter& writer)
+{
+    for (auto& [id, user] : l_Users)
+    {
+        if (user->loggedIn)
+        {
+            send_to(user.get(), type, writer);
+        }
+    }
+}
+
+static void send_to_game(l_ServerGame& game, MessageType type, const MessageWriter& writer)
+{
+    for (uint16_t id : game.players)
+    {
+        l_ServerUser* user = get_user(id);
+        if (user != nullptr)
+        {
+            send_to(user, type, writer);
+        }
+    }
+}
+
+static void send_game_status(l_ServerGame& game)
+{
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU32(game.id);
+    writer.PutU8(static_cast<uint8_t>(game.status));
+    writer.PutU8(static_cast<uint8_t>(game.players.size()));
+    writer.PutU8(SERVER_MAX_PLAYERS);
+    send_to_all(MessageType::UpdateGameStatus, writer);
+}
+
+static void send_server_status(l_ServerUser* user)
+{
+    MessageWriter writer;
+    uint32_t users = 0;
+
+    for (auto& [id, other] : l_Users)
+    {
+        users += (other->loggedIn && other.get() != user) ? 1 : 0;
+    }
+
+    writer.PutString("");
+    writer.PutU32(users);
+    writer.PutU32(static_cast<uint32_t>(l_Games.size()));
+
+    for (auto& [id, other] : l_Users)
+    {
+        if (!other->loggedIn || other.get() == user)
+        {
+            continue;
+        }
+
+        writer.PutString(other->name);
+        writer.PutU32(other->ping);
+        writer.PutU8(other->gameId != 0 ? 2 : 1);
+        writer.PutU16(other->id);
+        writer.PutU8(static_cast<uint8_t>(other->connectionType));
+    }
+
+    for (auto& [id, game] : l_Games)
+    {
+        l_ServerUser* owner = get_user(game.ownerId);
+
+        writer.PutString(game.name);
+        writer.PutU32(game.id);
+        writer.PutString(game.emulator);
+        writer.PutString(owner != nullptr ? owner->name : "");
+        writer.PutString(std::to_string(game.players.size()) + "/" + std::to_string(SERVER_MAX_PLAYERS));
+        writer.PutU8(static_cast<uint8_t>(game.status));
+    }
+
+    send_to(user, MessageType::ServerStatus, writer);
+}
+
+static void send_join(l_ServerGame& game, l_ServerUser* user)
+{
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU32(game.id);
+    writer.PutString(user->name);
+    writer.PutU32(user->ping);
+    writer.PutU16(user->id);
+    writer.PutU8(static_cast<uint8_t>(user->connectionType));
+    send_to_game(game, MessageType::JoinGame, writer);
+}
+
+static void add_player(l_ServerGame& game, l_ServerUser* user)
+{
+    MessageWriter writer;
+
+    // tell the new player who's already there
+    writer.PutString("");
+    writer.PutU32(static_cast<uint32_t>(game.players.size()));
+    for (uint16_t id : game.players)
+    {
+        l_ServerUser* player = get_user(id);
+        writer.PutString(player->name);
+        writer.PutU32(player->ping);
+        writer.PutU16(player->id);
+        writer.PutU8(static_cast<uint8_t>(player->connectionType));
+    }
+    send_to(user, MessageType::PlayerInformation, writer);
+
+    user->gameId = game.id;
+    game.players.push_back(user->id);
+    send_join(game, user);
+}
+
+static void add_bots(l_ServerGame& game)
+{
+    for (int i = 0; i < l_ServerBots && game.players.size() < SERVER_MAX_PLAYERS; i++)
+    {
+        auto bot = std::make_unique<l_ServerUser>();
+        bot->id   = l_NextUserId++;
+        bot->name = "Bot" + std::to_string(i + 1);
+        bot->bot  = true;
+        bot->loggedIn = true;
+
+        l_ServerUser* botUser = bot.get();
+        l_Users[bot->id] = std::move(bot);
+        add_player(game, botUser);
+    }
+}
+
+static void reset_game(l_ServerGame& game)
+{
+    game.status       = GameStatus::Waiting;
+    game.frameSize    = 0;
+    game.combinedBase = 0;
+    game.combined.clear();
+
+    for (uint16_t id : game.players)
+    {
+        l_ServerUser* user = get_user(id);
+        user->player     = 0;
+        user->ready      = false;
+        user->dropped    = false;
+        user->sentFrames = 0;
+        user->frames.clear();
+        user->inCache.Reset();
+        user->outCache.Reset();
+    }
+}
+
+static void close_game(l_ServerGame& game)
+{
+    MessageWriter writer;
+    writer.PutString("");
+    writer.PutU32(game.id);
+    send_to_all(MessageType::CloseGame, writer);
+
+    for (uint16_t id : game.players)
+    {
+        l_ServerUser* user = get_user(id);
+        user->gameId = 0;
+        if (user->bot)
+        {
+            l_Users.erase(id);
+        }
+    }
+
+    l_Games.erase(game.id);
+}
+
+// a player is waited on when it's a real player
+// which is still in the game, bots and dropped
+// players are fed with neutral input
+static bool is_waited_on(l_ServerUser* user)
+{
+    return !user->bot && !user->dropped;
+}
+
+static void distribute_game_data(l_ServerGame& game)
+{
+    bool anyWaitedOn = false;
+
+    // combine frames while every player has input
+    while (game.frameSize > 0)
+    {
+        bool complete = true;
+        for (uint16_t id : game.players)
+        {
+            l_ServerUser* user = get_user(id);
+            if (is_waited_on(user))
+            {
+                anyWaitedOn = true;
+                complete &= !user->frames.empty();
+            }
+        }
+
+        if (!complete || !anyWaitedOn)
+        {
+            break;
+        }
+
+        std::vector<uint8_t> combined;
+        for (uint16_t id : game.players)
+        {
+            l_ServerUser* user = get_user(id);
+            if (is_waited_on(user))
+            {
+                combined.insert(combined.end(), user->frames.front().begin(), user->frames.front().end());
+                user->frames.pop_front();
+            }
+            else
+            {
+                combined.insert(combined.end(), game.frameSize, 0);
+            }
+        }
+        game.combined.push_back(std::move(combined));
+    }
+
+    uint64_t combinedEnd = game.combinedBase + game.combined.size();
+    uint64_t minSent     = combinedEnd;
+
+    // every player receives connectionType frames per message
+    for (uint16_t id : game.players)
+    {
+        l_ServerUser* user = get_user(id);
+        if (!is_waited_on(user))
+        {
+            continue;
+        }
+
+        while (combinedEnd - user->sentFrames >= static_cast<uint64_t>(user->connectionType))
+        {
+            std::vector<uint8_t> data;
+            for (int i = 0; i < user->connectionType; i++)
+            {
+                const std::vector<uint8_t>& frame = game.combined[user->sentFrames - game.combinedBase + i];
+                data.insert(data.end(), frame.begin(), frame.end());
+            }
+            user->sentFrames += user->connectionType;
+
+            MessageWriter writer;
+            writer.PutString("");
+            int index = user->outCache.Find(data);
+            if (index != -1)
+            {
+                writer.PutU8(static_cast<uint8_t>(index));
+                send_to(user, MessageType::GameCache, writer);
+            }
+            else
+            {
+                writer.PutU16(static_cast<uint16_t>(data.size()));
+                writer.PutBytes(data.data(), data.size());
+                send_to(user, MessageType::GameData, writer);
+                user->outCache.Add(data);
+            }
+        }
+
+        minSent = std::min(minSent, user->sentFrames);
+    }
+
+    // drop combined frames every player has received
+    while (game.combinedBase < minSent && !game.combined.empty())
+    {
+        game.combined.pop_front();
+        game.combinedBase++;
+    }
+}
+
+static void leave_game(l_ServerUser* user)
+{
+    auto iter = l_Games.find(user->gameId);
+    if (iter == l_Games.end())
+    {
+        user->gameId = 0;
+        return;
+    }
+
+    l_ServerGame& game = iter->second;
+
+    if (game.ownerId == user->id)
+    {
+        close_game(game);
+        return;
+    }
+
+    MessageWriter writer;
+    writer.PutString(user->name);
+    writer.PutU16(user->id);
+    send_to_game(game, MessageType::QuitGame, writer);
+
+    std::erase(game.players, user->id);
+    user->gameId = 0;
+
+    if (game.status != GameStatus::Waiting)
+    {
+        distribute_game_data(game);
+    }
+    send_game_status(game);
+}
+
+static void handle_message(l_ServerUser* user, const Message& message)
+{
+    MessageReader reader(message.Data);
+    l_ServerGame* game = nullptr;
+
+    auto gameIter = l_Games.find(user->gameId);
+    if (gameIter != l_Games.end())
+    {
+        game = &gameIter->second;
+    }
+
+    switch (message.Type)
+    {
+    default:
+        break;
+
+    case MessageType::UserInformation:
+    {
+        user->name           = reader.GetString();
+        user->emulator       = reader.GetString();
+        user->connectionType = std::clamp<int>(reader.GetU8(), 1, 6);
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        MessageWriter writer;
+        writer.PutString("");
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            writer.PutU32(i);
+        }
+        user->ackTime = std::chrono::steady_clock::now();
+        send_to(user, MessageType::ServerAck, writer);
+    } break;
+
+    case MessageType::ClientAck:
+    {
+        if (user->loggedIn)
+        {
+            break;
+        }
+
+        auto rtt = std::chrono::steady_clock::now() - user->ackTime;
+        user->ping += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(rtt).count());
+
+        if (++user->acks < KAILLERA_ACK_COUNT)
+        {
+            MessageWriter writer;
+            writer.PutString("");
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                writer.PutU32(i);
+            }
+            user->ackTime = std::chrono::steady_clock::now();
+            send_to(user, MessageType::ServerAck, writer);
+            break;
+        }
+
+        user->ping /= KAILLERA_ACK_COUNT;
+        user->loggedIn = true;
+        send_server_status(user);
+
+        MessageWriter joinedWriter;
+        joinedWriter.PutString(user->name);
+        joinedWriter.PutU16(user->id);
+        joinedWriter.PutU32(user->ping);
+        joinedWriter.PutU8(static_cast<uint8_t>(user->connectionType));
+        send_to_all(MessageType::UserJoined, joinedWriter);
+
+        MessageWriter infoWriter;
+        infoWriter.PutString("Server");
+        infoWriter.PutString("RMG-K loopback server");
+        send_to(user, MessageType::ServerInformation, infoWriter);
+    } break;
+
+    case MessageType::UserQuit:
+    {
+        reader.GetString();
+        reader.GetU16();
+        std::string reason = reader.GetString();
+
+        leave_game(user);
+
+        MessageWriter writer;
+        writer.PutString(user->name);
+        writer.PutU16(user->id);
+        writer.PutString(reason);
+        send_to_all(MessageType::UserQuit, writer);
+
+        l_Users.erase(user->id);
+    } break;
+
+    case MessageType::GlobalChat:
+    case MessageType::GameChat:
+    {
+        reader.GetString();
+        std::string text = reader.GetString();
+        if (!reader.IsValid())
+        {
+            break;
+        }
+
+        MessageWriter writer;
+        writer.PutString(user->name);
+        writer.PutString(text);
+        if (message.Type == MessageType::GlobalChat)
+        {
+            send_to_all(MessageType::GlobalChat, writer);
+        }
+        else if (game != nullptr)
+        {
+            send_to_game(*game, MessageType::GameChat, writer);
+        }
+    } break;
+
+    case MessageType::CreateGame:
+    {
+        reader.GetString();
+        std::string name = reader.GetString();
+        if (!reader.IsValid() || !user->loggedIn || game != nullptr)
+        {
+            break;
+        }
+
+        l_ServerGame newGame;
+        newGame.id       = l_NextGameId++;
+        newGame.name     = name;
+        newGame.emulator = user->emulator;
+        newGame.ownerId  = user->id;
+        l_Games[newGame.id] = newGame;
+        game = &l_Games[newGame.id];
+
+        MessageWriter writer;
+        writer.PutString(user->name);
+        writer.PutString(game->name);
+        writer.PutString(game->emulator);
+        writer.PutU32(game->id);
+        send_to_all(MessageType::CreateGame, writer);
+
+        add_player(*game, user);
+        add_bots(*game);
+        send_game_status(*game);
+    } break;
+
+    case MessageType::JoinGame:
+    {
+        reader.GetString();
+        uint32_t gameId = reader.GetU32();
+        if (!reader.IsValid() || !user->loggedIn || game != nullptr)
+        {
+            break;
+        }
+
+        auto iter = l_Games.find(gameId);
+        if (iter == l_Games.end() ||
+            iter->second.status != GameStatus::Waiting ||
+            iter->second.players.size() >= SERVER_MAX_PLAYERS)
+        {
+            break;
+        }
+
+        add_player(iter->second, user);
+        send_game_status(iter->second);
+    } break;
+
+    case MessageType::QuitGame:
+    {
+        leave_game(user);
+    } break;
+
+    case MessageType::StartGame:
+    {
+        if (game == nullptr || game->ownerId != user->id ||
+            game->status != GameStatus::Waiting)
+        {
+            break;
+        }
+
+        reset_game(*game);
+        game->status = GameStatus::NetSync;
+
+        int playerNumber = 1;
+        for (uint16_t id : game->players)
+        {
+            l_ServerUser* player = get_user(id);
+            player->player = playerNumber++;
+            player->ready  = player->bot;
+
+            MessageWriter writer;
+            writer.PutString("");
+            writer.PutU16(static_cast<uint16_t>(GetFrameDelay(player->ping, player->connectionType)));
+            writer.PutU8(static_cast<uint8_t>(player->player));
+            writer.PutU8(static_cast<uint8_t>(game->players.size()));
+            send_to(player, MessageType::StartGame, writer);
+        }
+
+        send_game_status(*game);
+    } break;
+
+    case MessageType::ReadyToPlay:
+    {
+        if (game == nullptr || game->status != GameStatus::NetSync)
+        {
+            break;
+        }
+
+        user->ready = true;
+
+        bool allReady = std::all_of(game->players.begin(), game->players.end(),
+                                    [](uint16_t id) { return get_user(id)->ready; });
+        if (allReady)
+        {
+            game->status = GameStatus::Playing;
+
+            MessageWriter writer;
+            writer.PutString("");
+            send_to_game(*game, MessageType::ReadyToPlay, writer);
+            send_game_status(*game);
+        }
+    } break;
+
+    case MessageType::GameData:
+    case MessageType::GameCache:
+    {
+        std::vector<uint8_t> data;
+
+        if (game == nullptr || game->status != GameStatus::Playing || user->dropped)
+        {
+            break;
+        }
+
+        reader.GetString();
+        if (message.Type == MessageType::GameData)
+        {
+            uint16_t length = reader.GetU16();
+            data = reader.GetBytes(length);
+            if (!reader.IsValid())
+            {
+                break;
+            }
+            user->inCache.Add(data);
+        }
+        else if (!user->inCache.Get(reader.GetU8(), data))
+        {
+            break;
+        }
+
+        if (data.empty() || (data.size() % user->connectionType) != 0)
+        {
+            break;
+        }
+
+        size_t frameSize = data.size() / user->connectionType;
+        if (game->frameSize == 0)
+        {
+            game->frameSize = frameSize;
+        }
+        else if (game->frameSize != frameSize)
+        {
+            break;
+        }
+
+        for (int i = 0; i < user->connectionType; i++)
+        {
+            user->frames.emplace_back(data.begin() + (i * frameSize), data.begin() + ((i + 1) * frameSize));
+        }
+
+        distribute_game_data(*game);
+    } break;
+
+    case MessageType::DropGame:
+    {
+        if (game == nullptr || game->status == GameStatus::Waiting || user->dropped)
+        {
+            break;
+        }
+
+        user->dropped = true;
+
+        MessageWriter writer;
+        writer.PutString(user->name);
+        writer.PutU8(static_cast<uint8_t>(user->player));
+        send_to_game(*game, MessageType::DropGame, writer);
+
+        bool allDropped = std::none_of(game->players.begin(), game->players.end(),
+                                       [](uint16_t id) { return is_waited_on(get_user(id)); });
+        if (allDropped)
+        {
+            reset_game(*game);
+        }
+        else
+        {
+            distribute_game_data(*game);
+        }
+
+        send_game_status(*game);
+    } break;
+    }
+}
+
+static void server_thread(void)
+{
+    uint8_t buffer[KAILLERA_MAX_PACKET_SIZE];
+    std::vector<Message> messages;
+
+    while (l_ServerRunning)
+    {
+        pollfd pfd;
+        pfd.fd      = l_ServerSocket;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+
+        if (poll(&pfd, 1, SERVER_POLL_MS) <= 0 || !(pfd.revents & POLLIN))
+        {
+            continue;
+        }
+
+        sockaddr_in address;
+        socklen_t addressLength = sizeof(address);
+        ssize_t size = recvfrom(l_ServerSocket, buffer, sizeof(buffer), 0, (sockaddr*)&address, &addressLength);
+        if (size <= 0)
+        {
+            continue;
+        }
+
+        // handshake, the game port is the same as the connection port
+        if (size >= 5 && std::memcmp(buffer, "HELLO", 5) == 0)
+        {
+            std::string reply;
+            if (std::string((char*)buffer, strnlen((char*)buffer, size)) == "HELLO" KAILLERA_PROTOCOL_VERSION)
+            {
+                reply = "HELLOD00D" + std::to_string(l_ServerPort);
+            }
+            else
+            {
+                reply = "VER";
+            }
+            sendto(l_ServerSocket, reply.c_str(), reply.size() + 1, 0, (sockaddr*)&address, addressLength);
+            continue;
+        }
+        else if (size == 5 && std::memcmp(buffer, "PING", 5) == 0)
+        {
+            sendto(l_ServerSocket, "PONG", 5, 0, (sockaddr*)&address, addressLength);
+            continue;
+        }
+
+        l_ServerUser* user = find_user(address);
+        if (user == nullptr)
+        {
+            auto newUser = std::make_unique<l_ServerUser>();
+            newUser->address = address;
+            newUser->id      = l_NextUserId++;
+            user = newUser.get();
+            l_Users[newUser->id] = std::move(newUser);
+        }
+
+        messages.clear();
+        if (!user->receiver.Parse(buffer, size, messages))
+        {
+            continue;
+        }
+
+        uint16_t userId = user->id;
+        for (const Message& message : messages)
+        {
+            // the user might've quit while handling the previous message
+            user = get_user(userId);
+            if (user == nullptr)
+            {
+                break;
+            }
+
+            handle_message(user, message);
+        }
+    }
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreStartKailleraLoopbackServer(int port, int botPlayers)
+{
+    sockaddr_in address;
+
+    if (l_ServerRunning)
+    {
+        CoreSetError("CoreStartKailleraLoopbackServer: server is already running");
+        return false;
+    }
+
+    l_ServerSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (l_ServerSocket == -1)
+    {
+        CoreSetError("CoreStartKailleraLoopbackServer: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(l_ServerSocket, (sockaddr*)&address, sizeof(address)) != 0)
+    {
+        CoreSetError("CoreStartKailleraLoopbackServer: bind() failed: " + std::string(strerror(errno)));
+        close(l_ServerSocket);
+        l_ServerSocket = -1;
+        return false;
+    }
+
+    l_ServerPort = port;
+    l_ServerBots = std::clamp(botPlayers, 0, SERVER_MAX_PLAYERS - 1);
+    l_NextUserId = 1;
+    l_NextGameId = 1;
+    l_Users.clear();
+    l_Games.clear();
+
+    l_ServerRunning = true;
+    l_ServerThread  = std::thread(server_thread);
+    return true;
+}
+
+CORE_EXPORT bool CoreIsKailleraLoopbackServerRunning(void)
+{
+    return l_ServerRunning;
+}
+
+CORE_EXPORT void CoreStopKailleraLoopbackServer(void)
+{
+    if (!l_ServerRunning)
+    {
+        return;
+    }
+
+    l_ServerRunning = false;
+    if (l_ServerThread.joinable())
+    {
+        l_ServerThread.join();
+    }
+
+    close(l_ServerSocket);
+    l_ServerSocket = -1;
+    l_Users.clear();
+    l_Games.clear();
+}
+
+#else // _WIN32
+
+CORE_EXPORT bool CoreStartKailleraLoopbackServer(int port, int botPlayers)
+{
+    (void)port;
+    (void)botPlayers;
+    CoreSetError("CoreStartKailleraLoopbackServer: the loopback server is only available with the native Kaillera client");
+    return false;
+}
+
+CORE_EXPORT bool CoreIsKailleraLoopbackServerRunning(void)
+{
+    return false;
+}
+
+CORE_EXPORT void CoreStopKailleraLoopbackServer(void)
+{
+}
+
+#endif // _WIN32
@@ -0,0 +1,31 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_KAILLERASERVER_HPP
+#define CORE_KAILLERASERVER_HPP
+
+//
+// Minimal Kaillera server which listens on the loopback
+// interface, used to test and benchmark the native client
+// without depending on an outside server
+//
+
+// starts the loopback server on 127.0.0.1:port,
+// botPlayers is the amount of simulated players
+// which join every created game and send neutral
+// input as soon as it's needed
+bool CoreStartKailleraLoopbackServer(int port, int botPlayers = 0);
+
+// returns whether the loopback server is running
+bool CoreIsKailleraLoopbackServerRunning(void);
+
+// stops the loopback server
+void CoreStopKailleraLoopbackServer(void);
+
+#endif // CORE_KAILLERASERVER_HPP
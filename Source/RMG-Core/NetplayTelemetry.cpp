@@ -0,0 +1,262 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "NetplayTelemetry.hpp"
+#include "Library.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cmath>
+
+//
+// Local Defines
+//
+
+// amount of frames in the ring, has to be a power of 2
+#define TELEMETRY_RING_SIZE 1024
+
+// waits shorter than this aren't counted as stalls
+#define TELEMETRY_STALL_US 1000
+
+#define TELEMETRY_FLAG_INPUT    (1 << 0)
+#define TELEMETRY_FLAG_BUFFERED (1 << 1)
+#define TELEMETRY_FLAG_ERROR    (1 << 2)
+
+//
+// Local Structures
+//
+
+// the fields are atomic so readers can copy entries
+// while the emulation thread overwrites old ones,
+// entries which were overwritten are discarded
+struct l_TelemetryEntry
+{
+    std::atomic<uint32_t> WaitUs      = 0;
+    std::atomic<uint32_t> FrameTimeUs = 0;
+    std::atomic<uint32_t> Flags       = 0;
+};
+
+typedef void (*netplay_telemetry_callback_t)(long long wait_us, int result);
+typedef void (*set_netplay_telemetry_callback_t)(netplay_telemetry_callback_t callback);
+
+//
+// Local Variables
+//
+
+static l_TelemetryEntry l_Entries[TELEMETRY_RING_SIZE];
+static std::atomic<uint64_t> l_WriteCount = 0;
+
+// state of the frame in progress,
+// only used by the emulation thread
+static uint64_t l_CurrentWaitUs = 0;
+static uint32_t l_CurrentFlags  = 0;
+static std::chrono::steady_clock::time_point l_LastFrameTime;
+static bool l_HasLastFrameTime = false;
+
+//
+// Local Functions
+//
+
+static void netplay_telemetry_callback(long long wait_us, int result)
+{
+    CoreNetplayTelemetryAddWait(static_cast<int64_t>(wait_us), result);
+}
+
+static double get_percentile(const std::vector<uint32_t>& sorted, double percentile)
+{
+    size_t index = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+    index = std::clamp(index, static_cast<size_t>(1), sorted.size()) - 1;
+    return sorted[index] / 1000.0;
+}
+
+static double get_standard_deviation(const std::vector<double>& values, double& mean)
+{
+    double sum = 0.0;
+    double squaredSum = 0.0;
+
+    for (double value : values)
+    {
+        sum += value;
+    }
+    mean = sum / values.size();
+
+    for (double value : values)
+    {
+        squaredSum += (value - mean) * (value - mean);
+    }
+
+    return std::sqrt(squaredSum / values.size());
+}
+
+//
+// Internal Functions
+//
+
+void CoreStartNetplayTelemetry(void)
+{
+    l_WriteCount       = 0;
+    l_CurrentWaitUs    = 0;
+    l_CurrentFlags     = 0;
+    l_HasLastFrameTime = false;
+
+    CoreLibraryHandle handle = (CoreLibraryHandle)m64p::Core.GetHandle();
+    if (handle == nullptr)
+    {
+        return;
+    }
+
+    set_netplay_telemetry_callback_t set_callback =
+        (set_netplay_telemetry_callback_t)CoreGetLibrarySymbol(handle, "set_netplay_telemetry_callback");
+    if (set_callback != nullptr)
+    {
+        set_callback(netplay_telemetry_callback);
+    }
+}
+
+void CoreNetplayTelemetryAddWait(int64_t waitUs, int result)
+{
+    l_CurrentWaitUs += static_cast<uint64_t>(std::max<int64_t>(waitUs, 0));
+    l_CurrentFlags  |= TELEMETRY_FLAG_INPUT;
+
+    if (result == 0)
+    {
+        l_CurrentFlags |= TELEMETRY_FLAG_BUFFERED;
+    }
+    else if (result < 0)
+    {
+        l_CurrentFlags |= TELEMETRY_FLAG_ERROR;
+    }
+}
+
+void CoreNetplayTelemetryFrame(void)
+{
+    auto currentTime = std::chrono::steady_clock::now();
+    uint64_t frameTimeUs = 0;
+
+    if (l_HasLastFrameTime)
+    {
+        frameTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - l_LastFrameTime).count();
+    }
+    l_LastFrameTime    = currentTime;
+    l_HasLastFrameTime = true;
+
+    // only frames which requested netplay input are kept
+    if (l_CurrentFlags == 0)
+    {
+        return;
+    }
+
+    uint64_t writeCount = l_WriteCount.load(std::memory_order_relaxed);
+    l_TelemetryEntry& entry = l_Entries[writeCount & (TELEMETRY_RING_SIZE - 1)];
+    entry.WaitUs.store(static_cast<uint32_t>(std::min<uint64_t>(l_CurrentWaitUs, UINT32_MAX)), std::memory_order_relaxed);
+    entry.FrameTimeUs.store(static_cast<uint32_t>(std::min<uint64_t>(frameTimeUs, UINT32_MAX)), std::memory_order_relaxed);
+    entry.Flags.store(l_CurrentFlags, std::memory_order_relaxed);
+    l_WriteCount.store(writeCount + 1, std::memory_order_release);
+
+    l_CurrentWaitUs = 0;
+    l_CurrentFlags  = 0;
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreGetNetplayTelemetryStats(CoreNetplayTelemetryStats& stats, uint32_t frames)
+{
+    std::vector<uint32_t> waits;
+    std::vector<uint32_t> frameTimes;
+    std::vector<uint32_t> flags;
+
+    uint64_t endCount   = l_WriteCount.load(std::memory_order_acquire);
+    uint64_t count      = std::min<uint64_t>({ frames, endCount, TELEMETRY_RING_SIZE - 1 });
+    uint64_t startCount = endCount - count;
+
+    waits.reserve(count);
+    frameTimes.reserve(count);
+    flags.reserve(count);
+
+    for (uint64_t i = startCount; i < endCount; i++)
+    {
+        const l_TelemetryEntry& entry = l_Entries[i & (TELEMETRY_RING_SIZE - 1)];
+        waits.push_back(entry.WaitUs.load(std::memory_order_relaxed));
+        frameTimes.push_back(entry.FrameTimeUs.load(std::memory_order_relaxed));
+        flags.push_back(entry.Flags.load(std::memory_order_relaxed));
+    }
+
+    // discard the entries which the emulation thread has
+    // (or might have started to) overwrite while copying them
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t currentCount = l_WriteCount.load(std::memory_order_relaxed);
+    if (currentCount < endCount)
+    { // telemetry has been restarted
+        return false;
+    }
+
+    uint64_t overwritten = 0;
+    if ((currentCount + 1) > (startCount + TELEMETRY_RING_SIZE))
+    {
+        overwritten = std::min<uint64_t>(count, (currentCount + 1) - (startCount + TELEMETRY_RING_SIZE));
+    }
+    waits.erase(waits.begin(), waits.begin() + overwritten);
+    frameTimes.erase(frameTimes.begin(), frameTimes.begin() + overwritten);
+    flags.erase(flags.begin(), flags.begin() + overwritten);
+
+    if (waits.empty())
+    {
+        return false;
+    }
+
+    stats = CoreNetplayTelemetryStats();
+    stats.Frames = static_cast<uint32_t>(waits.size());
+
+    std::vector<double> frameTimesMs;
+    std::vector<double> frameTimesWithoutStallsMs;
+    for (size_t i = 0; i < waits.size(); i++)
+    {
+        if (waits[i] >= TELEMETRY_STALL_US)
+        {
+            stats.StallFrames++;
+        }
+        if (flags[i] & TELEMETRY_FLAG_BUFFERED)
+        {
+            stats.BufferedFrames++;
+        }
+        if (flags[i] & TELEMETRY_FLAG_ERROR)
+        {
+            stats.ErrorFrames++;
+        }
+
+        // the first frame after starting has no frame time
+        if (frameTimes[i] != 0)
+        {
+            frameTimesMs.push_back(frameTimes[i] / 1000.0);
+            frameTimesWithoutStallsMs.push_back((frameTimes[i] - std::min(waits[i], frameTimes[i])) / 1000.0);
+        }
+    }
+
+    std::sort(waits.begin(), waits.end());
+    stats.StallP50 = get_percentile(waits, 0.50);
+    stats.StallP95 = get_percentile(waits, 0.95);
+    stats.StallP99 = get_percentile(waits, 0.99);
+    stats.StallMax = waits.back() / 1000.0;
+
+    if (!frameTimesMs.empty())
+    {
+        double meanWithoutStalls;
+        stats.FrameTimeStdDev              = get_standard_deviation(frameTimesMs, stats.FrameTimeMean);
+        stats.FrameTimeStdDevWithoutStalls = get_standard_deviation(frameTimesWithoutStallsMs, meanWithoutStalls);
+    }
+
+    return true;
+}
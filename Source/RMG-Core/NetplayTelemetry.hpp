@@ -0,0 +1,58 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NETPLAYTELEMETRY_HPP
+#define CORE_NETPLAYTELEMETRY_HPP
+
+#include <cstdint>
+
+//
+// Per-frame netplay telemetry, both the Kaillera PIF callback
+// and the mupen64plus netplay input requests report how long
+// they waited on input, the emulation thread writes one entry
+// per frame into a lock-free ring which can be queried from
+// any thread
+//
+
+struct CoreNetplayTelemetryStats
+{
+    uint32_t Frames                       = 0;  // frames in the statistics
+    uint32_t StallFrames                  = 0;  // frames which waited on input for at least a millisecond
+    uint32_t BufferedFrames               = 0;  // frames without input because the frame delay was being filled
+    uint32_t ErrorFrames                  = 0;  // frames in which an input request failed
+    double   StallP50                     = 0.0; // 50th percentile of the time waited on input in milliseconds
+    double   StallP95                     = 0.0; // 95th percentile of the time waited on input in milliseconds
+    double   StallP99                     = 0.0; // 99th percentile of the time waited on input in milliseconds
+    double   StallMax                     = 0.0; // longest time waited on input in milliseconds
+    double   FrameTimeMean                = 0.0; // mean frame time in milliseconds
+    double   FrameTimeStdDev              = 0.0; // frame time standard deviation in milliseconds
+    double   FrameTimeStdDevWithoutStalls = 0.0; // frame time standard deviation without the time waited on input
+};
+
+#ifdef CORE_INTERNAL
+// clears the telemetry and hooks the mupen64plus
+// netplay telemetry callback, has to be called
+// before emulation starts
+void CoreStartNetplayTelemetry(void);
+
+// adds the time an input request waited to the current frame,
+// result is > 0 when input arrived, 0 when the frame delay
+// is being filled and < 0 when the request failed
+void CoreNetplayTelemetryAddWait(int64_t waitUs, int result);
+
+// finishes the current frame, has to be
+// called from the frame callback
+void CoreNetplayTelemetryFrame(void);
+#endif // CORE_INTERNAL
+
+// retrieves statistics of the most recent frames which
+// waited on netplay input, returns false when there are none
+bool CoreGetNetplayTelemetryStats(CoreNetplayTelemetryStats& stats, uint32_t frames = 600);
+
+#endif // CORE_NETPLAYTELEMETRY_HPP
@@ -24,7 +24,7 @@
 // Local Functions
 //
 
-static std::string get_name_from_headername(uint8_t name[20])
+static std::string get_name_from_headername(const uint8_t name[20])
 {
     std::string safeName;
     size_t count = 0;
@@ -40,7 +40,7 @@ static std::string get_name_from_headername(uint8_t name[20])
         }
     }
 
-    safeName = std::string(reinterpret_cast<char*>(name), count);
+    safeName = std::string(reinterpret_cast<const char*>(name), count);
     return CoreConvertStringEncoding(safeName, CoreStringEncoding::Shift_JIS);
 }
 
@@ -164,6 +164,21 @@ static CoreSystemType get_systemtype_from_countrycode(uint8_t countryCode)
     return systemType;
 }
 
+//
+// Internal Functions
+//
+
+void CoreConvertRomHeader(const m64p_rom_header& m64p_header, CoreRomHeader& header)
+{
+    header.CRC1        = ntohl(m64p_header.CRC1);
+    header.CRC2        = ntohl(m64p_header.CRC2);
+    header.CountryCode = m64p_header.Country_code;
+    header.Name        = get_name_from_headername(m64p_header.Name);
+    header.GameID      = get_gameid_from_header(m64p_header);
+    header.Region      = get_region_from_countrycode(static_cast<char>(header.CountryCode));
+    header.SystemType  = get_systemtype_from_countrycode(header.CountryCode);
+}
+
 //
 // Exported Functions
 //
@@ -188,13 +203,6 @@ CORE_EXPORT bool CoreGetCurrentRomHeader(CoreRomHeader& header)
         return false;
     }
 
-    header.CRC1        = ntohl(m64p_header.CRC1);
-    header.CRC2        = ntohl(m64p_header.CRC2);
-    header.CountryCode = m64p_header.Country_code;
-    header.Name        = get_name_from_headername(m64p_header.Name);
-    header.GameID      = get_gameid_from_header(m64p_header);
-    header.Region      = get_region_from_countrycode(static_cast<char>(header.CountryCode));
-    header.SystemType  = get_systemtype_from_countrycode(header.CountryCode);
-
+    CoreConvertRomHeader(m64p_header, header);
     return true;
 }
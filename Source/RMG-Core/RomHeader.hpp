@@ -45,4 +45,11 @@ struct CoreRomHeader
 // retrieves the currently opened ROM header
 bool CoreGetCurrentRomHeader(CoreRomHeader& header);
 
+#ifdef CORE_INTERNAL
+#include "m64p/api/m64p_types.h"
+
+// converts the ROM header in N64 native byte order
+void CoreConvertRomHeader(const m64p_rom_header& m64p_header, CoreRomHeader& header);
+#endif // CORE_INTERNAL
+
 #endif // CORE_ROMHEADER_HPP
\ No newline at end of file
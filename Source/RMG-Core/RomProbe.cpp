@@ -0,0 +1,176 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "RomSettings.hpp"
+#include "RomHeader.hpp"
+#include "RomProbe.hpp"
+#include "m64p/Api.hpp"
+#include "Archive.hpp"
+#include "Library.hpp"
+#include "String.hpp"
+#include "Error.hpp"
+#include "File.hpp"
+
+#include <md5.h>
+
+#include <cstring>
+
+//
+// Local Variables
+//
+
+static const uint8_t l_Z64Signature[4] = { 0x80, 0x37, 0x12, 0x40 };
+static const uint8_t l_V64Signature[4] = { 0x37, 0x80, 0x40, 0x12 };
+static const uint8_t l_N64Signature[4] = { 0x40, 0x12, 0x37, 0x80 };
+
+//
+// Local Structures
+//
+
+typedef int (*romdatabase_lookup_rom_t)(const void* header, const unsigned char* md5, m64p_rom_settings* settings);
+
+//
+// Local Functions
+//
+
+static bool is_valid_rom(const std::vector<char>& buffer)
+{
+    if (buffer.size() < sizeof(m64p_rom_header))
+    {
+        return false;
+    }
+
+    return (std::memcmp(buffer.data(), l_Z64Signature, sizeof(l_Z64Signature)) == 0) ||
+            (std::memcmp(buffer.data(), l_V64Signature, sizeof(l_V64Signature)) == 0 && buffer.size() % 2 == 0) ||
+            (std::memcmp(buffer.data(), l_N64Signature, sizeof(l_N64Signature)) == 0 && buffer.size() % 4 == 0);
+}
+
+// converts the ROM to N64 native (big endian) byte order,
+// see swap_copy_rom() in mupen64plus-core's rom.c
+static void swap_rom(std::vector<char>& buffer)
+{
+    if (std::memcmp(buffer.data(), l_V64Signature, sizeof(l_V64Signature)) == 0)
+    {
+        for (size_t i = 0; i < buffer.size(); i += 2)
+        {
+            std::swap(buffer[i], buffer[i + 1]);
+        }
+    }
+    else if (std::memcmp(buffer.data(), l_N64Signature, sizeof(l_N64Signature)) == 0)
+    {
+        for (size_t i = 0; i < buffer.size(); i += 4)
+        {
+            std::swap(buffer[i], buffer[i + 3]);
+            std::swap(buffer[i + 1], buffer[i + 2]);
+        }
+    }
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT CoreRomProbeResult CoreProbeRom(std::filesystem::path file, CoreRomType& type, CoreRomHeader& header, CoreRomSettings& defaultSettings)
+{
+    std::string error;
+    std::vector<char> buf;
+    std::string file_extension;
+    romdatabase_lookup_rom_t romdatabase_lookup_rom;
+    md5_state_t md5_state;
+    md5_byte_t md5_digest[16];
+    m64p_rom_header m64p_header;
+    m64p_rom_settings m64p_settings;
+
+    if (!m64p::Core.IsHooked())
+    {
+        return CoreRomProbeResult::Unsupported;
+    }
+
+    // the ROM database lookup needs a core which exports it
+    romdatabase_lookup_rom = (romdatabase_lookup_rom_t)CoreGetLibrarySymbol((CoreLibraryHandle)m64p::Core.GetHandle(), "romdatabase_lookup_rom");
+    if (romdatabase_lookup_rom == nullptr)
+    {
+        return CoreRomProbeResult::Unsupported;
+    }
+
+    file_extension = file.has_extension() ? file.extension().string() : "";
+    file_extension = CoreLowerString(file_extension);
+
+    // disks are expanded and hashed by the core
+    // when opening them, so those can't be probed
+    if (file_extension == ".d64" ||
+        file_extension == ".ndd")
+    {
+        return CoreRomProbeResult::Unsupported;
+    }
+
+    if (file_extension == ".zip" ||
+        file_extension == ".7z")
+    {
+        std::filesystem::path extracted_file;
+        bool                  is_disk = false;
+        uint64_t              extracted_size = 0;
+
+        // only read the directory of the archive first,
+        // so archives without ROMs or with disks
+        // don't have to be extracted
+        if (!CoreGetArchiveFileInfo(file, extracted_file, is_disk, extracted_size))
+        {
+            return CoreRomProbeResult::Invalid;
+        }
+
+        if (is_disk)
+        {
+            return CoreRomProbeResult::Unsupported;
+        }
+
+        if (extracted_size < sizeof(m64p_rom_header) ||
+            extracted_size > CORE_ARCHIVE_FILE_SIZE_MAX)
+        {
+            return CoreRomProbeResult::Invalid;
+        }
+
+        // the MD5 needs the whole ROM, but don't add
+        // it to the archive cache, that would evict
+        // the ROMs which have actually been played
+        if (!CoreReadArchiveFile(file, extracted_file, is_disk, buf, false))
+        {
+            return CoreRomProbeResult::Invalid;
+        }
+    }
+    else if (!CoreReadFile(file, buf))
+    {
+        return CoreRomProbeResult::Invalid;
+    }
+
+    if (!is_valid_rom(buf))
+    {
+        error = "CoreProbeRom Failed: ";
+        error += "not a valid ROM image!";
+        CoreSetError(error);
+        return CoreRomProbeResult::Invalid;
+    }
+
+    swap_rom(buf);
+
+    md5_init(&md5_state);
+    md5_append(&md5_state, reinterpret_cast<const md5_byte_t*>(buf.data()), static_cast<unsigned int>(buf.size()));
+    md5_finish(&md5_state, md5_digest);
+
+    std::memcpy(&m64p_header, buf.data(), sizeof(m64p_header));
+
+    m64p_settings = {};
+    romdatabase_lookup_rom(&m64p_header, md5_digest, &m64p_settings);
+
+    type = CoreRomType::Cartridge;
+    CoreConvertRomHeader(m64p_header, header);
+    CoreConvertRomSettings(m64p_settings, defaultSettings);
+    return CoreRomProbeResult::Success;
+}
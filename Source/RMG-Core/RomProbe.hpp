@@ -0,0 +1,31 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ROMPROBE_HPP
+#define CORE_ROMPROBE_HPP
+
+#include <filesystem>
+
+#include "Rom.hpp"
+#include "RomHeader.hpp"
+#include "RomSettings.hpp"
+
+enum class CoreRomProbeResult
+{
+    Success,    // ROM has been probed
+    Invalid,    // file isn't a valid ROM
+    Unsupported // file has to be opened with CoreOpenRom
+};
+
+// attempts to retrieve the type, header and default settings
+// of the ROM without opening it in the core, it doesn't touch
+// any global state so it's safe to call from multiple threads
+CoreRomProbeResult CoreProbeRom(std::filesystem::path file, CoreRomType& type, CoreRomHeader& header, CoreRomSettings& defaultSettings);
+
+#endif // CORE_ROMPROBE_HPP
@@ -24,6 +24,45 @@
 static CoreRomSettings l_DefaultRomSettings;
 static bool            l_HasDefaultRomSettings = false;
 
+//
+// Internal Functions
+//
+
+void CoreConvertRomSettings(const m64p_rom_settings& m64p_settings, CoreRomSettings& settings)
+{
+    settings.GoodName = CoreConvertStringEncoding(m64p_settings.goodname, CoreStringEncoding::Shift_JIS);
+    settings.MD5 = std::string(m64p_settings.MD5);
+    settings.SaveType = m64p_settings.savetype;
+    settings.DisableExtraMem = m64p_settings.disableextramem;
+    settings.TransferPak = m64p_settings.transferpak;
+    settings.CountPerOp = m64p_settings.countperop;
+    settings.SiDMADuration = m64p_settings.sidmaduration;
+}
+
+bool CoreGetRomSettingsOverlay(const CoreRomSettings& defaultSettings, CoreRomSettings& settings)
+{
+    settings = defaultSettings;
+
+    // don't do anything when section doesn't exist
+    if (!CoreSettingsSectionExists(settings.MD5))
+    {
+        return false;
+    }
+
+    // or when we don't override the settings
+    if (!CoreSettingsGetBoolValue(SettingsID::Game_OverrideSettings, settings.MD5))
+    {
+        return false;
+    }
+
+    settings.SaveType = CoreSettingsGetIntValue(SettingsID::Game_SaveType, settings.MD5);
+    settings.DisableExtraMem = CoreSettingsGetBoolValue(SettingsID::Game_DisableExtraMem, settings.MD5);
+    settings.TransferPak = CoreSettingsGetBoolValue(SettingsID::Game_TransferPak, settings.MD5);
+    settings.CountPerOp = CoreSettingsGetIntValue(SettingsID::Game_CountPerOp, settings.MD5);
+    settings.SiDMADuration = CoreSettingsGetIntValue(SettingsID::Game_SiDmaDuration, settings.MD5);
+    return true;
+}
+
 //
 // Exported Functions
 //
@@ -48,13 +87,7 @@ CORE_EXPORT bool CoreGetCurrentRomSettings(CoreRomSettings& settings)
         return false;
     }
 
-    settings.GoodName = CoreConvertStringEncoding(m64p_settings.goodname, CoreStringEncoding::Shift_JIS);
-    settings.MD5 = std::string(m64p_settings.MD5);
-    settings.SaveType = m64p_settings.savetype;
-    settings.DisableExtraMem = m64p_settings.disableextramem;
-    settings.TransferPak = m64p_settings.transferpak;
-    settings.CountPerOp = m64p_settings.countperop;
-    settings.SiDMADuration = m64p_settings.sidmaduration;
+    CoreConvertRomSettings(m64p_settings, settings);
     return true;
 }
 
@@ -146,30 +179,18 @@ CORE_EXPORT bool CoreApplyRomSettings(CoreRomSettings settings)
 
 CORE_EXPORT bool CoreApplyRomSettingsOverlay(void)
 {
+    CoreRomSettings defaultSettings;
     CoreRomSettings settings;
 
-    if (!CoreGetCurrentDefaultRomSettings(settings))
+    if (!CoreGetCurrentDefaultRomSettings(defaultSettings))
     {
         return false;
     }
 
-    // don't do anything when section doesn't exist
-    if (!CoreSettingsSectionExists(settings.MD5))
-    {
-        return false;
-    }
-
-    // or when we don't override the settings
-    if (!CoreSettingsGetBoolValue(SettingsID::Game_OverrideSettings, settings.MD5))
+    if (!CoreGetRomSettingsOverlay(defaultSettings, settings))
     {
         return false;
     }
 
-    settings.SaveType = CoreSettingsGetIntValue(SettingsID::Game_SaveType, settings.MD5);
-    settings.DisableExtraMem = CoreSettingsGetBoolValue(SettingsID::Game_DisableExtraMem, settings.MD5);
-    settings.TransferPak = CoreSettingsGetBoolValue(SettingsID::Game_TransferPak, settings.MD5);
-    settings.CountPerOp = CoreSettingsGetIntValue(SettingsID::Game_CountPerOp, settings.MD5);
-    settings.SiDMADuration = CoreSettingsGetIntValue(SettingsID::Game_SiDmaDuration, settings.MD5);
-
     return CoreApplyRomSettings(settings);
 }
@@ -60,4 +60,15 @@ bool CoreApplyRomSettings(CoreRomSettings settings);
 // applies the ROM settings settings if they exist
 bool CoreApplyRomSettingsOverlay(void);
 
+#ifdef CORE_INTERNAL
+#include "m64p/api/m64p_types.h"
+
+// converts the mupen64plus ROM settings
+void CoreConvertRomSettings(const m64p_rom_settings& m64p_settings, CoreRomSettings& settings);
+
+// retrieves the ROM settings overlay for the given
+// default ROM settings, returns false when there's none
+bool CoreGetRomSettingsOverlay(const CoreRomSettings& defaultSettings, CoreRomSettings& settings);
+#endif // CORE_INTERNAL
+
 #endif // CORE_ROMSETTINGS_HPP
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "m64p/Api.hpp"
 
 #include <algorithm>
+#include <climits>
 
 //
 // Local Functions
@@ -300,3 +301,78 @@ CORE_EXPORT bool CoreLoadSaveState(std::filesystem::path file)
 
     return ret == M64ERR_SUCCESS;
 }
+
+CORE_EXPORT size_t CoreGetSaveStateMemorySize(void)
+{
+    std::string error;
+    m64p_error ret;
+    int size = 0;
+
+    if (!m64p::Core.IsHooked())
+    {
+        return 0;
+    }
+
+    ret = m64p::Core.DoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_STATE_MEMORY_SIZE, &size);
+    if (ret != M64ERR_SUCCESS)
+    {
+        error = "CoreGetSaveStateMemorySize: m64p::Core.DoCommand(M64CMD_CORE_STATE_QUERY) Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        CoreSetError(error);
+        return 0;
+    }
+
+    return static_cast<size_t>(size);
+}
+
+CORE_EXPORT bool CoreSaveStateToMemory(void* buffer, size_t size)
+{
+    std::string error;
+    m64p_error ret;
+
+    if (!m64p::Core.IsHooked())
+    {
+        return false;
+    }
+
+    ret = m64p::Core.DoCommand(M64CMD_STATE_SAVE_MEMORY, static_cast<int>(std::min(size, static_cast<size_t>(INT_MAX))), buffer);
+    if (ret != M64ERR_SUCCESS)
+    {
+        error = "CoreSaveStateToMemory: m64p::Core.DoCommand(M64CMD_STATE_SAVE_MEMORY) Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        if (ret == M64ERR_INVALID_STATE)
+        {
+            // the core refuses memory states during netplay
+            error += " (emulation isn't running or netplay is active)";
+        }
+        CoreSetError(error);
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
+
+CORE_EXPORT bool CoreLoadStateFromMemory(void* buffer, size_t size)
+{
+    std::string error;
+    m64p_error ret;
+
+    if (!m64p::Core.IsHooked())
+    {
+        return false;
+    }
+
+    ret = m64p::Core.DoCommand(M64CMD_STATE_LOAD_MEMORY, static_cast<int>(std::min(size, static_cast<size_t>(INT_MAX))), buffer);
+    if (ret != M64ERR_SUCCESS)
+    {
+        error = "CoreLoadStateFromMemory: m64p::Core.DoCommand(M64CMD_STATE_LOAD_MEMORY) Failed: ";
+        error += m64p::Core.ErrorMessage(ret);
+        if (ret == M64ERR_INVALID_STATE)
+        {
+            // the core refuses memory states during netplay
+            error += " (emulation isn't running or netplay is active)";
+        }
+        CoreSetError(error);
+    }
+
+    return ret == M64ERR_SUCCESS;
+}
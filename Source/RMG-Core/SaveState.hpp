@@ -56,4 +56,26 @@ bool CoreLoadSaveState(void);
 // loads saved state from file
 bool CoreLoadSaveState(std::filesystem::path file);
 
+// retrieves the size of the buffer which
+// is needed to save state to memory,
+// returns 0 on error
+size_t CoreGetSaveStateMemorySize(void);
+
+// saves state to the given buffer without
+// compression or allocating memory, the state
+// is written at the next safe point of the
+// emulation, which is before the next frame
+// starts when called from the frame callback,
+// completion is reported with
+// CoreStateCallbackType::MemoryStateSaved,
+// fails while netplay is active
+bool CoreSaveStateToMemory(void* buffer, size_t size);
+
+// loads saved state from the given buffer,
+// the state is loaded at the next safe point
+// of the emulation, completion is reported with
+// CoreStateCallbackType::MemoryStateLoaded,
+// fails while netplay is active
+bool CoreLoadStateFromMemory(void* buffer, size_t size);
+
 #endif // CORE_SAVESTATE_HPP
\ No newline at end of file
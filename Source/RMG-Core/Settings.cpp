@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <sstream>
 #include <variant>
+#include <mutex>
 
 //
 // Local Defines
@@ -43,6 +44,12 @@ struct l_Setting
     bool ForceUseSetAlways  = false;
 };
 
+struct l_CachedSetting
+{
+    uint32_t Version = 0;
+    std::variant<std::monostate, int, bool, float, std::string, std::vector<int>, std::vector<std::string>> Value;
+};
+
 //
 // Local Variables
 //
@@ -54,6 +61,14 @@ static std::vector<std::string> l_keyList;
 // Internal runtime settings (not persisted to config file)
 static bool l_InputPluginSwitchRequested = false;
 
+// values of the settings retrieved by their SettingsID,
+// an entry is only valid when its version matches
+// l_SettingsCacheVersion, which is incremented whenever
+// the config has been changed
+static std::mutex      l_SettingsCacheMutex;
+static uint32_t        l_SettingsCacheVersion = 1;
+static l_CachedSetting l_SettingsCache[static_cast<int>(SettingsID::Invalid)];
+
 //
 // Local Functions
 //
@@ -145,6 +160,9 @@ static l_Setting get_setting(SettingsID settingId)
     case SettingsID::GUI_OnScreenDisplayMaxMessages:
         setting = {SETTING_SECTION_GUI, "OnScreenDisplayMaxMessages", 5};
         break;
+    case SettingsID::GUI_OnScreenDisplayNetplayStats:
+        setting = {SETTING_SECTION_GUI, "OnScreenDisplayNetplayStats", false};
+        break;
     case SettingsID::GUI_AutoStartNetplayOnStartup:
         setting = {SETTING_SECTION_GUI, "AutoStartNetplayOnStartup", false};
         break;
@@ -191,6 +209,30 @@ static l_Setting get_setting(SettingsID settingId)
     case SettingsID::Netplay_SelectedServer:
         setting = {SETTING_SECTION_NETPLAY, "SelectedServer", std::string("")};
         break;
+    case SettingsID::Netplay_KailleraRollback:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraRollback", false};
+        break;
+    case SettingsID::Netplay_KailleraRollbackFrames:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraRollbackFrames", 7};
+        break;
+    case SettingsID::Netplay_KailleraStateHashLog:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraStateHashLog", false};
+        break;
+    case SettingsID::Netplay_KailleraReplayRecord:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraReplayRecord", false};
+        break;
+    case SettingsID::Netplay_KailleraAutoFrameDelay:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraAutoFrameDelay", false};
+        break;
+    case SettingsID::Netplay_KailleraTargetStallRate:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraTargetStallRate", 1};
+        break;
+    case SettingsID::Netplay_KailleraServer:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraServer", std::string("")};
+        break;
+    case SettingsID::Netplay_KailleraConnectionType:
+        setting = {SETTING_SECTION_NETPLAY, "KailleraConnectionType", 1};
+        break;
 
     case SettingsID::Core_GFX_Plugin:
         setting = {SETTING_SECTION_CORE, "GFX_Plugin", 
@@ -263,6 +305,18 @@ static l_Setting get_setting(SettingsID settingId)
     case SettingsID::Core_DisableSaveFileLoading:
         setting = {SETTING_SECTION_M64P, "DisableSaveFileLoading", false};
         break;
+    case SettingsID::Core_FramePacingClock:
+        setting = {SETTING_SECTION_M64P, "FramePacingClock", 0};
+        break;
+    case SettingsID::Core_FastForwardSpeedFactor:
+        setting = {SETTING_SECTION_M64P, "FastForwardSpeedFactor", 0};
+        break;
+    case SettingsID::Core_FastForwardFrameSkip:
+        setting = {SETTING_SECTION_M64P, "FastForwardFrameSkip", 4};
+        break;
+    case SettingsID::Core_FastForwardFrameSkipInterval:
+        setting = {SETTING_SECTION_M64P, "FastForwardFrameSkipInterval", 5};
+        break;
 
     case SettingsID::CoreOverlay_RandomizeInterrupt:
         setting = {SETTING_SECTION_OVERLAY, "RandomizeInterrupt", true};
@@ -428,6 +482,9 @@ static l_Setting get_setting(SettingsID settingId)
     case SettingsID::KeyBinding_LimitFPS:
         setting = {SETTING_SECTION_KEYBIND, "LimitFPS", std::string("F4")};
         break;
+    case SettingsID::KeyBinding_FastForward:
+        setting = {SETTING_SECTION_KEYBIND, "FastForward", std::string("Shift+F4")};
+        break;
     case SettingsID::KeyBinding_SpeedFactor25:
         setting = {SETTING_SECTION_KEYBIND, "SpeedFactor25", std::string("Alt+0")};
         break;
@@ -561,6 +618,9 @@ static l_Setting get_setting(SettingsID settingId)
     case SettingsID::RomBrowser_MaxItems:
         setting = {SETTING_SECTION_ROMBROWSER, "MaxItems", 2048};
         break;
+    case SettingsID::RomBrowser_ArchiveCacheSize:
+        setting = {SETTING_SECTION_ROMBROWSER, "ArchiveCacheSize", 1024};
+        break;
     case SettingsID::RomBrowser_ColumnVisibility:
         setting = {SETTING_SECTION_ROMBROWSER, "ColumnVisibility", std::string("1;1;1;0;0;0;0;0;0;")};
         break;
@@ -1455,6 +1515,63 @@ static l_Setting get_setting(SettingsID settingId)
     return setting;
 }
 
+static void invalidate_cached_settings(void)
+{
+    std::lock_guard<std::mutex> guard(l_SettingsCacheMutex);
+    l_SettingsCacheVersion++;
+}
+
+// retrieves the cached value of settingId, when it isn't
+// cached, version is set to the version which has to be
+// passed to set_cached_setting()
+template<typename T>
+static bool get_cached_setting(SettingsID settingId, T& value, uint32_t& version)
+{
+    const int index = static_cast<int>(settingId);
+    if (index < 0 || index >= static_cast<int>(SettingsID::Invalid))
+    {
+        version = 0;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(l_SettingsCacheMutex);
+    const l_CachedSetting& cachedSetting = l_SettingsCache[index];
+
+    if (cachedSetting.Version != l_SettingsCacheVersion ||
+        !std::holds_alternative<T>(cachedSetting.Value))
+    {
+        version = l_SettingsCacheVersion;
+        return false;
+    }
+
+    value = std::get<T>(cachedSetting.Value);
+    return true;
+}
+
+template<typename T>
+static void set_cached_setting(SettingsID settingId, const l_Setting& setting, const T& value, uint32_t version)
+{
+    // the core and the plugins change their own sections
+    // without going through us, so only cache our sections
+    if (version == 0 ||
+        !m64p::Config.IsHooked() ||
+        !setting.Section.starts_with(SETTING_SECTION_GUI))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(l_SettingsCacheMutex);
+
+    // don't cache the value when the config
+    // has been changed while retrieving it
+    if (version != l_SettingsCacheVersion)
+    {
+        return;
+    }
+
+    l_SettingsCache[static_cast<int>(settingId)] = { version, value };
+}
+
 static void config_listsections_callback(void*, const char* section)
 {
     l_sectionList.emplace_back(std::string(section));
@@ -1562,6 +1679,7 @@ static bool config_option_set(const std::string& section, const std::string& key
     }
 
     ret = m64p::Config.SetParameter(l_sectionHandle, key.c_str(), type, value);
+    invalidate_cached_settings();
     if (ret != M64ERR_SUCCESS)
     {
         error = "config_option_set m64p::Config.SetParameter Failed: ";
@@ -1648,6 +1766,8 @@ static bool config_option_default_set(const std::string& section, const std::str
         } break;
     }
 
+    invalidate_cached_settings();
+
     if (ret != M64ERR_SUCCESS)
     {
         CoreSetError(error);
@@ -1931,6 +2051,7 @@ CORE_EXPORT bool CoreSettingsRevertSection(std::string section)
     }
 
     ret = m64p::Config.RevertChanges(section.c_str());
+    invalidate_cached_settings();
     if (ret != M64ERR_SUCCESS)
     {
         error = "CoreSettingsRevertSection m64p::Config.RevertChanges() Failed: ";
@@ -1959,6 +2080,7 @@ CORE_EXPORT bool CoreSettingsDeleteSection(std::string section)
     }
 
     ret = m64p::Config.DeleteSection(section.c_str());
+    invalidate_cached_settings();
     if (ret != M64ERR_SUCCESS)
     {
         error = "CoreSettingsDeleteSection m64p::Config.DeleteSection() Failed: ";
@@ -1974,6 +2096,11 @@ CORE_EXPORT bool CoreSettingsKeyExists(std::string section, std::string key)
     return config_key_exists(section, key);
 }
 
+CORE_EXPORT void CoreSettingsInvalidateCache(void)
+{
+    invalidate_cached_settings();
+}
+
 CORE_EXPORT bool CoreSettingsSetValue(SettingsID settingId, int value)
 {
     l_Setting setting = get_setting(settingId);
@@ -2150,9 +2277,17 @@ CORE_EXPORT std::vector<int> CoreSettingsGetDefaultIntListValue(SettingsID setti
 
 CORE_EXPORT int CoreSettingsGetIntValue(SettingsID settingId)
 {
+    int value;
+    uint32_t version;
+    if (get_cached_setting(settingId, value, version))
+    {
+        return value;
+    }
+
     l_Setting setting = get_setting(settingId);
-    int value = setting.DefaultValue.index() == 0 ? 0 : std::get<int>(setting.DefaultValue);
+    value = setting.DefaultValue.index() == 0 ? 0 : std::get<int>(setting.DefaultValue);
     config_option_get(setting.Section, setting.Key, M64TYPE_INT, &value, sizeof(value));
+    set_cached_setting(settingId, setting, value, version);
     return value;
 }
 
@@ -2164,38 +2299,80 @@ CORE_EXPORT bool CoreSettingsGetBoolValue(SettingsID settingId)
         return l_InputPluginSwitchRequested;
     }
 
+    bool cachedValue;
+    uint32_t version;
+    if (get_cached_setting(settingId, cachedValue, version))
+    {
+        return cachedValue;
+    }
+
     l_Setting setting = get_setting(settingId);
     int value = setting.DefaultValue.index() == 0 ? 0 : (std::get<bool>(setting.DefaultValue) ? 1 : 0);
     config_option_get(setting.Section, setting.Key, M64TYPE_BOOL, &value, sizeof(value));
+    set_cached_setting(settingId, setting, value > 0, version);
     return value > 0;
 }
 
 CORE_EXPORT float CoreSettingsGetFloatValue(SettingsID settingId)
 {
+    float value;
+    uint32_t version;
+    if (get_cached_setting(settingId, value, version))
+    {
+        return value;
+    }
+
     l_Setting setting = get_setting(settingId);
-    float value = setting.DefaultValue.index() == 0 ? 0.0f : std::get<float>(setting.DefaultValue);
+    value = setting.DefaultValue.index() == 0 ? 0.0f : std::get<float>(setting.DefaultValue);
     config_option_get(setting.Section, setting.Key, M64TYPE_FLOAT, &value, sizeof(value));
+    set_cached_setting(settingId, setting, value, version);
     return value;
 }
 
 CORE_EXPORT std::string CoreSettingsGetStringValue(SettingsID settingId)
 {
+    std::string cachedValue;
+    uint32_t version;
+    if (get_cached_setting(settingId, cachedValue, version))
+    {
+        return cachedValue;
+    }
+
     l_Setting setting = get_setting(settingId);
     char value[STR_SIZE] = {0};
     config_option_get(setting.Section, setting.Key, M64TYPE_STRING, value, sizeof(value));
+    set_cached_setting(settingId, setting, std::string(value), version);
     return std::string(value);
 }
 
 CORE_EXPORT std::vector<int> CoreSettingsGetIntListValue(SettingsID settingId)
 {
+    std::vector<int> value;
+    uint32_t version;
+    if (get_cached_setting(settingId, value, version))
+    {
+        return value;
+    }
+
     l_Setting setting = get_setting(settingId);
-    return CoreSettingsGetIntListValue(settingId, setting.Section);
+    value = CoreSettingsGetIntListValue(settingId, setting.Section);
+    set_cached_setting(settingId, setting, value, version);
+    return value;
 }
 
 CORE_EXPORT std::vector<std::string> CoreSettingsGetStringListValue(SettingsID settingId)
 {
+    std::vector<std::string> value;
+    uint32_t version;
+    if (get_cached_setting(settingId, value, version))
+    {
+        return value;
+    }
+
     l_Setting setting = get_setting(settingId);
-    return CoreSettingsGetStringListValue(settingId, setting.Section);
+    value = CoreSettingsGetStringListValue(settingId, setting.Section);
+    set_cached_setting(settingId, setting, value, version);
+    return value;
 }
 
 CORE_EXPORT int CoreSettingsGetIntValue(SettingsID settingId, std::string section)
@@ -34,6 +34,7 @@ enum class SettingsID
     GUI_OnScreenDisplayDuration,
     GUI_OnScreenDisplayScale,
     GUI_OnScreenDisplayMaxMessages,
+    GUI_OnScreenDisplayNetplayStats,
     GUI_AutoStartNetplayOnStartup,
     GUI_Toolbar,
     GUI_ToolbarArea,
@@ -51,6 +52,14 @@ enum class SettingsID
     Netplay_ServerJsonUrl,
     Netplay_DispatcherUrl,
     Netplay_SelectedServer,
+    Netplay_KailleraRollback,
+    Netplay_KailleraRollbackFrames,
+    Netplay_KailleraStateHashLog,
+    Netplay_KailleraReplayRecord,
+    Netplay_KailleraAutoFrameDelay,
+    Netplay_KailleraTargetStallRate,
+    Netplay_KailleraServer,
+    Netplay_KailleraConnectionType,
 
     // Core Plugin Settings
     Core_GFX_Plugin,
@@ -91,6 +100,10 @@ enum class SettingsID
     Core_SaveFileNameFormat,
     Core_GbCameraVideoCaptureBackend1,
     Core_DisableSaveFileLoading,
+    Core_FramePacingClock,
+    Core_FastForwardSpeedFactor,
+    Core_FastForwardFrameSkip,
+    Core_FastForwardFrameSkipInterval,
 
     // (mupen64plus) Overlay Core Settings
     CoreOverlay_RandomizeInterrupt,
@@ -140,6 +153,7 @@ enum class SettingsID
     KeyBinding_Resume,
     KeyBinding_Screenshot,
     KeyBinding_LimitFPS,
+    KeyBinding_FastForward,
     KeyBinding_SpeedFactor25,
     KeyBinding_SpeedFactor50,
     KeyBinding_SpeedFactor75,
@@ -186,6 +200,7 @@ enum class SettingsID
     RomBrowser_Maximized,
     RomBrowser_Recursive,
     RomBrowser_MaxItems,
+    RomBrowser_ArchiveCacheSize,
     RomBrowser_ColumnVisibility,
     RomBrowser_ColumnOrder,
     RomBrowser_ColumnSizes,
@@ -516,6 +531,10 @@ bool CoreSettingsDeleteSection(std::string section);
 // returns whether a key in the given section exists
 bool CoreSettingsKeyExists(std::string section, std::string key);
 
+// drops the cached settings, the getters which take a SettingsID
+// cache the retrieved values until the config has been changed
+void CoreSettingsInvalidateCache(void);
+
 // sets setting as int value
 bool CoreSettingsSetValue(SettingsID settingId, int value);
 // sets setting as bool value
@@ -0,0 +1,274 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define CORE_INTERNAL
+#include "StateHash.hpp"
+#include "RomHeader.hpp"
+#include "Library.hpp"
+#include "Error.hpp"
+
+#include "m64p/Api.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <atomic>
+
+//
+// Local Defines
+//
+
+#define STATEHASH_FILE_MAGIC "RMGCoreStateHashLog_1"
+
+// amount of frames after which the log is flushed
+#define STATEHASH_FLUSH_FRAMES 600
+
+//
+// Local Structures
+//
+
+struct l_FrameHash
+{
+    bool     Present = false;
+    uint64_t Cpu     = 0;
+    uint64_t Rsp     = 0;
+    uint64_t Rdram   = 0;
+};
+
+typedef void (*sync_snapshot_hash_t)(uint64_t* cpu, uint64_t* rsp, uint64_t* rdram);
+
+//
+// Local Variables
+//
+
+static std::atomic<bool> l_Active = false;
+static std::filesystem::path l_LogPath;
+static std::ofstream l_LogStream;
+
+static sync_snapshot_hash_t l_sync_snapshot_hash = nullptr;
+
+static uint32_t l_Frame = 0;
+
+//
+// Local Functions
+//
+
+static void write_frame_hash(uint32_t frame, const l_FrameHash& hash)
+{
+#define FWRITE(x) l_LogStream.write((char*)&x, sizeof(x))
+    FWRITE(frame);
+    FWRITE(hash.Cpu);
+    FWRITE(hash.Rsp);
+    FWRITE(hash.Rdram);
+#undef FWRITE
+}
+
+static bool read_log(std::filesystem::path file, uint32_t& crc1, uint32_t& crc2, std::vector<l_FrameHash>& hashes)
+{
+    std::ifstream inputStream;
+    char magicBuf[sizeof(STATEHASH_FILE_MAGIC)];
+    uint32_t frame;
+    l_FrameHash hash;
+
+    inputStream.open(file, std::ios::binary);
+    if (!inputStream.is_open())
+    {
+        CoreSetError("CoreCompareStateHashLogs: failed to open " + file.string());
+        return false;
+    }
+
+#define FREAD(x) inputStream.read((char*)&x, sizeof(x))
+    inputStream.read(magicBuf, sizeof(magicBuf));
+    FREAD(crc1);
+    FREAD(crc2);
+    if (!inputStream || std::memcmp(magicBuf, STATEHASH_FILE_MAGIC, sizeof(magicBuf)) != 0)
+    {
+        CoreSetError("CoreCompareStateHashLogs: " + file.string() + " isn't a state hash log");
+        return false;
+    }
+
+    while (FREAD(frame) && FREAD(hash.Cpu) && FREAD(hash.Rsp) && FREAD(hash.Rdram))
+    {
+        if (frame >= hashes.size())
+        {
+            hashes.resize(static_cast<size_t>(frame) + 1);
+        }
+
+        // frames which were simulated again replace the earlier entry
+        hash.Present  = true;
+        hashes[frame] = hash;
+    }
+#undef FREAD
+
+    return true;
+}
+
+//
+// Internal Functions
+//
+
+bool CoreStartStateHashLog(std::filesystem::path file)
+{
+    CoreRomHeader header;
+
+    if (l_Active)
+    {
+        CoreStopStateHashLog();
+    }
+
+    CoreLibraryHandle handle = (CoreLibraryHandle)m64p::Core.GetHandle();
+    if (handle == nullptr)
+    {
+        CoreSetError("CoreStartStateHashLog: core isn't loaded");
+        return false;
+    }
+
+    l_sync_snapshot_hash = (sync_snapshot_hash_t)CoreGetLibrarySymbol(handle, "sync_snapshot_hash");
+    if (l_sync_snapshot_hash == nullptr)
+    {
+        CoreSetError("CoreStartStateHashLog: core doesn't support sync snapshots");
+        return false;
+    }
+
+    if (!CoreGetCurrentRomHeader(header))
+    {
+        return false;
+    }
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(file.parent_path(), errorCode);
+
+    l_LogStream.open(file, std::ios::binary | std::ios::trunc);
+    if (!l_LogStream.is_open())
+    {
+        CoreSetError("CoreStartStateHashLog: failed to open " + file.string());
+        return false;
+    }
+
+    l_LogStream.write((char*)STATEHASH_FILE_MAGIC, sizeof(STATEHASH_FILE_MAGIC));
+    l_LogStream.write((char*)&header.CRC1, sizeof(header.CRC1));
+    l_LogStream.write((char*)&header.CRC2, sizeof(header.CRC2));
+
+    l_LogPath = file;
+    l_Frame   = 0;
+    l_Active  = true;
+    return true;
+}
+
+void CoreStopStateHashLog(void)
+{
+    if (!l_Active)
+    {
+        return;
+    }
+
+    l_Active = false;
+    l_LogStream.close();
+}
+
+void CoreStateHashFrame(void)
+{
+    l_FrameHash hash;
+    uint32_t frame;
+
+    if (!l_Active)
+    {
+        return;
+    }
+
+    // the core hashes the state in place, copying
+    // RDRAM first would cost more than hashing it
+    l_sync_snapshot_hash(&hash.Cpu, &hash.Rsp, &hash.Rdram);
+
+    frame = l_Frame++;
+    write_frame_hash(frame, hash);
+    if ((frame % STATEHASH_FLUSH_FRAMES) == 0)
+    {
+        l_LogStream.flush();
+    }
+}
+
+uint32_t CoreGetStateHashFrame(void)
+{
+    return l_Frame;
+}
+
+void CoreSetStateHashFrame(uint32_t frame)
+{
+    l_Frame = frame;
+}
+
+//
+// Exported Functions
+//
+
+CORE_EXPORT bool CoreIsStateHashLogActive(void)
+{
+    return l_Active;
+}
+
+CORE_EXPORT bool CoreGetStateHashLogPath(std::filesystem::path& path)
+{
+    if (!l_Active)
+    {
+        return false;
+    }
+
+    path = l_LogPath;
+    return true;
+}
+
+CORE_EXPORT bool CoreCompareStateHashLogs(std::filesystem::path file1, std::filesystem::path file2, CoreStateHashDivergence& divergence)
+{
+    std::vector<l_FrameHash> hashes1;
+    std::vector<l_FrameHash> hashes2;
+    uint32_t crc1[2] = {0};
+    uint32_t crc2[2] = {0};
+
+    if (!read_log(file1, crc1[0], crc2[0], hashes1) ||
+        !read_log(file2, crc1[1], crc2[1], hashes2))
+    {
+        return false;
+    }
+
+    if (crc1[0] != crc1[1] || crc2[0] != crc2[1])
+    {
+        CoreSetError("CoreCompareStateHashLogs: logs are of different ROMs");
+        return false;
+    }
+
+    divergence = CoreStateHashDivergence();
+
+    size_t frames = std::min(hashes1.size(), hashes2.size());
+    for (size_t frame = 0; frame < frames; frame++)
+    {
+        const l_FrameHash& hash1 = hashes1[frame];
+        const l_FrameHash& hash2 = hashes2[frame];
+
+        if (!hash1.Present || !hash2.Present)
+        {
+            continue;
+        }
+
+        divergence.ComparedFrames++;
+        divergence.Cpu   = hash1.Cpu   != hash2.Cpu;
+        divergence.Rsp   = hash1.Rsp   != hash2.Rsp;
+        divergence.Rdram = hash1.Rdram != hash2.Rdram;
+
+        if (divergence.Cpu || divergence.Rsp || divergence.Rdram)
+        {
+            divergence.Found = true;
+            divergence.Frame = static_cast<uint32_t>(frame);
+            return true;
+        }
+    }
+
+    return true;
+}
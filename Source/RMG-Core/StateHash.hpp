@@ -0,0 +1,64 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_STATEHASH_HPP
+#define CORE_STATEHASH_HPP
+
+#include <filesystem>
+#include <cstdint>
+
+//
+// Per-frame hashes of the emulated state, the core hashes the
+// state in place on the emulation thread, the hashes are written
+// to a log which can be compared with the log of another player
+// to find the first frame which desynced
+//
+
+struct CoreStateHashDivergence
+{
+    bool     Found          = false; // whether a frame differs
+    uint32_t Frame          = 0;     // first frame which differs
+    bool     Cpu            = false; // CPU, CP0 or FPU registers differ
+    bool     Rsp            = false; // RSP DMEM differs
+    bool     Rdram          = false; // RDRAM differs
+    uint32_t ComparedFrames = 0;     // frames which are in both logs
+};
+
+#ifdef CORE_INTERNAL
+// starts hashing the state of every frame,
+// the hashes are written to file
+bool CoreStartStateHashLog(std::filesystem::path file);
+
+// stops hashing and closes the log
+void CoreStopStateHashLog(void);
+
+// hashes the state of the next frame,
+// has to be called from the frame callback
+void CoreStateHashFrame(void);
+
+// retrieves the frame which is hashed next
+uint32_t CoreGetStateHashFrame(void);
+
+// sets the frame which is hashed next, used
+// when a snapshot of an earlier frame is restored
+void CoreSetStateHashFrame(uint32_t frame);
+#endif // CORE_INTERNAL
+
+// returns whether the state is being hashed
+bool CoreIsStateHashLogActive(void);
+
+// retrieves the path of the current log
+bool CoreGetStateHashLogPath(std::filesystem::path& path);
+
+// compares two logs, frames which were logged more than once
+// (because they were simulated again after a rollback) use
+// the hashes which were logged last
+bool CoreCompareStateHashLogs(std::filesystem::path file1, std::filesystem::path file2, CoreStateHashDivergence& divergence);
+
+#endif // CORE_STATEHASH_HPP
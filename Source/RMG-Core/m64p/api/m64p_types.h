@@ -139,6 +139,9 @@ typedef enum {
   M64CORE_STATE_LOADCOMPLETE,
   M64CORE_STATE_SAVECOMPLETE,
   M64CORE_SCREENSHOT_CAPTURED,
+  M64CORE_STATE_MEMORY_LOADCOMPLETE,
+  M64CORE_STATE_MEMORY_SAVECOMPLETE,
+  M64CORE_STATE_MEMORY_SIZE
 } m64p_core_param;
 
 typedef enum {
@@ -171,7 +174,9 @@ typedef enum {
   M64CMD_PIF_OPEN,
   M64CMD_ROM_SET_SETTINGS,
   M64CMD_DISK_OPEN,
-  M64CMD_DISK_CLOSE
+  M64CMD_DISK_CLOSE,
+  M64CMD_STATE_LOAD_MEMORY,
+  M64CMD_STATE_SAVE_MEMORY
 } m64p_command;
 
 typedef struct {
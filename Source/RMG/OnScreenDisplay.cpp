@@ -9,10 +9,13 @@
  */
 #include "OnScreenDisplay.hpp"
 
+#include <RMG-Core/NetplayTelemetry.hpp>
+#include <RMG-Core/KailleraDelay.hpp>
 #include <RMG-Core/Settings.hpp>
 
 #include <backends/imgui_impl_opengl3.h>
 #include <imgui.h>
+#include <cstdio>
 #include <cmath>
 #include <chrono>
 #include <deque>
@@ -56,6 +59,10 @@ static size_t      l_KailleraChatMaxMessages = 5;
 static bool        l_FontsDirty      = true;
 static const float l_BaseFontSize    = 13.0f;
 
+static bool        l_NetplayStatsEnabled = false;
+static std::string l_NetplayStatsText;
+static std::chrono::time_point<std::chrono::high_resolution_clock> l_NetplayStatsTime;
+
 static void OnScreenDisplayUpdateFonts(void)
 {
     if (!l_FontsDirty)
@@ -76,6 +83,53 @@ static void OnScreenDisplayUpdateFonts(void)
     l_FontsDirty = false;
 }
 
+static void OnScreenDisplayUpdateNetplayStats(std::chrono::time_point<std::chrono::high_resolution_clock> currentTime)
+{
+    CoreNetplayTelemetryStats stats;
+    CoreKailleraDelayStats delayStats;
+    char buffer[256];
+
+    if (!l_NetplayStatsEnabled)
+    {
+        l_NetplayStatsText.clear();
+        return;
+    }
+
+    // computing the percentiles every frame is wasteful
+    if ((currentTime - l_NetplayStatsTime) < std::chrono::milliseconds(500))
+    {
+        return;
+    }
+    l_NetplayStatsTime = currentTime;
+
+    if (!CoreGetNetplayTelemetryStats(stats))
+    {
+        l_NetplayStatsText.clear();
+        return;
+    }
+
+    std::snprintf(buffer, sizeof(buffer),
+        "Input wait: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms\n"
+        "Stalls: %u/%u frames, buffered: %u, errors: %u\n"
+        "Frame time: %.2f ms, stddev %.2f ms (%.2f ms without waits)",
+        stats.StallP50, stats.StallP95, stats.StallP99, stats.StallMax,
+        stats.StallFrames, stats.Frames, stats.BufferedFrames, stats.ErrorFrames,
+        stats.FrameTimeMean, stats.FrameTimeStdDev, stats.FrameTimeStdDevWithoutStalls);
+    l_NetplayStatsText = buffer;
+
+    // the delay statistics are only there once
+    // a round trip time has been measured
+    if (CoreGetKailleraDelayStats(delayStats))
+    {
+        std::snprintf(buffer, sizeof(buffer),
+            "\nRound trip: %.1f ms, jitter %.1f ms, stall rate %.1f%%\n"
+            "Frame delay: %d (recommended %d)",
+            delayStats.RoundTripTime, delayStats.Jitter, delayStats.StallRate * 100.0,
+            delayStats.FrameDelay, delayStats.RecommendedFrameDelay);
+        l_NetplayStatsText += buffer;
+    }
+}
+
 //
 // Exported Functions
 //
@@ -139,6 +193,7 @@ void OnScreenDisplayLoadSettings(void)
         maxChatMessages = 1;
     }
     l_KailleraChatMaxMessages = static_cast<size_t>(maxChatMessages);
+    l_NetplayStatsEnabled = CoreSettingsGetBoolValue(SettingsID::GUI_OnScreenDisplayNetplayStats);
 
     std::vector<int> backgroundColor = CoreSettingsGetIntListValue(SettingsID::GUI_OnScreenDisplayBackgroundColor);
     std::vector<int> textColor       = CoreSettingsGetIntListValue(SettingsID::GUI_OnScreenDisplayTextColor);
@@ -255,9 +310,12 @@ void OnScreenDisplayRender(void)
         l_MessageQueue.pop_front();
     }
 
-    const bool hasMessages = l_Enabled && !l_MessageQueue.empty();
+    OnScreenDisplayUpdateNetplayStats(currentTime);
+
+    const bool hasMessages     = l_Enabled && !l_MessageQueue.empty();
+    const bool hasNetplayStats = l_Enabled && !l_NetplayStatsText.empty();
 
-    if (!hasMessages)
+    if (!hasMessages && !hasNetplayStats)
     {
         return;
     }
@@ -331,6 +389,18 @@ void OnScreenDisplayRender(void)
         offsetY += windowSize.y * stackSpacingFactor;
     }
 
+    // netplay statistics are shown in the
+    // opposite corner of the messages
+    if (hasNetplayStats)
+    {
+        const bool anchorRight = (l_MessagePosition == 0 || l_MessagePosition == 1);
+        const float statsX = anchorRight ? (io.DisplaySize.x - l_MessagePaddingX) : l_MessagePaddingX;
+        ImGui::SetNextWindowPos(ImVec2(statsX, baseY), ImGuiCond_Always, ImVec2(anchorRight ? 1.0f : 0.0f, pivot.y));
+        ImGui::Begin("OSD Netplay Statistics", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoFocusOnAppearing);
+        ImGui::Text("%s", l_NetplayStatsText.c_str());
+        ImGui::End();
+    }
+
     ImGui::PopStyleColor(2);
 
     ImGui::Render();
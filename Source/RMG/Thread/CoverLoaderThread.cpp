@@ -0,0 +1,326 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "CoverLoaderThread.hpp"
+
+#include <QCryptographicHash>
+#include <QImageReader>
+#include <QThreadPool>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+
+using namespace Thread;
+
+//
+// Local Defines
+//
+
+// thumbnails which are older or over the size limit
+// are removed, they're created again when needed
+#define THUMBNAIL_MAX_AGE_DAYS       90
+#define THUMBNAIL_DIRECTORY_SIZE_MAX (256 * 1024 * 1024) /* 256 MiB */
+
+//
+// Local Functions
+//
+
+static QString get_cover_file_key(const QString& fileName)
+{
+    // file names are case insensitive on windows
+#ifdef _WIN32
+    return fileName.toLower();
+#else
+    return fileName;
+#endif // _WIN32
+}
+
+CoverLoaderThread::CoverLoaderThread(QObject *parent) : QThread(parent)
+{
+}
+
+CoverLoaderThread::~CoverLoaderThread(void)
+{
+    this->Stop();
+}
+
+void CoverLoaderThread::SetCoversDirectory(QString directory)
+{
+    QMutexLocker locker(&this->requestsMutex);
+    this->coversDirectory = directory;
+}
+
+void CoverLoaderThread::SetThumbnailDirectory(QString directory)
+{
+    QMutexLocker locker(&this->requestsMutex);
+    this->thumbnailDirectory = directory;
+}
+
+void CoverLoaderThread::SetThumbnailSize(QSize size)
+{
+    QMutexLocker locker(&this->requestsMutex);
+    this->thumbnailSize = size;
+}
+
+void CoverLoaderThread::AddRequest(QString file, QStringList names)
+{
+    QMutexLocker locker(&this->requestsMutex);
+    this->requests.append({ file, names });
+    this->requestsCondition.wakeOne();
+}
+
+void CoverLoaderThread::ClearRequests(void)
+{
+    QMutexLocker locker(&this->requestsMutex);
+    this->requests.clear();
+    this->generation++;
+}
+
+void CoverLoaderThread::Stop(void)
+{
+    {
+        QMutexLocker locker(&this->requestsMutex);
+        this->stop = true;
+        this->requestsCondition.wakeAll();
+    }
+
+    while (this->isRunning())
+    {
+        this->wait();
+    }
+}
+
+void CoverLoaderThread::run(void)
+{
+    this->stop = false;
+
+    while (!this->stop)
+    {
+        QList<Request> batch;
+        QString coversDirectory;
+        QString thumbnailDirectory;
+        QSize   thumbnailSize;
+        int     batchGeneration;
+
+        {
+            QMutexLocker locker(&this->requestsMutex);
+            while (!this->stop && this->requests.isEmpty())
+            {
+                this->requestsCondition.wait(&this->requestsMutex);
+            }
+
+            batch.swap(this->requests);
+            coversDirectory    = this->coversDirectory;
+            thumbnailDirectory = this->thumbnailDirectory;
+            thumbnailSize      = this->thumbnailSize;
+            batchGeneration    = this->generation;
+        }
+
+        if (this->stop)
+        {
+            break;
+        }
+
+        this->updateCoverFiles(coversDirectory);
+        QDir().mkpath(thumbnailDirectory);
+
+        // thumbnails of changed or removed covers are
+        // never used again, so prune the directory once
+        if (thumbnailDirectory != this->prunedThumbnailDirectory)
+        {
+            this->pruneThumbnails(thumbnailDirectory);
+            this->prunedThumbnailDirectory = thumbnailDirectory;
+        }
+
+        // our cover data, filled by the workers
+        QList<CoverLoaderThreadData> data;
+        QMutex dataMutex;
+
+        std::atomic<int> nextRequestIndex = 0;
+
+        // decoding and scaling the covers is the expensive
+        // part, so spread the covers over a thread per core
+        auto worker = [&]()
+        {
+            int index;
+
+            while (!this->stop && this->generation == batchGeneration &&
+                    (index = nextRequestIndex++) < batch.size())
+            {
+                const Request& request = batch.at(index);
+                CoverLoaderThreadData coverData;
+                QFileInfo coverFile;
+
+                coverData.File = request.File;
+
+                if (this->findCoverFile(request.Names, coverFile) &&
+                    this->loadCover(coverFile, thumbnailDirectory, thumbnailSize, coverData.Image))
+                {
+                    coverData.CoverFile = coverFile.filePath();
+                }
+
+                QMutexLocker locker(&dataMutex);
+                data.append(coverData);
+            }
+        };
+
+        auto sendData = [&]()
+        {
+            QList<CoverLoaderThreadData> loadedData;
+            {
+                QMutexLocker locker(&dataMutex);
+                loadedData.swap(data);
+            }
+
+            if (!loadedData.isEmpty() && this->generation == batchGeneration)
+            {
+                emit this->CoversLoaded(loadedData);
+            }
+        };
+
+        QThreadPool threadPool;
+        const int threadCount = std::max(1, std::min(QThread::idealThreadCount(), static_cast<int>(batch.size())));
+        threadPool.setMaxThreadCount(threadCount);
+        for (int i = 0; i < threadCount; i++)
+        {
+            threadPool.start(worker);
+        }
+
+        // send the covers to the UI in batches,
+        // so it doesn't have to update the view
+        // for every single cover
+        while (!threadPool.waitForDone(50))
+        {
+            sendData();
+        }
+
+        sendData();
+    }
+}
+
+void CoverLoaderThread::updateCoverFiles(const QString& coversDirectory)
+{
+    QFileInfo directoryInfo(coversDirectory);
+    QDateTime directoryTime = directoryInfo.lastModified();
+
+    // adding or removing covers changes the
+    // modification time of the directory
+    if (!this->coverFiles.isEmpty() &&
+        directoryTime == this->coverFilesTime)
+    {
+        return;
+    }
+
+    this->coverFiles.clear();
+    this->coverFilesTime = directoryTime;
+
+    QDir directory(coversDirectory);
+    const QFileInfoList fileInfoList = directory.entryInfoList({ "*.png", "*.jpg", "*.jpeg" }, QDir::Files);
+    for (const QFileInfo& fileInfo : fileInfoList)
+    {
+        this->coverFiles.insert(get_cover_file_key(fileInfo.fileName()), fileInfo);
+    }
+}
+
+bool CoverLoaderThread::findCoverFile(const QStringList& names, QFileInfo& coverFile)
+{
+    for (const QString& name : names)
+    {
+        // we support jpg & png as file extensions
+        for (const QString& ext : { ".png", ".jpg", ".jpeg" })
+        {
+            auto iter = this->coverFiles.constFind(get_cover_file_key(name + ext));
+            if (iter != this->coverFiles.cend())
+            {
+                coverFile = iter.value();
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void CoverLoaderThread::pruneThumbnails(const QString& thumbnailDirectory)
+{
+    QDir directory(thumbnailDirectory);
+    QDateTime oldestTime = QDateTime::currentDateTime().addDays(-THUMBNAIL_MAX_AGE_DAYS);
+    qint64 totalSize = 0;
+
+    // newest first, so the oldest thumbnails
+    // are the ones over the size limit
+    const QFileInfoList fileInfoList = directory.entryInfoList({ "*.png" }, QDir::Files, QDir::Time);
+    for (const QFileInfo& fileInfo : fileInfoList)
+    {
+        totalSize += fileInfo.size();
+        if (fileInfo.lastModified() < oldestTime ||
+            totalSize > THUMBNAIL_DIRECTORY_SIZE_MAX)
+        {
+            QFile::remove(fileInfo.filePath());
+        }
+    }
+}
+
+bool CoverLoaderThread::loadCover(const QFileInfo& cachedCoverFile, const QString& thumbnailDirectory, const QSize& thumbnailSize, QImage& image)
+{
+    // the directory listing doesn't change when a cover
+    // is overwritten, so retrieve the file's own info
+    QFileInfo coverFile(cachedCoverFile);
+    coverFile.refresh();
+
+    // the thumbnail is keyed by the cover file,
+    // its modification time and the thumbnail size,
+    // so changed covers get a new thumbnail
+    QByteArray key = coverFile.filePath().toUtf8();
+    key += '\0';
+    key += QByteArray::number(coverFile.lastModified().toMSecsSinceEpoch());
+    key += '\0';
+    key += QByteArray::number(coverFile.size());
+    key += '\0';
+    key += QByteArray::number(thumbnailSize.width());
+    key += 'x';
+    key += QByteArray::number(thumbnailSize.height());
+
+    QString thumbnailFile = thumbnailDirectory;
+    thumbnailFile += '/';
+    thumbnailFile += QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex());
+    thumbnailFile += ".png";
+
+    if (image.load(thumbnailFile))
+    {
+        return true;
+    }
+
+    QImageReader reader(coverFile.filePath());
+    QSize size = reader.size();
+    if (size.isValid() && thumbnailSize.isValid() &&
+        (size.width() > thumbnailSize.width() || size.height() > thumbnailSize.height()))
+    {
+        // some decoders (i.e jpeg) can decode at a
+        // lower resolution directly, which is a lot
+        // faster than decoding the full image
+        reader.setScaledSize(size.scaled(thumbnailSize, Qt::KeepAspectRatio));
+    }
+
+    if (!reader.read(&image))
+    {
+        return false;
+    }
+
+    // QSaveFile writes to a temporary file first,
+    // so a partially written thumbnail is never loaded
+    QSaveFile saveFile(thumbnailFile);
+    if (saveFile.open(QIODevice::WriteOnly) &&
+        image.save(&saveFile, "PNG"))
+    {
+        saveFile.commit();
+    }
+
+    return true;
+}
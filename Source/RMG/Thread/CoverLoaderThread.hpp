@@ -0,0 +1,97 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef COVERLOADERTHREAD_HPP
+#define COVERLOADERTHREAD_HPP
+
+#include <QWaitCondition>
+#include <QStringList>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QString>
+#include <QThread>
+#include <QMutex>
+#include <QImage>
+#include <QHash>
+#include <QSize>
+
+#include <atomic>
+
+struct CoverLoaderThreadData
+{
+    QString File;
+    // empty when no cover has been found
+    QString CoverFile;
+    QImage  Image;
+};
+
+namespace Thread
+{
+class CoverLoaderThread : public QThread
+{
+    Q_OBJECT
+
+  public:
+    CoverLoaderThread(QObject *);
+    ~CoverLoaderThread(void);
+
+    void SetCoversDirectory(QString);
+    void SetThumbnailDirectory(QString);
+    void SetThumbnailSize(QSize);
+
+    // queues loading the cover of file, the names are tried
+    // in order with the supported image extensions
+    void AddRequest(QString file, QStringList names);
+    // drops the queued requests
+    void ClearRequests(void);
+    void Stop(void);
+
+    void run(void) override;
+
+  private:
+    struct Request
+    {
+        QString     File;
+        QStringList Names;
+    };
+
+    QString coversDirectory;
+    QString thumbnailDirectory;
+    QSize   thumbnailSize;
+
+    QList<Request> requests;
+    QMutex         requestsMutex;
+    QWaitCondition requestsCondition;
+
+    std::atomic<bool> stop = false;
+    // incremented by ClearRequests(),
+    // so the workers can drop the current batch
+    std::atomic<int>  generation = 0;
+
+    // the contents of the covers directory, so
+    // we don't have to check whether each possible
+    // cover file exists, only accessed by run()
+    QHash<QString, QFileInfo> coverFiles;
+    QDateTime                 coverFilesTime;
+
+    // the thumbnail directory which has been
+    // pruned already, only accessed by run()
+    QString prunedThumbnailDirectory;
+
+    void updateCoverFiles(const QString& coversDirectory);
+    bool findCoverFile(const QStringList& names, QFileInfo& coverFile);
+    void pruneThumbnails(const QString& thumbnailDirectory);
+    bool loadCover(const QFileInfo& coverFile, const QString& thumbnailDirectory, const QSize& thumbnailSize, QImage& image);
+
+  signals:
+    void CoversLoaded(QList<CoverLoaderThreadData> data);
+};
+} // namespace Thread
+
+#endif // COVERLOADERTHREAD_HPP
@@ -11,8 +11,9 @@
 
 #include <RMG-Core/CachedRomHeaderAndSettings.hpp>
 
-#include <QElapsedTimer>
 #include <QDirIterator>
+#include <QThreadPool>
+#include <QMutex>
 
 using namespace Thread;
 
@@ -34,6 +35,11 @@ void RomSearcherThread::SetDirectory(QString directory)
     this->directory = directory;
 }
 
+void RomSearcherThread::SetFiles(QStringList files)
+{
+    this->files = files;
+}
+
 void RomSearcherThread::SetRecursive(bool value)
 {
     this->recursive = value;
@@ -56,10 +62,21 @@ void RomSearcherThread::Stop(void)
 void RomSearcherThread::run(void)
 {
     this->stop = false;
-    this->searchDirectory(this->directory);
+
+    // when files have been given, only
+    // retrieve those instead of searching
+    // the directory
+    if (!this->files.isEmpty())
+    {
+        this->searchFiles(this->files);
+    }
+    else
+    {
+        this->searchDirectory(this->directory);
+    }
 }
 
-void RomSearcherThread::searchDirectory(QString directory)
+QStringList RomSearcherThread::GetFileFilter(void)
 {
     QStringList filter;
     filter << "*.N64";
@@ -69,17 +86,15 @@ void RomSearcherThread::searchDirectory(QString directory)
     filter << "*.D64";
     filter << "*.ZIP";
     filter << "*.7Z";
+    return filter;
+}
 
+void RomSearcherThread::searchDirectory(QString directory)
+{
     QDirIterator::IteratorFlag flag = this->recursive ? 
         QDirIterator::Subdirectories : 
         QDirIterator::NoIteratorFlags;
-    QDirIterator romDirIt(directory, filter, QDir::Files, flag);
-
-    CoreRomType     type;
-    CoreRomHeader   header;
-    CoreRomSettings defaultSettings;
-    CoreRomSettings settings;
-    bool            ret;
+    QDirIterator romDirIt(directory, GetFileFilter(), QDir::Files, flag);
 
     QList<QString> roms;
     while (romDirIt.hasNext())
@@ -87,56 +102,84 @@ void RomSearcherThread::searchDirectory(QString directory)
         roms.push_back(romDirIt.next());
     }
 
+    this->searchFiles(roms);
+}
+
+void RomSearcherThread::searchFiles(QList<QString> roms)
+{
     const int romAmount = std::min(this->maxItems, (int)roms.size());
 
-    // our ROM data
+    // our ROM data, filled by the workers
     QList<RomSearcherThreadData> data;
+    QMutex dataMutex;
 
-    // keep track of the time
-    QElapsedTimer timer;
-    timer.start();
+    std::atomic<int> nextRomIndex = 0;
+    std::atomic<int> romsDone     = 0;
 
-    for (int i = 0; i < romAmount; i++)
+    // retrieving the header & settings of ROMs which
+    // aren't cached yet is mostly I/O and hashing,
+    // so spread the ROMs over a thread per core
+    auto worker = [&]()
     {
-        QString file = roms.at(i);
+        CoreRomType     type;
+        CoreRomHeader   header;
+        CoreRomSettings settings;
+        int             index;
 
-        if (CoreGetCachedRomHeaderAndSettings(file.toStdU32String(), &type, &header, nullptr, &settings))
+        while (!this->stop && (index = nextRomIndex++) < romAmount)
         {
-            data.push_back(
+            QString file = roms.at(index);
+
+            if (CoreGetCachedRomHeaderAndSettings(file.toStdU32String(), &type, &header, nullptr, &settings))
             {
-                file,
-                type,
-                header,
-                settings
-            });
+                QMutexLocker locker(&dataMutex);
+                data.push_back(
+                {
+                    file,
+                    type,
+                    header,
+                    settings
+                });
+            }
+
+            romsDone++;
         }
+    };
 
-        // we need to give the UI some breathing room,
-        // so when 10ms have passed,
-        // send our data to the UI and
-        // clear our data and restart
-        // the timer
-        if (timer.elapsed() >= 10)
+    auto sendData = [&]()
+    {
+        QList<RomSearcherThreadData> foundData;
         {
-            emit this->RomsFound(data, (i + 1), romAmount);
-            data.clear();
-            timer.start();
+            QMutexLocker locker(&dataMutex);
+            foundData.swap(data);
         }
 
-        if (this->stop)
+        if (!foundData.isEmpty())
         {
-            break;
+            emit this->RomsFound(foundData, romsDone, romAmount);
         }
+    };
+
+    QThreadPool threadPool;
+    const int threadCount = std::max(1, std::min(QThread::idealThreadCount(), romAmount));
+    threadPool.setMaxThreadCount(threadCount);
+    for (int i = 0; i < threadCount; i++)
+    {
+        threadPool.start(worker);
+    }
+
+    // we need to give the UI some breathing room,
+    // so send the data found by the workers
+    // to the UI in batches every 10ms
+    while (!threadPool.waitForDone(10))
+    {
+        sendData();
     }
 
     // when we're done and
     // we still have data left,
     // send it to the UI before we finish
-    if (!data.isEmpty())
-    {
-        emit this->RomsFound(data, romAmount, romAmount);
-    }
+    sendData();
 
     emit this->Finished(this->stop);
 }
-
@@ -14,9 +14,12 @@
 #include <RMG-Core/RomHeader.hpp>
 #include <RMG-Core/Rom.hpp>
 
+#include <QStringList>
 #include <QString>
 #include <QThread>
 
+#include <atomic>
+
 struct RomSearcherThreadData
 {
     QString File;
@@ -36,19 +39,25 @@ class RomSearcherThread : public QThread
     ~RomSearcherThread(void);
 
     void SetDirectory(QString);
+    void SetFiles(QStringList);
     void SetRecursive(bool);
     void SetMaximumFiles(int);
     void Stop(void);
 
     void run(void) override;
 
+    // returns the name filter of the supported files
+    static QStringList GetFileFilter(void);
+
   private:
     QString directory;
+    QStringList files;
     bool recursive = false;
     int  maxItems = 0;
-    bool stop = false;
+    std::atomic<bool> stop = false;
 
     void searchDirectory(QString);
+    void searchFiles(QList<QString>);
 
   signals:
     void RomsFound(QList<RomSearcherThreadData> data, int index, int count);
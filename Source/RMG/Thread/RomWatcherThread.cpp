@@ -0,0 +1,392 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "RomWatcherThread.hpp"
+#include "RomSearcherThread.hpp"
+
+#include <QElapsedTimer>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QFile>
+#include <QDir>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+#include <poll.h>
+#endif // __linux__
+
+// interval between directory walks when polling
+#define ROMWATCHER_POLL_INTERVAL 30000
+// time without new events before changes are sent,
+// so i.e copying a large ROM is only handled once
+#define ROMWATCHER_SETTLE_TIME 1000
+
+using namespace Thread;
+
+RomWatcherThread::RomWatcherThread(QObject *parent) : QThread(parent)
+{
+}
+
+RomWatcherThread::~RomWatcherThread(void)
+{
+    this->Stop();
+}
+
+void RomWatcherThread::SetDirectory(QString directory)
+{
+    this->directory = QDir::cleanPath(directory);
+}
+
+void RomWatcherThread::SetRecursive(bool value)
+{
+    this->recursive = value;
+}
+
+void RomWatcherThread::Stop(void)
+{
+    this->stop = true;
+    while (this->isRunning())
+    {
+        this->wait();
+    }
+}
+
+void RomWatcherThread::run(void)
+{
+    this->stop = false;
+    this->changedFiles.clear();
+    this->removedFiles.clear();
+
+#ifdef __linux__
+    // inotify doesn't see changes made by other
+    // machines on network shares, so poll those
+    if (!this->isNetworkFileSystem() &&
+        this->watchDirectoryInotify())
+    {
+        return;
+    }
+#endif // __linux__
+
+    this->watchDirectoryPolling();
+}
+
+bool RomWatcherThread::isRomFile(const QString& file)
+{
+    return QDir::match(RomSearcherThread::GetFileFilter(), QFileInfo(file).fileName());
+}
+
+bool RomWatcherThread::waitFor(int milliseconds)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!this->stop && timer.elapsed() < milliseconds)
+    {
+        QThread::msleep(100);
+    }
+
+    return !this->stop;
+}
+
+void RomWatcherThread::sendChanges(void)
+{
+    if (this->changedFiles.isEmpty() &&
+        this->removedFiles.isEmpty())
+    {
+        return;
+    }
+
+    emit this->FilesChanged(this->changedFiles.values(), this->removedFiles.values());
+
+    this->changedFiles.clear();
+    this->removedFiles.clear();
+}
+
+#ifdef __linux__
+bool RomWatcherThread::isNetworkFileSystem(void)
+{
+    struct statfs fileSystemStat;
+
+    if (statfs(QFile::encodeName(this->directory).constData(), &fileSystemStat) != 0)
+    {
+        return false;
+    }
+
+    switch (static_cast<uint32_t>(fileSystemStat.f_type))
+    {
+        case 0x6969:     // NFS
+        case 0x517B:     // SMB
+        case 0xFF534D42: // CIFS
+        case 0xFE534D42: // SMB2
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RomWatcherThread::watchDirectoryInotify(void)
+{
+    const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                            IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+    QHash<int, QString> watches;
+    QElapsedTimer lastEventTimer;
+    bool hasEvents = false;
+    bool lostEvents = false;
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    auto addWatch = [&](const QString& directory)
+    {
+        int wd = inotify_add_watch(fd, QFile::encodeName(directory).constData(), mask);
+        if (wd == -1)
+        {
+            return false;
+        }
+
+        watches.insert(wd, directory);
+        return true;
+    };
+
+    auto addWatches = [&](const QString& directory)
+    {
+        if (!addWatch(directory))
+        {
+            return false;
+        }
+
+        if (!this->recursive)
+        {
+            return true;
+        }
+
+        QDirIterator dirIt(directory, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (dirIt.hasNext())
+        {
+            if (this->stop || !addWatch(dirIt.next()))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    auto removeWatches = [&](const QString& directory)
+    {
+        for (auto iter = watches.begin(); iter != watches.end();)
+        {
+            if (iter.value() == directory ||
+                iter.value().startsWith(directory + '/'))
+            {
+                inotify_rm_watch(fd, iter.key());
+                iter = watches.erase(iter);
+            }
+            else
+            {
+                iter++;
+            }
+        }
+    };
+
+    // when we can't watch the whole directory,
+    // i.e because we've hit the watch limit,
+    // let the caller fall back to polling
+    if (!addWatches(this->directory))
+    {
+        close(fd);
+        return this->stop;
+    }
+
+    while (!this->stop && !lostEvents)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 100) > 0 && (pfd.revents & POLLIN))
+        {
+            alignas(struct inotify_event) char buf[16384];
+            ssize_t len;
+
+            while ((len = read(fd, buf, sizeof(buf))) > 0)
+            {
+                const struct inotify_event* event;
+                for (char* ptr = buf; ptr < (buf + len); ptr += sizeof(struct inotify_event) + event->len)
+                {
+                    event = reinterpret_cast<const struct inotify_event*>(ptr);
+
+                    if (event->mask & IN_Q_OVERFLOW)
+                    {
+                        lostEvents = true;
+                        continue;
+                    }
+
+                    if (event->mask & IN_IGNORED)
+                    {
+                        watches.remove(event->wd);
+                        continue;
+                    }
+
+                    QString directory = watches.value(event->wd);
+                    if (directory.isEmpty())
+                    {
+                        continue;
+                    }
+
+                    // the watched directory itself has been
+                    // removed or moved, when that's the ROM
+                    // directory, we can't keep track of it
+                    if (event->len == 0)
+                    {
+                        if ((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) &&
+                            directory == this->directory)
+                        {
+                            lostEvents = true;
+                        }
+                        continue;
+                    }
+
+                    QString path = directory + '/' + QFile::decodeName(event->name);
+
+                    if (event->mask & IN_ISDIR)
+                    {
+                        if (!this->recursive)
+                        {
+                            continue;
+                        }
+
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        {
+                            if (!addWatches(path))
+                            {
+                                lostEvents = true;
+                                continue;
+                            }
+
+                            // ROMs may have been added to the directory
+                            // before we started watching it
+                            QDirIterator romDirIt(path, RomSearcherThread::GetFileFilter(), QDir::Files, QDirIterator::Subdirectories);
+                            while (romDirIt.hasNext())
+                            {
+                                QString file = romDirIt.next();
+                                this->changedFiles.insert(file);
+                                this->removedFiles.remove(file);
+                            }
+                        }
+                        else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                        {
+                            removeWatches(path);
+                            this->removedFiles.insert(path);
+                            this->changedFiles.removeIf([&path](const QString& file)
+                            {
+                                return file.startsWith(path + '/');
+                            });
+                        }
+                    }
+                    else if (this->isRomFile(path))
+                    {
+                        if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                        {
+                            this->changedFiles.insert(path);
+                            this->removedFiles.remove(path);
+                        }
+                        else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                        {
+                            this->removedFiles.insert(path);
+                            this->changedFiles.remove(path);
+                        }
+                    }
+                }
+            }
+
+            hasEvents = true;
+            lastEventTimer.start();
+        }
+
+        if (hasEvents && lastEventTimer.elapsed() >= ROMWATCHER_SETTLE_TIME)
+        {
+            this->sendChanges();
+            hasEvents = false;
+        }
+    }
+
+    close(fd);
+
+    if (lostEvents)
+    {
+        emit this->RefreshRequired();
+    }
+
+    return true;
+}
+#endif // __linux__
+
+QHash<QString, RomWatcherThread::FileInfo> RomWatcherThread::getDirectorySnapshot(void)
+{
+    QHash<QString, FileInfo> snapshot;
+
+    QDirIterator::IteratorFlag flag = this->recursive ?
+        QDirIterator::Subdirectories :
+        QDirIterator::NoIteratorFlags;
+    QDirIterator romDirIt(this->directory, RomSearcherThread::GetFileFilter(), QDir::Files, flag);
+
+    while (!this->stop && romDirIt.hasNext())
+    {
+        romDirIt.next();
+
+        QFileInfo fileInfo = romDirIt.fileInfo();
+        snapshot.insert(fileInfo.filePath(),
+        {
+            fileInfo.size(),
+            fileInfo.lastModified().toMSecsSinceEpoch()
+        });
+    }
+
+    return snapshot;
+}
+
+void RomWatcherThread::watchDirectoryPolling(void)
+{
+    QHash<QString, FileInfo> snapshot = this->getDirectorySnapshot();
+    QHash<QString, FileInfo> newSnapshot;
+
+    while (this->waitFor(ROMWATCHER_POLL_INTERVAL))
+    {
+        newSnapshot = this->getDirectorySnapshot();
+        if (this->stop)
+        {
+            break;
+        }
+
+        for (auto iter = newSnapshot.cbegin(); iter != newSnapshot.cend(); iter++)
+        {
+            auto oldIter = snapshot.constFind(iter.key());
+            if (oldIter == snapshot.cend() || !(oldIter.value() == iter.value()))
+            {
+                this->changedFiles.insert(iter.key());
+            }
+        }
+
+        for (auto iter = snapshot.cbegin(); iter != snapshot.cend(); iter++)
+        {
+            if (!newSnapshot.contains(iter.key()))
+            {
+                this->removedFiles.insert(iter.key());
+            }
+        }
+
+        snapshot.swap(newSnapshot);
+        this->sendChanges();
+    }
+}
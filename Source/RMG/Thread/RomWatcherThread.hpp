@@ -0,0 +1,78 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ROMWATCHERTHREAD_HPP
+#define ROMWATCHERTHREAD_HPP
+
+#include <QStringList>
+#include <QString>
+#include <QThread>
+#include <QHash>
+#include <QSet>
+
+#include <atomic>
+
+namespace Thread
+{
+class RomWatcherThread : public QThread
+{
+    Q_OBJECT
+
+  public:
+    RomWatcherThread(QObject *);
+    ~RomWatcherThread(void);
+
+    void SetDirectory(QString);
+    void SetRecursive(bool);
+    void Stop(void);
+
+    void run(void) override;
+
+  private:
+    struct FileInfo
+    {
+        qint64 size;
+        qint64 lastModified;
+
+        bool operator==(const FileInfo& other) const
+        {
+            return size == other.size && lastModified == other.lastModified;
+        }
+    };
+
+    QString directory;
+    bool recursive = false;
+    std::atomic<bool> stop = false;
+
+    QSet<QString> changedFiles;
+    QSet<QString> removedFiles;
+
+    bool isRomFile(const QString& file);
+    bool waitFor(int milliseconds);
+    void sendChanges(void);
+
+#ifdef __linux__
+    bool isNetworkFileSystem(void);
+    bool watchDirectoryInotify(void);
+#endif // __linux__
+    QHash<QString, FileInfo> getDirectorySnapshot(void);
+    void watchDirectoryPolling(void);
+
+  signals:
+    // changedFiles contains new and modified ROMs, removedFiles
+    // contains removed ROMs and directories, all ROMs in a
+    // removed directory should be considered removed
+    void FilesChanged(QStringList changedFiles, QStringList removedFiles);
+    // emitted when changes have been lost, so only
+    // a full refresh can bring the ROM list up to date
+    void RefreshRequired(void);
+};
+} // namespace Thread
+
+#endif // ROMWATCHERTHREAD_HPP
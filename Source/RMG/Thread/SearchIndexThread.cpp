@@ -0,0 +1,294 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "SearchIndexThread.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Thread;
+
+//
+// Local Functions
+//
+
+// returns the key of a trigram or word prefix,
+// the length is stored in the lowest 16 bits,
+// followed by the (up to 3) UTF-16 characters
+static quint64 get_key(QStringView text)
+{
+    quint64 key = static_cast<quint64>(text.size());
+    for (qsizetype i = 0; i < text.size(); i++)
+    {
+        key |= static_cast<quint64>(text[i].unicode()) << (16 * (i + 1));
+    }
+    return key;
+}
+
+static bool is_word_start(QStringView text, qsizetype pos)
+{
+    return pos == 0 || !text[pos - 1].isLetterOrNumber();
+}
+
+static void add_keys(QStringView text, std::vector<quint64>& keys)
+{
+    for (qsizetype i = 0; i < text.size(); i++)
+    {
+        if (text[i].isSpace())
+        {
+            continue;
+        }
+
+        // search terms never contain spaces,
+        // so skip trigrams with spaces
+        if ((i + 2) < text.size() &&
+            !text[i + 1].isSpace() &&
+            !text[i + 2].isSpace())
+        {
+            keys.push_back(get_key(text.mid(i, 3)));
+        }
+
+        if (is_word_start(text, i))
+        {
+            keys.push_back(get_key(text.mid(i, 1)));
+            if ((i + 1) < text.size() &&
+                !text[i + 1].isSpace())
+            {
+                keys.push_back(get_key(text.mid(i, 2)));
+            }
+        }
+    }
+}
+
+//
+// SearchIndex
+//
+
+QStringList SearchIndex::Search(const QString& text) const
+{
+    QStringList results;
+    QStringList terms = text.simplified().toCaseFolded().split(' ', Qt::SkipEmptyParts);
+    std::vector<const std::vector<quint32>*> lists;
+
+    if (terms.isEmpty())
+    {
+        return results;
+    }
+
+    // retrieve the entries of every trigram,
+    // or of the word prefix for short terms
+    for (const QString& term : terms)
+    {
+        const qsizetype count = term.size() < 3 ? 1 : term.size() - 2;
+        for (qsizetype i = 0; i < count; i++)
+        {
+            auto iter = this->postings.constFind(get_key(QStringView(term).mid(i, std::min<qsizetype>(term.size(), 3))));
+            if (iter == this->postings.cend())
+            {
+                return results;
+            }
+
+            lists.push_back(&iter.value());
+        }
+    }
+
+    // intersect the lists, starting with the smallest
+    std::sort(lists.begin(), lists.end(), [](const std::vector<quint32>* a, const std::vector<quint32>* b)
+    {
+        return a->size() < b->size();
+    });
+
+    std::vector<quint32> candidates = *lists.front();
+    std::vector<quint32> intersection;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+    {
+        intersection.clear();
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                                lists[i]->cbegin(), lists[i]->cend(),
+                                std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+
+    // containing all trigrams doesn't mean the
+    // entry contains the term, so check that
+    // while scoring the entries
+    std::vector<std::pair<int, quint32>> scores;
+    scores.reserve(candidates.size());
+    for (quint32 candidate : candidates)
+    {
+        const Entry& entry = this->entries[candidate];
+        int score = 0;
+
+        for (const QString& term : terms)
+        {
+            int termScore = this->getTermScore(entry, term);
+            if (termScore == 0)
+            {
+                score = 0;
+                break;
+            }
+            score += termScore;
+        }
+
+        if (score > 0)
+        {
+            scores.push_back({ score, candidate });
+        }
+    }
+
+    std::stable_sort(scores.begin(), scores.end(), [](const std::pair<int, quint32>& a, const std::pair<int, quint32>& b)
+    {
+        return a.first > b.first;
+    });
+
+    results.reserve(scores.size());
+    for (const std::pair<int, quint32>& score : scores)
+    {
+        results.append(this->entries[score.second].File);
+    }
+
+    return results;
+}
+
+int SearchIndex::getTermScore(const Entry& entry, QStringView term) const
+{
+    static const int fieldWeights[Field_Count] = { 8, 4, 2, 2 };
+    const bool wordStartOnly = term.size() < 3;
+    int bestScore = 0;
+
+    for (int i = 0; i < Field_Count; i++)
+    {
+        QStringView field = entry.Fields[i];
+        qsizetype   pos   = 0;
+
+        while ((pos = field.indexOf(term, pos)) != -1)
+        {
+            int score;
+
+            if (pos == 0)
+            { // start of the field or the whole field
+                score = term.size() == field.size() ? 4 : 3;
+            }
+            else if (is_word_start(field, pos))
+            { // start of a word
+                score = 2;
+            }
+            else if (!wordStartOnly)
+            { // somewhere in a word
+                score = 1;
+            }
+            else
+            {
+                pos++;
+                continue;
+            }
+
+            bestScore = std::max(bestScore, score * fieldWeights[i]);
+
+            // later matches can't score better
+            // than the start of a word
+            if (score >= 2)
+            {
+                break;
+            }
+
+            pos++;
+        }
+    }
+
+    return bestScore;
+}
+
+//
+// SearchIndexThread
+//
+
+SearchIndexThread::SearchIndexThread(QObject *parent) : QThread(parent)
+{
+}
+
+SearchIndexThread::~SearchIndexThread(void)
+{
+    this->Stop();
+}
+
+void SearchIndexThread::SetData(QList<SearchIndexThreadData> data)
+{
+    this->data = data;
+}
+
+void SearchIndexThread::Stop(void)
+{
+    this->stop = true;
+    while (this->isRunning())
+    {
+        this->wait();
+    }
+}
+
+std::shared_ptr<const SearchIndex> SearchIndexThread::GetIndex(void)
+{
+    QMutexLocker locker(&this->indexMutex);
+    return this->index;
+}
+
+void SearchIndexThread::run(void)
+{
+    std::shared_ptr<SearchIndex> index = std::make_shared<SearchIndex>();
+    std::vector<quint64> keys;
+
+    this->stop = false;
+
+    index->entries.reserve(this->data.size());
+
+    for (qsizetype i = 0; i < this->data.size(); i++)
+    {
+        if (this->stop)
+        {
+            emit this->Finished(true);
+            return;
+        }
+
+        const SearchIndexThreadData& data = this->data.at(i);
+        SearchIndex::Entry entry;
+
+        entry.File = data.File;
+        entry.Fields[SearchIndex::Field_GoodName]     = data.GoodName.toCaseFolded();
+        entry.Fields[SearchIndex::Field_FileName]     = data.FileName.toCaseFolded();
+        entry.Fields[SearchIndex::Field_InternalName] = data.InternalName.toCaseFolded();
+        entry.Fields[SearchIndex::Field_GameID]       = data.GameID.toCaseFolded();
+
+        keys.clear();
+        for (const QString& field : entry.Fields)
+        {
+            add_keys(field, keys);
+        }
+
+        // only add the entry once per key,
+        // entries are added in order so the
+        // lists stay sorted
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        for (quint64 key : keys)
+        {
+            index->postings[key].push_back(static_cast<quint32>(i));
+        }
+
+        index->entries.push_back(std::move(entry));
+    }
+
+    this->data.clear();
+
+    {
+        QMutexLocker locker(&this->indexMutex);
+        this->index = index;
+    }
+
+    emit this->Finished(false);
+}
@@ -0,0 +1,109 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SEARCHINDEXTHREAD_HPP
+#define SEARCHINDEXTHREAD_HPP
+
+#include <QStringList>
+#include <QString>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct SearchIndexThreadData
+{
+    QString File;
+    QString GoodName;
+    QString InternalName;
+    QString GameID;
+    QString FileName;
+};
+
+namespace Thread
+{
+class SearchIndexThread;
+}
+
+//
+// Search index of the ROMs, it contains the trigrams of
+// the names of every ROM and the first 1 and 2 characters
+// of every word, so a search only has to look at the ROMs
+// which contain all trigrams of the search terms
+//
+class SearchIndex
+{
+  public:
+    // returns the files of the ROMs which contain
+    // every word of text, best match first,
+    // words shorter than 3 characters only match
+    // the start of a word
+    QStringList Search(const QString& text) const;
+
+  private:
+    friend class Thread::SearchIndexThread;
+
+    enum Field
+    {
+        Field_GoodName = 0,
+        Field_FileName,
+        Field_InternalName,
+        Field_GameID,
+        Field_Count
+    };
+
+    struct Entry
+    {
+        QString File;
+        // case folded
+        QString Fields[Field_Count];
+    };
+
+    std::vector<Entry> entries;
+    // key of trigram or word prefix -> sorted entry indexes
+    QHash<quint64, std::vector<quint32>> postings;
+
+    int getTermScore(const Entry& entry, QStringView term) const;
+};
+
+namespace Thread
+{
+class SearchIndexThread : public QThread
+{
+    Q_OBJECT
+
+  public:
+    SearchIndexThread(QObject *);
+    ~SearchIndexThread(void);
+
+    void SetData(QList<SearchIndexThreadData>);
+    void Stop(void);
+
+    // returns the last index which has been built
+    std::shared_ptr<const SearchIndex> GetIndex(void);
+
+    void run(void) override;
+
+  private:
+    QList<SearchIndexThreadData> data;
+    std::atomic<bool> stop = false;
+
+    std::shared_ptr<const SearchIndex> index;
+    QMutex indexMutex;
+
+  signals:
+    void Finished(bool canceled);
+};
+} // namespace Thread
+
+#endif // SEARCHINDEXTHREAD_HPP
@@ -0,0 +1,286 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "KailleraLobbyDialog.hpp"
+#include "Utilities/QtMessageBox.hpp"
+#include "NetplayCommon.hpp"
+
+#include <QRegularExpressionValidator>
+#include <QRegularExpression>
+#include <QTableWidgetItem>
+#include <QHeaderView>
+
+#include <algorithm>
+
+#include <RMG-Core/Settings.hpp>
+#include <RMG-Core/Kaillera.hpp>
+#include <RMG-Core/Error.hpp>
+
+using namespace UserInterface::Dialog;
+using namespace Utilities;
+
+//
+// Local Defines
+//
+
+#define KAILLERA_DEFAULT_PORT 27888
+
+//
+// Exported Functions
+//
+
+KailleraLobbyDialog::KailleraLobbyDialog(QWidget *parent, QStringList gameNames) : QDialog(parent)
+{
+    this->setupUi(this);
+
+    // set validator for nickname
+    QRegularExpression re(NETPLAYCOMMON_NICKNAME_REGEX);
+    this->nickNameLineEdit->setValidator(new QRegularExpressionValidator(re, this));
+    this->nickNameLineEdit->setText(QString::fromStdString(CoreSettingsGetStringValue(SettingsID::Netplay_Nickname)));
+
+    this->serverLineEdit->setText(QString::fromStdString(CoreSettingsGetStringValue(SettingsID::Netplay_KailleraServer)));
+
+    // connection types range from 1 (LAN) to 6 (Bad)
+    int connectionType = CoreSettingsGetIntValue(SettingsID::Netplay_KailleraConnectionType);
+    this->connectionTypeComboBox->setCurrentIndex(std::clamp(connectionType, 1, 6) - 1);
+
+    this->romComboBox->addItems(gameNames);
+
+    this->gameTableWidget->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    this->toggleUI();
+}
+
+KailleraLobbyDialog::~KailleraLobbyDialog(void)
+{
+}
+
+bool KailleraLobbyDialog::HasConnected(void)
+{
+    return this->hasConnected;
+}
+
+void KailleraLobbyDialog::toggleUI(void)
+{
+    bool connected = CoreIsKailleraServerConnected();
+
+    this->nickNameLineEdit->setEnabled(!connected);
+    this->serverLineEdit->setEnabled(!connected);
+    this->connectionTypeComboBox->setEnabled(!connected);
+    this->connectButton->setText(connected ? "Disconnect" : "Connect");
+    this->connectButton->setEnabled(connected || !this->nickNameLineEdit->text().isEmpty());
+
+    this->romComboBox->setEnabled(connected && !this->inGame);
+    this->createButton->setEnabled(connected && !this->inGame && this->romComboBox->count() > 0);
+    this->joinButton->setEnabled(connected && !this->inGame && !this->gameTableWidget->selectedItems().isEmpty());
+    this->startButton->setEnabled(connected && this->inGame && this->gameOwner && !this->gameStarted);
+}
+
+void KailleraLobbyDialog::refreshGames(void)
+{
+    std::vector<CoreKailleraGame> games;
+
+    if (!CoreGetKailleraGameList(games))
+    {
+        games.clear();
+    }
+
+    // keep the selection across refreshes
+    uint32_t selectedId = 0;
+    QList<QTableWidgetItem*> selectedItems = this->gameTableWidget->selectedItems();
+    if (!selectedItems.isEmpty())
+    {
+        selectedId = selectedItems.first()->data(Qt::UserRole).toUInt();
+    }
+
+    this->gameTableWidget->blockSignals(true);
+    this->gameTableWidget->setRowCount(static_cast<int>(games.size()));
+
+    int row = 0;
+    for (const CoreKailleraGame& game : games)
+    {
+        QString status;
+        switch (game.Status)
+        {
+        default:
+        case 0:
+            status = "Waiting";
+            break;
+        case 1:
+            status = "Playing";
+            break;
+        case 2:
+            status = "Netsync";
+            break;
+        }
+
+        const QString columns[] =
+        {
+            QString::fromStdString(game.Name),
+            QString::fromStdString(game.Emulator),
+            QString::fromStdString(game.Owner),
+            QString::fromStdString(game.Users),
+            status,
+        };
+
+        for (int column = 0; column < 5; column++)
+        {
+            QTableWidgetItem* item = new QTableWidgetItem(columns[column]);
+            item->setData(Qt::UserRole, game.Id);
+            this->gameTableWidget->setItem(row, column, item);
+        }
+
+        if (game.Id == selectedId)
+        {
+            this->gameTableWidget->selectRow(row);
+        }
+
+        row++;
+    }
+
+    this->gameTableWidget->blockSignals(false);
+    this->toggleUI();
+}
+
+void KailleraLobbyDialog::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == this->refreshTimerId)
+    {
+        if (!CoreIsKailleraServerConnected())
+        {
+            // server went away
+            this->killTimer(this->refreshTimerId);
+            this->refreshTimerId = -1;
+            this->inGame      = false;
+            this->gameOwner   = false;
+            this->gameStarted = false;
+        }
+
+        this->refreshGames();
+    }
+}
+
+void KailleraLobbyDialog::on_connectButton_clicked(void)
+{
+    if (CoreIsKailleraServerConnected())
+    {
+        CoreDisconnectKailleraServer();
+        if (this->refreshTimerId != -1)
+        {
+            this->killTimer(this->refreshTimerId);
+            this->refreshTimerId = -1;
+        }
+        this->inGame      = false;
+        this->gameOwner   = false;
+        this->gameStarted = false;
+        this->refreshGames();
+        return;
+    }
+
+    QString server = this->serverLineEdit->text().trimmed();
+    QString address = server;
+    int port = KAILLERA_DEFAULT_PORT;
+
+    int portSeparator = server.lastIndexOf(':');
+    if (portSeparator != -1)
+    {
+        bool ok = false;
+        address = server.left(portSeparator);
+        port    = server.mid(portSeparator + 1).toInt(&ok);
+        if (!ok || port <= 0 || port > 65535)
+        {
+            QtMessageBox::Error(this, "Invalid server port", server);
+            return;
+        }
+    }
+
+    if (address.isEmpty())
+    {
+        QtMessageBox::Error(this, "No server specified", "Enter the address of a Kaillera server");
+        return;
+    }
+
+    int connectionType = this->connectionTypeComboBox->currentIndex() + 1;
+
+    // blocks until the server accepted the login or timed out
+    this->setCursor(Qt::WaitCursor);
+    bool ret = CoreConnectKailleraServer(address.toStdString(), port,
+                                         this->nickNameLineEdit->text().toStdString(), connectionType);
+    this->unsetCursor();
+    if (!ret)
+    {
+        QtMessageBox::Error(this, "CoreConnectKailleraServer() Failed", QString::fromStdString(CoreGetError()));
+        this->toggleUI();
+        return;
+    }
+
+    CoreSettingsSetValue(SettingsID::Netplay_Nickname, this->nickNameLineEdit->text().toStdString());
+    CoreSettingsSetValue(SettingsID::Netplay_KailleraServer, server.toStdString());
+    CoreSettingsSetValue(SettingsID::Netplay_KailleraConnectionType, connectionType);
+
+    this->hasConnected   = true;
+    this->refreshTimerId = this->startTimer(1000);
+    this->refreshGames();
+}
+
+void KailleraLobbyDialog::on_createButton_clicked(void)
+{
+    if (!CoreCreateKailleraGame(this->romComboBox->currentText().toStdString()))
+    {
+        QtMessageBox::Error(this, "CoreCreateKailleraGame() Failed", QString::fromStdString(CoreGetError()));
+        return;
+    }
+
+    this->inGame    = true;
+    this->gameOwner = true;
+    this->refreshGames();
+}
+
+void KailleraLobbyDialog::on_joinButton_clicked(void)
+{
+    QList<QTableWidgetItem*> selectedItems = this->gameTableWidget->selectedItems();
+    if (selectedItems.isEmpty())
+    {
+        return;
+    }
+
+    uint32_t gameId = selectedItems.first()->data(Qt::UserRole).toUInt();
+    if (!CoreJoinKailleraGame(gameId))
+    {
+        QtMessageBox::Error(this, "CoreJoinKailleraGame() Failed", QString::fromStdString(CoreGetError()));
+        return;
+    }
+
+    this->inGame    = true;
+    this->gameOwner = false;
+    this->refreshGames();
+}
+
+void KailleraLobbyDialog::on_startButton_clicked(void)
+{
+    // the game start callback takes it from here
+    if (!CoreStartKailleraGame())
+    {
+        QtMessageBox::Error(this, "CoreStartKailleraGame() Failed", QString::fromStdString(CoreGetError()));
+        return;
+    }
+
+    this->gameStarted = true;
+    this->toggleUI();
+}
+
+void KailleraLobbyDialog::on_gameTableWidget_itemSelectionChanged(void)
+{
+    this->toggleUI();
+}
+
+void KailleraLobbyDialog::on_nickNameLineEdit_textChanged(void)
+{
+    this->toggleUI();
+}
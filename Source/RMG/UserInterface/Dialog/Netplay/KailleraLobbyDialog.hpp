@@ -0,0 +1,66 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef KAILLERALOBBYDIALOG_HPP
+#define KAILLERALOBBYDIALOG_HPP
+
+#include <QStringList>
+#include <QTimerEvent>
+#include <QDialog>
+#include <QString>
+
+#include "ui_KailleraLobbyDialog.h"
+
+namespace UserInterface
+{
+namespace Dialog
+{
+//
+// KailleraLobbyDialog
+//
+// Minimal lobby for the native Kaillera client, used on platforms
+// where there's no kailleraclient.dll to provide its own server dialog
+//
+class KailleraLobbyDialog : public QDialog, private Ui::KailleraLobbyDialog
+{
+    Q_OBJECT
+
+  public:
+    KailleraLobbyDialog(QWidget *parent, QStringList gameNames);
+    ~KailleraLobbyDialog(void);
+
+    // whether a server login succeeded while the dialog was open
+    bool HasConnected(void);
+
+  private:
+    int refreshTimerId = -1;
+    bool hasConnected  = false;
+    bool inGame        = false;
+    bool gameOwner     = false;
+    bool gameStarted   = false;
+
+    void toggleUI(void);
+    void refreshGames(void);
+
+  protected:
+    void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE;
+
+  private slots:
+    void on_connectButton_clicked(void);
+    void on_createButton_clicked(void);
+    void on_joinButton_clicked(void);
+    void on_startButton_clicked(void);
+
+    void on_gameTableWidget_itemSelectionChanged(void);
+    void on_nickNameLineEdit_textChanged(void);
+};
+} // namespace Dialog
+} // namespace UserInterface
+
+#endif // KAILLERALOBBYDIALOG_HPP
@@ -494,6 +494,9 @@ void SettingsDialog::loadInterfaceEmulationSettings(void)
     this->confirmExitWhileInGameCheckBox->setChecked(CoreSettingsGetBoolValue(SettingsID::GUI_ConfirmExitWhileInGame));
     this->statusBarMessageDurationSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::GUI_StatusbarMessageDuration));
     this->openglTypeComboBox->setCurrentIndex(CoreSettingsGetBoolValue(SettingsID::GUI_OpenGLES));
+    this->framePacingClockComboBox->setCurrentIndex(CoreSettingsGetIntValue(SettingsID::Core_FramePacingClock));
+    this->fastForwardSpeedSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::Core_FastForwardSpeedFactor));
+    this->fastForwardFrameSkipSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::Core_FastForwardFrameSkip));
 }
 
 void SettingsDialog::loadInterfaceRomBrowserSettings(void)
@@ -516,6 +519,7 @@ void SettingsDialog::loadInterfaceOSDSettings(void)
     this->osdDurationSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::GUI_OnScreenDisplayDuration));
     this->osdScaleDoubleSpinBox->setValue(CoreSettingsGetFloatValue(SettingsID::GUI_OnScreenDisplayScale));
     this->osdMaxMessagesSpinBox->setValue(CoreSettingsGetIntValue(SettingsID::GUI_OnScreenDisplayMaxMessages));
+    this->osdNetplayStatsCheckBox->setChecked(CoreSettingsGetBoolValue(SettingsID::GUI_OnScreenDisplayNetplayStats));
 
     std::vector<int> backgroundColor = CoreSettingsGetIntListValue(SettingsID::GUI_OnScreenDisplayBackgroundColor);
     std::vector<int> textColor = CoreSettingsGetIntListValue(SettingsID::GUI_OnScreenDisplayTextColor);
@@ -661,6 +665,9 @@ void SettingsDialog::loadDefaultInterfaceEmulationSettings(void)
     this->confirmExitWhileInGameCheckBox->setChecked(CoreSettingsGetDefaultBoolValue(SettingsID::GUI_ConfirmExitWhileInGame));
     this->statusBarMessageDurationSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::GUI_StatusbarMessageDuration));
     this->openglTypeComboBox->setCurrentIndex(CoreSettingsGetDefaultBoolValue(SettingsID::GUI_OpenGLES));
+    this->framePacingClockComboBox->setCurrentIndex(CoreSettingsGetDefaultIntValue(SettingsID::Core_FramePacingClock));
+    this->fastForwardSpeedSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::Core_FastForwardSpeedFactor));
+    this->fastForwardFrameSkipSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::Core_FastForwardFrameSkip));
 }
 
 void SettingsDialog::loadDefaultInterfaceRomBrowserSettings(void)
@@ -683,6 +690,7 @@ void SettingsDialog::loadDefaultInterfaceOSDSettings(void)
     this->osdDurationSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::GUI_OnScreenDisplayDuration));
     this->osdScaleDoubleSpinBox->setValue(CoreSettingsGetDefaultFloatValue(SettingsID::GUI_OnScreenDisplayScale));
     this->osdMaxMessagesSpinBox->setValue(CoreSettingsGetDefaultIntValue(SettingsID::GUI_OnScreenDisplayMaxMessages));
+    this->osdNetplayStatsCheckBox->setChecked(CoreSettingsGetDefaultBoolValue(SettingsID::GUI_OnScreenDisplayNetplayStats));
 
     const std::vector<int> backgroundColor = CoreSettingsGetDefaultIntListValue(SettingsID::GUI_OnScreenDisplayBackgroundColor);
     const std::vector<int> textColor = CoreSettingsGetDefaultIntListValue(SettingsID::GUI_OnScreenDisplayTextColor);
@@ -905,6 +913,11 @@ void SettingsDialog::saveInterfaceEmulationSettings(void)
     CoreSettingsSetValue(SettingsID::GUI_ConfirmExitWhileInGame, this->confirmExitWhileInGameCheckBox->isChecked());
     CoreSettingsSetValue(SettingsID::GUI_StatusbarMessageDuration, this->statusBarMessageDurationSpinBox->value());
     CoreSettingsSetValue(SettingsID::GUI_OpenGLES, this->openglTypeComboBox->currentIndex() == 1);
+    CoreSettingsSetValue(SettingsID::Core_FramePacingClock, this->framePacingClockComboBox->currentIndex());
+    CoreSettingsSetValue(SettingsID::Core_FastForwardSpeedFactor, this->fastForwardSpeedSpinBox->value());
+    // one frame is presented after the skipped frames
+    CoreSettingsSetValue(SettingsID::Core_FastForwardFrameSkip, this->fastForwardFrameSkipSpinBox->value());
+    CoreSettingsSetValue(SettingsID::Core_FastForwardFrameSkipInterval, this->fastForwardFrameSkipSpinBox->value() + 1);
 }
 
 void SettingsDialog::saveInterfaceRomBrowserSettings(void)
@@ -927,6 +940,7 @@ void SettingsDialog::saveInterfaceOSDSettings(void)
     CoreSettingsSetValue(SettingsID::GUI_OnScreenDisplayDuration, this->osdDurationSpinBox->value());
     CoreSettingsSetValue(SettingsID::GUI_OnScreenDisplayScale, static_cast<float>(this->osdScaleDoubleSpinBox->value()));
     CoreSettingsSetValue(SettingsID::GUI_OnScreenDisplayMaxMessages, this->osdMaxMessagesSpinBox->value());
+    CoreSettingsSetValue(SettingsID::GUI_OnScreenDisplayNetplayStats, this->osdNetplayStatsCheckBox->isChecked());
     CoreSettingsSetValue(SettingsID::GUI_OnScreenDisplayBackgroundColor, std::vector<int>({ this->currentBackgroundColor.red(),
                                                                                             this->currentBackgroundColor.green(),
                                                                                             this->currentBackgroundColor.blue(),
@@ -969,6 +983,7 @@ void SettingsDialog::commonHotkeySettings(SettingsDialogAction action)
         { this->pauseKeyButton, SettingsID::KeyBinding_Resume },
         { this->generateBitmapKeyButton, SettingsID::KeyBinding_Screenshot },
         { this->limitFPSKeyButton, SettingsID::KeyBinding_LimitFPS },
+        { this->fastForwardKeyButton, SettingsID::KeyBinding_FastForward },
         { this->saveStateKeyButton, SettingsID::KeyBinding_SaveState },
         { this->saveAsKeyButton, SettingsID::KeyBinding_SaveAs },
         { this->loadStateKeyButton, SettingsID::KeyBinding_LoadState },
@@ -1518,6 +1533,7 @@ void SettingsDialog::on_KeybindButton_KeybindingChanged(KeybindButton* button)
         this->pauseKeyButton,
         this->generateBitmapKeyButton,
         this->limitFPSKeyButton,
+        this->fastForwardKeyButton,
         this->speedFactor25KeyButton,
         this->speedFactor50KeyButton,
         this->speedFactor75KeyButton,
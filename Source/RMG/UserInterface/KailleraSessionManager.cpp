@@ -16,6 +16,9 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include "Dialog/Netplay/KailleraLobbyDialog.hpp"
+#include <QEventLoop>
 #endif
 
 KailleraSessionManager::KailleraSessionManager(QWidget* parent)
@@ -69,7 +72,7 @@ KailleraSessionManager::~KailleraSessionManager()
     }
 }
 
-bool KailleraSessionManager::showServerDialog()
+bool KailleraSessionManager::showServerDialog(QStringList gameNames)
 {
 #ifdef _WIN32
     // Get native window handle from Qt widget
@@ -82,10 +85,18 @@ bool KailleraSessionManager::showServerDialog()
     // Show Kaillera's built-in server selection dialog
     // This is a blocking call - user will select server, create/join game
     // When they start a game, gameCallback will be invoked
+    (void)gameNames;
     return CoreShowKailleraServerDialog(hwnd);
 #else
-    // Kaillera is Windows-only
-    return false;
+    // The native client has no dialog of its own, show ours modeless
+    // and wait for it to close so this blocks like the Windows one,
+    // the queued game start callbacks are still delivered meanwhile
+    UserInterface::Dialog::KailleraLobbyDialog dialog(m_parentWidget, gameNames);
+    QEventLoop eventLoop;
+    connect(&dialog, &QDialog::finished, &eventLoop, &QEventLoop::quit);
+    dialog.show();
+    eventLoop.exec();
+    return dialog.HasConnected();
 #endif
 }
 
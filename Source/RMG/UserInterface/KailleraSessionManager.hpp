@@ -11,6 +11,7 @@
 #define KAILLERASESSIONMANAGER_HPP
 
 #include <QObject>
+#include <QStringList>
 #include <QString>
 #include <QWidget>
 
@@ -28,9 +29,10 @@ public:
     KailleraSessionManager(QWidget* parent = nullptr);
     ~KailleraSessionManager();
 
-    // Show Kaillera's server selection dialog
+    // Show Kaillera's server selection dialog, gameNames is
+    // offered when creating a game with the native client
     // Returns true if user connected to server, false if cancelled
-    bool showServerDialog();
+    bool showServerDialog(QStringList gameNames);
 
     // Get current game state
     bool isGameActive() const;
@@ -52,6 +52,7 @@
 #include <QString>
 #include <QTimer>
 #include <QShowEvent>
+#include <QScreen>
 #include <QDir>
 #include <QUrl>
 #include <QRegularExpression>
@@ -66,7 +67,10 @@
 #include <vector>
 
 #include <RMG-Core/CachedRomHeaderAndSettings.hpp>
+#include <RMG-Core/ArchiveCache.hpp>
 #include <RMG-Core/SpeedLimiter.hpp>
+#include <RMG-Core/FastForward.hpp>
+#include <RMG-Core/FramePacing.hpp>
 #include <RMG-Core/Directories.hpp>
 #include <RMG-Core/SpeedFactor.hpp>
 #include <RMG-Core/Screenshot.hpp>
@@ -990,6 +994,10 @@ void MainWindow::updateActions(bool inEmulation, bool isPaused)
     this->action_System_LimitFPS->setEnabled(inEmulation && !CoreHasInitNetplay());
     this->action_System_LimitFPS->setShortcut(QKeySequence(keyBinding));
     this->action_System_LimitFPS->setChecked(CoreIsSpeedLimiterEnabled());
+    keyBinding = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::KeyBinding_FastForward));
+    this->action_System_FastForward->setEnabled(inEmulation && !CoreHasInitNetplay() && !CoreHasInitKaillera());
+    this->action_System_FastForward->setShortcut(QKeySequence(keyBinding));
+    this->action_System_FastForward->setChecked(CoreIsFastForwardEnabled());
     this->menuSpeedFactor->setEnabled(inEmulation && !CoreHasInitNetplay());
     keyBinding = QString::fromStdString(CoreSettingsGetStringValue(SettingsID::KeyBinding_SaveState));
     this->action_System_SaveState->setEnabled(inEmulation);
@@ -1260,6 +1268,7 @@ void MainWindow::configureActions(void)
         this->action_System_Shutdown, this->action_Netplay_Start,
         this->action_System_HardReset, this->action_System_Pause,
         this->action_System_Screenshot, this->action_System_LimitFPS,
+        this->action_System_FastForward,
         this->actionSpeed25, this->actionSpeed50, this->actionSpeed75,
         this->actionSpeed100, this->actionSpeed125, this->actionSpeed150,
         this->actionSpeed175, this->actionSpeed200, this->actionSpeed225,
@@ -1390,6 +1399,7 @@ void MainWindow::connectActionSignals(void)
     connect(this->action_System_Screenshot, &QAction::triggered, this,
             &MainWindow::on_Action_System_Screenshot);
     connect(this->action_System_LimitFPS, &QAction::triggered, this, &MainWindow::on_Action_System_LimitFPS);
+    connect(this->action_System_FastForward, &QAction::triggered, this, &MainWindow::on_Action_System_FastForward);
     connect(this->action_System_SaveState, &QAction::triggered, this, &MainWindow::on_Action_System_SaveState);
     connect(this->action_System_SaveAs, &QAction::triggered, this, &MainWindow::on_Action_System_SaveAs);
     connect(this->action_System_LoadState, &QAction::triggered, this, &MainWindow::on_Action_System_LoadState);
@@ -1960,6 +1970,16 @@ void MainWindow::on_Action_System_LimitFPS(void)
     }
 }
 
+void MainWindow::on_Action_System_FastForward(void)
+{
+    bool enabled = this->action_System_FastForward->isChecked();
+
+    if (!CoreSetFastForwardState(enabled))
+    {
+        this->showErrorMessage("CoreSetFastForwardState() Failed", QString::fromStdString(CoreGetError()));
+    }
+}
+
 void MainWindow::on_Action_System_SpeedFactor(int factor)
 {
     if (!CoreSetSpeedFactor(factor))
@@ -2274,6 +2294,13 @@ void MainWindow::on_Action_View_ClearRomCache(void)
     {
         this->showErrorMessage("CoreClearRomHeaderAndSettingsCache() Failed", QString::fromStdString(CoreGetError()));
     }
+
+    if (!CoreClearArchiveCache())
+    {
+        this->showErrorMessage("CoreClearArchiveCache() Failed", QString::fromStdString(CoreGetError()));
+    }
+
+    this->ui_Widget_RomBrowser->ClearCoverCache();
 }
 
 void MainWindow::on_Action_View_Log(void)
@@ -2366,11 +2393,18 @@ void MainWindow::on_Action_Netplay_BrowseSessions(void)
     this->action_Netplay_Start->setEnabled(false);
     this->action_System_StartRom->setEnabled(false);
 
-    // Show Kaillera's built-in server browser dialog
+    QStringList gameNames;
+    for (const auto& name : goodNames)
+    {
+        gameNames.append(QString::fromStdString(name));
+    }
+
+    // Show Kaillera's server browser dialog, on Windows the one
+    // from kailleraclient.dll, elsewhere our native lobby
     // This is a blocking call - user will select server, join/create game
     // When they start a game, gameStarted signal will be emitted
     // Dialog stays open until user closes it
-    this->kailleraSessionManager->showServerDialog();
+    this->kailleraSessionManager->showServerDialog(gameNames);
 
     // Dialog closed - clean up Kaillera session
     // (emulation may still be running - user can manually stop it)
@@ -2435,7 +2469,6 @@ void MainWindow::on_Kaillera_GameStarted(QString gameName, int playerNum, int to
 
 void MainWindow::on_Kaillera_ChatReceived(QString nickname, QString message)
 {
-#ifdef _WIN32
     // Only show in-game Kaillera chat (not lobby chat).
     if (!CoreHasInitKaillera() || !this->emulationThread->isRunning())
     {
@@ -2448,10 +2481,6 @@ void MainWindow::on_Kaillera_ChatReceived(QString nickname, QString message)
     message.replace('\n', ' ');
 
     OnScreenDisplaySetKailleraChatMessage("<" + nickname.toStdString() + "> " + message.toStdString());
-#else
-    (void)nickname;
-    (void)message;
-#endif
 }
 
 void MainWindow::on_Kaillera_PlayerDropped(QString nickname, int playerNum)
@@ -2607,6 +2636,9 @@ void MainWindow::on_Emulation_Started(void)
 
     this->ui_MessageBoxList.clear();
     this->ui_DebugCallbackErrors.clear();
+
+    // the frame pacer can follow the refresh rate of the display
+    CoreSetFramePacingDisplayRefreshRate(this->screen()->refreshRate());
 }
 
 void MainWindow::on_Emulation_Finished(bool ret, QString error)
@@ -199,6 +199,7 @@ class MainWindow : public QMainWindow, private Ui::MainWindow
     void on_Action_System_Pause(void);
     void on_Action_System_Screenshot(void);
     void on_Action_System_LimitFPS(void);
+    void on_Action_System_FastForward(void);
     void on_Action_System_SpeedFactor(int factor);
     void on_Action_System_SaveState(void);
     void on_Action_System_SaveAs(void);
@@ -0,0 +1,436 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "RomBrowserModel.hpp"
+
+#include <QFileInfo>
+#include <QPixmap>
+
+using namespace UserInterface::Widget;
+
+//
+// Local Defines
+//
+
+// maximum amount of loaded covers, the covers
+// which haven't been used for the longest time
+// are dropped, and requested again when needed
+#define ROMBROWSERMODEL_COVERS_MAX 1024
+
+//
+// RomBrowserModel
+//
+
+RomBrowserModel::RomBrowserModel(QObject *parent) : QAbstractTableModel(parent)
+{
+    this->coverFallbackIcon = QIcon(QPixmap(":Resource/CoverFallback.png"));
+    this->covers.setMaxCost(ROMBROWSERMODEL_COVERS_MAX);
+}
+
+RomBrowserModel::~RomBrowserModel(void)
+{
+}
+
+int RomBrowserModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : this->rows.size();
+}
+
+int RomBrowserModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : Column_Count;
+}
+
+QVariant RomBrowserModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= this->rows.size())
+    {
+        return QVariant();
+    }
+
+    const Row& row = this->rows.at(index.row());
+
+    switch (role)
+    {
+    default:
+        return QVariant();
+    case Qt::DisplayRole:
+        return this->getText(row, index.column());
+    case Qt::DecorationRole:
+        if (index.column() == Column_Name)
+        {
+            return this->getCover(row);
+        }
+        return QVariant();
+    case DataRole:
+        return QVariant::fromValue<RomBrowserModelData>(row.data);
+    }
+}
+
+QVariant RomBrowserModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section)
+    {
+    default:
+        return QVariant();
+    case Column_Name:
+        return "Name";
+    case Column_InternalName:
+        return "Internal Name";
+    case Column_MD5:
+        return "MD5";
+    case Column_Format:
+        return "Format";
+    case Column_FileName:
+        return "File Name";
+    case Column_FileExtension:
+        return "File Ext.";
+    case Column_FileSize:
+        return "File Size";
+    case Column_GameID:
+        return "I.D.";
+    case Column_Region:
+        return "Region";
+    }
+}
+
+void RomBrowserModel::AddRoms(const QList<RomBrowserModelData>& data)
+{
+    if (data.isEmpty())
+    {
+        return;
+    }
+
+    this->beginInsertRows(QModelIndex(), this->rows.size(), this->rows.size() + data.size() - 1);
+    for (const RomBrowserModelData& romData : data)
+    {
+        this->rowIndexes.insert(romData.file, this->rows.size());
+        this->rows.append({ romData, this->getName(romData) });
+    }
+    this->endInsertRows();
+}
+
+void RomBrowserModel::RemoveRoms(std::function<bool(const RomBrowserModelData&)> predicate)
+{
+    QList<bool> removeRows(this->rows.size());
+    bool removed = false;
+
+    for (int i = 0; i < this->rows.size(); i++)
+    {
+        removeRows[i] = predicate(this->rows.at(i).data);
+        removed |= removeRows[i];
+    }
+
+    if (!removed)
+    {
+        return;
+    }
+
+    // remove the rows in ranges, starting at the end,
+    // so the indexes of the other ranges stay valid
+    for (int last = this->rows.size() - 1; last >= 0; last--)
+    {
+        if (!removeRows.at(last))
+        {
+            continue;
+        }
+
+        int first = last;
+        while (first > 0 && removeRows.at(first - 1))
+        {
+            first--;
+        }
+
+        this->beginRemoveRows(QModelIndex(), first, last);
+        for (int i = first; i <= last; i++)
+        {
+            this->covers.remove(this->rows.at(i).data.file);
+            this->requestedCovers.remove(this->rows.at(i).data.file);
+            this->rowIndexes.remove(this->rows.at(i).data.file);
+        }
+        this->rows.remove(first, (last - first) + 1);
+
+        // the search results are mapped to rows when rows have
+        // been removed, so the row indexes have to be updated
+        // before the views are notified
+        for (int i = first; i < this->rows.size(); i++)
+        {
+            this->rowIndexes.insert(this->rows.at(i).data.file, i);
+        }
+        this->endRemoveRows();
+
+        last = first;
+    }
+}
+
+void RomBrowserModel::Clear(void)
+{
+    this->beginResetModel();
+    this->rows.clear();
+    this->rowIndexes.clear();
+    this->covers.clear();
+    this->requestedCovers.clear();
+    this->endResetModel();
+}
+
+const RomBrowserModelData& RomBrowserModel::GetRomData(int row) const
+{
+    return this->rows.at(row).data;
+}
+
+int RomBrowserModel::GetRomRow(const QString& file) const
+{
+    return this->rowIndexes.value(file, -1);
+}
+
+bool RomBrowserModel::LessThan(int leftRow, int rightRow, int column) const
+{
+    const Row& left  = this->rows.at(leftRow);
+    const Row& right = this->rows.at(rightRow);
+
+    switch (column)
+    {
+    case Column_Name:
+        return left.name < right.name;
+    case Column_FileSize:
+        return this->getFileSize(left) < this->getFileSize(right);
+    default:
+        return this->getText(left, column) < this->getText(right, column);
+    }
+}
+
+void RomBrowserModel::SetCover(const QString& file, const QString& coverFile, const QImage& image)
+{
+    auto iter = this->rowIndexes.constFind(file);
+    if (iter == this->rowIndexes.cend())
+    {
+        return;
+    }
+
+    const int row = iter.value();
+
+    this->rows[row].data.coverFile = coverFile;
+    this->requestedCovers.remove(file);
+
+    if (image.isNull())
+    {
+        this->covers.insert(file, new QIcon(this->coverFallbackIcon));
+    }
+    else
+    {
+        this->covers.insert(file, new QIcon(QPixmap::fromImage(image)));
+    }
+
+    QModelIndex modelIndex = this->index(row, Column_Name);
+    emit this->dataChanged(modelIndex, modelIndex, { Qt::DecorationRole, DataRole });
+}
+
+void RomBrowserModel::ResetCover(const QString& file)
+{
+    auto iter = this->rowIndexes.constFind(file);
+    if (iter == this->rowIndexes.cend())
+    {
+        return;
+    }
+
+    this->covers.remove(file);
+    this->requestedCovers.remove(file);
+
+    QModelIndex modelIndex = this->index(iter.value(), Column_Name);
+    emit this->dataChanged(modelIndex, modelIndex, { Qt::DecorationRole });
+}
+
+void RomBrowserModel::ResetCovers(void)
+{
+    this->covers.clear();
+    this->requestedCovers.clear();
+
+    if (!this->rows.isEmpty())
+    {
+        emit this->dataChanged(this->index(0, Column_Name), this->index(this->rows.size() - 1, Column_Name), { Qt::DecorationRole });
+    }
+}
+
+QString RomBrowserModel::getName(const RomBrowserModelData& data) const
+{
+    // generate name to use in UI
+    QString name = QString::fromStdString(data.settings.GoodName);
+    if (name.endsWith("(unknown rom)") ||
+        name.endsWith("(unknown disk)"))
+    {
+        name = QFileInfo(data.file).fileName();
+    }
+
+    return name;
+}
+
+qint64 RomBrowserModel::getFileSize(const Row& row) const
+{
+    if (row.fileSize == -1)
+    {
+        row.fileSize = QFileInfo(row.data.file).size();
+    }
+
+    return row.fileSize;
+}
+
+QString RomBrowserModel::getText(const Row& row, int column) const
+{
+    switch (column)
+    {
+    default:
+        return QString();
+    case Column_Name:
+        return row.name;
+    case Column_InternalName:
+        return QString::fromStdString(row.data.header.Name);
+    case Column_MD5:
+        return QString::fromStdString(row.data.settings.MD5);
+    case Column_Format:
+        return row.data.type == CoreRomType::Disk ? "Disk" : "Cartridge";
+    case Column_FileName:
+        return QFileInfo(row.data.file).completeBaseName();
+    case Column_FileExtension:
+        return QFileInfo(row.data.file).suffix().prepend(".").toUpper();
+    case Column_FileSize:
+    {
+        QString fileSize = QString::number(this->getFileSize(row) / 1048576.0, 'f', 2).append(" MB");
+        if (fileSize.size() == 7)
+        {
+            fileSize.prepend("  ");
+        }
+        return fileSize;
+    }
+    case Column_GameID:
+        return QString::fromStdString(row.data.header.GameID);
+    case Column_Region:
+        return QString::fromStdString(row.data.header.Region);
+    }
+}
+
+QIcon RomBrowserModel::getCover(const Row& row) const
+{
+    QIcon* cover = this->covers.object(row.data.file);
+    if (cover != nullptr)
+    {
+        return *cover;
+    }
+
+    // request the cover once, the fallback
+    // is shown until it has been loaded
+    if (!this->requestedCovers.contains(row.data.file))
+    {
+        this->requestedCovers.insert(row.data.file);
+        emit const_cast<RomBrowserModel*>(this)->CoverRequested(row.data);
+    }
+
+    return this->coverFallbackIcon;
+}
+
+//
+// RomBrowserProxyModel
+//
+
+RomBrowserProxyModel::RomBrowserProxyModel(QObject *parent, bool showCovers) : QSortFilterProxyModel(parent)
+{
+    this->showCovers = showCovers;
+}
+
+RomBrowserProxyModel::~RomBrowserProxyModel(void)
+{
+}
+
+QVariant RomBrowserProxyModel::data(const QModelIndex& index, int role) const
+{
+    // don't request covers for views which don't show them
+    if (!this->showCovers && role == Qt::DecorationRole)
+    {
+        return QVariant();
+    }
+
+    return QSortFilterProxyModel::data(index, role);
+}
+
+void RomBrowserProxyModel::SetSearchResults(const QList<int>& rows)
+{
+    this->searching = true;
+    this->searchRanks.fill(-1, this->sourceModel()->rowCount());
+
+    for (int i = 0; i < rows.size(); i++)
+    {
+        if (rows.at(i) >= 0 && rows.at(i) < this->searchRanks.size())
+        {
+            this->searchRanks[rows.at(i)] = i;
+        }
+    }
+
+    this->invalidate();
+}
+
+void RomBrowserProxyModel::SetFilterText(const QString& text)
+{
+    if (text == this->filterText)
+    {
+        return;
+    }
+
+    this->filterText = text;
+    this->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    this->setFilterKeyColumn(0);
+    this->setFilterWildcard(text);
+}
+
+void RomBrowserProxyModel::ClearSearchResults(void)
+{
+    if (!this->searching)
+    {
+        return;
+    }
+
+    this->searching = false;
+    this->searchRanks.clear();
+    this->invalidate();
+}
+
+bool RomBrowserProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    if (!this->searching)
+    {
+        return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+    }
+
+    return sourceRow < this->searchRanks.size() &&
+            this->searchRanks.at(sourceRow) != -1;
+}
+
+bool RomBrowserProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    // show the best search results first,
+    // regardless of the sort order
+    if (this->searching &&
+        left.row() < this->searchRanks.size() &&
+        right.row() < this->searchRanks.size())
+    {
+        const int leftRank  = this->searchRanks.at(left.row());
+        const int rightRank = this->searchRanks.at(right.row());
+        return this->sortOrder() == Qt::AscendingOrder ?
+                leftRank < rightRank :
+                leftRank > rightRank;
+    }
+
+    // compare the ROM data directly, instead of
+    // comparing the text of the columns
+    const RomBrowserModel* model = static_cast<const RomBrowserModel*>(this->sourceModel());
+    return model->LessThan(left.row(), right.row(), left.column());
+}
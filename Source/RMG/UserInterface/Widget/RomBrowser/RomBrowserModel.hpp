@@ -0,0 +1,176 @@
+/*
+ * Rosalie's Mupen GUI - https://github.com/Rosalie241/RMG
+ *  Copyright (C) 2020-2025 Rosalie Wanders <rosalie@mailbox.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ROMBROWSERMODEL_HPP
+#define ROMBROWSERMODEL_HPP
+
+#include <RMG-Core/RomSettings.hpp>
+#include <RMG-Core/RomHeader.hpp>
+#include <RMG-Core/Rom.hpp>
+
+#include <QSortFilterProxyModel>
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QString>
+#include <QCache>
+#include <QImage>
+#include <QIcon>
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+#include <functional>
+
+struct RomBrowserModelData
+{
+    QString         file;
+    CoreRomType     type;
+    CoreRomHeader   header;
+    CoreRomSettings settings;
+    QString         coverFile;
+
+    RomBrowserModelData() {}
+
+    RomBrowserModelData(QString file, CoreRomType type, CoreRomHeader header, CoreRomSettings settings)
+    {
+        this->file     = file;
+        this->type     = type;
+        this->header   = header;
+        this->settings = settings;
+    }
+};
+
+Q_DECLARE_METATYPE(RomBrowserModelData);
+
+namespace UserInterface
+{
+namespace Widget
+{
+//
+// Model of the ROM browser, shared by the list and grid view,
+// it only stores the ROM data, the text of the columns and the
+// covers are created when a view asks for them, so only for
+// the rows which are visible
+//
+class RomBrowserModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+  public:
+    enum Column
+    {
+        Column_Name = 0,
+        Column_InternalName,
+        Column_MD5,
+        Column_Format,
+        Column_FileName,
+        Column_FileExtension,
+        Column_FileSize,
+        Column_GameID,
+        Column_Region,
+        Column_Count
+    };
+
+    // role of the RomBrowserModelData of a row
+    static constexpr int DataRole = Qt::UserRole + 1;
+
+    RomBrowserModel(QObject *);
+    ~RomBrowserModel(void);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void AddRoms(const QList<RomBrowserModelData>& data);
+    // removes the ROMs for which predicate returns true
+    void RemoveRoms(std::function<bool(const RomBrowserModelData&)> predicate);
+    void Clear(void);
+
+    const RomBrowserModelData& GetRomData(int row) const;
+    // returns the row of file, or -1 when it isn't found
+    int GetRomRow(const QString& file) const;
+
+    // compares the given column of both rows,
+    // used by the proxy models to sort the rows
+    bool LessThan(int leftRow, int rightRow, int column) const;
+
+    // sets the loaded cover of file, an empty coverFile
+    // means there's no cover for file
+    void SetCover(const QString& file, const QString& coverFile, const QImage& image);
+    // drops the loaded cover of file, so it'll be requested again
+    void ResetCover(const QString& file);
+    // drops all loaded covers
+    void ResetCovers(void);
+
+  private:
+    struct Row
+    {
+        RomBrowserModelData data;
+        QString             name;
+        // retrieved when it's needed
+        mutable qint64      fileSize = -1;
+    };
+
+    QList<Row>          rows;
+    QHash<QString, int> rowIndexes;
+
+    QIcon coverFallbackIcon;
+    mutable QCache<QString, QIcon> covers;
+    mutable QSet<QString>          requestedCovers;
+
+    QString getName(const RomBrowserModelData& data) const;
+    qint64  getFileSize(const Row& row) const;
+    QString getText(const Row& row, int column) const;
+    QIcon   getCover(const Row& row) const;
+
+  signals:
+    // emitted when a view needs the cover of a ROM
+    // which hasn't been loaded yet
+    void CoverRequested(RomBrowserModelData data);
+};
+
+//
+// Sorts and filters the RomBrowserModel for a view,
+// only the grid view shows the covers
+//
+class RomBrowserProxyModel : public QSortFilterProxyModel
+{
+  public:
+    RomBrowserProxyModel(QObject *, bool showCovers);
+    ~RomBrowserProxyModel(void);
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // only shows the given rows of the source model,
+    // sorted in the given order
+    void SetSearchResults(const QList<int>& rows);
+    // shows all rows again
+    void ClearSearchResults(void);
+    // only shows the rows whose name contains text,
+    // used while there are no search results
+    void SetFilterText(const QString& text);
+
+  protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+  private:
+    bool showCovers;
+
+    QString    filterText;
+    bool       searching = false;
+    // rank of every row of the source model,
+    // -1 when it isn't a search result
+    QList<int> searchRanks;
+};
+} // namespace Widget
+} // namespace UserInterface
+
+#endif // ROMBROWSERMODEL_HPP
@@ -15,43 +15,22 @@
 #include <QBoxLayout>
 #include <QScrollBar>
 #include <QPixmap>
+#include <QSet>
 #include <QLabel>
 #include <vector>
+#include <limits>
 #include <QList>
 #include <QDir>
 
+#include <RMG-Core/CachedRomHeaderAndSettings.hpp>
 #include <RMG-Core/Directories.hpp>
+#include <RMG-Core/Emulation.hpp>
 #include <RMG-Core/SaveState.hpp>
 #include <RMG-Core/Settings.hpp>
 #include <RMG-Core/Plugins.hpp>
 
 using namespace UserInterface::Widget;
 
-//
-// Internal Struct
-//
-
-struct RomBrowserModelData
-{
-    QString         file;
-    CoreRomType     type;
-    CoreRomHeader   header;
-    CoreRomSettings settings;
-    QString         coverFile;
-
-    RomBrowserModelData() {}
-
-    RomBrowserModelData(QString file, CoreRomType type, CoreRomHeader header, CoreRomSettings settings)
-    {
-        this->file     = file;
-        this->type     = type;
-        this->header   = header;
-        this->settings = settings;
-    }
-};
-
-Q_DECLARE_METATYPE(RomBrowserModelData);
-
 //
 // Exported Functions
 // 
@@ -81,6 +60,46 @@ RomBrowserWidget::RomBrowserWidget(QWidget *parent) : QWidget(parent)
     connect(this->romSearcherThread, &Thread::RomSearcherThread::RomsFound, this, &RomBrowserWidget::on_RomBrowserThread_RomsFound);
     connect(this->romSearcherThread, &Thread::RomSearcherThread::Finished, this, &RomBrowserWidget::on_RomBrowserThread_Finished);
 
+    // configure rom watcher thread, which keeps the
+    // ROM list up to date after a full refresh,
+    // the changed ROMs are retrieved by the updater
+    this->romWatcherThread = new Thread::RomWatcherThread(this);
+    connect(this->romWatcherThread, &Thread::RomWatcherThread::FilesChanged, this, &RomBrowserWidget::on_RomWatcherThread_FilesChanged);
+    connect(this->romWatcherThread, &Thread::RomWatcherThread::RefreshRequired, this, &RomBrowserWidget::on_RomWatcherThread_RefreshRequired);
+    this->romUpdaterThread = new Thread::RomSearcherThread(this);
+    this->romUpdaterThread->SetMaximumFiles(std::numeric_limits<int>::max());
+    connect(this->romUpdaterThread, &Thread::RomSearcherThread::RomsFound, this, &RomBrowserWidget::on_RomUpdaterThread_RomsFound);
+    connect(this->romUpdaterThread, &Thread::RomSearcherThread::Finished, this, &RomBrowserWidget::on_RomUpdaterThread_Finished);
+    this->pendingChangesTimer.setSingleShot(true);
+    this->pendingChangesTimer.setInterval(1000);
+    connect(&this->pendingChangesTimer, &QTimer::timeout, this, &RomBrowserWidget::processPendingChanges);
+
+    // configure cover loader thread, covers are loaded
+    // in the background and the fallback cover is shown
+    // until they've been loaded
+    this->coverThumbnailSize = this->getCoverThumbnailSize(QSize(CoreSettingsGetIntValue(SettingsID::RomBrowser_GridViewIconWidth),
+                                                                    CoreSettingsGetIntValue(SettingsID::RomBrowser_GridViewIconHeight)));
+    this->coverLoaderThread = new Thread::CoverLoaderThread(this);
+    this->coverThumbnailDirectory = QString::fromStdString(CoreGetUserCacheDirectory().string());
+    this->coverThumbnailDirectory += CORE_DIR_SEPERATOR_STR;
+    this->coverThumbnailDirectory += "Covers";
+    this->coverLoaderThread->SetThumbnailDirectory(this->coverThumbnailDirectory);
+    this->coverLoaderThread->SetThumbnailSize(this->coverThumbnailSize);
+    connect(this->coverLoaderThread, &Thread::CoverLoaderThread::CoversLoaded, this, &RomBrowserWidget::on_CoverLoaderThread_CoversLoaded);
+    this->coverLoaderThread->start();
+
+    // configure model, which is shared by both views,
+    // covers are only loaded when the grid view shows them
+    this->model = new Widget::RomBrowserModel(this);
+    connect(this->model, &RomBrowserModel::CoverRequested, this, &RomBrowserWidget::loadCover);
+
+    // configure search index thread, the search index is
+    // built in the background whenever the ROMs change,
+    // removed ROMs shift the rows of the search results
+    this->searchIndexThread = new Thread::SearchIndexThread(this);
+    connect(this->searchIndexThread, &Thread::SearchIndexThread::Finished, this, &RomBrowserWidget::on_SearchIndexThread_Finished);
+    connect(this->model, &QAbstractItemModel::rowsRemoved, this, &RomBrowserWidget::applySearch);
+
     // configure empty widget
     this->emptyWidget = new Widget::RomBrowserEmptyWidget(this);
     this->stackedWidget->addWidget(this->emptyWidget);
@@ -96,9 +115,8 @@ RomBrowserWidget::RomBrowserWidget(QWidget *parent) : QWidget(parent)
 
     // configure list view widget
     this->listViewWidget = new Widget::RomBrowserListViewWidget(this);
-    this->listViewModel  = new QStandardItemModel(this);
-    this->listViewProxyModel = new QSortFilterProxyModel(this);
-    this->listViewProxyModel->setSourceModel(this->listViewModel);
+    this->listViewProxyModel = new Widget::RomBrowserProxyModel(this, false);
+    this->listViewProxyModel->setSourceModel(this->model);
     this->listViewWidget->setModel(this->listViewProxyModel);
     this->listViewWidget->setFrameStyle(QFrame::NoFrame);
     this->listViewWidget->setItemDelegate(new NoFocusDelegate(this));
@@ -110,7 +128,7 @@ RomBrowserWidget::RomBrowserWidget(QWidget *parent) : QWidget(parent)
     this->listViewWidget->setSelectionMode(QAbstractItemView::SingleSelection);
     this->listViewWidget->setVerticalScrollMode(QAbstractItemView::ScrollMode::ScrollPerPixel);
     this->listViewWidget->verticalHeader()->hide();
-    this->listViewWidget->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    this->listViewWidget->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     this->listViewWidget->horizontalHeader()->setSectionsMovable(true);
     this->listViewWidget->horizontalHeader()->setFirstSectionMovable(true);
     this->listViewWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
@@ -128,36 +146,21 @@ RomBrowserWidget::RomBrowserWidget(QWidget *parent) : QWidget(parent)
     connect(this->listViewWidget, &Widget::RomBrowserListViewWidget::ZoomOut, this, &RomBrowserWidget::on_ZoomOut);
     connect(this->listViewWidget, &Widget::RomBrowserListViewWidget::FileDropped, this, &RomBrowserWidget::FileDropped);
 
-    // set up list view's columns
-    QStringList labels;
-    labels << "Name";
-    labels << "Internal Name";
-    labels << "MD5";
-    labels << "Format";
-    labels << "File Name";
-    labels << "File Ext.";
-    labels << "File Size";
-    labels << "I.D.";
-    labels << "Region";
-    this->listViewModel->setColumnCount(labels.size());
-    this->listViewModel->setHorizontalHeaderLabels(labels);
-
     // set full names of list view's columns
-    this->columnNames << labels.at(0);
-    this->columnNames << labels.at(1);
-    this->columnNames << labels.at(2);
+    this->columnNames << "Name";
+    this->columnNames << "Internal Name";
+    this->columnNames << "MD5";
     this->columnNames << "Game Format";
-    this->columnNames << labels.at(4);
+    this->columnNames << "File Name";
     this->columnNames << "File Extension";
-    this->columnNames << labels.at(6);
+    this->columnNames << "File Size";
     this->columnNames << "Game I.D.";
     this->columnNames << "Game Region";
 
     // configure grid view widget
     this->gridViewWidget = new Widget::RomBrowserGridViewWidget(this);
-    this->gridViewModel  = new QStandardItemModel(this);
-    this->gridViewProxyModel = new QSortFilterProxyModel(this);
-    this->gridViewProxyModel->setSourceModel(this->gridViewModel);
+    this->gridViewProxyModel = new Widget::RomBrowserProxyModel(this, true);
+    this->gridViewProxyModel->setSourceModel(this->model);
     this->gridViewWidget->setModel(this->gridViewProxyModel);
     this->gridViewWidget->setFlow(QListView::Flow::LeftToRight);
     this->gridViewWidget->setResizeMode(QListView::Adjust);
@@ -293,14 +296,33 @@ RomBrowserWidget::~RomBrowserWidget()
 
 void RomBrowserWidget::RefreshRomList(void)
 {
-    this->listViewModel->removeRows(0, this->listViewModel->rowCount());
-    this->gridViewModel->removeRows(0, this->gridViewModel->rowCount());
+    // a full refresh makes the pending changes obsolete
+    this->romWatcherThread->Stop();
+    this->romUpdaterThread->Stop();
+    this->pendingChangesTimer.stop();
+    this->pendingChangedFiles.clear();
+    this->pendingRemovedFiles.clear();
+    this->pendingRefresh = false;
+
+    this->coverLoaderThread->ClearRequests();
+
+    this->searchIndexThread->Stop();
+    this->searchIndex.reset();
+    this->listViewProxyModel->ClearSearchResults();
+    this->gridViewProxyModel->ClearSearchResults();
+
+    // don't sort while the ROMs are being added,
+    // they're sorted once the refresh has finished
+    this->listViewProxyModel->sort(-1);
+    this->gridViewProxyModel->sort(-1);
+    this->model->Clear();
 
     this->menu_PlayGameWithDisk->clear();
 
     this->coversDirectory = QString::fromStdString(CoreGetUserDataDirectory().string());
     this->coversDirectory += CORE_DIR_SEPERATOR_STR;
     this->coversDirectory += "Covers";
+    this->coverLoaderThread->SetCoversDirectory(this->coversDirectory);
 
     this->listViewSortSection = CoreSettingsGetIntValue(SettingsID::RomBrowser_ListViewSortSection);
     this->listViewSortOrder   = CoreSettingsGetIntValue(SettingsID::RomBrowser_ListViewSortOrder);
@@ -325,14 +347,21 @@ void RomBrowserWidget::RefreshRomList(void)
     this->romSearcherThread->start();
 }
 
+void RomBrowserWidget::ClearCoverCache(void)
+{
+    QDir(this->coverThumbnailDirectory).removeRecursively();
+}
+
 bool RomBrowserWidget::IsRefreshingRomList(void)
 {
-    return this->romSearcherThread->isRunning();
+    return this->romSearcherThread->isRunning() ||
+            this->romUpdaterThread->isRunning();
 }
 
 void RomBrowserWidget::StopRefreshRomList(void)
 {
-    return this->romSearcherThread->Stop();
+    this->romSearcherThread->Stop();
+    this->romUpdaterThread->Stop();
 }
 
 void RomBrowserWidget::ShowList(void)
@@ -406,17 +435,10 @@ void RomBrowserWidget::SetToggleSearch(void)
 QMap<QString, CoreRomSettings> RomBrowserWidget::GetModelData(void)
 {
     QMap<QString, CoreRomSettings> data;
-    QPair<QStandardItemModel*, QSortFilterProxyModel*> model = this->getCurrentModel();
-    RomBrowserModelData modelData;
 
-    if (model.first == nullptr)
+    for (int i = 0; i < this->model->rowCount(); i++)
     {
-        return data;
-    }
-
-    for (int i = 0; i < model.first->rowCount(); i++)
-    {
-        modelData = model.first->item(i)->data().value<RomBrowserModelData>();
+        const RomBrowserModelData& modelData = this->model->GetRomData(i);
         // only add cartridges, 64dd disks aren't supported
         if (modelData.type == CoreRomType::Cartridge)
         {
@@ -427,7 +449,7 @@ QMap<QString, CoreRomSettings> RomBrowserWidget::GetModelData(void)
     return data;
 }
 
-QPair<QStandardItemModel*, QSortFilterProxyModel*> RomBrowserWidget::getCurrentModel(void)
+RomBrowserProxyModel* RomBrowserWidget::getCurrentProxyModel(void)
 {
     QWidget* currentWidget = this->stackedWidget->currentWidget();
     if (currentWidget == this->loadingWidget)
@@ -437,14 +459,14 @@ QPair<QStandardItemModel*, QSortFilterProxyModel*> RomBrowserWidget::getCurrentM
 
     if (currentWidget == this->listViewWidget)
     {
-        return qMakePair(this->listViewModel, this->listViewProxyModel);
+        return this->listViewProxyModel;
     }
     else if (currentWidget == this->gridViewWidget)
     {
-        return qMakePair(this->gridViewModel, this->gridViewProxyModel);
+        return this->gridViewProxyModel;
     }
 
-    return qMakePair(nullptr, nullptr);
+    return nullptr;
 }
 
 QAbstractItemView* RomBrowserWidget::getCurrentModelView(void)
@@ -469,23 +491,21 @@ QAbstractItemView* RomBrowserWidget::getCurrentModelView(void)
 
 bool RomBrowserWidget::getCurrentData(RomBrowserModelData& data)
 {
-    QPair<QStandardItemModel*, QSortFilterProxyModel*> model = this->getCurrentModel();
+    RomBrowserProxyModel* proxyModel = this->getCurrentProxyModel();
     QAbstractItemView* view = this->getCurrentModelView();
 
-    if (model.first == nullptr || model.second == nullptr || view == nullptr)
+    if (proxyModel == nullptr || view == nullptr)
     {
         return false;
     }
 
-    QModelIndex    index = model.second->mapToSource(view->currentIndex());
-    QStandardItem* item  = model.first->item(index.row(), 0);
-
-    if (item == nullptr)
+    QModelIndex index = proxyModel->mapToSource(view->currentIndex());
+    if (!index.isValid())
     {
         return false;
     }
 
-    data = item->data().value<RomBrowserModelData>();
+    data = this->model->GetRomData(index.row());
     return true;
 }
 
@@ -502,109 +522,185 @@ QString RomBrowserWidget::getCurrentRom(void)
     return data.file;
 }
 
-void RomBrowserWidget::addRomData(QString file, CoreRomType type, CoreRomHeader header, CoreRomSettings settings)
+void RomBrowserWidget::addRomData(const QList<RomSearcherThreadData>& data)
+{
+    QList<RomBrowserModelData> modelData;
+    modelData.reserve(data.size());
+
+    for (const RomSearcherThreadData& romData : data)
+    {
+        modelData.append(RomBrowserModelData(romData.File, romData.Type, romData.Header, romData.Settings));
+    }
+
+    this->model->AddRoms(modelData);
+}
+
+void RomBrowserWidget::removeRomData(const QSet<QString>& changedFiles, const QStringList& removedFiles)
 {
-    QString name;
-    QString gameFormat;
-    float fileSize;
-    QString fileSizeString;
-    QString coverFile;
-    QIcon   coverIcon;
-    QVariant itemData;
-    RomBrowserModelData modelData;
+    this->model->RemoveRoms([&](const RomBrowserModelData& modelData)
+    {
+        for (const QString& removedFile : removedFiles)
+        {
+            if (modelData.file == removedFile ||
+                modelData.file.startsWith(removedFile + '/'))
+            {
+                // changed files are retrieved again,
+                // so only removed files are removed
+                // from the cache
+                CoreRemoveCachedRomHeaderAndSettings(modelData.file.toStdU32String());
+                return true;
+            }
+        }
+
+        return changedFiles.contains(modelData.file);
+    });
+}
+
+void RomBrowserWidget::processPendingChanges(void)
+{
+    // wait until a refresh or update has finished,
+    // ROMs which can't be probed are opened in the core,
+    // so that can't be done during emulation either
+    if (this->romSearcherThread->isRunning() ||
+        this->romUpdaterThread->isRunning() ||
+        CoreIsEmulationRunning())
+    {
+        this->pendingChangesTimer.start();
+        return;
+    }
 
-    // create item data
-    modelData = RomBrowserModelData(file, type, header, settings);
+    if (this->pendingRefresh)
+    {
+        this->RefreshRomList();
+        return;
+    }
 
-    // generate name to use in UI
-    name = QString::fromStdString(settings.GoodName);
-    if (name.endsWith("(unknown rom)") ||
-        name.endsWith("(unknown disk)"))
+    if (this->pendingChangedFiles.isEmpty() &&
+        this->pendingRemovedFiles.isEmpty())
     {
-        name = QFileInfo(file).fileName();
+        return;
     }
 
-    // generate game format to use in UI
-    if (type == CoreRomType::Disk)
+    QSet<QString> changedFiles(this->pendingChangedFiles.begin(), this->pendingChangedFiles.end());
+
+    this->removeRomData(changedFiles, this->pendingRemovedFiles);
+
+    if (!changedFiles.isEmpty())
     {
-        gameFormat = "Disk";
+        this->romUpdaterThread->SetFiles(QStringList(changedFiles.begin(), changedFiles.end()));
+        this->romUpdaterThread->start();
     }
     else
     {
-        gameFormat = "Cartridge";
-    }
-
-    // generate file size to use in UI
-    fileSize = QFileInfo(file).size()/1048576.0;
-    fileSizeString = (QString::number(fileSize, 'f', 2)).append(" MB");
-    if (fileSizeString.size() == 7)
-    {
-        fileSizeString = fileSizeString.prepend("  ");
-    }
-
-    // retrieve cover image
-    coverIcon = this->getCurrentCover(file, header, settings, coverFile);
-    modelData.coverFile = coverFile;
-
-    // create item data
-    itemData = QVariant::fromValue<RomBrowserModelData>(modelData);
-
-    QList<QStandardItem*> listViewRow;
-    // goodname
-    QStandardItem* listViewItem1 = new QStandardItem();
-    listViewItem1->setText(name);
-    listViewItem1->setData(itemData);
-    listViewRow.append(listViewItem1);
-    // internal name
-    QStandardItem* listViewItem2 = new QStandardItem();
-    listViewItem2->setText(QString::fromStdString(header.Name));
-    listViewRow.append(listViewItem2);
-    // MD5
-    QStandardItem* listViewItem3 = new QStandardItem();
-    listViewItem3->setText(QString::fromStdString(settings.MD5));
-    listViewRow.append(listViewItem3);
-    // game format
-    QStandardItem* listViewItem4 = new QStandardItem();
-    listViewItem4->setText(gameFormat);
-    listViewRow.append(listViewItem4);
-    // file name
-    QStandardItem* listViewItem5 = new QStandardItem();
-    listViewItem5->setText(QFileInfo(file).completeBaseName());
-    listViewRow.append(listViewItem5);
-    // file extension
-    QStandardItem* listViewItem6 = new QStandardItem();
-    listViewItem6->setText(((QFileInfo(file).suffix()).prepend(".")).toUpper());
-    listViewRow.append(listViewItem6);
-    // file size
-    QStandardItem* listViewItem7 = new QStandardItem();
-    listViewItem7->setText(fileSizeString);
-    listViewRow.append(listViewItem7);
-    // game i.d.
-    QStandardItem* listViewItem8 = new QStandardItem();
-    listViewItem8->setText(QString::fromStdString(header.GameID));
-    listViewRow.append(listViewItem8);
-    // region
-    QStandardItem* listViewItem9 = new QStandardItem();
-    listViewItem9->setText(QString::fromStdString(header.Region));
-    listViewRow.append(listViewItem9);
-    this->listViewModel->appendRow(listViewRow);
-
-    QStandardItem* gridViewItem = new QStandardItem();
-    gridViewItem->setIcon(coverIcon);
-    gridViewItem->setText(name);
-    gridViewItem->setData(itemData);
-    this->gridViewModel->appendRow(gridViewItem);
+        this->generatePlayWithDiskMenu();
+        this->buildSearchIndex();
+        this->updateCurrentWidget();
+    }
+
+    this->pendingChangedFiles.clear();
+    this->pendingRemovedFiles.clear();
+}
+
+void RomBrowserWidget::updateCurrentWidget(void)
+{
+    // don't interfere with the loading screen
+    if (this->stackedWidget->currentWidget() == this->loadingWidget)
+    {
+        return;
+    }
+
+    if (this->model->rowCount() == 0)
+    {
+        this->stackedWidget->setCurrentWidget(this->emptyWidget);
+    }
+    else if (this->stackedWidget->currentWidget() == this->emptyWidget)
+    {
+        this->stackedWidget->setCurrentWidget(this->currentViewWidget);
+        this->searchWidget->setVisible(this->showSearchWidget);
+    }
 }
 
-QIcon RomBrowserWidget::getCurrentCover(QString file, CoreRomHeader header, CoreRomSettings settings, QString& coverFileName)
+void RomBrowserWidget::buildSearchIndex(void)
 {
-    QPixmap pixmap;
+    QList<SearchIndexThreadData> data;
+    data.reserve(this->model->rowCount());
+
+    for (int i = 0; i < this->model->rowCount(); i++)
+    {
+        const RomBrowserModelData& modelData = this->model->GetRomData(i);
+        data.append(
+        {
+            modelData.file,
+            this->model->index(i, RomBrowserModel::Column_Name).data().toString(),
+            QString::fromStdString(modelData.header.Name),
+            QString::fromStdString(modelData.header.GameID),
+            QFileInfo(modelData.file).fileName()
+        });
+    }
+
+    this->searchIndexThread->Stop();
+    this->searchIndexThread->SetData(data);
+    this->searchIndexThread->start();
+}
 
+void RomBrowserWidget::applySearch(void)
+{
+    if (this->searchText.trimmed().isEmpty())
+    {
+        this->listViewProxyModel->SetFilterText(QString());
+        this->gridViewProxyModel->SetFilterText(QString());
+        this->listViewProxyModel->ClearSearchResults();
+        this->gridViewProxyModel->ClearSearchResults();
+        return;
+    }
+
+    // match the name of every ROM until
+    // the search index has been built
+    if (this->searchIndex == nullptr)
+    {
+        this->listViewProxyModel->ClearSearchResults();
+        this->gridViewProxyModel->ClearSearchResults();
+        this->listViewProxyModel->SetFilterText(this->searchText);
+        this->gridViewProxyModel->SetFilterText(this->searchText);
+        return;
+    }
+
+    this->listViewProxyModel->SetFilterText(QString());
+    this->gridViewProxyModel->SetFilterText(QString());
+
+    QList<int> rows;
+    for (const QString& file : this->searchIndex->Search(this->searchText))
+    {
+        // the ROM may have been removed
+        // after the index has been built
+        int row = this->model->GetRomRow(file);
+        if (row != -1)
+        {
+            rows.append(row);
+        }
+    }
+
+    this->listViewProxyModel->SetSearchResults(rows);
+    this->gridViewProxyModel->SetSearchResults(rows);
+}
+
+QSize RomBrowserWidget::getCoverThumbnailSize(const QSize& iconSize)
+{
+    // round the size up, so zooming in a bit
+    // doesn't require new thumbnails
+    const int step = 128;
+    QSize size = iconSize * this->devicePixelRatio();
+    return QSize(((size.width() / step) + 1) * step,
+                    ((size.height() / step) + 1) * step);
+}
+
+void RomBrowserWidget::loadCover(const RomBrowserModelData& data)
+{
     // construct basename of file,
     // by retrieving the last index of '.'
     // and removing all characters from that index
     // until the end of the string
-    QString baseName         = QFileInfo(file).fileName();
+    QString baseName         = QFileInfo(data.file).fileName();
     qsizetype lastIndexOfDot = baseName.lastIndexOf(".");
     if (lastIndexOfDot != -1)
     { // only remove when index was found
@@ -616,12 +712,12 @@ QIcon RomBrowserWidget::getCurrentCover(QString file, CoreRomHeader header, Core
     // 2) MD5
     // 3) good name
     // 4) internal name
-    bool foundCover = false;
+    QStringList names;
     for (QString name : { 
         baseName,
-        QString::fromStdString(settings.MD5), 
-        QString::fromStdString(settings.GoodName), 
-        QString::fromStdString(header.Name) })
+        QString::fromStdString(data.settings.MD5), 
+        QString::fromStdString(data.settings.GoodName), 
+        QString::fromStdString(data.header.Name) })
     {
         // fixup file name
         QString fixedName = name;
@@ -639,35 +735,10 @@ QIcon RomBrowserWidget::getCurrentCover(QString file, CoreRomHeader header, Core
             continue;
         }
 
-        // we support jpg & png as file extensions
-        for (QString ext : { ".png", ".jpg", ".jpeg" })
-        {
-            QString coverPath = this->coversDirectory;
-            coverPath += CORE_DIR_SEPERATOR_STR;
-            coverPath += fixedName;
-            coverPath += ext;
-
-            if (QFile::exists(coverPath) && 
-                pixmap.load(coverPath))
-            {
-                coverFileName = coverPath;
-                foundCover = true;
-                break;
-            }
-        }
-
-        if (foundCover)
-        {
-            break;
-        }
-    }
-    // fallback
-    if (!foundCover)
-    {
-        pixmap.load(":Resource/CoverFallback.png");
+        names.append(fixedName);
     }
 
-    return QIcon(pixmap);
+    this->coverLoaderThread->AddRequest(data.file, names);
 }
 
 void RomBrowserWidget::timerEvent(QTimerEvent* event)
@@ -755,7 +826,7 @@ void RomBrowserWidget::generateColumnsMenu(void)
 {
     this->menu_Columns->clear();
 
-    for (int i = 0; i < this->listViewModel->columnCount(); i++)
+    for (int i = 0; i < this->model->columnCount(); i++)
     {
         int column = this->listViewWidget->horizontalHeader()->logicalIndex(i);
 
@@ -772,20 +843,13 @@ void RomBrowserWidget::generateColumnsMenu(void)
 void RomBrowserWidget::generatePlayWithDiskMenu(void)
 {
     QAction* playGameWithAction;
-    QPair<QStandardItemModel*, QSortFilterProxyModel*> model = this->getCurrentModel();
-    RomBrowserModelData modelData;
     int count = 0;
 
     this->menu_PlayGameWithDisk->clear();
 
-    if (model.first == nullptr)
-    {
-        return;
-    }
-
-    for (int i = 0; i < model.first->rowCount(); i++)
+    for (int i = 0; i < this->model->rowCount(); i++)
     {
-        modelData = model.first->item(i)->data().value<RomBrowserModelData>();
+        const RomBrowserModelData& modelData = this->model->GetRomData(i);
         if (modelData.type == CoreRomType::Disk)
         {
             if (count == 0)
@@ -795,8 +859,8 @@ void RomBrowserWidget::generatePlayWithDiskMenu(void)
             }
 
             playGameWithAction = new QAction(this);
-            playGameWithAction->setText(model.first->item(i)->text());
-            playGameWithAction->setData(model.first->item(i)->data());
+            playGameWithAction->setText(this->model->index(i, RomBrowserModel::Column_Name).data().toString());
+            playGameWithAction->setData(QVariant::fromValue<RomBrowserModelData>(modelData));
             this->menu_PlayGameWithDisk->addAction(playGameWithAction);
 
             // only add 10 disks to menu,
@@ -850,15 +914,8 @@ void RomBrowserWidget::generateStateMenu(void)
 
 void RomBrowserWidget::on_searchWidget_SearchTextChanged(const QString& text)
 {
-    // TODO: I should really make a custom data
-    // model at this point to save memory & CPU cycles...
-    this->listViewProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    this->listViewProxyModel->setFilterWildcard(text);
-    this->listViewProxyModel->setFilterKeyColumn(0);
-
-    this->gridViewProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    this->gridViewProxyModel->setFilterWildcard(text);
-    this->gridViewProxyModel->setFilterKeyColumn(0);
+    this->searchText = text;
+    this->applySearch();
 }
 
 void RomBrowserWidget::on_listViewWidget_sortIndicatorChanged(int logicalIndex, Qt::SortOrder sortOrder)
@@ -898,7 +955,7 @@ void RomBrowserWidget::on_listViewWidget_sectionResized(int logicalIndex, int ol
             CoreSettingsSetValue(SettingsID::RomBrowser_ColumnVisibility, columnVisibility);
 
             int lastVisibleColumn = -1;
-            for (int i = 0; i < this->listViewModel->columnCount(); i++)
+            for (int i = 0; i < this->model->columnCount(); i++)
             {
                 int column = this->listViewWidget->horizontalHeader()->logicalIndex(i);
                 if (!this->listViewWidget->horizontalHeader()->isSectionHidden(column))
@@ -938,6 +995,20 @@ void RomBrowserWidget::on_gridViewWidget_iconSizeChanged(const QSize& size)
 {
     CoreSettingsSetValue(SettingsID::RomBrowser_GridViewIconWidth, size.width());
     CoreSettingsSetValue(SettingsID::RomBrowser_GridViewIconHeight, size.height());
+
+    // reload the covers when the
+    // thumbnails have become too small
+    QSize thumbnailSize = this->getCoverThumbnailSize(size);
+    if (thumbnailSize.width() <= this->coverThumbnailSize.width() &&
+        thumbnailSize.height() <= this->coverThumbnailSize.height())
+    {
+        return;
+    }
+
+    this->coverThumbnailSize = thumbnailSize;
+    this->coverLoaderThread->ClearRequests();
+    this->coverLoaderThread->SetThumbnailSize(thumbnailSize);
+    this->model->ResetCovers();
 }
 
 void RomBrowserWidget::on_ZoomIn(void)
@@ -965,10 +1036,7 @@ void RomBrowserWidget::on_ZoomOut(void)
 void RomBrowserWidget::on_RomBrowserThread_RomsFound(QList<RomSearcherThreadData> data, int index, int count)
 {
     // add every item to our dataset
-    for (qsizetype i = 0; i < data.size(); i++)
-    {
-        this->addRomData(data[i].File, data[i].Type, data[i].Header, data[i].Settings);
-    }
+    this->addRomData(data);
 
     // update loading widget
     this->loadingWidget->SetCurrentRomIndex(index, count);
@@ -990,17 +1058,21 @@ void RomBrowserWidget::on_RomBrowserThread_Finished(bool canceled)
 
     // reset column sizes setting in config file if number of values is incorrect
     if (!columnSizes.empty() && 
-        columnSizes.size() != this->listViewModel->columnCount())
+        columnSizes.size() != this->model->columnCount())
     {
         columnSizes.clear();
-        columnSizes.resize(this->listViewModel->columnCount(), -1);
+        columnSizes.resize(this->model->columnCount(), -1);
         CoreSettingsSetValue(SettingsID::RomBrowser_ColumnSizes, columnSizes);
     }
 
     // update list view's column sizes when
     // we have any rows in our list view
-    if (this->listViewModel->rowCount() != 0)
+    if (this->model->rowCount() != 0)
     {
+        // all rows have the same height, so use a fixed
+        // height instead of measuring every row
+        this->listViewWidget->verticalHeader()->setDefaultSectionSize(this->listViewWidget->sizeHintForRow(0));
+
         for (size_t i = 0; i < columnSizes.size(); i++)
         {
             // set column widths to values specified in config file (or resize to content if not already specified)
@@ -1020,10 +1092,10 @@ void RomBrowserWidget::on_RomBrowserThread_Finished(bool canceled)
 
     // reset column order setting in config file if number of values is incorrect
     if (!columnOrder.empty() &&
-        columnOrder.size() != this->listViewModel->columnCount())
+        columnOrder.size() != this->model->columnCount())
     {
         columnOrder.clear();
-        for (int i = 0; i < this->listViewModel->columnCount(); i++)
+        for (int i = 0; i < this->model->columnCount(); i++)
         {
             columnOrder.push_back(i);
         }
@@ -1038,10 +1110,10 @@ void RomBrowserWidget::on_RomBrowserThread_Finished(bool canceled)
 
     // reset column visibility setting in config file if number of values is incorrect
     if (!columnVisibility.empty() &&
-        columnVisibility.size() != this->listViewModel->columnCount())
+        columnVisibility.size() != this->model->columnCount())
     {
         columnVisibility.clear();
-        columnVisibility.resize(this->listViewModel->columnCount(), 0);
+        columnVisibility.resize(this->model->columnCount(), 0);
         for (int i = 0; i < 3; i++)
         {
             columnVisibility.at(i) = 1;
@@ -1063,6 +1135,10 @@ void RomBrowserWidget::on_RomBrowserThread_Finished(bool canceled)
     // this should save a lot of otherwise wasted CPU cycles
     this->generatePlayWithDiskMenu();
 
+    // build the search index in the background,
+    // until it's done searching shows all ROMs
+    this->buildSearchIndex();
+
     // when canceled, we shouldn't switch to the grid/list view
     // because that can cause some flicker, so just return here
     // and don't do anything because a refresh will be triggered
@@ -1073,7 +1149,13 @@ void RomBrowserWidget::on_RomBrowserThread_Finished(bool canceled)
         return;
     }
 
-    if (this->listViewModel->rowCount() == 0)
+    // keep track of changes in the directory,
+    // so we don't have to refresh again
+    this->romWatcherThread->SetDirectory(QString::fromStdString(CoreSettingsGetStringValue(SettingsID::RomBrowser_Directory)));
+    this->romWatcherThread->SetRecursive(CoreSettingsGetBoolValue(SettingsID::RomBrowser_Recursive));
+    this->romWatcherThread->start();
+
+    if (this->model->rowCount() == 0)
     {
         this->stackedWidget->setCurrentWidget(this->emptyWidget);
         emit this->RomListRefreshFinished(false);
@@ -1095,6 +1177,61 @@ void RomBrowserWidget::on_RomBrowserThread_Finished(bool canceled)
     emit this->RomListRefreshFinished(false);
 }
 
+void RomBrowserWidget::on_RomWatcherThread_FilesChanged(QStringList changedFiles, QStringList removedFiles)
+{
+    this->pendingChangedFiles.append(changedFiles);
+    this->pendingRemovedFiles.append(removedFiles);
+    this->processPendingChanges();
+}
+
+void RomBrowserWidget::on_RomWatcherThread_RefreshRequired(void)
+{
+    this->pendingRefresh = true;
+    this->processPendingChanges();
+}
+
+void RomBrowserWidget::on_RomUpdaterThread_RomsFound(QList<RomSearcherThreadData> data, int index, int count)
+{
+    this->addRomData(data);
+}
+
+void RomBrowserWidget::on_RomUpdaterThread_Finished(bool canceled)
+{
+    // sort data
+    this->listViewProxyModel->sort(this->listViewSortSection, static_cast<Qt::SortOrder>(this->listViewSortOrder));
+    this->gridViewProxyModel->sort(0, Qt::SortOrder::AscendingOrder);
+
+    this->generatePlayWithDiskMenu();
+    this->buildSearchIndex();
+    this->updateCurrentWidget();
+
+    // handle the changes which came in
+    // while we were busy
+    if (!canceled)
+    {
+        this->processPendingChanges();
+    }
+}
+
+void RomBrowserWidget::on_CoverLoaderThread_CoversLoaded(QList<CoverLoaderThreadData> data)
+{
+    for (const CoverLoaderThreadData& coverData : data)
+    {
+        this->model->SetCover(coverData.File, coverData.CoverFile, coverData.Image);
+    }
+}
+
+void RomBrowserWidget::on_SearchIndexThread_Finished(bool canceled)
+{
+    if (canceled)
+    {
+        return;
+    }
+
+    this->searchIndex = this->searchIndexThread->GetIndex();
+    this->applySearch();
+}
+
 void RomBrowserWidget::on_Action_PlayGame(void)
 {
     emit this->PlayGame(this->getCurrentRom());
@@ -1193,7 +1330,7 @@ void RomBrowserWidget::on_Action_ResetColumnSizes(void)
     std::vector<int> columnVisibility = CoreSettingsGetIntListValue(SettingsID::RomBrowser_ColumnVisibility);
     this->listViewWidget->horizontalHeader()->setStretchLastSection(false);
 
-    for (int i = 0; i < this->listViewModel->columnCount(); i++)
+    for (int i = 0; i < this->model->columnCount(); i++)
     {
         this->listViewWidget->horizontalHeader()->setSectionHidden(i, false);
     }
@@ -1214,11 +1351,10 @@ void RomBrowserWidget::on_Action_SetCoverImage(void)
 {
     QString sourceFile;
     QFileInfo sourceFileInfo;
-    QString coverFile;
 
-    QPair<QStandardItemModel*, QSortFilterProxyModel*> model = this->getCurrentModel();
-    QAbstractItemView* view  = this->getCurrentModelView();
-    if (model.first == nullptr || model.second == nullptr || view == nullptr)
+    RomBrowserModelData data;
+
+    if (!this->getCurrentData(data))
     {
         return;
     }
@@ -1237,10 +1373,6 @@ void RomBrowserWidget::on_Action_SetCoverImage(void)
     // retrieve file info
     sourceFileInfo = QFileInfo(sourceFile);
 
-    QModelIndex         index = model.second->mapToSource(view->currentIndex());
-    QStandardItem*      item  = model.first->item(index.row(), index.column());
-    RomBrowserModelData data  = model.first->itemData(index).last().value<RomBrowserModelData>();
-
     // construct new file name (for the cover)
     QString newFileName = this->coversDirectory;
     newFileName += CORE_DIR_SEPERATOR_STR;
@@ -1268,32 +1400,23 @@ void RomBrowserWidget::on_Action_SetCoverImage(void)
     QFile::copy(sourceFile, newFileName);
 
     // update item
-    item->setIcon(this->getCurrentCover(data.file, data.header, data.settings, coverFile));
-    data.coverFile = coverFile;
-    item->setData(QVariant::fromValue<RomBrowserModelData>(data));
+    this->model->ResetCover(data.file);
 }
 
 void RomBrowserWidget::on_Action_RemoveCoverImage(void)
 {
-    QPair<QStandardItemModel*, QSortFilterProxyModel*> model = this->getCurrentModel();
-    QAbstractItemView*  view  = this->getCurrentModelView();
-    if (model.first == nullptr || model.second == nullptr || view == nullptr)
+    RomBrowserModelData data;
+
+    if (!this->getCurrentData(data))
     {
         return;
     }
 
-    QModelIndex         index = model.second->mapToSource(view->currentIndex());
-    QStandardItem*      item  = model.first->item(index.row(), index.column());
-    RomBrowserModelData data  = model.first->itemData(index).last().value<RomBrowserModelData>();
-    QString coverFile;
-
     if (!data.coverFile.isEmpty() && QFile::exists(data.coverFile))
     {
         QFile::remove(data.coverFile);
     }
 
     // update item
-    item->setIcon(this->getCurrentCover(data.file, data.header, data.settings, coverFile));
-    data.coverFile = coverFile;
-    item->setData(QVariant::fromValue<RomBrowserModelData>(data));
+    this->model->ResetCover(data.file);
 }
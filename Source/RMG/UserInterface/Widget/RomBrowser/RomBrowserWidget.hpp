@@ -10,7 +10,10 @@
 #ifndef ROMBROWSERWIDGET_HPP
 #define ROMBROWSERWIDGET_HPP
 
+#include "Thread/CoverLoaderThread.hpp"
 #include "Thread/RomSearcherThread.hpp"
+#include "Thread/RomWatcherThread.hpp"
+#include "Thread/SearchIndexThread.hpp"
 #include "UserInterface/NoFocusDelegate.hpp"
 
 #include "RomBrowserListViewWidget.hpp"
@@ -18,25 +21,21 @@
 #include "RomBrowserLoadingWidget.hpp"
 #include "RomBrowserSearchWidget.hpp"
 #include "RomBrowserEmptyWidget.hpp"
+#include "RomBrowserModel.hpp"
 
-#include <QSortFilterProxyModel>
-#include <QStandardItemModel>
 #include <QStackedWidget>
 #include <QGridLayout>
 #include <QListWidget>
 #include <QHeaderView>
 #include <QTableView>
+#include <QTimer>
 #include <QLineEdit>
 #include <QAction>
 #include <QString>
 #include <QList>
 #include <QMenu>
-#include <QPair>
 #include <QMap>
 
-// forward declaration of internal struct
-struct RomBrowserModelData;
-
 namespace UserInterface
 {
 namespace Widget
@@ -53,6 +52,9 @@ class RomBrowserWidget : public QWidget
     bool IsRefreshingRomList(void);
     void StopRefreshRomList(void);
 
+    // removes the cached cover thumbnails
+    void ClearCoverCache(void);
+
     void ShowList(void);
     void ShowGrid(void);
 
@@ -66,20 +68,30 @@ class RomBrowserWidget : public QWidget
     Widget::RomBrowserEmptyWidget*    emptyWidget    = nullptr;
     Widget::RomBrowserLoadingWidget*  loadingWidget  = nullptr;
 
+    Widget::RomBrowserModel* model                   = nullptr;
     Widget::RomBrowserListViewWidget* listViewWidget = nullptr;
-    QStandardItemModel* listViewModel                = nullptr;
-    QSortFilterProxyModel* listViewProxyModel        = nullptr;
+    Widget::RomBrowserProxyModel* listViewProxyModel = nullptr;
     Widget::RomBrowserGridViewWidget* gridViewWidget = nullptr;
-    QStandardItemModel* gridViewModel                = nullptr;
-    QSortFilterProxyModel* gridViewProxyModel        = nullptr;
+    Widget::RomBrowserProxyModel* gridViewProxyModel = nullptr;
 
     Widget::RomBrowserSearchWidget* searchWidget = nullptr;
     bool showSearchWidget = false;
 
+    QString searchText;
+    std::shared_ptr<const SearchIndex> searchIndex;
+    Thread::SearchIndexThread* searchIndexThread = nullptr;
+
     QWidget* currentViewWidget = nullptr;
 
     QElapsedTimer romSearcherTimer;
     Thread::RomSearcherThread* romSearcherThread = nullptr;
+
+    Thread::RomWatcherThread*  romWatcherThread  = nullptr;
+    Thread::RomSearcherThread* romUpdaterThread  = nullptr;
+    QStringList pendingChangedFiles;
+    QStringList pendingRemovedFiles;
+    bool        pendingRefresh = false;
+    QTimer      pendingChangesTimer;
   
     int listViewSortSection = 0;
     int listViewSortOrder = 0;
@@ -106,16 +118,26 @@ class RomBrowserWidget : public QWidget
     QAction* action_ColumnsMenuEntry;
 
     QString coversDirectory;
+    QString coverThumbnailDirectory;
+    QSize   coverThumbnailSize;
+    Thread::CoverLoaderThread* coverLoaderThread = nullptr;
 
-    QPair<QStandardItemModel*, QSortFilterProxyModel*> getCurrentModel(void);
+    Widget::RomBrowserProxyModel* getCurrentProxyModel(void);
     QAbstractItemView*  getCurrentModelView(void);
     bool getCurrentData(RomBrowserModelData& data);
 
     QString getCurrentRom(void);
 
-    void addRomData(QString file, CoreRomType type, CoreRomHeader header, CoreRomSettings settings);
+    void addRomData(const QList<RomSearcherThreadData>& data);
+    void removeRomData(const QSet<QString>& changedFiles, const QStringList& removedFiles);
+    void processPendingChanges(void);
+    void updateCurrentWidget(void);
 
-    QIcon getCurrentCover(QString file, CoreRomHeader header, CoreRomSettings settings, QString& coverFileName);
+    void buildSearchIndex(void);
+    void applySearch(void);
+
+    QSize getCoverThumbnailSize(const QSize& iconSize);
+    void  loadCover(const RomBrowserModelData& data);
 
   protected:
     void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE;
@@ -142,6 +164,15 @@ class RomBrowserWidget : public QWidget
     void on_RomBrowserThread_RomsFound(QList<RomSearcherThreadData> data, int index, int count);
     void on_RomBrowserThread_Finished(bool canceled);
 
+    void on_RomWatcherThread_FilesChanged(QStringList changedFiles, QStringList removedFiles);
+    void on_RomWatcherThread_RefreshRequired(void);
+    void on_RomUpdaterThread_RomsFound(QList<RomSearcherThreadData> data, int index, int count);
+    void on_RomUpdaterThread_Finished(bool canceled);
+
+    void on_CoverLoaderThread_CoversLoaded(QList<CoverLoaderThreadData> data);
+
+    void on_SearchIndexThread_Finished(bool canceled);
+
     void on_Action_PlayGame(void);
     void on_Action_PlayGameWith(void);
     void on_Menu_PlayGameWithDisk(QAction* action);
@@ -26,8 +26,11 @@
 #include <signal.h>
 #endif
 
+#include <RMG-Core/KailleraReplay.hpp>
+#include <RMG-Core/StateHash.hpp>
 #include <RMG-Core/Directories.hpp>
 #include <RMG-Core/Version.hpp>
+#include <RMG-Core/Error.hpp>
 
 //
 // Local Functions
@@ -222,6 +225,8 @@ int main(int argc, char **argv)
     QCommandLineOption quitAfterEmulationOption({"q", "quit-after-emulation"}, "Quits RMG when emulation has finished");
     QCommandLineOption loadStateSlot("load-state-slot", "Loads save state slot when launching the ROM", "Slot Number");
     QCommandLineOption diskOption("disk", "64DD Disk to open ROM in combination with", "64DD Disk");
+    QCommandLineOption kailleraReplayOption("kaillera-replay", "Plays Kaillera replay with ROM without speed limiter", "Replay");
+    QCommandLineOption compareStateHashLogsOption("compare-state-hash-logs", "Compares the two Kaillera state hash logs given instead of the ROM and prints the first frame which differs");
 
 #ifndef PORTABLE_INSTALL
     parser.addOption(libPathOption);
@@ -235,6 +240,8 @@ int main(int argc, char **argv)
     parser.addOption(quitAfterEmulationOption);
     parser.addOption(loadStateSlot);
     parser.addOption(diskOption);
+    parser.addOption(kailleraReplayOption);
+    parser.addOption(compareStateHashLogsOption);
     parser.addPositionalArgument("ROM", "ROM to open");
 
     // parse arguments
@@ -270,6 +277,35 @@ int main(int argc, char **argv)
     // specified ROM path to launch
     QStringList args = parser.positionalArguments();
 
+    if (parser.isSet(compareStateHashLogsOption))
+    {
+        CoreStateHashDivergence divergence;
+
+        if (args.size() != 2)
+        {
+            std::cerr << "--compare-state-hash-logs requires 2 logs" << std::endl;
+            return 1;
+        }
+
+        if (!CoreCompareStateHashLogs(args.at(0).toStdU32String(), args.at(1).toStdU32String(), divergence))
+        {
+            std::cerr << CoreGetError() << std::endl;
+            return 1;
+        }
+
+        if (!divergence.Found)
+        {
+            std::cout << "No differences in " << divergence.ComparedFrames << " frames" << std::endl;
+            return 0;
+        }
+
+        std::cout << "Frame " << divergence.Frame << " differs:"
+                  << (divergence.Cpu   ? " CPU"   : "")
+                  << (divergence.Rsp   ? " RSP"   : "")
+                  << (divergence.Rdram ? " RDRAM" : "") << std::endl;
+        return 1;
+    }
+
     CoreAddCallbackMessage(CoreDebugMessageType::Info, 
             "Initializing on " + QGuiApplication::platformName().toStdString());
 
@@ -289,6 +325,13 @@ int main(int argc, char **argv)
             saveStateSlot = -1;
         }
 
+        if (parser.isSet(kailleraReplayOption) &&
+            !CoreLoadKailleraReplay(parser.value(kailleraReplayOption).toStdU32String()))
+        {
+            std::cerr << CoreGetError() << std::endl;
+            return 1;
+        }
+
         window.OpenROM(args.at(0), parser.value(diskOption), parser.isSet(fullscreenOption), parser.isSet(quitAfterEmulationOption), saveStateSlot);
     }
 